@@ -0,0 +1,88 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   BenchMain.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "Benchmarks.h"
+#include "Corpus.h"
+
+#include <benchmark/benchmark.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    bool hasArgument(int argc, char **argv, const char *prefix)
+    {
+        return std::any_of(argv + 1, argv + argc, [prefix](const char *argument)
+        {
+            return juce::String(argument).startsWith(prefix);
+        });
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Main
+//======================================================================================================================
+int main(int argc, char **argv)
+{
+    // Fonts, images and components need juce to be set up, though nothing is ever shown on the screen
+    const juce::ScopedJuceInitialiser_GUI juce_initialiser;
+    
+    const Corpus corpus(juce::File(JAMAL_BENCH_CORPUS_DIR),
+                        juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("jamal-bench-corpus"));
+    
+    ::registerSyntaxBenchmarks(corpus);
+    ::registerRenderBenchmarks(corpus);
+    
+    // Unless told otherwise, results are written as json named after the commit, for comparing them with
+    // google benchmark's tools/compare.py
+    std::vector<char*> arguments(argv, argv + argc);
+    std::string        out_argument        = "--benchmark_out=jamal_bench-" JAMAL_BENCH_COMMIT ".json";
+    std::string        out_format_argument = "--benchmark_out_format=json";
+    
+    if (!::hasArgument(argc, argv, "--benchmark_out="))
+    {
+        arguments.push_back(out_argument.data());
+        arguments.push_back(out_format_argument.data());
+    }
+    
+    int num_arguments = static_cast<int>(arguments.size());
+    benchmark::Initialize(&num_arguments, arguments.data());
+    
+    if (benchmark::ReportUnrecognizedArguments(num_arguments, arguments.data()))
+    {
+        return 1;
+    }
+    
+    benchmark::AddCustomContext("jamal_commit", JAMAL_BENCH_COMMIT);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+//======================================================================================================================
+// endregion Main
+//**********************************************************************************************************************
@@ -0,0 +1,34 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   Benchmarks.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+class Corpus;
+
+/** Registers the benchmarks of parsing grammars, themes and documents. */
+void registerSyntaxBenchmarks(const Corpus &corpus);
+
+/** Registers the benchmarks of laying out and painting text, which render into an image instead of a window. */
+void registerRenderBenchmarks(const Corpus &corpus);
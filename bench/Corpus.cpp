@@ -0,0 +1,121 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   Corpus.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "Corpus.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    constexpr const char *Sample_Wildcard = "small.xml;small.xaml";
+    
+    //==================================================================================================================
+    juce::String getSizeName(std::int64_t size)
+    {
+        return size >= (1 << 20) ? juce::String(size >> 20) + "M" : juce::String(size >> 10) + "K";
+    }
+    
+    /** Gets a sample without its prolog, so it can be repeated inside another element. */
+    juce::String getBody(const juce::String &sample)
+    {
+        juce::StringArray lines = juce::StringArray::fromLines(sample);
+        
+        while (!lines.isEmpty() && (lines[0].startsWith("<?xml") || lines[0].startsWith("<!DOCTYPE")))
+        {
+            lines.remove(0);
+        }
+        
+        return lines.joinIntoString("\n").trimEnd() + "\n";
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Corpus
+//======================================================================================================================
+Corpus::Corpus(juce::File parSourceDirectory, juce::File parCacheDirectory)
+    : sourceDirectory(std::move(parSourceDirectory)),
+      cacheDirectory (std::move(parCacheDirectory))
+{
+    (void) cacheDirectory.createDirectory();
+    
+    for (const auto &sample : sourceDirectory.findChildFiles(juce::File::findFiles, false, Sample_Wildcard))
+    {
+        for (const std::int64_t size : Sizes)
+        {
+            const juce::String size_name = ::getSizeName(size);
+            const juce::File   target    = cacheDirectory.getChildFile(sample.getFileNameWithoutExtension() + "-"
+                                                                       + size_name + sample.getFileExtension());
+            
+            if (target.existsAsFile() || generate(sample, target, size))
+            {
+                entries.push_back({ sample.getFileName() + "/" + size_name, target, target.getSize() });
+            }
+        }
+    }
+    
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+    {
+        return a.name.compareNatural(b.name) < 0;
+    });
+}
+
+//======================================================================================================================
+bool Corpus::generate(const juce::File &sample, const juce::File &target, std::int64_t size)
+{
+    const juce::String body     = ::getBody(sample.loadFileAsString());
+    const juce::File   tmp_file = target.getSiblingFile(target.getFileName() + ".tmp");
+    
+    {
+        juce::FileOutputStream output(tmp_file);
+        
+        if (!output.openedOk() || !output.setPosition(0) || !output.truncate().wasOk())
+        {
+            return false;
+        }
+        
+        output << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<corpus>\n";
+        
+        while (output.getPosition() < size)
+        {
+            output << body;
+        }
+        
+        output << "</corpus>\n";
+        output.flush();
+        
+        if (output.getStatus().failed())
+        {
+            (void) tmp_file.deleteFile();
+            return false;
+        }
+    }
+    
+    return tmp_file.moveFileTo(target);
+}
+//======================================================================================================================
+// endregion Corpus
+//**********************************************************************************************************************
@@ -0,0 +1,76 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   Corpus.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+    The documents the benchmarks run on.
+    
+    Only small hand written samples are checked in, the bigger documents are generated from them by repeating
+    their content inside one root element until a size is reached. Generated files are kept in a cache directory
+    and only written again if they are missing.
+ */
+class Corpus
+{
+public:
+    struct Entry
+    {
+        juce::String name; // The sample and the size, for example "small.xaml/1M"
+        juce::File   file;
+        std::int64_t size;
+    };
+    
+    //==================================================================================================================
+    /** The approximate sizes of the generated documents, in bytes. */
+    static constexpr std::array<std::int64_t, 5> Sizes { 4 << 10, 64 << 10, 1 << 20, 16 << 20, 100 << 20 };
+    
+    //==================================================================================================================
+    /**
+        Finds the samples and generates the documents that are missing.
+        
+        @param sourceDirectory The directory with the checked in samples, grammar and theme
+        @param cacheDirectory  The directory generated documents are kept in between runs
+     */
+    Corpus(juce::File sourceDirectory, juce::File cacheDirectory);
+    
+    //==================================================================================================================
+    /** Gets all documents, ordered by sample and then by size. */
+    const std::vector<Entry>& getEntries() const noexcept { return entries; }
+    
+    juce::File getGrammarFile() const { return sourceDirectory.getChildFile("xml.tmLanguage.json"); }
+    juce::File getThemeFile()   const { return sourceDirectory.getChildFile("theme.json"); }
+    
+private:
+    juce::File         sourceDirectory;
+    juce::File         cacheDirectory;
+    std::vector<Entry> entries;
+    
+    //==================================================================================================================
+    static bool generate(const juce::File &sample, const juce::File &target, std::int64_t size);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Corpus)
+};
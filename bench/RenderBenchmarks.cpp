@@ -0,0 +1,267 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   RenderBenchmarks.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "Benchmarks.h"
+#include "Corpus.h"
+
+#include "editor/CodeEditor.h"
+#include "editor/TextView.h"
+#include "editor/render/TextViewLayout.h"
+#include "editor/syntax/textmate/TextMateParser.h"
+#include "editor/syntax/textmate/TextMateThemeParser.h"
+
+#include <benchmark/benchmark.h>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    constexpr int Image_Width   = 1280;
+    constexpr int Image_Height  = 800;
+    constexpr int Visible_Lines = 60;
+    
+    //==================================================================================================================
+    /** The grammar and theme of the corpus, with a tokenizer that styles lines the same way the editor does. */
+    struct Highlighting
+    {
+        TextMateParser::ParseResult        grammar;
+        TextMateThemeParser::ParseResult   theme;
+        TextMateScopeStacks                stacks;
+        TextMateThemeMatcher               matcher { stacks };
+        std::unique_ptr<TextMateTokenizer> tokenizer;
+        
+        //==============================================================================================================
+        Highlighting(const juce::String &grammarJson, const juce::String &themeJson)
+            : grammar(TextMateParser::parse(grammarJson)),
+              theme  (TextMateThemeParser::parse(themeJson))
+        {
+            if (isValid())
+            {
+                stacks.addGrammar(grammar.second);
+                matcher.setTheme(theme.second);
+                matcher.precompute();
+                tokenizer = std::make_unique<TextMateTokenizer>(grammar.second, stacks);
+            }
+        }
+        
+        //==============================================================================================================
+        bool isValid() const noexcept
+        {
+            return grammar.first == TextMateParser::ParseStatus::Success
+                   && theme.first == TextMateThemeParser::ParseStatus::Success;
+        }
+    };
+    
+    //==================================================================================================================
+    /** Reads the lines of a document that fit on the screen, without loading all of it. */
+    juce::StringArray readVisibleLines(const juce::File &file)
+    {
+        juce::FileInputStream input(file);
+        juce::StringArray     lines;
+        
+        while (input.openedOk() && !input.isExhausted() && lines.size() < Visible_Lines)
+        {
+            lines.add(input.readNextLine());
+        }
+        
+        return lines;
+    }
+    
+    /** Tokenizes lines from the start of a document, with the styles the editor would give them. */
+    std::vector<TextView::Line> createLines(const juce::StringArray &text, TokenArena &arena,
+                                            Highlighting &highlighting)
+    {
+        std::vector<TextView::Line>           lines;
+        std::vector<TextMateTokenizer::Token> tokens;
+        TokenArena::Builder                   builder;
+        TextMateTokenizer::State              state = highlighting.tokenizer->getInitialState();
+        
+        for (const auto &line : text)
+        {
+            highlighting.tokenizer->tokenizeLine(line, state, tokens);
+            builder.clear();
+            
+            for (const auto &token : tokens)
+            {
+                builder.add(token.start, highlighting.matcher.getSchemeIndex(token.stack));
+            }
+            
+            lines.emplace_back(arena, arena.store(builder, {}), line);
+        }
+        
+        return lines;
+    }
+    
+    //==================================================================================================================
+    void benchmarkCreateLayout(benchmark::State &state, const Corpus::Entry &entry, const juce::String &grammarJson,
+                               const juce::String &themeJson)
+    {
+        Highlighting highlighting(grammarJson, themeJson);
+        
+        if (!highlighting.isValid())
+        {
+            state.SkipWithError("The grammar or theme of the corpus could not be parsed");
+            return;
+        }
+        
+        TextView   view;
+        TokenArena arena;
+        view.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 14.0f, juce::Font::plain));
+        
+        const std::vector<TextView::Line> lines = ::createLines(::readVisibleLines(entry.file), arena, highlighting);
+        TextViewLayout                    layout;
+        
+        for (auto _ : state)
+        {
+            for (const auto &line : lines)
+            {
+                layout.createLayout(view, line, static_cast<float>(Image_Width));
+            }
+        }
+        
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+    }
+    
+    void benchmarkDrawLayout(benchmark::State &state, const Corpus::Entry &entry, const juce::String &grammarJson,
+                             const juce::String &themeJson)
+    {
+        Highlighting highlighting(grammarJson, themeJson);
+        
+        if (!highlighting.isValid())
+        {
+            state.SkipWithError("The grammar or theme of the corpus could not be parsed");
+            return;
+        }
+        
+        TextView   view;
+        TokenArena arena;
+        view.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 14.0f, juce::Font::plain));
+        
+        const std::vector<TextView::Line> lines = ::createLines(::readVisibleLines(entry.file), arena, highlighting);
+        std::vector<std::unique_ptr<TextViewLayout>> layouts;
+        
+        for (const auto &line : lines)
+        {
+            layouts.emplace_back(std::make_unique<TextViewLayout>())
+                ->createLayout(view, line, static_cast<float>(Image_Width));
+        }
+        
+        const float line_height = view.getFont().getHeight() * view.getLineSpacing();
+        juce::Image image(juce::Image::ARGB, Image_Width, Image_Height, true);
+        
+        for (auto _ : state)
+        {
+            juce::Graphics g(image);
+            float          line_pos = 0.0f;
+            
+            for (const auto &layout : layouts)
+            {
+                layout->draw(g, { 0.0f, line_pos, static_cast<float>(Image_Width), line_height });
+                line_pos += line_height;
+            }
+        }
+        
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(layouts.size()));
+    }
+    
+    void benchmarkEditorPaint(benchmark::State &state, const Corpus::Entry &entry, const juce::String &grammarJson,
+                              const juce::String &themeJson)
+    {
+        // The editor keeps referring to the grammar, so this has to outlive it
+        const Highlighting highlighting(grammarJson, themeJson);
+        
+        if (!highlighting.isValid())
+        {
+            state.SkipWithError("The grammar or theme of the corpus could not be parsed");
+            return;
+        }
+        
+        juce::CodeDocument document;
+        document.replaceAllContent(entry.file.loadFileAsString());
+        
+        CodeEditor editor(document);
+        editor.setBounds(0, 0, Image_Width, Image_Height);
+        editor.setGrammar(highlighting.grammar.second);
+        editor.setTheme(highlighting.theme.second);
+        
+        // The editor lays out its lines when it is created, without them a paint would only time the background
+        const FoldIndex &fold_index = editor.getFoldIndex();
+        
+        if (fold_index.getNumLines() != document.getNumLines() || fold_index.getNumRows() == 0)
+        {
+            state.SkipWithError("The editor has no lines to paint");
+            return;
+        }
+        
+        juce::Image image(juce::Image::ARGB, Image_Width, Image_Height, true);
+        
+        for (auto _ : state)
+        {
+            juce::Graphics g(image);
+            editor.paintEntireComponent(g, false);
+        }
+        
+        const int visible_rows = static_cast<int>(std::ceil(Image_Height / fold_index.getDefaultHeight()));
+        state.SetItemsProcessed(state.iterations() * juce::jmin(fold_index.getNumRows(), visible_rows));
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Registration
+//======================================================================================================================
+void registerRenderBenchmarks(const Corpus &corpus)
+{
+    const juce::String grammar_json = corpus.getGrammarFile().loadFileAsString();
+    const juce::String theme_json   = corpus.getThemeFile()  .loadFileAsString();
+    
+    for (const auto &entry : corpus.getEntries())
+    {
+        const std::string name = entry.name.toStdString();
+        
+        // Laying out and drawing only ever touches the visible lines, so the smallest document of a sample will do
+        if (entry.size <= Corpus::Sizes.front() * 2)
+        {
+            benchmark::RegisterBenchmark(("TextViewLayout/createLayout/" + name).c_str(), ::benchmarkCreateLayout,
+                                         entry, grammar_json, theme_json)
+                ->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(("TextViewLayout/draw/" + name).c_str(), ::benchmarkDrawLayout, entry,
+                                         grammar_json, theme_json)
+                ->Unit(benchmark::kMicrosecond);
+        }
+        
+        // The editor tokenizes the whole document when it gets its grammar, which takes minutes for the bigger ones
+        if (entry.size <= Corpus::Sizes[2] * 2)
+        {
+            benchmark::RegisterBenchmark(("CodeEditor/paint/" + name).c_str(), ::benchmarkEditorPaint, entry,
+                                         grammar_json, theme_json)
+                ->Unit(benchmark::kMicrosecond);
+        }
+    }
+}
+//======================================================================================================================
+// endregion Registration
+//**********************************************************************************************************************
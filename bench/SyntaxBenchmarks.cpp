@@ -0,0 +1,204 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   SyntaxBenchmarks.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "Benchmarks.h"
+#include "Corpus.h"
+
+#include "editor/document/TextRope.h"
+#include "editor/search/TextSearch.h"
+#include "editor/syntax/XmlParser.h"
+#include "editor/syntax/textmate/TextMateGrammar.h"
+#include "editor/syntax/textmate/TextMateParser.h"
+#include "editor/syntax/textmate/TextMateScopeStacks.h"
+#include "editor/syntax/textmate/TextMateTheme.h"
+#include "editor/syntax/textmate/TextMateThemeMatcher.h"
+#include "editor/syntax/textmate/TextMateThemeParser.h"
+#include "editor/syntax/textmate/TextMateTokenizer.h"
+
+#include <benchmark/benchmark.h>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    void benchmarkGrammarParse(benchmark::State &state, const juce::String &json)
+    {
+        for (auto _ : state)
+        {
+            TextMateParser::ParseResult result = TextMateParser::parse(json);
+            benchmark::DoNotOptimize(result);
+        }
+        
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(json.getNumBytesAsUTF8()));
+    }
+    
+    void benchmarkThemeMatch(benchmark::State &state, const juce::String &grammarJson, const juce::String &themeJson)
+    {
+        const TextMateParser::ParseResult      grammar = TextMateParser::parse(grammarJson);
+        const TextMateThemeParser::ParseResult theme   = TextMateThemeParser::parse(themeJson);
+        
+        if (grammar.first != TextMateParser::ParseStatus::Success
+            || theme.first != TextMateThemeParser::ParseStatus::Success)
+        {
+            state.SkipWithError("The grammar or theme of the corpus could not be parsed");
+            return;
+        }
+        
+        TextMateScopeStacks stacks;
+        stacks.addGrammar(grammar.second);
+        
+        for (auto _ : state)
+        {
+            TextMateThemeMatcher matcher(stacks);
+            matcher.setTheme(theme.second);
+            matcher.precompute();
+            benchmark::DoNotOptimize(matcher.getScheme().data());
+        }
+        
+        state.counters["stacks"] = static_cast<double>(stacks.size());
+    }
+    
+    void benchmarkTokenize(benchmark::State &state, const Corpus::Entry &entry, const juce::String &grammarJson)
+    {
+        const TextMateParser::ParseResult grammar = TextMateParser::parse(grammarJson);
+        
+        if (grammar.first != TextMateParser::ParseStatus::Success)
+        {
+            state.SkipWithError("The grammar of the corpus could not be parsed");
+            return;
+        }
+        
+        TextMateScopeStacks stacks;
+        TextMateTokenizer   tokenizer(grammar.second, stacks);
+        
+        const juce::StringArray               lines = juce::StringArray::fromLines(entry.file.loadFileAsString());
+        std::vector<TextMateTokenizer::Token> tokens;
+        std::size_t                           num_tokens = 0;
+        
+        for (auto _ : state)
+        {
+            TextMateTokenizer::State line_state = tokenizer.getInitialState();
+            num_tokens = 0;
+            
+            for (const auto &line : lines)
+            {
+                tokenizer.tokenizeLine(line, line_state, tokens);
+                num_tokens += tokens.size();
+            }
+        }
+        
+        state.SetBytesProcessed(state.iterations() * entry.size);
+        state.counters["tokens"] = static_cast<double>(num_tokens);
+    }
+    
+    //==================================================================================================================
+    void benchmarkXmlParse(benchmark::State &state, const Corpus::Entry &entry)
+    {
+        const TextRope text(entry.file.loadFileAsString());
+        SyntaxTree     tree;
+        
+        for (auto _ : state)
+        {
+            XmlParser::parse(tree, text);
+            benchmark::ClobberMemory();
+        }
+        
+        state.SetBytesProcessed(state.iterations() * entry.size);
+        state.counters["memory"] = static_cast<double>(tree.getMemoryUsage());
+    }
+    
+    void benchmarkXmlReparse(benchmark::State &state, const Corpus::Entry &entry)
+    {
+        // Typing and deleting a character in the middle of the document, the most common edit there is
+        TextRope   text(entry.file.loadFileAsString());
+        SyntaxTree tree;
+        XmlParser::parse(tree, text);
+        
+        const int offset = text.getLength() / 2;
+        
+        for (auto _ : state)
+        {
+            text.insert(offset, "x");
+            XmlParser::reparse(tree, text, offset, 0, 1);
+            text.remove(offset, 1);
+            XmlParser::reparse(tree, text, offset, 1, 0);
+        }
+    }
+    
+    void benchmarkFindAll(benchmark::State &state, const Corpus::Entry &entry, SearchQuery query)
+    {
+        const TextRope text(entry.file.loadFileAsString());
+        std::size_t    num_matches = 0;
+        
+        for (auto _ : state)
+        {
+            num_matches = TextSearch::findAll(text, query).size();
+        }
+        
+        state.SetBytesProcessed(state.iterations() * entry.size);
+        state.counters["matches"] = static_cast<double>(num_matches);
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Registration
+//======================================================================================================================
+void registerSyntaxBenchmarks(const Corpus &corpus)
+{
+    const juce::String grammar_json = corpus.getGrammarFile().loadFileAsString();
+    const juce::String theme_json   = corpus.getThemeFile()  .loadFileAsString();
+    
+    benchmark::RegisterBenchmark("TextMateParser/parse", ::benchmarkGrammarParse, grammar_json);
+    benchmark::RegisterBenchmark("TextMateThemeMatcher/precompute", ::benchmarkThemeMatch, grammar_json, theme_json);
+    
+    for (const auto &entry : corpus.getEntries())
+    {
+        const std::string name = entry.name.toStdString();
+        
+        benchmark::RegisterBenchmark(("XmlParser/parse/" + name).c_str(), ::benchmarkXmlParse, entry)
+            ->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("XmlParser/reparse/" + name).c_str(), ::benchmarkXmlReparse, entry)
+            ->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark(("TextSearch/literal/" + name).c_str(), ::benchmarkFindAll, entry,
+                                     SearchQuery { "Binding", false, true, false })
+            ->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("TextSearch/regex/" + name).c_str(), ::benchmarkFindAll, entry,
+                                     SearchQuery { "id=\"bk1[0-9]+\"", true, true, false })
+            ->Unit(benchmark::kMillisecond);
+        
+        // The expressions run on std::regex, the bigger documents would take minutes for the same time per byte
+        if (entry.size <= Corpus::Sizes[2] * 2)
+        {
+            benchmark::RegisterBenchmark(("TextMateTokenizer/tokenize/" + name).c_str(), ::benchmarkTokenize, entry,
+                                         grammar_json)
+                ->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+//======================================================================================================================
+// endregion Registration
+//**********************************************************************************************************************
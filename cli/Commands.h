@@ -0,0 +1,47 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   Commands.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+    Highlights files to html or ansi text with TextMate grammars and a theme.
+    Options: --grammar=<file or folder> --theme=<file> [--format=html|ansi] [--output=<folder>] [--jobs=<n>]
+ */
+void runHighlight(const juce::ArgumentList &args);
+
+/**
+    Searches all files below a folder for a pattern and prints every match.
+    Options: [--regex] [--ignore-case] [--word] [--include=<globs>] [--exclude=<globs>] [--hidden] [--jobs=<n>]
+             [--index=<file>]
+ */
+void runSearch(const juce::ArgumentList &args);
+
+/**
+    Checks xml files for well-formedness and validity against xsd schemas and prints what was found.
+    Options: [--schemas=<folder>] [--cache=<folder>] [--jobs=<n>] [--quiet]
+ */
+void runValidate(const juce::ArgumentList &args);
@@ -0,0 +1,102 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FileBatch.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "FileBatch.h"
+
+//**********************************************************************************************************************
+// region FileBatch
+//======================================================================================================================
+FileBatch::FileBatch(const juce::ArgumentList &args, const juce::String &wildcard)
+    : numJobs(args.containsOption("--jobs") ? args.getValueForOption("--jobs").getIntValue()
+                                            : juce::SystemStats::getNumCpus())
+{
+    // The first argument is the command itself
+    for (int i = 1; i < args.size(); ++i)
+    {
+        const juce::ArgumentList::Argument argument = args[i];
+        
+        if (argument.isOption())
+        {
+            continue;
+        }
+        
+        const juce::File file = argument.resolveAsFile();
+        
+        if (file.isDirectory())
+        {
+            const std::size_t first = files.size();
+            
+            for (const auto &entry : juce::RangedDirectoryIterator(file, true, wildcard, juce::File::findFiles))
+            {
+                files.push_back(entry.getFile());
+            }
+            
+            // The order a folder is listed in depends on the file system, output should not
+            std::sort(files.begin() + static_cast<std::ptrdiff_t>(first), files.end());
+        }
+        else if (file.existsAsFile())
+        {
+            files.push_back(file);
+        }
+        else
+        {
+            juce::ConsoleApplication::fail("No such file or folder: " + argument.text);
+        }
+    }
+    
+    if (numJobs < 1)
+    {
+        juce::ConsoleApplication::fail("The number of jobs must be at least 1");
+    }
+}
+
+//======================================================================================================================
+juce::String FileBatch::getDisplayPath(const juce::File &file)
+{
+    const juce::File working_directory = juce::File::getCurrentWorkingDirectory();
+    return file.isAChildOf(working_directory) ? file.getRelativePathFrom(working_directory) : file.getFullPathName();
+}
+
+//======================================================================================================================
+int FileBatch::getNumThreads() const noexcept
+{
+    return juce::jmax(1, juce::jmin(numJobs, static_cast<int>(files.size())));
+}
+
+juce::String FileBatch::getSummary(const juce::String &verb) const
+{
+    const double elapsed     = juce::jmax(seconds, 1e-9);
+    const double megabytes   = static_cast<double>(numBytes) / (1024.0 * 1024.0);
+    const int    num_threads = getNumThreads();
+    
+    return verb + " " + juce::String(files.size()) + (files.size() == 1 ? " file" : " files")
+           + " (" + juce::File::descriptionOfSizeInBytes(numBytes) + ") in " + juce::String(seconds, 3) + " s"
+           + " on " + juce::String(num_threads) + (num_threads == 1 ? " thread: " : " threads: ")
+           + juce::String(static_cast<double>(files.size()) / elapsed, 1) + " files/s, "
+           + juce::String(megabytes / elapsed, 2) + " MB/s";
+}
+//======================================================================================================================
+// endregion FileBatch
+//**********************************************************************************************************************
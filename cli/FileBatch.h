@@ -0,0 +1,119 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FileBatch.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <thread>
+
+/**
+    The files a command was given on the command line, and the threads to work on them with.
+    Folders are searched recursively, the number of threads is taken from --jobs=<n> or is the number of cpus.
+ */
+class FileBatch
+{
+public:
+    /**
+        Collects the files named on the command line, this fails the command if one of them doesn't exist.
+        
+        @param args     The arguments of the command, anything that is not an option is a file or folder
+        @param wildcard The pattern of the files to pick up in folders, like "*.xml;*.xaml"
+     */
+    FileBatch(const juce::ArgumentList &args, const juce::String &wildcard);
+    
+    //==================================================================================================================
+    const std::vector<juce::File>& getFiles() const noexcept { return files; }
+    
+    /** Removes the files a predicate returns true for, before the batch is run. */
+    template<class Fn>
+    void removeFilesIf(Fn &&predicate)
+    {
+        files.erase(std::remove_if(files.begin(), files.end(), predicate), files.end());
+    }
+    
+    //==================================================================================================================
+    /**
+        Processes all files, spread across the threads of the batch.
+        Every thread makes its own context first, which it then hands to every file it processes.
+        
+        @param createContext Makes the context of a thread, returning something that can be dereferenced
+        @param process       Called as process(context, file, index) and returns the number of bytes it processed
+     */
+    template<class ContextFn, class Fn>
+    void run(ContextFn &&createContext, Fn &&process)
+    {
+        std::atomic<std::size_t>  next_file   { 0 };
+        std::atomic<std::int64_t> total_bytes { 0 };
+        
+        const auto work = [this, &next_file, &total_bytes, &createContext, &process]
+        {
+            auto context = createContext();
+            
+            for (std::size_t i = next_file++; i < files.size(); i = next_file++)
+            {
+                total_bytes += process(*context, files[i], i);
+            }
+        };
+        
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        
+        std::vector<std::thread> threads;
+        
+        for (int i = 1; i < getNumThreads(); ++i)
+        {
+            threads.emplace_back(work);
+        }
+        
+        work();
+        
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        
+        seconds  = (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+        numBytes = total_bytes;
+    }
+    
+    //==================================================================================================================
+    /** Gets the path to show for a file, relative to the working directory if the file is inside it. */
+    static juce::String getDisplayPath(const juce::File &file);
+    
+    //==================================================================================================================
+    /** Gets the number of threads the batch runs on, there are never more than files. */
+    int getNumThreads() const noexcept;
+    
+    /** Gets a line about how many files and bytes the last run got through and how fast it was. */
+    juce::String getSummary(const juce::String &verb) const;
+    
+private:
+    std::vector<juce::File> files;
+    std::int64_t            numBytes { 0 };
+    double                  seconds  { 0.0 };
+    int                     numJobs;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FileBatch)
+};
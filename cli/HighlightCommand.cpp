@@ -0,0 +1,178 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   HighlightCommand.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "Commands.h"
+#include "FileBatch.h"
+#include "Highlighter.h"
+
+#include "editor/syntax/textmate/TextMateCache.h"
+#include "editor/syntax/textmate/TextMateTheme.h"
+#include "editor/syntax/textmate/TextMateThemeParser.h"
+
+#include <iostream>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    int loadGrammars(TextMateCache &cache, const juce::File &location)
+    {
+        const juce::Array<juce::File> grammar_files = location.isDirectory()
+                                                          ? location.findChildFiles(juce::File::findFiles, false,
+                                                                                    "*.json")
+                                                          : juce::Array<juce::File> { location };
+        int num_loaded = 0;
+        
+        for (const auto &file : grammar_files)
+        {
+            if (cache.fromFile(file))
+            {
+                ++num_loaded;
+            }
+            else
+            {
+                std::cerr << "Could not read the grammar " << FileBatch::getDisplayPath(file) << std::endl;
+            }
+        }
+        
+        return num_loaded;
+    }
+    
+    TextMateTheme loadTheme(const juce::File &file)
+    {
+        TextMateThemeParser::ParseResult result = TextMateThemeParser::parse(file.loadFileAsString());
+        
+        if (result.first != TextMateThemeParser::ParseStatus::Success)
+        {
+            juce::ConsoleApplication::fail("Could not read the theme " + FileBatch::getDisplayPath(file));
+        }
+        
+        return std::move(result.second);
+    }
+    
+    //==================================================================================================================
+    juce::File getOutputFile(const juce::File &folder, const juce::File &input, const juce::String &extension)
+    {
+        // Files keep the folders they were in below the working directory, so files with the same name don't clash
+        const juce::File working_directory = juce::File::getCurrentWorkingDirectory();
+        const juce::String relative_path   = input.isAChildOf(working_directory)
+                                                 ? input.getRelativePathFrom(working_directory)
+                                                 : input.getFileName();
+        return folder.getChildFile(relative_path + extension);
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Highlight
+//======================================================================================================================
+void runHighlight(const juce::ArgumentList &args)
+{
+    TextMateCache &cache = TextMateCache::getInstance();
+    
+    if (::loadGrammars(cache, args.getFileForOption("--grammar")) == 0)
+    {
+        juce::ConsoleApplication::fail("No grammar could be read");
+    }
+    
+    const TextMateTheme theme       = ::loadTheme(args.getExistingFileForOption("--theme"));
+    const juce::String  format_name = args.containsOption("--format") ? args.getValueForOption("--format") : "html";
+    
+    if (format_name != "html" && format_name != "ansi")
+    {
+        juce::ConsoleApplication::fail("Unknown format " + format_name.quoted() + ", it must be html or ansi");
+    }
+    
+    const Highlighter::Format format        = (format_name == "html" ? Highlighter::Format::Html
+                                                                     : Highlighter::Format::Ansi);
+    const bool                to_folder     = args.containsOption("--output");
+    const juce::File          output_folder = (to_folder ? args.getFileForOption("--output") : juce::File());
+    const juce::String        extension     = (format == Highlighter::Format::Html ? ".html" : ".ans");
+    
+    FileBatch batch(args, "*");
+    const std::size_t num_given = batch.getFiles().size();
+    
+    batch.removeFilesIf([&cache](const juce::File &file)
+    {
+        return cache.findForExtension(file.getFileExtension()) == nullptr;
+    });
+    
+    if (batch.getFiles().size() < num_given)
+    {
+        std::cerr << "Skipped " << (num_given - batch.getFiles().size()) << " files without a grammar" << std::endl;
+    }
+    
+    // Without an output folder the results are held back, so they can be written out in order
+    std::vector<juce::MemoryBlock> results(to_folder ? 0 : batch.getFiles().size());
+    std::atomic<int>               num_failed { 0 };
+    
+    batch.run([&theme, format]
+    {
+        return std::make_unique<Highlighter>(theme, format);
+    },
+    [&](Highlighter &highlighter, const juce::File &file, std::size_t index) -> std::int64_t
+    {
+        const juce::String    text     = file.loadFileAsString();
+        const TextMateGrammar &grammar = *cache.findForExtension(file.getFileExtension());
+        
+        if (!to_folder)
+        {
+            juce::MemoryOutputStream stream(results[index], false);
+            highlighter.highlight(grammar, file.getFileName(), text, stream);
+            return file.getSize();
+        }
+        
+        const juce::File output_file = ::getOutputFile(output_folder, file, extension);
+        (void) output_file.getParentDirectory().createDirectory();
+        
+        juce::FileOutputStream stream(output_file);
+        
+        if (!stream.openedOk() || !stream.setPosition(0) || !stream.truncate().wasOk())
+        {
+            ++num_failed;
+            return 0;
+        }
+        
+        highlighter.highlight(grammar, file.getFileName(), text, stream);
+        return file.getSize();
+    });
+    
+    for (const auto &result : results)
+    {
+        std::cout.write(static_cast<const char*>(result.getData()), static_cast<std::streamsize>(result.getSize()));
+    }
+    
+    std::cout.flush();
+    std::cerr << batch.getSummary("Highlighted") << std::endl;
+    
+    if (num_failed > 0)
+    {
+        juce::ConsoleApplication::fail("Could not write " + juce::String(num_failed.load()) + " files");
+    }
+}
+//======================================================================================================================
+// endregion Highlight
+//**********************************************************************************************************************
@@ -0,0 +1,170 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   Highlighter.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "Highlighter.h"
+
+#include "editor/syntax/textmate/TextMateTheme.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    juce::String escapeHtml(const juce::String &text)
+    {
+        return text.replace("&", "&amp;").replace("<", "&lt;").replace(">", "&gt;").replace("\"", "&quot;");
+    }
+    
+    juce::String getAnsiColour(juce::Colour colour)
+    {
+        return "38;2;" + juce::String(colour.getRed()) + ";" + juce::String(colour.getGreen()) + ";"
+               + juce::String(colour.getBlue());
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Highlighter
+//======================================================================================================================
+Highlighter::Highlighter(const TextMateTheme &theme, Format parFormat)
+    : defaultColour(theme.defaultForeground), format(parFormat)
+{
+    matcher.setTheme(theme);
+}
+
+//======================================================================================================================
+void Highlighter::highlight(const TextMateGrammar &grammar, const juce::String &title, const juce::String &text,
+                            juce::OutputStream &output)
+{
+    TextMateTokenizer        &tokenizer = getTokenizer(grammar);
+    TextMateTokenizer::State state      = tokenizer.getInitialState();
+    
+    if (format == Format::Html)
+    {
+        // Themes don't say which background they were made for, a light text is assumed to be meant for a dark one
+        const juce::String background = (defaultColour.getPerceivedBrightness() > 0.5f ? "1e1e1e" : "ffffff");
+        
+        output << "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n"
+               << "<title>" << ::escapeHtml(title) << "</title>\n</head>\n"
+               << "<body style=\"background:#" << background << "\">\n"
+               << "<pre style=\"color:#" << defaultColour.toDisplayString(false) << "\">";
+    }
+    
+    for (const auto &line : juce::StringArray::fromLines(text))
+    {
+        tokenizer.tokenizeLine(line, state, tokens);
+        
+        for (std::size_t i = 0; i < tokens.size(); ++i)
+        {
+            const int          end    = (i + 1 < tokens.size() ? tokens[i + 1].start : line.length());
+            const int          index  = matcher.getSchemeIndex(tokens[i].stack);
+            const SchemeEntry  &style = matcher.getScheme()[static_cast<std::size_t>(index)];
+            const juce::String token  = line.substring(tokens[i].start, end);
+            
+            if (format == Format::Html)
+            {
+                writeHtmlToken(output, style, token);
+            }
+            else
+            {
+                writeAnsiToken(output, style, token);
+            }
+        }
+        
+        output << (format == Format::Ansi ? "\x1b[0m\n" : "\n");
+    }
+    
+    if (format == Format::Html)
+    {
+        output << "</pre>\n</body>\n</html>\n";
+    }
+}
+
+//======================================================================================================================
+TextMateTokenizer& Highlighter::getTokenizer(const TextMateGrammar &grammar)
+{
+    std::unique_ptr<TextMateTokenizer> &tokenizer = tokenizers[&grammar];
+    
+    if (!tokenizer)
+    {
+        tokenizer = std::make_unique<TextMateTokenizer>(grammar, stacks);
+    }
+    
+    return *tokenizer;
+}
+
+//======================================================================================================================
+void Highlighter::writeHtmlToken(juce::OutputStream &output, const SchemeEntry &style, const juce::String &text) const
+{
+    if (style.colour == defaultColour && style.styleFlags == juce::Font::plain)
+    {
+        output << ::escapeHtml(text);
+        return;
+    }
+    
+    output << "<span style=\"color:#" << style.colour.toDisplayString(false);
+    
+    if ((style.styleFlags & juce::Font::bold) != 0)
+    {
+        output << ";font-weight:bold";
+    }
+    
+    if ((style.styleFlags & juce::Font::italic) != 0)
+    {
+        output << ";font-style:italic";
+    }
+    
+    if ((style.styleFlags & juce::Font::underlined) != 0)
+    {
+        output << ";text-decoration:underline";
+    }
+    
+    output << "\">" << ::escapeHtml(text) << "</span>";
+}
+
+void Highlighter::writeAnsiToken(juce::OutputStream &output, const SchemeEntry &style, const juce::String &text) const
+{
+    output << "\x1b[0;" << ::getAnsiColour(style.colour);
+    
+    if ((style.styleFlags & juce::Font::bold) != 0)
+    {
+        output << ";1";
+    }
+    
+    if ((style.styleFlags & juce::Font::italic) != 0)
+    {
+        output << ";3";
+    }
+    
+    if ((style.styleFlags & juce::Font::underlined) != 0)
+    {
+        output << ";4";
+    }
+    
+    output << "m" << text;
+}
+//======================================================================================================================
+// endregion Highlighter
+//**********************************************************************************************************************
@@ -0,0 +1,78 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   Highlighter.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "editor/syntax/textmate/TextMateScopeStacks.h"
+#include "editor/syntax/textmate/TextMateThemeMatcher.h"
+#include "editor/syntax/textmate/TextMateTokenizer.h"
+
+struct TextMateTheme;
+
+/**
+    Turns texts into coloured html or ansi text with TextMate grammars and a theme.
+    A highlighter keeps its own scope stacks and tokenizers, so every thread of a batch needs one of its own.
+ */
+class Highlighter
+{
+public:
+    enum class Format
+    {
+        Html,
+        Ansi
+    };
+    
+    //==================================================================================================================
+    Highlighter(const TextMateTheme &theme, Format format);
+    
+    //==================================================================================================================
+    /**
+        Highlights a text and writes the result to a stream.
+        
+        @param grammar The grammar to tokenize the text with
+        @param title   The title of the html document, this is not used for ansi
+        @param text    The text to highlight
+        @param output  The stream to write to
+     */
+    void highlight(const TextMateGrammar &grammar, const juce::String &title, const juce::String &text,
+                   juce::OutputStream &output);
+                   
+private:
+    TextMateScopeStacks                                                            stacks;
+    TextMateThemeMatcher                                                           matcher { stacks };
+    std::unordered_map<const TextMateGrammar*, std::unique_ptr<TextMateTokenizer>> tokenizers;
+    std::vector<TextMateTokenizer::Token>                                          tokens;
+    
+    juce::Colour defaultColour;
+    Format       format;
+    
+    //==================================================================================================================
+    TextMateTokenizer& getTokenizer(const TextMateGrammar &grammar);
+    
+    void writeHtmlToken(juce::OutputStream &output, const SchemeEntry &style, const juce::String &text) const;
+    void writeAnsiToken(juce::OutputStream &output, const SchemeEntry &style, const juce::String &text) const;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Highlighter)
+};
@@ -0,0 +1,65 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   Main.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "Commands.h"
+
+int main(int argc, char *argv[])
+{
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Usage: jamal-cli <command> [options] <files or folders...>", true);
+    app.addVersionCommand("--version|-v", "jamal-cli " JAMAL_CLI_VERSION);
+    
+    app.addCommand({
+        "highlight",
+        "highlight --grammar=<file|folder> --theme=<file> [--format=html|ansi] [--output=<folder>] [--jobs=<n>]",
+        "Highlights files to html or ansi text.",
+        "Tokenizes files with the TextMate grammar for their extension and colours them with a theme.\n"
+        "Without --output, the results are written to the standard output in the order the files were given.",
+        runHighlight
+    });
+    
+    app.addCommand({
+        "search",
+        "search <pattern> [<folder>] [--regex] [--ignore-case] [--word] [--include=<globs>] [--exclude=<globs>] "
+        "[--hidden] [--jobs=<n>] [--index=<file>]",
+        "Searches all files below a folder for a pattern.",
+        "Prints path:line:column and the line of every match as it is found, followed by the number of matches.\n"
+        "Globs are separated by semicolons, like \"*.xml;*.xaml\". Exits with 1 if nothing was found.\n"
+        "With --index, a trigram index of the folder is kept in the given file and brought up to date before every "
+        "search; literal patterns only look at the files it says can contain them.",
+        runSearch
+    });
+    
+    app.addCommand({
+        "validate",
+        "validate [--schemas=<folder>] [--cache=<folder>] [--jobs=<n>] [--quiet]",
+        "Checks xml files for well-formedness and against xsd schemas.",
+        "Validates all files on as many threads as there are cpus and prints their diagnostics, followed by\n"
+        "a summary of the throughput. Exits with 1 if there was any error.",
+        runValidate
+    });
+    
+    return app.findAndRunCommand(argc, argv);
+}
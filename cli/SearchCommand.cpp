@@ -0,0 +1,182 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   SearchCommand.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "Commands.h"
+#include "FileBatch.h"
+
+#include "editor/search/TrigramIndex.h"
+
+#include <iostream>
+#include <set>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    /** How long the message loop runs before it is checked whether the search finished. */
+    constexpr int Dispatch_Interval_Ms = 20;
+    
+    //==================================================================================================================
+    juce::StringArray getGlobsForOption(const juce::ArgumentList &args, const juce::String &option)
+    {
+        return args.containsOption(option) ? juce::StringArray::fromTokens(args.getValueForOption(option), ";", "")
+                                           : juce::StringArray();
+    }
+    
+    /** Gets the arguments that are no options, after the command itself. */
+    juce::StringArray getPositionalArguments(const juce::ArgumentList &args)
+    {
+        juce::StringArray positional;
+        
+        for (int i = 1; i < args.size(); ++i)
+        {
+            if (!args[i].isOption())
+            {
+                positional.add(args[i].text);
+            }
+        }
+        
+        return positional;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Search
+//======================================================================================================================
+void runSearch(const juce::ArgumentList &args)
+{
+    const juce::StringArray positional = ::getPositionalArguments(args);
+    
+    if (positional.isEmpty() || positional.size() > 2)
+    {
+        juce::ConsoleApplication::fail("Expected a pattern and at most one folder to search");
+    }
+    
+    const juce::File root = (positional.size() > 1 ? juce::File::getCurrentWorkingDirectory()
+                                                         .getChildFile(positional[1])
+                                                   : juce::File::getCurrentWorkingDirectory());
+    
+    if (!root.isDirectory())
+    {
+        juce::ConsoleApplication::fail("No such folder: " + positional[1]);
+    }
+    
+    const int num_jobs = (args.containsOption("--jobs") ? args.getValueForOption("--jobs").getIntValue()
+                                                        : juce::SystemStats::getNumCpus());
+    
+    if (num_jobs < 1)
+    {
+        juce::ConsoleApplication::fail("The number of jobs must be at least 1");
+    }
+    
+    SearchQuery query;
+    query.pattern   = positional[0];
+    query.isRegex   = args.containsOption("--regex");
+    query.matchCase = !args.containsOption("--ignore-case");
+    query.wholeWord = args.containsOption("--word");
+    
+    FileSearch::Options options;
+    options.ignoreGlobs.addArray(::getGlobsForOption(args, "--exclude"));
+    options.fileGlobs         = ::getGlobsForOption(args, "--include");
+    options.searchHiddenFiles = args.containsOption("--hidden");
+    
+    std::unique_ptr<TrigramIndex> index;
+    
+    if (args.containsOption("--index"))
+    {
+        const juce::File index_file = args.getFileForOption("--index");
+        index = std::make_unique<TrigramIndex>(root, options);
+        
+        // An index that is missing or belongs to another folder is built from scratch, otherwise only the files
+        // that changed since it was saved are read again
+        (void) index->load(index_file);
+        
+        if (index->update() > 0 && !index->save(index_file))
+        {
+            juce::ConsoleApplication::fail("Could not write the index to " + index_file.getFullPathName());
+        }
+        
+        options.index = index.get();
+    }
+    
+    // Results are delivered on the message thread, which this one becomes for as long as the search runs
+    juce::MessageManager *const message_manager = juce::MessageManager::getInstance();
+    
+    const double start       = juce::Time::getMillisecondCounterHiRes();
+    int          num_matches = 0;
+    bool         started     = false;
+    
+    {
+        std::set<juce::File> matched_files;
+        bool                 finished = false;
+        FileSearch           search(num_jobs);
+        
+        started = search.start(root, query, options, [&](std::vector<FileSearch::Match> matches, bool isFinished)
+        {
+            for (const auto &match : matches)
+            {
+                std::cout << FileBatch::getDisplayPath(match.file) << ":" << (match.line + 1) << ":"
+                          << (match.columns.getStart() + 1) << ": " << match.lineText.trim() << "\n";
+                matched_files.insert(match.file);
+            }
+            
+            num_matches += static_cast<int>(matches.size());
+            finished     = isFinished;
+        });
+        
+        while (started && !finished)
+        {
+            (void) message_manager->runDispatchLoopUntil(Dispatch_Interval_Ms);
+        }
+        
+        if (started)
+        {
+            const double seconds = (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+            
+            std::cout << num_matches << (num_matches == 1 ? " match in " : " matches in ")
+                      << matched_files.size() << (matched_files.size() == 1 ? " file" : " files")
+                      << ", searched in " << juce::String(seconds, 3) << " s on " << num_jobs
+                      << (num_jobs == 1 ? " thread" : " threads") << std::endl;
+        }
+    }
+    
+    juce::MessageManager::deleteInstance();
+    
+    if (!started)
+    {
+        juce::ConsoleApplication::fail("The pattern " + query.pattern.quoted() + " is not a valid expression");
+    }
+    
+    // Like grep, finding nothing is reported through the exit code
+    if (num_matches == 0)
+    {
+        juce::ConsoleApplication::fail({}, 1);
+    }
+}
+//======================================================================================================================
+// endregion Search
+//**********************************************************************************************************************
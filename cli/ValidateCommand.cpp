@@ -0,0 +1,176 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   ValidateCommand.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "Commands.h"
+#include "FileBatch.h"
+
+#include "editor/analyser/SchemaGrammarPool.h"
+#include "editor/analyser/XmlValidator.h"
+
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include <iostream>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    /** Keeps xerces initialised for as long as it exists. */
+    class XercesInitialiser
+    {
+    public:
+        XercesInitialiser()
+        {
+            try
+            {
+                xercesc::XMLPlatformUtils::Initialize();
+            }
+            catch (const xercesc::XMLException&)
+            {
+                juce::ConsoleApplication::fail("Could not initialise the xml parser");
+            }
+        }
+        
+        ~XercesInitialiser()
+        {
+            xercesc::XMLPlatformUtils::Terminate();
+        }
+    };
+    
+    //==================================================================================================================
+    const char* getSeverityName(XmlDiagnostic::Severity severity) noexcept
+    {
+        switch (severity)
+        {
+            case XmlDiagnostic::Severity::Warning: return "warning";
+            case XmlDiagnostic::Severity::Error:   return "error";
+            case XmlDiagnostic::Severity::Fatal:   return "fatal error";
+        }
+        
+        return "error";
+    }
+    
+    void loadSchemas(SchemaGrammarPool &pool, const juce::File &folder)
+    {
+        const int status = pool.load(folder.findChildFiles(juce::File::findFiles, true, "*.xsd"));
+        
+        if (status == SchemaGrammarPool::LoadStatus::NoSchemas)
+        {
+            juce::ConsoleApplication::fail("There are no schemas in " + FileBatch::getDisplayPath(folder));
+        }
+        
+        if (status == SchemaGrammarPool::LoadStatus::CompilationFailed)
+        {
+            juce::ConsoleApplication::fail("Could not compile the schemas in " + FileBatch::getDisplayPath(folder)
+                                           + ": " + pool.getLoadError());
+        }
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Validate
+//======================================================================================================================
+void runValidate(const juce::ArgumentList &args)
+{
+    FileBatch batch(args, "*.xml;*.xaml");
+    
+    if (batch.getFiles().empty())
+    {
+        juce::ConsoleApplication::fail("There are no files to validate");
+    }
+    
+    // Xerces has to outlive everything that uses it
+    const XercesInitialiser xerces;
+    
+    const juce::File cache_folder = args.containsOption("--cache")
+                                        ? args.getFileForOption("--cache")
+                                        : juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                              .getChildFile("jamal-cli-schemas");
+    (void) cache_folder.createDirectory();
+    
+    SchemaGrammarPool grammar_pool(cache_folder);
+    
+    if (args.containsOption("--schemas"))
+    {
+        ::loadSchemas(grammar_pool, args.getExistingFolderForOption("--schemas"));
+    }
+    
+    // The pool is locked once it was loaded, so all threads can look schemas up in it at the same time
+    const SchemaGrammarPool *const shared_pool = (grammar_pool.isLoaded() ? &grammar_pool : nullptr);
+    
+    std::vector<std::vector<XmlDiagnostic>> diagnostics(batch.getFiles().size());
+    
+    batch.run([shared_pool]
+    {
+        return std::make_unique<XmlValidator>(shared_pool);
+    },
+    [&diagnostics](XmlValidator &validator, const juce::File &file, std::size_t index) -> std::int64_t
+    {
+        validator.validate(TextRope(file.loadFileAsString()), file.getFullPathName(), diagnostics[index]);
+        return file.getSize();
+    });
+    
+    const bool quiet        = args.containsOption("--quiet");
+    int        num_errors   = 0;
+    int        num_warnings = 0;
+    int        num_failed   = 0;
+    
+    for (std::size_t i = 0; i < diagnostics.size(); ++i)
+    {
+        const juce::String path       = FileBatch::getDisplayPath(batch.getFiles()[i]);
+        bool               has_errors = false;
+        
+        for (const auto &diagnostic : diagnostics[i])
+        {
+            const bool is_warning = (diagnostic.severity == XmlDiagnostic::Severity::Warning);
+            
+            ++(is_warning ? num_warnings : num_errors);
+            has_errors |= !is_warning;
+            
+            if (!quiet)
+            {
+                std::cout << path << ":" << diagnostic.line << ":" << diagnostic.column << ": "
+                          << ::getSeverityName(diagnostic.severity) << ": " << diagnostic.message << "\n";
+            }
+        }
+        
+        num_failed += (has_errors ? 1 : 0);
+    }
+    
+    std::cout << batch.getSummary("Validated") << "\n"
+              << num_errors << (num_errors == 1 ? " error, " : " errors, ")
+              << num_warnings << (num_warnings == 1 ? " warning" : " warnings")
+              << ", " << num_failed << " of " << batch.getFiles().size() << " files failed" << std::endl;
+    
+    if (num_errors > 0)
+    {
+        juce::ConsoleApplication::fail({}, 1);
+    }
+}
+//======================================================================================================================
+// endregion Validate
+//**********************************************************************************************************************
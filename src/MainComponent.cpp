@@ -25,18 +25,71 @@
 
 #include "MainComponent.h"
 
+#include "editor/analyser/message/MessageChangeDocument.h"
+#include "editor/analyser/message/MessageOpenDocument.h"
+
+//**********************************************************************************************************************
+// region Namespace
 //======================================================================================================================
-// region MainComponent
+namespace
+{
+    juce::File getApplicationDataDirectory()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                   .getChildFile(JUCE_APPLICATION_NAME_STRING);
+    }
+}
+//======================================================================================================================
+// endregion Namespace
 //**********************************************************************************************************************
+// region MainComponent
+//======================================================================================================================
 MainComponent::MainComponent()
-    : editor(document)
+    : editor(document),
+      analyser(::getApplicationDataDirectory().getChildFile("schemas"),
+               ::getApplicationDataDirectory().getChildFile("cache")),
+      documentId("/home/elanda/Desktop/test.xml")
 {
-    document.insertText(0, juce::File("/home/elanda/Desktop/test.xml").loadFileAsString());
+    const juce::File document_file(documentId);
+    const juce::File journal_directory = ::getApplicationDataDirectory().getChildFile("journal");
+    
+    // Unsaved edits that survived a crash win over the file, they stay in the journal until the next save
+    TextRope recovered_text;
+    
+    if (DocumentJournal::recover(journal_directory, document_file, recovered_text))
+    {
+        document.insertText(0, recovered_text.toString());
+        savedRevision = -1;
+    }
+    else
+    {
+        document.insertText(0, document_file.loadFileAsString());
+    }
+    
+    editor.clearUndoHistory();
+    journal = std::make_unique<DocumentJournal>(journal_directory, document_file,
+                                                TextRope(document.getAllContent()));
+    journal->addListener(this);
+    
+    fileWatcher.addFile(document_file);
+    fileWatcher.addListener(this);
+    
+    document.addListener(this);
+    analyser.addListener(this);
+    analyser.postMessage(std::make_unique<MessageOpenDocument>(documentId, document.getAllContent()));
     
     setSize(900, 600);
     addAndMakeVisible(editor);
 }
 
+MainComponent::~MainComponent()
+{
+    fileWatcher.removeListener(this);
+    journal->removeListener(this);
+    analyser.removeListener(this);
+    document.removeListener(this);
+}
+
 //======================================================================================================================
 void MainComponent::paint(juce::Graphics &g)
 {
@@ -47,6 +100,138 @@ void MainComponent::resized()
 {
     editor.setBounds(getLocalBounds());
 }
+
+bool MainComponent::keyPressed(const juce::KeyPress &key)
+{
+    if (key == juce::KeyPress('s', juce::ModifierKeys::commandModifier, 0))
+    {
+        pendingSaveRevisions.push_back(documentRevision);
+        journal->save();
+        return true;
+    }
+    
+    return false;
+}
+
+//======================================================================================================================
+void MainComponent::codeDocumentTextInserted(const juce::String &newText, int insertIndex)
+{
+    analyser.postMessage(std::make_unique<MessageChangeDocument>(documentId, ++documentRevision, insertIndex, 0,
+                                                                 newText));
+    journal->recordEdit(insertIndex, 0, newText);
+}
+
+void MainComponent::codeDocumentTextDeleted(int startIndex, int endIndex)
+{
+    analyser.postMessage(std::make_unique<MessageChangeDocument>(documentId, ++documentRevision, startIndex,
+                                                                 endIndex - startIndex, juce::String()));
+    journal->recordEdit(startIndex, endIndex - startIndex, {});
+}
+
+//======================================================================================================================
+void MainComponent::diagnosticsChanged(const DiagnosticBatch &batch)
+{
+    // The analyser dropped an edit somewhere and ignores the ones after it, only the whole text gets it back on track
+    if (batch.documentId == documentId && batch.needsResync)
+    {
+        analyser.postMessage(std::make_unique<MessageOpenDocument>(documentId, document.getAllContent(),
+                                                                   documentRevision));
+        return;
+    }
+    
+    // Anything older than the text we have now would be put at the wrong places, the batch for the newest
+    // revision is on its way and the squiggles we have follow the edits until then
+    if (batch.documentId == documentId && batch.revision == documentRevision)
+    {
+        editor.setDiagnostics(batch.diagnostics);
+    }
+}
+
+void MainComponent::documentSaved(const juce::File &file, bool succeeded)
+{
+    // Saves finish in the order they were started, each one wrote the text as it was at its revision
+    const int revision = pendingSaveRevisions.empty() ? savedRevision : pendingSaveRevisions.front();
+    
+    if (!pendingSaveRevisions.empty())
+    {
+        pendingSaveRevisions.pop_front();
+    }
+    
+    if (succeeded)
+    {
+        savedRevision = revision;
+        savedFileTime = file.getLastModificationTime();
+        savedFileSize = file.getSize();
+    }
+    else
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Saving failed",
+                                               "The document could not be written to " + file.getFullPathName()
+                                               + ", the unsaved edits are kept in the journal.");
+    }
+}
+
+void MainComponent::fileChanged(const juce::File &file)
+{
+    // A save of ours may be older than the document by now, merging it would throw away what was typed since
+    if (file != juce::File(documentId)
+        || (file.getLastModificationTime() == savedFileTime && file.getSize() == savedFileSize))
+    {
+        return;
+    }
+    
+    if (!hasUnsavedChanges())
+    {
+        reloadFromDisk(file);
+        return;
+    }
+    
+    // Merging would silently replace what was typed since the last save, so the user decides; further changes
+    // while the question is open are picked up by the answer, as it loads the file then
+    if (askingToReload)
+    {
+        return;
+    }
+    
+    askingToReload = true;
+    
+    juce::Component::SafePointer<MainComponent> safe_this(this);
+    (void) juce::AlertWindow::showOkCancelBox(juce::MessageBoxIconType::QuestionIcon, "File changed on disk",
+                                              file.getFullPathName() + " was changed by another program, reloading "
+                                              "it discards the edits that have not been saved yet.",
+                                              "Reload", "Keep my edits", this,
+                                              juce::ModalCallbackFunction::create([safe_this, file](int result)
+    {
+        if (safe_this == nullptr)
+        {
+            return;
+        }
+        
+        safe_this->askingToReload = false;
+        
+        if (result != 0)
+        {
+            safe_this->reloadFromDisk(file);
+        }
+    }));
+}
+
+//======================================================================================================================
+bool MainComponent::hasUnsavedChanges() const noexcept
+{
+    return documentRevision != savedRevision || !pendingSaveRevisions.empty();
+}
+
+void MainComponent::reloadFromDisk(const juce::File &file)
+{
+    editor.mergeExternalText(file.loadFileAsString());
+    
+    // The text is the file's now, as long as no save of ours is still about to overwrite it
+    if (pendingSaveRevisions.empty())
+    {
+        savedRevision = documentRevision;
+    }
+}
 //**********************************************************************************************************************
 // endregion MainComponent
 //======================================================================================================================
@@ -26,24 +26,60 @@
 #pragma once
 
 #include "editor/CodeEditor.h"
+#include "editor/analyser/XmlAnalyser.h"
+#include "editor/document/DocumentJournal.h"
+#include "editor/document/FileWatcher.h"
 
 #include <juce_gui_extra/juce_gui_extra.h>
 #include <jaut_core/jaut_core.h>
 
+#include <deque>
+
 
 //======================================================================================================================
-class MainComponent : public juce::Component
+class MainComponent : public juce::Component, private juce::CodeDocument::Listener, private XmlAnalyser::Listener,
+                      private DocumentJournal::Listener, private FileWatcher::Listener
 {
 public:
     MainComponent();
+    ~MainComponent() override;
     
     //==================================================================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
+    bool keyPressed(const juce::KeyPress &key) override;
     
 private:
     juce::CodeDocument document;
     CodeEditor         editor;
+    XmlAnalyser        analyser;
+    juce::String       documentId;
+    int                documentRevision { 0 };
+    
+    std::unique_ptr<DocumentJournal> journal;
+    FileWatcher                      fileWatcher;
+    
+    // The watcher sees our own saves too, they are recognised by the time and size the file had after them
+    juce::Time  savedFileTime;
+    juce::int64 savedFileSize { -1 };
+    
+    // The revision the file on disk has, and those of the saves still being written in the order they were started
+    int             savedRevision { 0 };
+    std::deque<int> pendingSaveRevisions;
+    bool            askingToReload { false };
+    
+    //==================================================================================================================
+    void codeDocumentTextInserted(const juce::String &newText, int insertIndex) override;
+    void codeDocumentTextDeleted(int startIndex, int endIndex) override;
+    
+    //==================================================================================================================
+    void diagnosticsChanged(const DiagnosticBatch &batch) override;
+    void documentSaved(const juce::File &file, bool succeeded) override;
+    void fileChanged(const juce::File &file) override;
+    
+    //==================================================================================================================
+    bool hasUnsavedChanges() const noexcept;
+    void reloadFromDisk(const juce::File &file);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 };
@@ -25,8 +25,12 @@
 
 #include "CodeEditor.h"
 
+#include "document/CodeDocumentTextSource.h"
+#include "document/LineDiff.h"
+#include "syntax/XmlParser.h"
 #include "syntax/textmate/TextMateCache.h"
 #include "syntax/textmate/TextMateGrammar.h"
+#include "syntax/textmate/TextMateTheme.h"
 #include "small_vector/small_vector.h"
 
 //**********************************************************************************************************************
@@ -34,11 +38,6 @@
 //======================================================================================================================
 namespace
 {
-    int getMaxPossibleLines(const juce::Rectangle<int> &bounds, float lineHeight, double scrollOffset)
-    {
-        return static_cast<int>(std::ceil(static_cast<double>(bounds.getHeight()) / lineHeight  + scrollOffset));
-    }
-    
     juce::Rectangle<float> getLineBounds(const juce::Rectangle<int> &editorBounds, float charPos, float linePos,
                                          float lineHeight) noexcept
     {
@@ -49,6 +48,12 @@ namespace
             lineHeight
         };
     }
+    
+    bool isNameCharacter(juce::juce_wchar character) noexcept
+    {
+        return juce::CharacterFunctions::isLetterOrDigit(character)
+               || character == ':' || character == '-' || character == '_' || character == '.';
+    }
 }
 //======================================================================================================================
 // endregion Namespace
@@ -59,13 +64,60 @@ namespace
 //**********************************************************************************************************************
 // region Line
 //======================================================================================================================
-void CodeEditor::Line::drawLine(const CodeEditor &editor, juce::Rectangle<float> bounds, int startPos) const
+void CodeEditor::Line::drawLine(juce::Graphics &g, const CodeEditor &editor, juce::Rectangle<float> bounds,
+                                int startPos) const
 {
-    juce::AttributedString text_brush;
+    const std::vector<SchemeEntry> &scheme = editor.themeMatcher.getScheme();
+    const juce::String             text    = lineText.trimCharactersAtEnd("\r\n");
     
-    for (const auto &token : tokens)
+    // The font is monospaced, so every token can be drawn on its own right where its first character goes
+    const auto draw_token = [&](int start, int end, int style)
     {
+        start = juce::jmax(start, startPos);
+        
+        const float x = bounds.getX() + static_cast<float>(start - startPos) * editor.charWidth;
+        
+        if (start >= end || x >= bounds.getRight())
+        {
+            return;
+        }
+        
+        if (juce::isPositiveAndBelow(style, static_cast<int>(scheme.size())))
+        {
+            const SchemeEntry &entry = scheme[static_cast<std::size_t>(style)];
+            g.setColour(entry.colour);
+            g.setFont(editor.font.withStyle(entry.styleFlags));
+        }
+        else
+        {
+            g.setColour(editor.findColour(ColourId::Text));
+            g.setFont(editor.font);
+        }
         
+        g.drawText(text.substring(start, end),
+                   { x, bounds.getY(), static_cast<float>(end - start) * editor.charWidth, bounds.getHeight() },
+                   juce::Justification::centredLeft, false);
+    };
+    
+    // Text before the first token, or all of it if the line wasn't tokenized yet, goes in the text colour
+    TokenArena::Token previous { 0, -1 };
+    
+    editor.tokenArena.forEachToken(tokens, [&draw_token, &previous](TokenArena::Token token)
+    {
+        draw_token(previous.start, token.start, previous.style);
+        previous = token;
+    });
+    
+    draw_token(previous.start, text.length(), previous.style);
+}
+
+void CodeEditor::Line::drawDescription(juce::Graphics &g, const CodeEditor &editor, juce::Rectangle<float> bounds,
+                                       int startPos) const
+{
+    for (const auto &token : descriptionTokens)
+    {
+        const float token_pos = static_cast<float>(token.startPos - startPos) * editor.charWidth;
+        g.drawText(token.text, bounds.withTrimmedLeft(juce::jmax(0.0f, token_pos)), juce::Justification::centredLeft);
     }
 }
 
@@ -75,44 +127,389 @@ bool CodeEditor::Line::isExtendedLine() const noexcept
     return !descriptionTokens.empty();
 }
 
+void CodeEditor::Line::setDescriptionTokens(std::vector<DescriptionToken> newTokens) noexcept
+{
+    descriptionTokens = std::move(newTokens);
+}
+
 //======================================================================================================================
+CodeEditor::Line::FoldRegion&       CodeEditor::Line::getFoldRegion()       noexcept { return foldRegion; }
 const CodeEditor::Line::FoldRegion& CodeEditor::Line::getFoldRegion() const noexcept { return foldRegion; }
 const juce::String&                 CodeEditor::Line::getLineText()   const noexcept { return lineText;   }
 
+void CodeEditor::Line::setLineText(juce::String newText) noexcept
+{
+    lineText = std::move(newText);
+}
+
+void CodeEditor::Line::setEndState(TextMateTokenizer::State newState) noexcept
+{
+    endState = std::move(newState);
+}
+
 //======================================================================================================================
 // endregion Line
 //**********************************************************************************************************************
+// region Gutter
+//======================================================================================================================
+CodeEditor::Gutter::Gutter(CodeEditor &parEditor)
+    : editor(parEditor)
+{}
+
+//======================================================================================================================
+void CodeEditor::Gutter::paint(juce::Graphics &g)
+{
+    g.fillAll(editor.findColour(ColourId::GutterBackground));
+    
+    // Only the lines inside the clip are looked at, an edit repaints no more than the rows it changed
+    const FoldIndex            &fold_index = editor.foldIndex;
+    const juce::Rectangle<int> clip        = g.getClipBounds();
+    const double               content_y   = getContentY();
+    const int                  num_lines   = editor.document->getNumLines();
+    const int                  first_line  = fold_index.getLineAtY(clip.getY() - content_y);
+    const int                  last_line   = juce::jmin(fold_index.getLineAtY(clip.getBottom() - content_y),
+                                                        num_lines - 1);
+    
+    if (first_line > last_line)
+    {
+        return;
+    }
+    
+    collectIcons(first_line, last_line);
+    const std::vector<FoldProvider::Region> regions = editor.foldProvider.getRegions({ first_line, last_line + 1 });
+    
+    const juce::Font   &font           = digits.getFont();
+    const float        line_height     = static_cast<float>(fold_index.getDefaultHeight());
+    const float        baseline_offset = (line_height - font.getHeight()) / 2.0f + font.getAscent();
+    const float        numbers_right   = static_cast<float>(getWidth() - Marker_Width - Padding);
+    const juce::Colour number_colour   = editor.findColour(ColourId::LineNumber);
+    
+    auto  next_region = regions.begin();
+    float line_pos    = static_cast<float>(content_y + fold_index.getYForLine(first_line));
+    
+    for (int row = fold_index.getRowForLine(first_line); row < fold_index.getNumRows(); ++row)
+    {
+        const int line = fold_index.getLineForRow(row);
+        
+        if (line > last_line)
+        {
+            break;
+        }
+        
+        // The number goes beside the text, which is below the description of an extended line
+        const auto  index    = static_cast<std::size_t>(line);
+        const bool  extended = index < editor.lines.size() && editor.lines[index].isExtendedLine();
+        const float text_pos = line_pos + (extended ? line_height : 0.0f);
+        const juce::Rectangle<float> text_row(0.0f, text_pos, static_cast<float>(getWidth()), line_height);
+        
+        const Icon icon = lineIcons[static_cast<std::size_t>(line - first_line)];
+        
+        if (icon != Icon::None)
+        {
+            drawIcon(g, icon, text_row.withX(static_cast<float>(Padding)).withWidth(static_cast<float>(Icon_Width)));
+        }
+        
+        g.setColour(number_colour);
+        digits.drawNumber(g, line + 1, numbers_right, text_pos + baseline_offset);
+        
+        while (next_region != regions.end() && next_region->lines.getStart() < line)
+        {
+            ++next_region;
+        }
+        
+        if (next_region != regions.end() && next_region->lines.getStart() == line && line + 1 < num_lines)
+        {
+            drawFoldMarker(g, !fold_index.isLineVisible(line + 1),
+                           text_row.withX(numbers_right + Padding).withWidth(static_cast<float>(Marker_Width)));
+        }
+        
+        line_pos += static_cast<float>(fold_index.getLineHeight(line));
+    }
+}
+
+void CodeEditor::Gutter::mouseDown(const juce::MouseEvent &event)
+{
+    if (event.x < getWidth() - Marker_Width)
+    {
+        return;
+    }
+    
+    const int line = editor.foldIndex.getLineAtY(static_cast<double>(event.position.y) - getContentY());
+    
+    if (!juce::isPositiveAndBelow(line, editor.document->getNumLines() - 1)
+        || editor.foldProvider.getRegionAt(line).lines.isEmpty())
+    {
+        return;
+    }
+    
+    editor.setFoldCollapsed(line, editor.foldIndex.isLineVisible(line + 1));
+}
+
+//======================================================================================================================
+void CodeEditor::Gutter::setFont(const juce::Font &font)
+{
+    digits.setFont(font);
+}
+
+int CodeEditor::Gutter::getNeededWidth() const noexcept
+{
+    const int digit_width = static_cast<int>(std::ceil(digits.getDigitWidth()));
+    return Padding * 3 + Icon_Width + numDigits * digit_width + Marker_Width;
+}
+
+bool CodeEditor::Gutter::updateDigitCount()
+{
+    const int count = DigitGlyphCache::getNumDigits(editor.document->getNumLines());
+    
+    if (count == numDigits)
+    {
+        return false;
+    }
+    
+    numDigits = count;
+    return true;
+}
+
+void CodeEditor::Gutter::repaintLines(int firstLine, int lastLine)
+{
+    const FoldIndex &fold_index = editor.foldIndex;
+    const int       num_lines   = editor.document->getNumLines();
+    
+    if (num_lines == 0 || firstLine > lastLine)
+    {
+        return;
+    }
+    
+    firstLine = juce::jlimit(0, num_lines - 1, firstLine);
+    lastLine  = juce::jlimit(0, num_lines - 1, lastLine);
+    
+    const double content_y = getContentY();
+    const double top       = content_y + fold_index.getYForLine(firstLine);
+    const double bottom    = lastLine == num_lines - 1
+                                 ? static_cast<double>(getHeight())
+                                 : content_y + fold_index.getYForLine(lastLine) + fold_index.getLineHeight(lastLine);
+    
+    // Rows outside the view are not worth a repaint, and their positions may not even fit an int
+    const int y        = static_cast<int>(std::floor(juce::jlimit(0.0, static_cast<double>(getHeight()), top)));
+    const int bottom_y = static_cast<int>(std::ceil (juce::jlimit(0.0, static_cast<double>(getHeight()), bottom)));
+    
+    if (bottom_y > y)
+    {
+        repaint(0, y, getWidth(), bottom_y - y);
+    }
+}
+
+//======================================================================================================================
+double CodeEditor::Gutter::getContentY() const noexcept
+{
+    const juce::ScrollBar &scroll_bar = editor.scrollBarRight;
+    const double           scroll_val = scroll_bar.isVisible() ? scroll_bar.getCurrentRangeStart() : 0.0;
+    
+    return static_cast<double>(editor.editorBounds.getY() - getY()) - scroll_val;
+}
+
+void CodeEditor::Gutter::collectIcons(int firstLine, int lastLine)
+{
+    lineIcons.assign(static_cast<std::size_t>(lastLine - firstLine + 1), Icon::None);
+    
+    if (editor.decorations.isEmpty())
+    {
+        return;
+    }
+    
+    editor.decorations.forEachInRange(editor.getOffsetRange(firstLine, lastLine),
+                                      [this, firstLine](const Decoration &decoration)
+    {
+        if (decoration.group != DecorationGroup::DiagnosticWarning
+            && decoration.group != DecorationGroup::DiagnosticError)
+        {
+            return;
+        }
+        
+        // A diagnostic that starts above the view gets its icon in the first line shown
+        const juce::CodeDocument::Position start(*editor.document, decoration.range.getStart());
+        const auto index = static_cast<std::size_t>(juce::jmax(firstLine, start.getLineNumber()) - firstLine);
+        const Icon icon  = decoration.group == DecorationGroup::DiagnosticError ? Icon::Error : Icon::Warning;
+        
+        lineIcons[index] = std::max(lineIcons[index], icon);
+    });
+}
+
+void CodeEditor::Gutter::drawIcon(juce::Graphics &g, Icon icon, juce::Rectangle<float> bounds) const
+{
+    const juce::Rectangle<float> area = bounds.withSizeKeepingCentre(Icon_Width - 4.0f, Icon_Width - 4.0f);
+    
+    if (icon == Icon::Error)
+    {
+        g.setColour(editor.findColour(ColourId::DiagnosticError));
+        g.fillEllipse(area);
+    }
+    else
+    {
+        juce::Path triangle;
+        triangle.addTriangle(area.getCentreX(), area.getY(), area.getRight(), area.getBottom(),
+                             area.getX(), area.getBottom());
+        
+        g.setColour(editor.findColour(ColourId::DiagnosticWarning));
+        g.fillPath(triangle);
+    }
+}
+
+void CodeEditor::Gutter::drawFoldMarker(juce::Graphics &g, bool collapsed, juce::Rectangle<float> bounds) const
+{
+    const juce::Rectangle<float> area = bounds.withSizeKeepingCentre(Marker_Width / 2.0f, Marker_Width / 2.0f);
+    juce::Path                   marker;
+    
+    // Points to the right while the region is collapsed and down while it is open
+    if (collapsed)
+    {
+        marker.addTriangle(area.getX(), area.getY(), area.getRight(), area.getCentreY(),
+                           area.getX(), area.getBottom());
+    }
+    else
+    {
+        marker.addTriangle(area.getX(), area.getY(), area.getRight(), area.getY(),
+                           area.getCentreX(), area.getBottom());
+    }
+    
+    g.setColour(editor.findColour(ColourId::FoldMarker));
+    g.fillPath(marker);
+}
+//======================================================================================================================
+// endregion Gutter
+//**********************************************************************************************************************
+// region Minimap
+//======================================================================================================================
+CodeEditor::Minimap::Minimap(CodeEditor &parEditor)
+    : editor(parEditor)
+{
+    setMouseCursor(juce::MouseCursor::PointingHandCursor);
+}
+
+//======================================================================================================================
+void CodeEditor::Minimap::paint(juce::Graphics &g)
+{
+    const int first_line = getFirstLine();
+    g.drawImageAt(editor.minimapModel.render(first_line, getWidth(), getHeight()), 0, 0);
+    
+    // The lines that are in the editor's view are covered by a translucent box
+    const juce::ScrollBar &scroll_bar  = editor.scrollBarRight;
+    const double           scroll_val  = scroll_bar.isVisible() ? scroll_bar.getCurrentRangeStart() : 0.0;
+    const double           view_height = static_cast<double>(editor.editorBounds.getHeight());
+    const int              top_line    = editor.foldIndex.getLineAtY(scroll_val);
+    const int              bottom_line = editor.foldIndex.getLineAtY(scroll_val + view_height);
+    
+    g.setColour(editor.findColour(ColourId::MinimapViewport));
+    g.fillRect(0, (top_line - first_line) * MinimapModel::Row_Height,
+               getWidth(), (bottom_line - top_line + 1) * MinimapModel::Row_Height);
+}
+
+void CodeEditor::Minimap::mouseDown(const juce::MouseEvent &event)
+{
+    scrollTo(event.y);
+}
+
+void CodeEditor::Minimap::mouseDrag(const juce::MouseEvent &event)
+{
+    scrollTo(event.y);
+}
+
+//======================================================================================================================
+int CodeEditor::Minimap::getFirstLine() const noexcept
+{
+    const int num_lines   = editor.minimapModel.getNumLines();
+    const int num_visible = getHeight() / MinimapModel::Row_Height;
+    
+    if (num_lines <= num_visible || !editor.scrollBarRight.isVisible())
+    {
+        return 0;
+    }
+    
+    const juce::ScrollBar &scroll_bar = editor.scrollBarRight;
+    const double           range      = scroll_bar.getMaximumRangeLimit() - scroll_bar.getCurrentRangeSize();
+    const double           proportion = range > 0.0 ? scroll_bar.getCurrentRangeStart() / range : 0.0;
+    
+    return juce::roundToInt(proportion * static_cast<double>(num_lines - num_visible));
+}
+
+//======================================================================================================================
+void CodeEditor::Minimap::scrollTo(int y)
+{
+    const int num_lines = editor.minimapModel.getNumLines();
+    
+    if (num_lines == 0)
+    {
+        return;
+    }
+    
+    // The clicked line ends up in the middle of the view
+    const int    line        = juce::jlimit(0, num_lines - 1, getFirstLine() + y / MinimapModel::Row_Height);
+    const double view_height = static_cast<double>(editor.editorBounds.getHeight());
+    
+    editor.scrollBarRight.setCurrentRangeStart(editor.foldIndex.getYForLine(line) - view_height / 2.0);
+}
+//======================================================================================================================
+// endregion Minimap
+//**********************************************************************************************************************
 // region CodeEditor
 //======================================================================================================================
 CodeEditor::CodeEditor(juce::CodeDocument &parDocument)
     : document(&parDocument),
       scrollBarRight(true), scrollBarBottom(false),
-      mainCaret{{ *document, 0 }, { this }},
+      gutter(*this), minimap(*this),
+      foldProvider(parDocument),
+      text(parDocument.getAllContent()),
       font("Droid Sans", 14.0f, 0),
       charWidth(font.getStringWidthFloat("0")),
       lineSpacing(1.2f)
 {
     addChildComponent(scrollBarRight);
     addChildComponent(scrollBarBottom);
-    addChildComponent(gutter);
-    mainCaret.position.setPositionMaintained(true);
-    mainCaret.caret.setSize(2, static_cast<int>(lineSpacing * 0.8f));
-    addAndMakeVisible(mainCaret.caret);
+    addAndMakeVisible(gutter);
+    addAndMakeVisible(minimap);
+    setWantsKeyboardFocus(true);
+    
+    XmlParser::parse(syntaxTree, CodeDocumentTextSource(*document));
+    lines.resize(static_cast<std::size_t>(document->getNumLines()));
+    updateLineTexts(0, document->getNumLines());
+    foldIndex.reset(document->getNumLines());
+    foldIndex.setDefaultHeight(static_cast<double>(font.getHeight() * lineSpacing));
+    foldProvider.setSyntaxTree(&syntaxTree);
+    gutter.setFont(font);
+    (void) gutter.updateDigitCount();
+    minimapModel.reset(document->getNumLines());
+    updateMinimapLines(0, document->getNumLines());
+    scrollBarRight.addListener(this);
+    document->addListener(this);
+    document->getUndoManager().setMaxNumberOfStoredUnits(0, 1);
     
     updateScrollBars();
+    startTimer(Caret_Blink_Interval);
 }
 
-CodeEditor::~CodeEditor() = default;
+CodeEditor::~CodeEditor()
+{
+    scrollBarRight.removeListener(this);
+    document->removeListener(this);
+}
 
 //======================================================================================================================
 void CodeEditor::paint(juce::Graphics &g)
 {
-    const double scroll_val  = scrollBarRight.getCurrentRangeStart();
-    const double line_offset = scroll_val - static_cast<int>(scroll_val);
+    const double scroll_val  = scrollBarRight.isVisible() ? scrollBarRight.getCurrentRangeStart() : 0.0;
     const float  line_height = font.getHeight() * lineSpacing;
-    const int    first_line  = scrollBarRight.isVisible() * static_cast<int>(scroll_val);
+    const double view_bottom = scroll_val + static_cast<double>(editorBounds.getHeight());
+    const int    first_line  = foldIndex.getLineAtY(scroll_val);
+    const int    last_line   = juce::jmin(foldIndex.getLineAtY(view_bottom), document->getNumLines() - 1);
     
-    float line_pos = static_cast<float>(editorBounds.getY()) - line_height * static_cast<float>(line_offset);
+    // Decorations are drawn in layers around the selection and the text, each of them in a few batched fills
+    collectDecorations(first_line, last_line);
+    decorationPipeline.render(g, TextDecorationRenderMode::Underlay);
+    drawSelections(g, first_line, last_line);
+    decorationPipeline.render(g, TextDecorationRenderMode::Between);
+    
+    float line_pos = static_cast<float>(editorBounds.getY())
+                     + static_cast<float>(foldIndex.getYForLine(first_line) - scroll_val);
     g.setFont(font);
     
     const double char_scroll_val = scrollBarBottom.getCurrentRangeStart();
@@ -121,9 +518,13 @@ void CodeEditor::paint(juce::Graphics &g)
     
     float char_pos = static_cast<float>(editorBounds.getX()) - charWidth * static_cast<float>(char_offset);
     
-    for (auto i = static_cast<std::size_t>(first_line); i < lines.size(); ++i)
+    // Rows are looked up through the fold index, so neither collapsed regions nor the heights of the lines above
+    // the view have to be walked over
+    for (int row = foldIndex.getRowForLine(first_line); row < foldIndex.getNumRows(); ++row)
     {
-        if (line_pos >= static_cast<float>(editorBounds.getBottom()))
+        const auto i = static_cast<std::size_t>(foldIndex.getLineForRow(row));
+        
+        if (line_pos >= static_cast<float>(editorBounds.getBottom()) || i >= lines.size())
         {
             break;
         }
@@ -133,28 +534,35 @@ void CodeEditor::paint(juce::Graphics &g)
         
         if (region.point != Line::FoldRegion::Point::Open || !region.collapsed)
         {
+            // The description of an extended line goes above its text
+            const float text_pos = line_pos + (line.isExtendedLine() ? line_height : 0.0f);
+            
             if (line.isExtendedLine())
             {
-                line_pos += line_height;
+                g.setColour(findColour(ColourId::DiagnosticError));
+                line.drawDescription(g, *this, ::getLineBounds(editorBounds, char_pos, line_pos, line_height),
+                                     first_char);
             }
             
-            if (line_pos >= static_cast<float>(editorBounds.getBottom()))
+            if (text_pos >= static_cast<float>(editorBounds.getBottom()))
             {
                 break;
             }
             
-            line.drawLine(*this, ::getLineBounds(editorBounds, char_pos, line_pos, line_height), first_char);
+            line.drawLine(g, *this, ::getLineBounds(editorBounds, char_pos, text_pos, line_height), first_char);
         }
         else
         {
-            i = static_cast<std::size_t>(region.foldRange.getEnd());
-            const Line &end_line = lines[i];
+            const Line &end_line = lines[static_cast<std::size_t>(region.foldRange.getEnd())];
             drawFoldedLine(g, ::getLineBounds(editorBounds, char_pos, line_pos, line_height),
-                           line, lines[i], first_char);
+                           line, end_line, first_char);
         }
         
-        line_pos += line_height;
+        line_pos += static_cast<float>(foldIndex.getLineHeight(static_cast<int>(i)));
     }
+    
+    decorationPipeline.render(g, TextDecorationRenderMode::Cover);
+    drawCarets(g, first_line, last_line);
 }
 
 void CodeEditor::resized()
@@ -169,6 +577,9 @@ void CodeEditor::resized()
         scrollBarRight.setBounds(temp.removeFromRight(10).withTrimmedBottom(Scroll_Bar_Cross_Size));
     }
     
+    minimap.setBounds(temp.removeFromRight(Minimap_Width));
+    editorBounds.setRight(minimap.getX());
+    
     if (scrollBarBottom.isVisible())
     {
         scrollBarBottom.setBounds(temp.removeFromBottom(10).withTrimmedRight(Scroll_Bar_Cross_Size));
@@ -179,75 +590,1062 @@ void CodeEditor::resized()
 juce::CodeDocument&       CodeEditor::getDocument()       noexcept { return *document; }
 const juce::CodeDocument& CodeEditor::getDocument() const noexcept { return *document; }
 
-//======================================================================================================================
-void CodeEditor::drawFoldedLine(juce::Graphics &g, juce::Rectangle<float> bounds,
-                                const Line &startLine, const Line &endLine, int startPos)
+const SyntaxTree& CodeEditor::getSyntaxTree() const noexcept { return syntaxTree; }
+
+void CodeEditor::clearUndoHistory()
 {
-    const Line::FoldRegion &start_region = startLine.getFoldRegion();
-    const Line::FoldRegion &end_region   = endLine  .getFoldRegion();
+    history.clear();
+    document->clearUndoHistory();
+}
+
+void CodeEditor::mergeExternalText(const juce::String &newText)
+{
+    const juce::StringArray           old_lines = LineDiff::splitLines(text.toString());
+    const juce::StringArray           new_lines = LineDiff::splitLines(newText);
+    const std::vector<LineDiff::Hunk> hunks     = LineDiff::compute(old_lines, new_lines);
     
-    juce::String fold_text;
-    fold_text << juce::String(startLine.getLineText()[start_region.startIndex]).paddedLeft(' ', start_region.startIndex)
-              << "..."
-              << endLine.getLineText()[end_region.startIndex];
+    if (hunks.empty())
+    {
+        return;
+    }
     
-    const int fold_text_length = fold_text.length();
-    fold_text = fold_text.substring(startPos);
+    std::vector<int> line_starts { 0 };
+    line_starts.reserve(static_cast<std::size_t>(old_lines.size() + 1));
     
-    if (!fold_text.isEmpty())
+    for (const juce::String &line : old_lines)
     {
-        g.setColour(findColour(ColourId::Text));
-        g.drawText(fold_text, bounds, juce::Justification::centredLeft);
+        line_starts.push_back(line_starts.back() + line.length());
+    }
+    
+    history.seal();
+    history.beginAction(UndoHistory::EditKind::Other);
+    
+    // Going backwards keeps the offsets of the hunks before valid, and flushing each hunk on its own means
+    // only the lines it touches are parsed, tokenized and laid out again
+    for (auto it = hunks.rbegin(); it != hunks.rend(); ++it)
+    {
+        const int          start       = line_starts[static_cast<std::size_t>(it->oldStart)];
+        const int          end         = line_starts[static_cast<std::size_t>(it->oldStart + it->oldCount)];
+        const juce::String replacement = new_lines.joinIntoString({}, it->newStart, it->newCount);
+        
+        batchEdits(true, [this, start, end, &replacement]
+        {
+            document->replaceSection(start, end, replacement);
+        });
     }
     
-    startPos -= fold_text_length;
-    endLine.drawLine(*this, bounds.removeFromLeft(static_cast<float>(fold_text.length()) * charWidth),
-                     end_region.startIndex + 1 + startPos);
+    history.endAction();
+    history.seal();
+    lastEditPosition = -1;
 }
 
 //======================================================================================================================
-bool CodeEditor::keyPressed(const juce::KeyPress &key)
+juce::CodeDocument::Position CodeEditor::getPositionAt(juce::Point<float> point) const
 {
-    return false;
+    const double scroll_val      = scrollBarRight .isVisible() ? scrollBarRight .getCurrentRangeStart() : 0.0;
+    const double char_scroll_val = scrollBarBottom.isVisible() ? scrollBarBottom.getCurrentRangeStart() : 0.0;
+    
+    const int line   = foldIndex.getLineAtY(static_cast<double>(point.y - static_cast<float>(editorBounds.getY()))
+                                            + scroll_val);
+    const int column = juce::roundToInt(static_cast<double>(point.x - static_cast<float>(editorBounds.getX()))
+                                        / charWidth + char_scroll_val);
+    
+    return { *document, juce::jmin(line, document->getNumLines() - 1), juce::jmax(0, column) };
 }
 
-//======================================================================================================================
-void CodeEditor::codeDocumentTextInserted(const juce::String&, int)
+void CodeEditor::setExtraLineHeight(int lineIndex, float extraHeight)
 {
+    foldIndex.setExtraHeight(lineIndex, static_cast<double>(extraHeight));
     updateScrollBars();
     repaint();
 }
 
-void CodeEditor::codeDocumentTextDeleted(int, int)
+//======================================================================================================================
+const CaretList& CodeEditor::getCarets() const noexcept { return carets; }
+
+void CodeEditor::setCarets(std::vector<CaretList::Caret> newCarets)
 {
-    updateScrollBars();
-    repaint();
+    carets.setCarets(std::move(newCarets));
+    repaint(editorBounds);
 }
 
 //======================================================================================================================
-void CodeEditor::updateScrollBars()
+bool CodeEditor::findAll(const SearchQuery &query)
 {
-    const int max_line_length = document->getMaximumLineLength();
+    clearSearch();
     
-    if (scrollPastEnd)
+    searchQuery    = query;
+    hasSearchQuery = true;
+    runSearch(false);
+    
+    return hasSearchQuery;
+}
+
+void CodeEditor::clearSearch()
+{
+    search.cancel();
+    decorations.removeGroup(DecorationGroup::Search);
+    pendingMatches.clear();
+    hasSearchQuery = false;
+    repaint(editorBounds);
+}
+
+std::vector<juce::Range<int>> CodeEditor::getSearchMatches() const
+{
+    std::vector<juce::Range<int>> matches;
+    
+    decorations.forEachInGroup(DecorationGroup::Search, [&matches](const Decoration &decoration)
+    {
+        matches.push_back(decoration.range);
+    });
+    
+    return matches;
+}
+
+void CodeEditor::selectAllMatches()
+{
+    std::vector<CaretList::Caret> new_carets;
+    
+    decorations.forEachInGroup(DecorationGroup::Search, [&new_carets](const Decoration &decoration)
+    {
+        new_carets.push_back({ decoration.range.getStart(), decoration.range.getEnd() });
+    });
+    
+    if (!new_carets.empty())
     {
-        scrollBarRight.setRangeLimits(0, static_cast<double>(lines.size() - 1));
+        setCarets(std::move(new_carets));
     }
-    else
+}
+
+//======================================================================================================================
+void CodeEditor::setDiagnostics(const std::vector<XmlDiagnostic> &diagnostics)
+{
+    decorations.removeGroup(DecorationGroup::DiagnosticWarning);
+    decorations.removeGroup(DecorationGroup::DiagnosticError);
+    
+    const juce::Colour warning_colour = findColour(ColourId::DiagnosticWarning);
+    const juce::Colour error_colour   = findColour(ColourId::DiagnosticError);
+    
+    // The heights go straight to the fold index, the scroll bars only need to know about them once at the end
+    for (const int line : describedLines)
     {
-        scrollBarRight.setRangeLimits(0, static_cast<int>(lines.size() - 1)
-                                         - static_cast<int>(static_cast<float>(editorBounds.getHeight())
-                                                            / (font.getHeight() * lineSpacing)));
+        lines[static_cast<std::size_t>(line)].setDescriptionTokens({});
+        foldIndex.setExtraHeight(line, 0.0);
     }
     
-    scrollBarBottom.setRangeLimits(0, max_line_length
-                                      - static_cast<int>(static_cast<float>(editorBounds.getWidth()) / charWidth));
+    describedLines.clear();
+    
+    // Warnings and errors are kept in groups of their own, so the gutter can tell them apart
+    for (const auto &diagnostic : diagnostics)
+    {
+        const bool is_warning = (diagnostic.severity == XmlDiagnostic::Severity::Warning);
+        decorations.add({ getDiagnosticRange(diagnostic), is_warning ? warning_colour : error_colour,
+                          DecorationStyle::Waved, TextDecorationRenderMode::Cover,
+                          is_warning ? DecorationGroup::DiagnosticWarning : DecorationGroup::DiagnosticError });
+        
+        // The first error of a line is also written out in an extra row above it
+        const int line = juce::jlimit(0, static_cast<int>(lines.size()) - 1, diagnostic.line - 1);
+        
+        if (is_warning || lines.empty() || lines[static_cast<std::size_t>(line)].isExtendedLine())
+        {
+            continue;
+        }
+        
+        lines[static_cast<std::size_t>(line)].setDescriptionTokens({
+            { diagnostic.message, juce::jmax(0, diagnostic.column - 1) }
+        });
+        foldIndex.setExtraHeight(line, foldIndex.getDefaultHeight());
+        describedLines.emplace_back(line);
+    }
+    
+    updateScrollBars();
+    repaint();
 }
 
 //======================================================================================================================
-void CodeEditor::fillSchemeList(const TextMateGrammar &grammar)
+void CodeEditor::setGrammar(const TextMateGrammar &grammar)
 {
+    fillSchemeList(grammar);
+    (void) foldProvider.setMarkers(grammar.foldingMarker);
+    
+    tokenizer = std::make_unique<TextMateTokenizer>(grammar, scopeStacks);
+    (void) tokenizeLines(0, static_cast<int>(lines.size()));
+    
+    updateMinimapLines(0, static_cast<int>(lines.size()));
+    updateMinimapColours();
+    repaint();
+}
+
+void CodeEditor::setTheme(const TextMateTheme &theme)
+{
+    themeMatcher.setTheme(theme);
+    themeMatcher.precompute();
+    
+    // Tokens refer to the entries of the old scheme, the new one may have different entries or order them otherwise
+    if (tokenizeLines(0, static_cast<int>(lines.size())) > 0)
+    {
+        updateMinimapLines(0, static_cast<int>(lines.size()));
+    }
+    
+    updateMinimapColours();
+    repaint();
+}
+
+void CodeEditor::setFoldCollapsed(int lineIndex, bool shouldBeCollapsed)
+{
+    if (!juce::isPositiveAndBelow(lineIndex, static_cast<int>(lines.size())))
+    {
+        return;
+    }
+    
+    Line::FoldRegion &region = lines[static_cast<std::size_t>(lineIndex)].getFoldRegion();
+    
+    if (region.collapsed == shouldBeCollapsed)
+    {
+        return;
+    }
+    
+    if (shouldBeCollapsed)
+    {
+        // Regions are only looked up when they are collapsed, an expanded region keeps no state in its lines
+        const FoldProvider::Region found = foldProvider.getRegionAt(lineIndex);
+        const auto                 end   = static_cast<std::size_t>(found.lines.getEnd());
+        
+        if (found.lines.isEmpty() || end >= lines.size())
+        {
+            return;
+        }
+        
+        region                     = { found.lines, Line::FoldRegion::Point::Open,  found.startColumn, true };
+        lines[end].getFoldRegion() = { found.lines, Line::FoldRegion::Point::Close, found.endColumn,   true };
+        
+        // The start line stays visible and shows the end line next to it, everything after it is hidden
+        foldIndex.hideLines({ lineIndex + 1, found.lines.getEnd() + 1 });
+        collapsedFolds.emplace_back(lineIndex);
+    }
+    else if (region.point == Line::FoldRegion::Point::Open)
+    {
+        expandFoldsIn({ lineIndex, lineIndex + 1 });
+    }
+    else
+    {
+        return;
+    }
+    
+    updateScrollBars();
+    repaint();
+}
+
+const FoldIndex& CodeEditor::getFoldIndex() const noexcept { return foldIndex; }
+
+//======================================================================================================================
+void CodeEditor::drawFoldedLine(juce::Graphics &g, juce::Rectangle<float> bounds,
+                                const Line &startLine, const Line &endLine, int startPos)
+{
+    const Line::FoldRegion &start_region = startLine.getFoldRegion();
+    const Line::FoldRegion &end_region   = endLine  .getFoldRegion();
+    
+    juce::String fold_text;
+    fold_text << juce::String(startLine.getLineText()[start_region.startIndex]).paddedLeft(' ', start_region.startIndex)
+              << "..."
+              << endLine.getLineText()[end_region.startIndex];
+    
+    const int fold_text_length = fold_text.length();
+    fold_text = fold_text.substring(startPos);
+    
+    // The start line shows its own text up to the fold character, the fold text is only padded with spaces there
+    if (start_region.startIndex > startPos)
+    {
+        const float                           text_width = static_cast<float>(start_region.startIndex - startPos);
+        const juce::Graphics::ScopedSaveState saved_state(g);
+        
+        g.reduceClipRegion(bounds.withWidth(text_width * charWidth).getSmallestIntegerContainer());
+        startLine.drawLine(g, *this, bounds, startPos);
+    }
+    
+    if (!fold_text.isEmpty())
+    {
+        g.setColour(findColour(ColourId::Text));
+        g.drawText(fold_text, bounds, juce::Justification::centredLeft);
+    }
+    
+    // The end line goes on right after the fold text, from the character after its fold character
+    bounds.removeFromLeft(static_cast<float>(fold_text.length()) * charWidth);
+    endLine.drawLine(g, *this, bounds, end_region.startIndex + 1 + juce::jmax(0, startPos - fold_text_length));
+}
+
+template<class Fn>
+void CodeEditor::forEachRowOf(juce::Range<int> range, Fn &&callback) const
+{
+    const juce::CodeDocument::Position start(*document, range.getStart());
+    const juce::CodeDocument::Position end  (*document, range.getEnd());
+    
+    // Walk rows instead of lines, a collapsed region inside the range is a single row
+    const int last_row = foldIndex.getRowForLine(end.getLineNumber());
+    
+    for (int row = foldIndex.getRowForLine(start.getLineNumber()); row <= last_row; ++row)
+    {
+        const int line = foldIndex.getLineForRow(row);
+        const int from = line == start.getLineNumber() ? start.getIndexInLine() : 0;
+        const int to   = line == end.getLineNumber()
+                             ? end.getIndexInLine()
+                             : juce::CodeDocument::Position(*document, line, std::numeric_limits<int>::max())
+                                   .getIndexInLine() + 1;
+        
+        callback(getCharacterBounds(line, from).withWidth(charWidth * static_cast<float>(to - from)));
+    }
+}
+
+void CodeEditor::collectDecorations(int firstLine, int lastLine)
+{
+    decorationPipeline.beginFrame(editorBounds.toFloat());
+    
+    if (decorations.isEmpty() || firstLine > lastLine)
+    {
+        return;
+    }
+    
+    const juce::Range<int> visible = getOffsetRange(firstLine, lastLine);
+    
+    decorations.forEachInRange(visible, [this, visible](const Decoration &decoration)
+    {
+        forEachRowOf(decoration.range.getIntersectionWith(visible), [this, &decoration](juce::Rectangle<float> bounds)
+        {
+            decorationPipeline.add(decoration.mode, decoration.style, decoration.colour, bounds);
+        });
+    });
+}
+
+void CodeEditor::drawSelections(juce::Graphics &g, int firstLine, int lastLine) const
+{
+    if (firstLine > lastLine)
+    {
+        return;
+    }
+    
+    const juce::Range<int>               visible    = getOffsetRange(firstLine, lastLine);
+    const std::vector<CaretList::Caret> &caret_list = carets.getCarets();
+    
+    juce::RectangleList<float> selection_bounds;
+    
+    // Carets are sorted, so only the ones inside the view are looked at
+    for (auto i = carets.findFirstCaretFrom(visible.getStart()); i < caret_list.size(); ++i)
+    {
+        const CaretList::Caret &caret = caret_list[i];
+        
+        if (caret.getSelection().getStart() > visible.getEnd())
+        {
+            break;
+        }
+        
+        if (caret.hasSelection())
+        {
+            forEachRowOf(caret.getSelection().getIntersectionWith(visible), [&selection_bounds](auto bounds)
+            {
+                selection_bounds.addWithoutMerging(bounds);
+            });
+        }
+    }
+    
+    g.setColour(findColour(ColourId::SelectionBackground));
+    g.fillRectList(selection_bounds);
+}
+
+void CodeEditor::drawCarets(juce::Graphics &g, int firstLine, int lastLine) const
+{
+    if (!caretsVisible || firstLine > lastLine)
+    {
+        return;
+    }
+    
+    const juce::Range<int>               visible    = getOffsetRange(firstLine, lastLine);
+    const std::vector<CaretList::Caret> &caret_list = carets.getCarets();
+    
+    juce::RectangleList<float> caret_bounds;
+    
+    for (auto i = carets.findFirstCaretFrom(visible.getStart()); i < caret_list.size(); ++i)
+    {
+        const CaretList::Caret &caret = caret_list[i];
+        
+        if (caret.getSelection().getStart() > visible.getEnd())
+        {
+            break;
+        }
+        
+        const juce::CodeDocument::Position position(*document, caret.position);
+        
+        if (foldIndex.isLineVisible(position.getLineNumber()))
+        {
+            caret_bounds.addWithoutMerging(getCharacterBounds(position.getLineNumber(), position.getIndexInLine())
+                                               .withWidth(2.0f));
+        }
+    }
+    
+    g.setColour(findColour(ColourId::Caret));
+    g.fillRectList(caret_bounds);
+}
+
+juce::Range<int> CodeEditor::getOffsetRange(int firstLine, int lastLine) const
+{
+    return {
+        juce::CodeDocument::Position(*document, firstLine, 0).getPosition(),
+        juce::CodeDocument::Position(*document, lastLine, std::numeric_limits<int>::max()).getPosition()
+    };
+}
+
+juce::Range<int> CodeEditor::getDiagnosticRange(const XmlDiagnostic &diagnostic) const
+{
+    // Xerces only reports where it noticed the problem, which is usually right after the offending name,
+    // so the squiggle covers the name around that point or at least one character
+    const int          line      = juce::jlimit(0, juce::jmax(0, document->getNumLines() - 1), diagnostic.line - 1);
+    const juce::String line_text = document->getLine(line).trimCharactersAtEnd("\r\n");
+    const int          column    = juce::jlimit(0, line_text.length(), diagnostic.column - 1);
+    
+    int start = column;
+    int end   = column;
+    
+    while (start > 0 && ::isNameCharacter(line_text[start - 1]))
+    {
+        --start;
+    }
+    
+    while (end < line_text.length() && ::isNameCharacter(line_text[end]))
+    {
+        ++end;
+    }
+    
+    if (start == end)
+    {
+        if (end < line_text.length())
+        {
+            ++end;
+        }
+        else if (start > 0)
+        {
+            --start;
+        }
+    }
+    
+    const int line_start = juce::CodeDocument::Position(*document, line, 0).getPosition();
+    return { line_start + start, line_start + end };
+}
+
+juce::Rectangle<float> CodeEditor::getCharacterBounds(int line, int column) const noexcept
+{
+    const double scroll_val      = scrollBarRight .isVisible() ? scrollBarRight .getCurrentRangeStart() : 0.0;
+    const double char_scroll_val = scrollBarBottom.isVisible() ? scrollBarBottom.getCurrentRangeStart() : 0.0;
+    
+    // The text of an extended line is below its description
+    const auto   index       = static_cast<std::size_t>(line);
+    const double description = index < lines.size() && lines[index].isExtendedLine() ? foldIndex.getDefaultHeight()
+                                                                                      : 0.0;
+    
+    return {
+        static_cast<float>(editorBounds.getX()) + charWidth * static_cast<float>(column - char_scroll_val),
+        static_cast<float>(static_cast<double>(editorBounds.getY()) + foldIndex.getYForLine(line) + description
+                           - scroll_val),
+        charWidth,
+        font.getHeight() * lineSpacing
+    };
+}
+
+//======================================================================================================================
+template<class Fn>
+void CodeEditor::batchEdits(bool shiftCarets, Fn &&edit)
+{
+    batchingEdits      = true;
+    shiftCaretsOnEdits = shiftCarets;
+    
+    edit();
+    
+    batchingEdits      = false;
+    shiftCaretsOnEdits = true;
+    
+    flushEdits();
+}
+
+template<class Fn>
+void CodeEditor::recordEdits(UndoHistory::EditKind kind, Fn &&edit)
+{
+    // Keystrokes only coalesce while the caret stays where the last one left it
+    if (carets.getMainCaret().position != lastEditPosition)
+    {
+        history.seal();
+    }
+    
+    history.beginAction(kind);
+    batchEdits(false, std::forward<Fn>(edit));
+    history.endAction();
+    
+    lastEditPosition = carets.getMainCaret().position;
+}
+
+void CodeEditor::applyHistory(const std::vector<UndoHistory::Edit> &edits)
+{
+    if (edits.empty())
+    {
+        return;
+    }
+    
+    applyingHistory = true;
+    batchEdits(true, [this, &edits]
+    {
+        for (const UndoHistory::Edit &edit : edits)
+        {
+            if (edit.removed.isNotEmpty())
+            {
+                document->deleteSection(edit.start, edit.start + edit.removed.length());
+            }
+            
+            if (edit.inserted.isNotEmpty())
+            {
+                document->insertText(edit.start, edit.inserted);
+            }
+        }
+    });
+    applyingHistory = false;
+    
+    const UndoHistory::Edit &last = edits.back();
+    carets.reset(last.start + last.inserted.length());
+    lastEditPosition = -1;
+}
+
+bool CodeEditor::keyPressed(const juce::KeyPress &key)
+{
+    const bool selecting = key.getModifiers().isShiftDown();
+    
+    if (key.isKeyCode(juce::KeyPress::leftKey) || key.isKeyCode(juce::KeyPress::rightKey))
+    {
+        carets.moveHorizontally(*document, key.isKeyCode(juce::KeyPress::leftKey) ? -1 : 1, selecting);
+    }
+    else if (key.isKeyCode(juce::KeyPress::upKey) || key.isKeyCode(juce::KeyPress::downKey))
+    {
+        carets.moveVertically(*document, key.isKeyCode(juce::KeyPress::upKey) ? -1 : 1, selecting);
+    }
+    else if (key.isKeyCode(juce::KeyPress::homeKey))
+    {
+        carets.moveToLineStart(*document, selecting);
+    }
+    else if (key.isKeyCode(juce::KeyPress::endKey))
+    {
+        carets.moveToLineEnd(*document, selecting);
+    }
+    else if (key.isKeyCode(juce::KeyPress::escapeKey) && carets.getNumCarets() > 1)
+    {
+        carets.reset(carets.getMainCaret().position);
+    }
+    else if (readOnly)
+    {
+        return false;
+    }
+    else if (key == juce::KeyPress('z', juce::ModifierKeys::commandModifier, 0))
+    {
+        applyHistory(history.undo());
+    }
+    else if (key == juce::KeyPress('z', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0)
+             || key == juce::KeyPress('y', juce::ModifierKeys::commandModifier, 0))
+    {
+        applyHistory(history.redo());
+    }
+    else if (key.isKeyCode(juce::KeyPress::backspaceKey))
+    {
+        recordEdits(UndoHistory::EditKind::Deleting, [this] { carets.deleteBackwards(*document); });
+    }
+    else if (key.isKeyCode(juce::KeyPress::deleteKey))
+    {
+        recordEdits(UndoHistory::EditKind::Deleting, [this] { carets.deleteForwards(*document); });
+    }
+    else
+    {
+        juce::String text;
+        
+        if (key.isKeyCode(juce::KeyPress::returnKey))
+        {
+            text = document->getNewLineCharacters();
+        }
+        else if (key.isKeyCode(juce::KeyPress::tabKey))
+        {
+            text = "\t";
+        }
+        else if (key.getTextCharacter() >= ' ' && !key.getModifiers().isCommandDown())
+        {
+            text = juce::String::charToString(key.getTextCharacter());
+        }
+        
+        if (text.isEmpty())
+        {
+            return false;
+        }
+        
+        // A new line always starts a transaction of its own, so undoing goes back line by line
+        const auto kind = (key.isKeyCode(juce::KeyPress::returnKey) ? UndoHistory::EditKind::Other
+                                                                    : UndoHistory::EditKind::Typing);
+        recordEdits(kind, [this, &text] { carets.insertText(*document, text); });
+    }
+    
+    // Keep the carets solid while typing
+    caretsVisible = true;
+    startTimer(Caret_Blink_Interval);
+    repaint(editorBounds);
+    
+    return true;
+}
+
+void CodeEditor::mouseDown(const juce::MouseEvent &event)
+{
+    const int position = getPositionAt(event.position).getPosition();
+    
+    if (event.mods.isAltDown())
+    {
+        carets.addCaret({ position, position });
+    }
+    else if (event.mods.isShiftDown())
+    {
+        carets.setMainCaretPosition(position, true);
+    }
+    else
+    {
+        carets.reset(position);
+    }
+    
+    grabKeyboardFocus();
+    caretsVisible = true;
+    repaint(editorBounds);
+}
+
+void CodeEditor::mouseDrag(const juce::MouseEvent &event)
+{
+    carets.setMainCaretPosition(getPositionAt(event.position).getPosition(), true);
+    repaint(editorBounds);
+}
+
+void CodeEditor::timerCallback()
+{
+    caretsVisible = !caretsVisible;
+    repaint(editorBounds);
+}
+
+void CodeEditor::scrollBarMoved(juce::ScrollBar*, double)
+{
+    repaint();
+}
+
+//======================================================================================================================
+void CodeEditor::codeDocumentTextInserted(const juce::String &newText, int insertIndex)
+{
+    if (!applyingHistory)
+    {
+        history.addEdit(insertIndex, {}, newText);
+    }
+    
+    text.insert(insertIndex, newText);
+    handleEdit(insertIndex, 0, newText.length());
+}
+
+void CodeEditor::codeDocumentTextDeleted(int startIndex, int endIndex)
+{
+    // The mirror still has the removed text, the document doesn't anymore
+    if (!applyingHistory)
+    {
+        history.addEdit(startIndex, text.getText({ startIndex, endIndex }), {});
+    }
+    
+    text.remove(startIndex, endIndex - startIndex);
+    handleEdit(startIndex, endIndex - startIndex, 0);
+}
+
+void CodeEditor::handleEdit(int start, int removedLength, int insertedLength)
+{
+    if (shiftCaretsOnEdits)
+    {
+        carets.shiftForEdit(start, removedLength, insertedLength);
+    }
+    
+    decorations.applyEdit(start, removedLength, insertedLength);
+    
+    const int end = start + removedLength;
+    
+    if (pendingEdit.start < 0)
+    {
+        pendingEdit = { start, end, start + insertedLength };
+    }
+    else
+    {
+        // The new edit's offsets are in the text after the pending ones, so map its end back before merging
+        pendingEdit.oldEnd = juce::jmax(pendingEdit.oldEnd, end - (pendingEdit.newEnd - pendingEdit.oldEnd));
+        pendingEdit.newEnd = juce::jmax(pendingEdit.newEnd, end) + insertedLength - removedLength;
+        pendingEdit.start  = juce::jmin(pendingEdit.start, start);
+    }
+    
+    if (!batchingEdits)
+    {
+        flushEdits();
+    }
+}
+
+void CodeEditor::flushEdits()
+{
+    if (pendingEdit.start < 0)
+    {
+        return;
+    }
+    
+    const EditSpan edit = std::exchange(pendingEdit, EditSpan{ -1, -1, -1 });
+    
+    XmlParser::reparse(syntaxTree, CodeDocumentTextSource(*document), edit.start, edit.oldEnd - edit.start,
+                       edit.newEnd - edit.start);
+    
+    const int first_line    = juce::CodeDocument::Position(*document, edit.start) .getLineNumber();
+    const int last_line     = juce::CodeDocument::Position(*document, edit.newEnd).getLineNumber();
+    const int old_num_lines = foldIndex.getNumLines();
+    updateLines(first_line, last_line - first_line + 1);
+    
+    if (hasSearchQuery)
+    {
+        rescanLines(first_line, last_line);
+    }
+    
+    updateScrollBars();
+    
+    // The gutter only repaints the numbers that moved, unless it has to make room for another digit
+    if (gutter.updateDigitCount())
+    {
+        resized();
+    }
+    else
+    {
+        const int num_lines = document->getNumLines();
+        gutter.repaintLines(first_line, num_lines != old_num_lines ? num_lines - 1 : last_line);
+    }
+    
+    repaint(editorBounds);
+}
+
+//======================================================================================================================
+void CodeEditor::updateLines(int firstLine, int numNewLines)
+{
+    // Lines are only ever added or removed inside the edited lines, so they are put right after the first of them
+    const int difference = document->getNumLines() - foldIndex.getNumLines();
+    
+    const auto insert_at  = lines.begin() + firstLine + 1;
+    
+    foldProvider.updateLines(firstLine, juce::jmax(1, numNewLines - difference), numNewLines);
+    
+    if (difference > 0)
+    {
+        foldIndex   .insertLines(firstLine + 1, difference);
+        minimapModel.insertLines(firstLine + 1, difference);
+        (void) lines.insert(insert_at, static_cast<std::size_t>(difference), Line());
+    }
+    else if (difference < 0)
+    {
+        // A collapsed region can't outlive its first or last line, so these are opened before they go
+        expandFoldsIn({ firstLine + 1, firstLine + 1 - difference });
+        
+        foldIndex   .removeLines(firstLine + 1, -difference);
+        minimapModel.removeLines(firstLine + 1, -difference);
+        
+        for (auto it = insert_at; it != insert_at - difference; ++it)
+        {
+            tokenArena.release(it->getTokens());
+        }
+        
+        // Lines after the edit were tokenized from the end of the last edited line, which is one of those removed
+        // if they all became one
+        if (numNewLines == 1)
+        {
+            lines[static_cast<std::size_t>(firstLine)].setEndState((insert_at - difference - 1)->getEndState());
+        }
+        
+        (void) lines.erase(insert_at, insert_at - difference);
+    }
+    
+    if (difference != 0)
+    {
+        shiftFolds(firstLine, difference);
+        shiftDescriptions(firstLine, difference);
+    }
+    
+    const int num_changed = juce::jmin(numNewLines, static_cast<int>(lines.size()) - firstLine);
+    updateLineTexts(firstLine, num_changed);
+    
+    // Rules left open by the edited lines can restyle any number of lines after them, which may be in styles the
+    // scheme didn't have an entry for yet
+    const std::size_t num_styles    = themeMatcher.getScheme().size();
+    const int         num_tokenized = tokenizeLines(firstLine, num_changed);
+    
+    if (themeMatcher.getScheme().size() != num_styles)
+    {
+        updateMinimapColours();
+    }
+    
+    updateMinimapLines(firstLine, juce::jmax(num_changed, num_tokenized));
+}
+
+void CodeEditor::updateLineTexts(int firstLine, int numLines)
+{
+    for (int i = firstLine; i < firstLine + numLines; ++i)
+    {
+        lines[static_cast<std::size_t>(i)].setLineText(document->getLine(i));
+    }
+}
+
+void CodeEditor::expandFoldsIn(juce::Range<int> lineRange)
+{
+    const auto first_removed = std::partition(collapsedFolds.begin(), collapsedFolds.end(), [&](int startLine)
+    {
+        const int end_line = lines[static_cast<std::size_t>(startLine)].getFoldRegion().foldRange.getEnd();
+        return !lineRange.contains(startLine) && !lineRange.contains(end_line);
+    });
+    
+    for (auto it = first_removed; it != collapsedFolds.end(); ++it)
+    {
+        Line::FoldRegion &start_region = lines[static_cast<std::size_t>(*it)].getFoldRegion();
+        const int        end_line     = start_region.foldRange.getEnd();
+        
+        foldIndex.showLines({ *it + 1, end_line + 1 });
+        lines[static_cast<std::size_t>(end_line)].getFoldRegion() = { {}, Line::FoldRegion::Point::None, 0, false };
+        start_region                                              = { {}, Line::FoldRegion::Point::None, 0, false };
+    }
+    
+    collapsedFolds.erase(first_removed, collapsedFolds.end());
+}
+
+void CodeEditor::shiftFolds(int firstLine, int difference)
+{
+    // Lines come and go right after the first edited line, the fold index gave new lines the folds of that line
+    const juce::Range<int> new_lines(firstLine + 1, firstLine + 1 + juce::jmax(0, difference));
+    
+    for (int &start_line : collapsedFolds)
+    {
+        if (start_line == firstLine && !new_lines.isEmpty())
+        {
+            foldIndex.hideLines(new_lines);
+        }
+        
+        // The regions moved along with their lines already, only the lines they refer to are still the old ones
+        start_line += (start_line > firstLine ? difference : 0);
+        
+        Line::FoldRegion &start_region = lines[static_cast<std::size_t>(start_line)].getFoldRegion();
+        int              end_line     = start_region.foldRange.getEnd();
+        
+        if (end_line == firstLine && !new_lines.isEmpty())
+        {
+            foldIndex.showLines(new_lines);
+        }
+        
+        end_line += (end_line > firstLine ? difference : 0);
+        
+        start_region.foldRange                                              = { start_line, end_line };
+        lines[static_cast<std::size_t>(end_line)].getFoldRegion().foldRange = { start_line, end_line };
+    }
+}
+
+void CodeEditor::shiftDescriptions(int firstLine, int difference)
+{
+    // The descriptions of removed lines went with them, those of the lines after them moved along
+    const juce::Range<int> removed_lines(firstLine + 1, firstLine + 1 + juce::jmax(0, -difference));
+    
+    describedLines.erase(std::remove_if(describedLines.begin(), describedLines.end(), [&removed_lines](int line)
+    {
+        return removed_lines.contains(line);
+    }), describedLines.end());
+    
+    for (int &line : describedLines)
+    {
+        line += (line > firstLine ? difference : 0);
+    }
+}
+
+void CodeEditor::runSearch(bool replaceWhenFinished)
+{
+    pendingMatches.clear();
+    
+    const bool started = search.start(text, searchQuery,
+                                      [this, replaceWhenFinished](std::vector<juce::Range<int>> matches, bool finished)
+    {
+        // A search after an edit replaces the old matches only once it's done, so they don't flicker in and out;
+        // until then, the old matches have been moved along with the edits by the store
+        if (!replaceWhenFinished)
+        {
+            addSearchMatches(matches);
+        }
+        else
+        {
+            pendingMatches.insert(pendingMatches.end(), matches.begin(), matches.end());
+            
+            if (finished)
+            {
+                decorations.removeGroup(DecorationGroup::Search);
+                addSearchMatches(pendingMatches);
+                pendingMatches.clear();
+            }
+        }
+        
+        if (!replaceWhenFinished || finished)
+        {
+            repaint(editorBounds);
+        }
+    });
+    
+    if (!started)
+    {
+        decorations.removeGroup(DecorationGroup::Search);
+        hasSearchQuery = false;
+    }
+}
+
+void CodeEditor::rescanLines(int firstLine, int lastLine)
+{
+    const int start = juce::CodeDocument::Position(*document, firstLine, 0)   .getPosition();
+    const int end   = juce::CodeDocument::Position(*document, lastLine + 1, 0).getPosition();
+    
+    // Matches outside the edited lines only moved, unless the pattern can reach across lines into them; a search
+    // still running was started on the old text, and a large edit is done faster by the pool than on this thread
+    const bool spans_lines = !searchQuery.isRegex && searchQuery.pattern.containsAnyOf("\r\n");
+    
+    if (search.isSearching() || spans_lines || end - start > TextSearch::Job_Size)
+    {
+        runSearch(true);
+        return;
+    }
+    
+    decorations.removeGroup(DecorationGroup::Search, { start, end });
+    addSearchMatches(TextSearch::findAll(text, searchQuery, { start, end }));
+}
+
+void CodeEditor::addSearchMatches(const std::vector<juce::Range<int>> &matches)
+{
+    const juce::Colour colour = findColour(ColourId::SearchMatchBackground);
+    
+    for (const auto &range : matches)
+    {
+        decorations.add({ range, colour, DecorationStyle::Fill, TextDecorationRenderMode::Underlay,
+                          DecorationGroup::Search });
+    }
+}
+
+void CodeEditor::updateScrollBars()
+{
+    const int    max_line_length = document->getMaximumLineLength();
+    const double content_height  = foldIndex.getTotalHeight();
+    const double view_height     = static_cast<double>(editorBounds.getHeight());
+    
+    // Scrolling is in pixels, so rows of any height and folded regions are accounted for exactly
+    if (scrollPastEnd)
+    {
+        scrollBarRight.setRangeLimits(0.0, content_height + view_height - foldIndex.getDefaultHeight());
+    }
+    else
+    {
+        scrollBarRight.setRangeLimits(0.0, juce::jmax(content_height, view_height));
+    }
+    
+    scrollBarRight.setCurrentRange(scrollBarRight.getCurrentRangeStart(), view_height);
+    scrollBarRight.setSingleStepSize(foldIndex.getDefaultHeight());
+    
+    scrollBarBottom.setRangeLimits(0, max_line_length
+                                      - static_cast<int>(static_cast<float>(editorBounds.getWidth()) / charWidth));
+}
+
+void CodeEditor::updateMinimapLines(int firstLine, int numLines)
+{
+    for (int i = firstLine; i < firstLine + numLines; ++i)
+    {
+        // Lines without tokens yet are drawn in the text colour until they are tokenized
+        const auto            index  = static_cast<std::size_t>(i);
+        const TokenArena::Run tokens = index < lines.size() ? lines[index].getTokens() : TokenArena::Run{};
+        
+        minimapModel.setLine(i, document->getLine(i), tokenArena, tokens);
+    }
+    
+    minimap.repaint();
+}
+
+void CodeEditor::updateMinimapColours()
+{
+    std::vector<juce::Colour> colours;
+    
+    for (const auto &entry : themeMatcher.getScheme())
+    {
+        colours.push_back(entry.colour);
+    }
+    
+    minimapModel.setColours(colours, findColour(ColourId::Text));
+    minimap.repaint();
+}
+
+
+//======================================================================================================================
+void CodeEditor::fillSchemeList(const TextMateGrammar &grammar)
+{
+    // Knowing every stack the grammar can produce up front means tokenizing never has to match selectors
+    scopeStacks.addGrammar(grammar);
+    themeMatcher.precompute();
+}
+
+//======================================================================================================================
+int CodeEditor::tokenizeLines(int firstLine, int numLines)
+{
+    if (!tokenizer)
+    {
+        return 0;
+    }
+    
+    TextMateTokenizer::State state = (firstLine > 0 ? lines[static_cast<std::size_t>(firstLine - 1)].getEndState()
+                                                    : tokenizer->getInitialState());
+    
+    std::vector<TextMateTokenizer::Token> line_tokens;
+    TokenArena::Builder                   builder;
+    
+    for (int i = firstLine; i < static_cast<int>(lines.size()); ++i)
+    {
+        tokenizer->tokenizeLine(lines[static_cast<std::size_t>(i)].getLineText().trimCharactersAtEnd("\r\n"),
+                                state, line_tokens);
+        builder.clear();
+        
+        for (const auto &token : line_tokens)
+        {
+            builder.add(token.start, themeMatcher.getSchemeIndex(token.stack));
+        }
+        
+        setLineTokens(i, builder);
+        
+        // From the last given line on, ending in the same state as before leaves the lines after it as they are
+        Line       &line   = lines[static_cast<std::size_t>(i)];
+        const bool settled = (i >= firstLine + numLines - 1 && state == line.getEndState());
+        line.setEndState(state);
+        
+        if (settled)
+        {
+            return i + 1 - firstLine;
+        }
+    }
+    
+    return static_cast<int>(lines.size()) - firstLine;
+}
+
+void CodeEditor::setLineTokens(int lineIndex, const TokenArena::Builder &builder)
+{
+    Line &line = lines[static_cast<std::size_t>(lineIndex)];
+    line.setTokens(tokenArena.store(builder, line.getTokens()));
+    
+    if (tokenArena.shouldCompact())
+    {
+        compactTokens();
+    }
+}
+
+void CodeEditor::compactTokens()
+{
+    TokenArena compacted;
+    
+    for (auto &line : lines)
+    {
+        line.setTokens(compacted.copyFrom(tokenArena, line.getTokens()));
+    }
     
+    tokenArena = std::move(compacted);
 }
 //======================================================================================================================
 // endregion CodeEditor
@@ -25,14 +25,32 @@
 
 #pragma once
 
+#include "analyser/XmlDiagnostic.h"
+#include "document/CaretList.h"
+#include "document/TokenArena.h"
+#include "document/UndoHistory.h"
+#include "render/DecorationStore.h"
+#include "render/DigitGlyphCache.h"
+#include "render/FoldIndex.h"
+#include "render/MinimapModel.h"
+#include "search/TextSearch.h"
+#include "syntax/FoldProvider.h"
+#include "syntax/SyntaxTree.h"
+#include "syntax/textmate/TextMateThemeMatcher.h"
+#include "syntax/textmate/TextMateTokenizer.h"
+
 #include <juce_gui_extra/juce_gui_extra.h>
 
 struct TextMateGrammar;
-class CodeEditor : public juce::Component, public juce::CodeDocument::Listener
+struct TextMateTheme;
+class CodeEditor : public juce::Component, public juce::CodeDocument::Listener, private juce::Timer,
+                   private juce::ScrollBar::Listener
 {
 public:
-    static constexpr int Line_Height_Padding   =  2;
-    static constexpr int Scroll_Bar_Cross_Size = 10;
+    static constexpr int Line_Height_Padding   =   2;
+    static constexpr int Scroll_Bar_Cross_Size =  10;
+    static constexpr int Caret_Blink_Interval  = 500;
+    static constexpr int Minimap_Width         = 100;
     
     //==================================================================================================================
     struct ColourId
@@ -44,7 +62,14 @@ public:
             CurrentLineBackground = 0x420692,
             SelectionBackground   = 0x420693,
             Text                  = 0x420694,
-            FoldRegion            = 0x420695
+            FoldRegion            = 0x420695,
+            SearchMatchBackground = 0x420696,
+            DiagnosticWarning     = 0x420697,
+            DiagnosticError       = 0x420698,
+            MinimapViewport       = 0x420699,
+            GutterBackground      = 0x42069a,
+            LineNumber            = 0x42069b,
+            FoldMarker            = 0x42069c
         };
     };
     
@@ -60,11 +85,159 @@ public:
     juce::CodeDocument&       getDocument()       noexcept;
     const juce::CodeDocument& getDocument() const noexcept;
     
+    /** Gets the structure of the document, it is kept up to date with every edit. */
+    const SyntaxTree& getSyntaxTree() const noexcept;
+    
+    /** Forgets all edits that could be undone, for example after a file was loaded into the document. */
+    void clearUndoHistory();
+    
+    /**
+        Changes the text to a new version that was made outside the editor, like a file that changed on disk.
+        Only the lines that differ are replaced, so tokens, folds and carets everywhere else stay as they are.
+        The whole change is undone in one step.
+     */
+    void mergeExternalText(const juce::String &newText);
+    
+    //==================================================================================================================
+    /** Gets the document position under a point in this component, taking folds and line heights into account. */
+    juce::CodeDocument::Position getPositionAt(juce::Point<float> point) const;
+    
+    /** Sets how much space a line takes up in addition to its text, for descriptions and inline annotations. */
+    void setExtraLineHeight(int lineIndex, float extraHeight);
+    
+    //==================================================================================================================
+    const CaretList& getCarets() const noexcept;
+    
+    /** Replaces all carets, for example to put one at every match of a search. */
+    void setCarets(std::vector<CaretList::Caret> newCarets);
+    
+    //==================================================================================================================
+    /**
+        Highlights all matches of a query, they are searched for in the background and show up as they are found.
+        The matches follow edits to the document until the search is cleared.
+        
+        @return False if the query is empty or not a valid regular expression
+     */
+    bool findAll(const SearchQuery &query);
+    
+    /** Stops highlighting the matches of the last search. */
+    void clearSearch();
+    
+    /** Gets the matches that were found so far, sorted by their start. */
+    std::vector<juce::Range<int>> getSearchMatches() const;
+    
+    /** Replaces all carets with one selecting each match that was found so far. */
+    void selectAllMatches();
+    
+    //==================================================================================================================
+    /**
+        Replaces the squiggles showing the analyser's diagnostics.
+        The diagnostics must have been made for the document's current text, they follow edits from then on.
+     */
+    void setDiagnostics(const std::vector<XmlDiagnostic> &diagnostics);
+    
+    //==================================================================================================================
+    /**
+        Sets the grammar that tokenizes the lines and, if there is no xml structure, provides the folding markers.
+        The grammar must stay alive for as long as it is set.
+     */
+    void setGrammar(const TextMateGrammar &grammar);
+    
+    /** Sets the theme that decides the colour and font style of each token. */
+    void setTheme(const TextMateTheme &theme);
+    
+    /** Collapses or expands the fold region that starts at the given line, if there is one. */
+    void setFoldCollapsed(int lineIndex, bool shouldBeCollapsed);
+    
+    /** Gets which lines are hidden by collapsed regions and the rows and heights of the others. */
+    const FoldIndex& getFoldIndex() const noexcept;
+    
 private:
+    /**
+        The line numbers, fold markers and diagnostic icons to the left of the text.
+        Only the rows inside the clip region are drawn, so edits and folds repaint just the rows they changed.
+     */
     class Gutter : public juce::Component
     {
     public:
-        int getNeededWidth() const noexcept { return 0; }
+        static constexpr int Padding      = 4;
+        static constexpr int Icon_Width   = 12;
+        static constexpr int Marker_Width = 12;
+        
+        //==============================================================================================================
+        explicit Gutter(CodeEditor &editor);
+        
+        //==============================================================================================================
+        void paint(juce::Graphics &g) override;
+        void mouseDown(const juce::MouseEvent &event) override;
+        
+        //==============================================================================================================
+        /** Sets the font of the line numbers. */
+        void setFont(const juce::Font &font);
+        
+        /** Gets the width that fits the icons, the fold markers and the number of the last line. */
+        int getNeededWidth() const noexcept;
+        
+        /**
+            Recounts the digits of the last line number.
+            
+            @return True if the count changed, in which case the gutter needs a different width
+         */
+        bool updateDigitCount();
+        
+        /**
+            Repaints the rows of a range of lines.
+            If the range ends at the document's last line, the space below it is repainted too, as it may have held
+            lines that were removed.
+         */
+        void repaintLines(int firstLine, int lastLine);
+        
+    private:
+        /** The most severe diagnostic of a line. */
+        enum class Icon : std::uint8_t
+        {
+            None,
+            Warning,
+            Error
+        };
+        
+        //==============================================================================================================
+        CodeEditor      &editor;
+        DigitGlyphCache digits;
+        int             numDigits { 1 };
+        
+        // Reused for every paint
+        std::vector<Icon> lineIcons;
+        
+        //==============================================================================================================
+        /** Gets where the top of the editor's content is in this component. */
+        double getContentY() const noexcept;
+        
+        void collectIcons(int firstLine, int lastLine);
+        void drawIcon(juce::Graphics &g, Icon icon, juce::Rectangle<float> bounds) const;
+        void drawFoldMarker(juce::Graphics &g, bool collapsed, juce::Rectangle<float> bounds) const;
+    };
+    
+    /** The overview of the document beside the vertical scroll bar, clicking or dragging it scrolls the editor. */
+    class Minimap : public juce::Component
+    {
+    public:
+        explicit Minimap(CodeEditor &editor);
+        
+        //==============================================================================================================
+        void paint(juce::Graphics &g) override;
+        void mouseDown(const juce::MouseEvent &event) override;
+        void mouseDrag(const juce::MouseEvent &event) override;
+        
+        //==============================================================================================================
+        /** Gets the line in the top row, if not all lines fit the minimap scrolls along with the editor. */
+        int getFirstLine() const noexcept;
+        
+    private:
+        CodeEditor &editor;
+        
+        //==============================================================================================================
+        void scrollTo(int y);
     };
     
     class Line
@@ -76,12 +249,6 @@ private:
             int          startPos;
         };
         
-        struct SyntaxToken
-        {
-            juce::Range<int> tokenRange;
-            int              tokenId;
-        };
-        
         struct FoldRegion
         {
             enum class Point
@@ -99,19 +266,34 @@ private:
         };
         
         //==============================================================================================================
-        void drawLine(const CodeEditor &editor, juce::Rectangle<float> bounds, int startPos) const;
+        void drawLine(juce::Graphics &g, const CodeEditor &editor, juce::Rectangle<float> bounds,
+                      int startPos) const;
+        void drawDescription(juce::Graphics &g, const CodeEditor &editor, juce::Rectangle<float> bounds,
+                             int startPos) const;
         
         //==============================================================================================================
         bool isExtendedLine() const noexcept;
+        void setDescriptionTokens(std::vector<DescriptionToken> newTokens) noexcept;
         
         //==============================================================================================================
+        FoldRegion&         getFoldRegion()       noexcept;
         const FoldRegion&   getFoldRegion() const noexcept;
         const juce::String& getLineText()   const noexcept;
+        void                setLineText(juce::String newText) noexcept;
+        
+        /** Gets where this line's tokens are in the editor's token arena. */
+        TokenArena::Run getTokens() const noexcept { return tokens; }
+        void            setTokens(TokenArena::Run newTokens) noexcept { tokens = newTokens; }
+        
+        /** Gets the rules that are still open at the end of this line, the next line is tokenized from there. */
+        const TextMateTokenizer::State& getEndState() const noexcept { return endState; }
+        void                            setEndState(TextMateTokenizer::State newState) noexcept;
         
         
     private:
         std::vector<DescriptionToken> descriptionTokens;
-        std::vector<SyntaxToken>      tokens;
+        TokenArena::Run               tokens;
+        TextMateTokenizer::State      endState;
         juce::String                  lineText;
         FoldRegion                    foldRegion { {}, FoldRegion::Point::None, 0, false };
     };
@@ -121,21 +303,27 @@ private:
         int lineIndex { -1 };
     };
     
-    struct DocumentCaret
+    enum class TextUpdateMode
     {
-        juce::CodeDocument::Position position;
-        juce::CaretComponent         caret;
+        Resized
     };
     
-    struct SchemeEntry
+    struct DecorationGroup
     {
-        juce::Colour colour;
-        int          styleFlags;
+        enum : std::uint16_t
+        {
+            Search,
+            DiagnosticWarning,
+            DiagnosticError
+        };
     };
     
-    enum class TextUpdateMode
+    /** The region changed by one or more edits, in offsets before and after them. */
+    struct EditSpan
     {
-        Resized
+        int start;
+        int oldEnd;
+        int newEnd;
     };
     
     //==================================================================================================================
@@ -143,14 +331,44 @@ private:
     
     juce::ScrollBar scrollBarRight;
     juce::ScrollBar scrollBarBottom;
-    DocumentCaret   mainCaret;
     Gutter          gutter;
+    Minimap         minimap;
     
     // Lines
-    std::vector<Line>          lines;
-    std::vector<SchemeEntry>   scheme;
-    std::vector<DocumentCaret> carets;
-    std::array<int, 4>         rulers {};
+    std::vector<Line>  lines;
+    CaretList          carets;
+    std::array<int, 4> rulers {};
+    
+    // The start lines of the collapsed regions and the lines with a description, they have to move along when lines
+    // are added or removed above them
+    std::vector<int> collapsedFolds;
+    std::vector<int> describedLines;
+    
+    // Tokens refer to their style by the index of an entry in the matcher's scheme
+    TokenArena                         tokenArena;
+    TextMateScopeStacks                scopeStacks;
+    TextMateThemeMatcher               themeMatcher { scopeStacks };
+    std::unique_ptr<TextMateTokenizer> tokenizer;
+    
+    SyntaxTree   syntaxTree;
+    FoldIndex    foldIndex;
+    FoldProvider foldProvider;
+    
+    // Every line is summarized once for the minimap and only summarized again when it changes
+    MinimapModel minimapModel;
+    
+    // Searches run on snapshots of a mirror of the document, which is cheap to copy
+    TextRope                      text;
+    TextSearch                    search;
+    SearchQuery                   searchQuery;
+    std::vector<juce::Range<int>> pendingMatches;
+    
+    // The document's own undo manager is kept from growing, edits are recorded here instead
+    UndoHistory history;
+    int         lastEditPosition { -1 };
+    
+    DecorationStore    decorations;
+    DecorationPipeline decorationPipeline;
     
     juce::Rectangle<int> editorBounds;
     juce::Font           font;
@@ -158,25 +376,75 @@ private:
     float charWidth;
     float lineSpacing;
     
-    bool readOnly      { false };
-    bool scrollPastEnd { false };
+    EditSpan pendingEdit { -1, -1, -1 };
+    
+    bool readOnly           { false };
+    bool scrollPastEnd      { false };
+    bool caretsVisible      { true };
+    bool batchingEdits      { false };
+    bool shiftCaretsOnEdits { true };
+    bool hasSearchQuery     { false };
+    bool applyingHistory    { false };
     
     //==================================================================================================================
     void drawFoldedLine(juce::Graphics &g, juce::Rectangle<float> bounds,
                         const Line &startLine, const Line &endLine, int startPos);
+    void collectDecorations(int firstLine, int lastLine);
+    void drawSelections(juce::Graphics &g, int firstLine, int lastLine) const;
+    void drawCarets    (juce::Graphics &g, int firstLine, int lastLine) const;
+    
+    /** Calls back with the bounds of every row a range of the document covers. */
+    template<class Fn>
+    void forEachRowOf(juce::Range<int> range, Fn &&callback) const;
+    
+    juce::Range<int>       getOffsetRange(int firstLine, int lastLine) const;
+    juce::Range<int>       getDiagnosticRange(const XmlDiagnostic &diagnostic) const;
+    juce::Rectangle<float> getCharacterBounds(int line, int column) const noexcept;
     
     //==================================================================================================================
     bool keyPressed(const juce::KeyPress &key) override;
+    void mouseDown(const juce::MouseEvent &event) override;
+    void mouseDrag(const juce::MouseEvent &event) override;
+    void timerCallback() override;
+    void scrollBarMoved(juce::ScrollBar *scrollBar, double newRangeStart) override;
+    
+    /** Runs a group of edits as one, the document structure is only updated once they are all done. */
+    template<class Fn>
+    void batchEdits(bool shiftCarets, Fn &&edit);
+    
+    /** Runs the edits of a keystroke, they are undone together with the keystrokes of the same kind before it. */
+    template<class Fn>
+    void recordEdits(UndoHistory::EditKind kind, Fn &&edit);
+    
+    void applyHistory(const std::vector<UndoHistory::Edit> &edits);
     
     //==================================================================================================================
     void codeDocumentTextInserted(const juce::String&, int) override;
     void codeDocumentTextDeleted(int, int) override;
     
+    void handleEdit(int start, int removedLength, int insertedLength);
+    void flushEdits();
+    
     //==================================================================================================================
+    void updateLines(int firstLine, int numNewLines);
+    void updateLineTexts(int firstLine, int numLines);
+    void expandFoldsIn(juce::Range<int> lineRange);
+    void shiftFolds(int firstLine, int difference);
+    void shiftDescriptions(int firstLine, int difference);
+    void runSearch(bool replaceWhenFinished);
+    void rescanLines(int firstLine, int lastLine);
+    void addSearchMatches(const std::vector<juce::Range<int>> &matches);
     void updateScrollBars();
+    void updateMinimapLines(int firstLine, int numLines);
+    void updateMinimapColours();
     
     //==================================================================================================================
     void fillSchemeList(const TextMateGrammar &grammar);
     
+    //==================================================================================================================
+    int  tokenizeLines(int firstLine, int numLines);
+    void setLineTokens(int lineIndex, const TokenArena::Builder &builder);
+    void compactTokens();
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CodeEditor)
 };
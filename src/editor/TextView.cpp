@@ -33,69 +33,16 @@
 //**********************************************************************************************************************
 // region TextView
 //======================================================================================================================
-//======================================================================================================================
-// region Line
-//======================================================================================================================
-void TextView::Line::addToken(Token newToken)
-{
-    tokens.emplace_back(newToken);
-}
-
-//======================================================================================================================
-void TextView::Line::updateSize(const juce::Font &font, double lineSpacingFactor)
-{
-    size.width  = font.getStringWidthFloat(text);
-    size.height = font.getHeight() * lineSpacingFactor;
-}
-
-//======================================================================================================================
-const juce::String& TextView::Line::getText() const noexcept
-{
-    return text;
-}
-
-TextView::Token TextView::Line::getToken(int index) const noexcept
-{ 
-    return tokens[static_cast<std::size_t>(index)];
-}
-
-juce::String TextView::Line::getTokenText(int index) const noexcept
-{
-    const int num_tokens = getNumTokens();
-    
-    if (jaut::fit(index, 0, num_tokens))
-    {
-        int token_end = text.length();
-        
-        if (index < (num_tokens - 1))
-        {
-            token_end = getToken(index + 1).startPos;
-        }
-        
-        return text.substring(getToken(index).startPos, token_end).trimEnd();
-    }
-    
-    return "";
-}
-
-//======================================================================================================================
-int TextView::Line::getNumTokens() const noexcept
-{
-    return static_cast<int>(tokens.size());
-}
-
-//======================================================================================================================
-// endregion Line
-//**********************************************************************************************************************
-// region TextView
-//======================================================================================================================
 void TextView::paint(juce::Graphics &g)
 {
-    TextViewLayout layout;
+    const float line_height = font.getHeight() * lineSpacing;
+    float       line_pos    = 0.0f;
     
     for (const auto &line : lines)
     {
-        layout.createLayout(*this, line, )
+        layout.createLayout(*this, line, static_cast<float>(getWidth()));
+        layout.draw(g, { 0.0f, line_pos, static_cast<float>(getWidth()), line_height });
+        line_pos += line_height;
     }
 }
 
@@ -133,7 +80,4 @@ void TextView::setFont(juce::Font newFont) noexcept
 }
 //======================================================================================================================
 // endregion TextView
-//======================================================================================================================
-//======================================================================================================================
-// endregion TextView
 //**********************************************************************************************************************
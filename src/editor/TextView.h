@@ -25,48 +25,18 @@
 
 #pragma once
 
+#include "render/ITextLayoutStyle.h"
+#include "render/TextLine.h"
 #include "render/TextViewLayout.h"
 
 #include <juce_gui_basics/juce_gui_basics.h>
-#include <jaut_gui/jaut_gui.h>
 
 // The text-view class for internal text and token handling
-class TextView : public juce::Component
+class TextView : public juce::Component, public ITextLayoutStyle
 {
 public:
-    struct Token
-    {
-        int startPos; // Token start pos for that line
-        int id;       // The syntax id for this token
-    };
-    
-    struct TokenType
-    {
-        juce::Colour colour;     // Colour of this token type
-        int          styleFlags; // Bit mask for juce::Font style flags
-    };
-    
-    class Line
-    {
-    public:
-        void addToken(Token newToken);
-        
-        //==============================================================================================================
-        void updateSize(const juce::Font &font, double lineSpacingFactor);
-        
-        //==============================================================================================================
-        Token               getToken(int index)     const noexcept;
-        const juce::String& getText()               const noexcept;
-        juce::String        getTokenText(int index) const noexcept;
-        
-        //==============================================================================================================
-        int getNumTokens() const noexcept;
-        
-    private:
-        std::vector<Token> tokens;
-        juce::String       text;
-        jaut::Size<double> size;
-    };
+    using Line  = TextLine;
+    using Token = TextLine::Token;
     
     //==================================================================================================================
     void paint(juce::Graphics &g) override;
@@ -83,14 +53,14 @@ public:
     }
     
     //==================================================================================================================
-    const TokenType&  getTokenType(int id) const noexcept;
-    const juce::Font& getFont()            const noexcept;
+    const TokenType&  getTokenType(int id) const noexcept override;
+    const juce::Font& getFont()            const noexcept override;
     
     //==================================================================================================================
     void setFont(juce::Font newFont) noexcept;
     
     //==================================================================================================================
-    float getLineSpacing() const noexcept { return lineSpacing; }
+    float getLineSpacing() const noexcept override { return lineSpacing; }
     
     Line&       getLine(int lineNumber)       noexcept { return lines[static_cast<std::size_t>(lineNumber)]; }
     const Line& getLine(int lineNumber) const noexcept { return lines[static_cast<std::size_t>(lineNumber)]; }
@@ -0,0 +1,67 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DiagnosticCollector.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "DiagnosticCollector.h"
+
+#include <xercesc/sax/SAXParseException.hpp>
+
+//======================================================================================================================
+DiagnosticCollector::DiagnosticCollector(std::vector<XmlDiagnostic> &destination)
+    : diagnostics(destination)
+{}
+
+//======================================================================================================================
+void DiagnosticCollector::warning(const xercesc::SAXParseException &exception)
+{
+    add(exception, XmlDiagnostic::Severity::Warning);
+}
+
+void DiagnosticCollector::error(const xercesc::SAXParseException &exception)
+{
+    add(exception, XmlDiagnostic::Severity::Error);
+}
+
+void DiagnosticCollector::fatalError(const xercesc::SAXParseException &exception)
+{
+    add(exception, XmlDiagnostic::Severity::Fatal);
+}
+
+void DiagnosticCollector::resetErrors()
+{
+    diagnostics.clear();
+}
+
+//======================================================================================================================
+void DiagnosticCollector::add(const xercesc::SAXParseException &exception, XmlDiagnostic::Severity severity)
+{
+    using CharType = juce::CharPointer_UTF16::CharType;
+    
+    diagnostics.push_back({
+        juce::String(juce::CharPointer_UTF16(reinterpret_cast<const CharType*>(exception.getMessage()))),
+        severity,
+        static_cast<int>(exception.getLineNumber()),
+        static_cast<int>(exception.getColumnNumber())
+    });
+}
@@ -0,0 +1,51 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DiagnosticCollector.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "XmlDiagnostic.h"
+
+#include <xercesc/sax/ErrorHandler.hpp>
+
+/** An error handler that records every reported problem instead of throwing. */
+class DiagnosticCollector : public xercesc::ErrorHandler
+{
+public:
+    explicit DiagnosticCollector(std::vector<XmlDiagnostic> &destination);
+    
+    //==================================================================================================================
+    void warning   (const xercesc::SAXParseException &exception) override;
+    void error     (const xercesc::SAXParseException &exception) override;
+    void fatalError(const xercesc::SAXParseException &exception) override;
+    void resetErrors() override;
+    
+private:
+    std::vector<XmlDiagnostic> &diagnostics;
+    
+    //==================================================================================================================
+    void add(const xercesc::SAXParseException &exception, XmlDiagnostic::Severity severity);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiagnosticCollector)
+};
@@ -0,0 +1,159 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   RopeInputSource.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "RopeInputSource.h"
+
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    class RopeInputStream : public xercesc::BinInputStream
+    {
+    public:
+        explicit RopeInputStream(const TextRope &parText)
+            : text(parText)
+        {}
+        
+        //==============================================================================================================
+        XMLFilePos curPos() const override
+        {
+            return static_cast<XMLFilePos>(bytesRead);
+        }
+        
+        XMLSize_t readBytes(XMLByte *const toFill, const XMLSize_t maxToRead) override
+        {
+            XMLSize_t written = 0;
+            
+            while (written < maxToRead)
+            {
+                if (pendingPos == pendingSize)
+                {
+                    if (!fillPending())
+                    {
+                        break;
+                    }
+                }
+                
+                const XMLSize_t amount = juce::jmin<XMLSize_t>(maxToRead - written, pendingSize - pendingPos);
+                std::copy_n(pending.data() + pendingPos, amount, toFill + written);
+                
+                pendingPos += amount;
+                written    += amount;
+            }
+            
+            bytesRead += written;
+            return written;
+        }
+        
+        const XMLCh* getContentType() const override
+        {
+            return nullptr;
+        }
+        
+    private:
+        static constexpr int Read_Block_Size = 1024;
+        
+        //==============================================================================================================
+        const TextRope &text;
+        
+        std::array<TextRope::Char, Read_Block_Size> block {};
+        std::array<XMLByte, Read_Block_Size * 4>    pending {};
+        
+        XMLSize_t pendingPos  { 0 };
+        XMLSize_t pendingSize { 0 };
+        XMLSize_t bytesRead   { 0 };
+        int       charPos     { 0 };
+        
+        //==============================================================================================================
+        bool fillPending()
+        {
+            const int num_chars = text.read(charPos, block.data(), Read_Block_Size);
+            
+            if (num_chars == 0)
+            {
+                return false;
+            }
+            
+            charPos     += num_chars;
+            pendingPos   = 0;
+            pendingSize  = 0;
+            
+            for (int i = 0; i < num_chars; ++i)
+            {
+                const auto c = static_cast<juce::uint32>(block[static_cast<std::size_t>(i)]);
+                
+                if (c < 0x80)
+                {
+                    pending[pendingSize++] = static_cast<XMLByte>(c);
+                }
+                else if (c < 0x800)
+                {
+                    pending[pendingSize++] = static_cast<XMLByte>(0xc0 | (c >> 6));
+                    pending[pendingSize++] = static_cast<XMLByte>(0x80 | (c & 0x3f));
+                }
+                else if (c < 0x10000)
+                {
+                    pending[pendingSize++] = static_cast<XMLByte>(0xe0 | (c >> 12));
+                    pending[pendingSize++] = static_cast<XMLByte>(0x80 | ((c >> 6) & 0x3f));
+                    pending[pendingSize++] = static_cast<XMLByte>(0x80 | (c & 0x3f));
+                }
+                else
+                {
+                    pending[pendingSize++] = static_cast<XMLByte>(0xf0 | (c >> 18));
+                    pending[pendingSize++] = static_cast<XMLByte>(0x80 | ((c >> 12) & 0x3f));
+                    pending[pendingSize++] = static_cast<XMLByte>(0x80 | ((c >> 6) & 0x3f));
+                    pending[pendingSize++] = static_cast<XMLByte>(0x80 | (c & 0x3f));
+                }
+            }
+            
+            return true;
+        }
+    };
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region RopeInputSource
+//======================================================================================================================
+RopeInputSource::RopeInputSource(TextRope parText, const juce::String &documentId)
+    : xercesc::InputSource(documentId.toRawUTF8()),
+      text(std::move(parText))
+{
+    // The stream always delivers UTF-8, whatever the xml declaration claims
+    setEncoding(xercesc::XMLUni::fgUTF8EncodingString);
+}
+
+//======================================================================================================================
+xercesc::BinInputStream* RopeInputSource::makeStream() const
+{
+    return new RopeInputStream(text);
+}
+//======================================================================================================================
+// endregion RopeInputSource
+//**********************************************************************************************************************
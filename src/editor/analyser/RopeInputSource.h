@@ -0,0 +1,48 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   RopeInputSource.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "../document/TextRope.h"
+
+#include <xercesc/sax/InputSource.hpp>
+
+/**
+    A xerces input source that streams a TextRope as UTF-8 without first flattening it into one big string.
+    The rope is copied on construction, which only shares its chunks.
+ */
+class RopeInputSource : public xercesc::InputSource
+{
+public:
+    RopeInputSource(TextRope text, const juce::String &documentId);
+    
+    //==================================================================================================================
+    xercesc::BinInputStream* makeStream() const override;
+    
+private:
+    TextRope text;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RopeInputSource)
+};
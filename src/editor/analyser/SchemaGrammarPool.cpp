@@ -0,0 +1,255 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   SchemaGrammarPool.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "SchemaGrammarPool.h"
+#include "DiagnosticCollector.h"
+
+#include <xercesc/framework/XMLGrammarPoolImpl.hpp>
+#include <xercesc/internal/BinFileOutputStream.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/util/BinFileInputStream.hpp>
+#include <xercesc/util/OutOfMemoryException.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    constexpr const char *Cache_File_Prefix    = "schemas-";
+    constexpr const char *Cache_File_Extension = ".grammar";
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region SchemaGrammarPool
+//======================================================================================================================
+SchemaGrammarPool::SchemaGrammarPool(juce::File parCacheDirectory)
+    : pool(std::make_unique<xercesc::XMLGrammarPoolImpl>(xercesc::XMLPlatformUtils::fgMemoryManager)),
+      cacheDirectory(std::move(parCacheDirectory))
+{}
+
+SchemaGrammarPool::~SchemaGrammarPool() = default;
+
+//======================================================================================================================
+int SchemaGrammarPool::load(const juce::Array<juce::File> &schemaFiles)
+{
+    loadError.clear();
+    
+    if (schemaFiles.isEmpty())
+    {
+        return LoadStatus::NoSchemas;
+    }
+    
+    if (loaded)
+    {
+        pool->unlockPool();
+        pool->clear();
+        loaded = false;
+    }
+    
+    // Directory listings come in no particular order, sorting keeps the cache key and the compile order stable
+    juce::Array<juce::File> sorted_files(schemaFiles);
+    sorted_files.sort();
+    
+    const juce::File cache_file = getCacheFile(sorted_files);
+    
+    if (loadFromCache(cache_file))
+    {
+        pool->lockPool();
+        loaded = true;
+        return LoadStatus::LoadedFromCache;
+    }
+    
+    if (!compileSchemas(sorted_files))
+    {
+        pool->clear();
+        return LoadStatus::CompilationFailed;
+    }
+    
+    pool->lockPool();
+    loaded = true;
+    
+    writeCache(cache_file);
+    return LoadStatus::Compiled;
+}
+
+//======================================================================================================================
+bool SchemaGrammarPool::isLoaded() const noexcept
+{
+    return loaded;
+}
+
+xercesc::XMLGrammarPool* SchemaGrammarPool::getPool() const noexcept
+{
+    return loaded ? pool.get() : nullptr;
+}
+
+const juce::String& SchemaGrammarPool::getLoadError() const noexcept
+{
+    return loadError;
+}
+
+//======================================================================================================================
+juce::File SchemaGrammarPool::getCacheFile(const juce::Array<juce::File> &schemaFiles) const
+{
+    // The cache is keyed by every schema's path, size and modification time, so touching any of them
+    // makes the old cache file unreachable and forces a recompile
+    juce::String key;
+    
+    for (const auto &file : schemaFiles)
+    {
+        key << file.getFullPathName() << ':'
+            << file.getSize()         << ':'
+            << file.getLastModificationTime().toMilliseconds() << ';';
+    }
+    
+    return cacheDirectory.getChildFile(Cache_File_Prefix + juce::String::toHexString(key.hashCode64())
+                                       + Cache_File_Extension);
+}
+
+//======================================================================================================================
+bool SchemaGrammarPool::loadFromCache(const juce::File &cacheFile)
+{
+    if (!cacheFile.existsAsFile())
+    {
+        return false;
+    }
+    
+    try
+    {
+        xercesc::BinFileInputStream input(cacheFile.getFullPathName().toRawUTF8());
+        
+        if (!input.getIsOpen())
+        {
+            return false;
+        }
+        
+        pool->deserializeGrammars(&input);
+        return true;
+    }
+    catch (const xercesc::XMLException&)
+    {}
+    catch (const xercesc::OutOfMemoryException&)
+    {}
+    
+    // A stale or corrupted cache is not an error, we just compile again and overwrite it
+    pool->clear();
+    (void) cacheFile.deleteFile();
+    return false;
+}
+
+bool SchemaGrammarPool::compileSchemas(const juce::Array<juce::File> &schemaFiles)
+{
+    xercesc::XercesDOMParser parser(nullptr, xercesc::XMLPlatformUtils::fgMemoryManager, pool.get());
+    parser.setValidationScheme(xercesc::XercesDOMParser::Val_Always);
+    parser.setDoNamespaces(true);
+    parser.setDoSchema(true);
+    parser.setValidationSchemaFullChecking(true);
+    parser.setHandleMultipleImports(true);
+    
+    std::vector<XmlDiagnostic> problems;
+    DiagnosticCollector        collector(problems);
+    parser.setErrorHandler(&collector);
+    
+    for (const auto &file : schemaFiles)
+    {
+        const juce::String path = file.getFullPathName();
+        
+        try
+        {
+            const bool compiled = parser.loadGrammar(path.toRawUTF8(), xercesc::Grammar::SchemaGrammarType, true);
+            
+            // Warnings don't stop a schema from compiling, only the first real problem is worth reporting
+            const auto problem = std::find_if(problems.begin(), problems.end(), [](const XmlDiagnostic &diagnostic)
+            {
+                return diagnostic.severity != XmlDiagnostic::Severity::Warning;
+            });
+            
+            if (problem != problems.end())
+            {
+                loadError << path << ':' << problem->line << ':' << problem->column << ": " << problem->message;
+                return false;
+            }
+            
+            if (!compiled)
+            {
+                loadError << path << ": the schema could not be read";
+                return false;
+            }
+        }
+        catch (const xercesc::XMLException &ex)
+        {
+            using CharType = juce::CharPointer_UTF16::CharType;
+            loadError << path << ": "
+                      << juce::String(juce::CharPointer_UTF16(reinterpret_cast<const CharType*>(ex.getMessage())));
+            return false;
+        }
+        catch (const xercesc::OutOfMemoryException&)
+        {
+            loadError << path << ": out of memory";
+            return false;
+        }
+        
+        problems.clear();
+    }
+    
+    return true;
+}
+
+void SchemaGrammarPool::writeCache(const juce::File &cacheFile)
+{
+    if (!cacheDirectory.createDirectory())
+    {
+        return;
+    }
+    
+    // Write next to the target first, so a crash mid-write never leaves a truncated cache that looks valid
+    const juce::File temp_file = cacheFile.getSiblingFile(cacheFile.getFileName() + ".tmp");
+    bool             success   = false;
+    
+    try
+    {
+        xercesc::BinFileOutputStream output(temp_file.getFullPathName().toRawUTF8());
+        
+        if (output.getIsOpen())
+        {
+            pool->serializeGrammars(&output);
+            success = true;
+        }
+    }
+    catch (const xercesc::XMLException&)
+    {}
+    catch (const xercesc::OutOfMemoryException&)
+    {}
+    
+    if (!success || !temp_file.moveFileTo(cacheFile))
+    {
+        (void) temp_file.deleteFile();
+    }
+}
+//======================================================================================================================
+// endregion SchemaGrammarPool
+//**********************************************************************************************************************
@@ -0,0 +1,102 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   SchemaGrammarPool.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <xercesc/util/XercesDefs.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+class XMLGrammarPool;
+class XMLGrammarPoolImpl;
+XERCES_CPP_NAMESPACE_END
+
+/**
+    Holds the compiled XSD grammars for all schemas known to the analyser.
+    
+    Schemas are compiled once (or restored from a serialized cache file) and the pool is locked afterwards,
+    so every parser created with it can share the grammars read-only, even across threads.
+ */
+class SchemaGrammarPool
+{
+public:
+    struct LoadStatus
+    {
+        enum
+        {
+            LoadedFromCache,
+            Compiled,
+            NoSchemas,
+            CompilationFailed
+        };
+    };
+    
+    //==================================================================================================================
+    /**
+        Creates a new, empty grammar pool.
+        Xerces must have been initialised before an instance of this class is created.
+        
+        @param cacheDirectory The directory serialized grammar sets will be written to and read from
+     */
+    explicit SchemaGrammarPool(juce::File cacheDirectory);
+    ~SchemaGrammarPool();
+    
+    //==================================================================================================================
+    /**
+        Loads the given schemas into the pool and locks it.
+        If a cache file for exactly this set of schemas exists, the grammars will be deserialized from there instead
+        of being compiled again, otherwise they are compiled and the result is written to the cache.
+        The order of the files doesn't matter, the same set always finds the same cache file.
+        
+        @param schemaFiles The xsd files to load
+        @return One of LoadStatus
+     */
+    int load(const juce::Array<juce::File> &schemaFiles);
+    
+    //==================================================================================================================
+    /** Gets whether the pool contains grammars and was locked. */
+    bool isLoaded() const noexcept;
+    
+    /** Gets the underlying xerces pool, this is nullptr until load() succeeded. */
+    xercesc::XMLGrammarPool* getPool() const noexcept;
+    
+    /** Gets why the last call to load() failed to compile the schemas, or an empty string if it didn't. */
+    const juce::String& getLoadError() const noexcept;
+    
+private:
+    std::unique_ptr<xercesc::XMLGrammarPoolImpl> pool;
+    juce::File   cacheDirectory;
+    juce::String loadError;
+    bool         loaded { false };
+    
+    //==================================================================================================================
+    juce::File getCacheFile(const juce::Array<juce::File> &schemaFiles) const;
+    
+    bool loadFromCache(const juce::File &cacheFile);
+    bool compileSchemas(const juce::Array<juce::File> &schemaFiles);
+    void writeCache(const juce::File &cacheFile);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SchemaGrammarPool)
+};
@@ -0,0 +1,93 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   SpscQueue.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+
+/**
+    A fixed-size, lock-free queue for exactly one producer thread and one consumer thread.
+    
+    Neither side ever blocks or allocates, a full queue simply refuses new items. The producer only ever writes
+    the tail and the consumer only ever writes the head, each on its own cache line so they don't contend.
+ */
+template<class T, std::size_t Capacity>
+class SpscQueue
+{
+public:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    
+    //==================================================================================================================
+    SpscQueue() = default;
+    
+    //==================================================================================================================
+    /**
+        Moves an item into the queue, this must only be called from the producer thread.
+        
+        @return False if the queue was full, in which case the item is left untouched
+     */
+    bool push(T &item)
+    {
+        const std::size_t tail_index = tail.load(std::memory_order_relaxed);
+        
+        if (tail_index - head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        
+        slots[tail_index & (Capacity - 1)] = std::move(item);
+        tail.store(tail_index + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+        Moves the oldest item out of the queue, this must only be called from the consumer thread.
+        
+        @return False if the queue was empty
+     */
+    bool pop(T &item)
+    {
+        const std::size_t head_index = head.load(std::memory_order_relaxed);
+        
+        if (head_index == tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        
+        item = std::move(slots[head_index & (Capacity - 1)]);
+        head.store(head_index + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> slots;
+    
+    alignas(64) std::atomic<std::size_t> head { 0 };
+    alignas(64) std::atomic<std::size_t> tail { 0 };
+    
+    JUCE_DECLARE_NON_COPYABLE(SpscQueue)
+};
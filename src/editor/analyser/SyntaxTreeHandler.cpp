@@ -0,0 +1,243 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   SyntaxTreeHandler.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "SyntaxTreeHandler.h"
+
+#include <xercesc/sax/Locator.hpp>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    juce::String toJuceString(const XMLCh *text)
+    {
+        using CharType = juce::CharPointer_UTF16::CharType;
+        return juce::String(juce::CharPointer_UTF16(reinterpret_cast<const CharType*>(text)));
+    }
+    
+    bool isNameChar(juce::juce_wchar c) noexcept
+    {
+        return c != 0 && c != '=' && c != '/' && c != '>' && !juce::CharacterFunctions::isWhitespace(c);
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region SyntaxTreeHandler
+//======================================================================================================================
+SyntaxTreeHandler::SyntaxTreeHandler(SyntaxTree &tree, const TextRope &parText)
+    : builder(tree), text(parText)
+{
+    lineStarts.emplace_back(0);
+    
+    std::array<TextRope::Char, 4096> block {};
+    
+    for (int offset = 0; offset < text.getLength();)
+    {
+        const int num_read = text.read(offset, block.data(), static_cast<int>(block.size()));
+        
+        for (int i = 0; i < num_read; ++i)
+        {
+            const TextRope::Char character = block[static_cast<std::size_t>(i)];
+            
+            if (character == '\n')
+            {
+                lineStarts.emplace_back(offset + i + 1);
+            }
+            else if (character > 0xffff)
+            {
+                wideChars.emplace_back(offset + i);
+            }
+        }
+        
+        offset += num_read;
+    }
+}
+
+//======================================================================================================================
+void SyntaxTreeHandler::finish()
+{
+    builder.finish(text.getLength());
+}
+
+//======================================================================================================================
+void SyntaxTreeHandler::setDocumentLocator(const xercesc::Locator *parLocator)
+{
+    locator = parLocator;
+}
+
+void SyntaxTreeHandler::startElement(const XMLCh*, const XMLCh*, const XMLCh *qualifiedName,
+                                     const xercesc::Attributes&)
+{
+    const int  tag_end      = getLocatorOffset();
+    const int  tag_start    = findTagStart(tag_end);
+    const bool self_closing = text.getCharAt(tag_end - 2) == '/';
+    
+    builder.openElement(::toJuceString(qualifiedName), tag_start);
+    addAttributes(tag_start, tag_end);
+    builder.finishStartTag(tag_end, self_closing);
+    
+    // SAX reports <a/> as a start and an end event at the same position, the builder closed it already
+    skipNextEnd = self_closing;
+}
+
+void SyntaxTreeHandler::endElement(const XMLCh*, const XMLCh*, const XMLCh*)
+{
+    if (std::exchange(skipNextEnd, false))
+    {
+        return;
+    }
+    
+    const int tag_end = getLocatorOffset();
+    builder.closeElement(findTagStart(tag_end), tag_end);
+}
+
+void SyntaxTreeHandler::comment(const XMLCh *chars, XMLSize_t length)
+{
+    // The length is in utf-16 units as well, the second half of a surrogate pair is no character of its own
+    const int num_chars = static_cast<int>(std::count_if(chars, chars + length, [](XMLCh unit)
+    {
+        return unit < 0xdc00 || unit > 0xdfff;
+    }));
+    
+    const int end = getLocatorOffset();
+    builder.addLeaf(SyntaxTree::NodeType::Comment, { end - num_chars - 7, end });
+}
+
+//======================================================================================================================
+int SyntaxTreeHandler::getLocatorOffset() const noexcept
+{
+    if (!locator)
+    {
+        return 0;
+    }
+    
+    const auto line   = static_cast<std::size_t>(juce::jmax<XMLFileLoc>(1, locator->getLineNumber()));
+    const auto column = static_cast<int>(juce::jmax<XMLFileLoc>(1, locator->getColumnNumber()));
+    
+    if (line > lineStarts.size())
+    {
+        return text.getLength();
+    }
+    
+    // Xerces counts columns in utf-16 units, where a character outside the BMP takes two of them; the target is the
+    // column's position in utf-16 units from the start of the text, the wide characters before it are taken off again
+    const int  line_start = lineStarts[line - 1];
+    const auto first_wide = std::lower_bound(wideChars.begin(), wideChars.end(), line_start) - wideChars.begin();
+    const int  target     = line_start + static_cast<int>(first_wide) + column - 1;
+    
+    // The utf-16 position of the i-th wide character is its offset plus i, which grows with i
+    std::size_t low  = static_cast<std::size_t>(first_wide);
+    std::size_t high = wideChars.size();
+    
+    while (low < high)
+    {
+        const std::size_t middle = (low + high) / 2;
+        
+        if (wideChars[middle] + static_cast<int>(middle) < target)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    
+    return juce::jmin(text.getLength(), target - static_cast<int>(low));
+}
+
+int SyntaxTreeHandler::findTagStart(int end) const noexcept
+{
+    // '<' can't appear unescaped inside a tag of a well-formed document, so the first one before the end is ours
+    for (int i = end - 1; i >= 0; --i)
+    {
+        if (text.getCharAt(i) == '<')
+        {
+            return i;
+        }
+    }
+    
+    return 0;
+}
+
+//======================================================================================================================
+void SyntaxTreeHandler::addAttributes(int tagStart, int tagEnd)
+{
+    int pos = tagStart + 1;
+    
+    // Skip the element name
+    while (pos < tagEnd && ::isNameChar(text.getCharAt(pos)))
+    {
+        ++pos;
+    }
+    
+    for (;;)
+    {
+        while (pos < tagEnd && juce::CharacterFunctions::isWhitespace(text.getCharAt(pos)))
+        {
+            ++pos;
+        }
+        
+        const int name_start = pos;
+        
+        while (pos < tagEnd && ::isNameChar(text.getCharAt(pos)))
+        {
+            ++pos;
+        }
+        
+        if (pos == name_start)
+        {
+            return;
+        }
+        
+        const juce::Range<int> name_range(name_start, pos);
+        
+        while (pos < tagEnd && text.getCharAt(pos) != '=')
+        {
+            ++pos;
+        }
+        
+        while (pos < tagEnd && text.getCharAt(pos) != '"' && text.getCharAt(pos) != '\'')
+        {
+            ++pos;
+        }
+        
+        const juce::juce_wchar quote       = text.getCharAt(pos++);
+        const int              value_start = pos;
+        
+        while (pos < tagEnd && text.getCharAt(pos) != quote)
+        {
+            ++pos;
+        }
+        
+        builder.addAttribute(text.getText(name_range), name_range, { value_start, pos });
+        ++pos;
+    }
+}
+//======================================================================================================================
+// endregion SyntaxTreeHandler
+//**********************************************************************************************************************
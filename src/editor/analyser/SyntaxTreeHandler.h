@@ -0,0 +1,71 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   SyntaxTreeHandler.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "../document/TextRope.h"
+#include "../syntax/SyntaxTree.h"
+
+#include <xercesc/sax2/DefaultHandler.hpp>
+
+/**
+    Builds a SyntaxTree from the events of the analyser's SAX pass.
+    
+    SAX only reports where an event ended, so tag starts and attribute positions are recovered from the text itself.
+    That is only reliable for well-formed parts of the document, everything after a fatal error is missing.
+ */
+class SyntaxTreeHandler : public xercesc::DefaultHandler
+{
+public:
+    SyntaxTreeHandler(SyntaxTree &tree, const TextRope &text);
+    
+    //==================================================================================================================
+    /** Closes all elements still open, this must be called after parsing even if the parse failed. */
+    void finish();
+    
+    //==================================================================================================================
+    void setDocumentLocator(const xercesc::Locator *locator) override;
+    
+    void startElement(const XMLCh *uri, const XMLCh *localName, const XMLCh *qualifiedName,
+                      const xercesc::Attributes &attributes) override;
+    void endElement(const XMLCh *uri, const XMLCh *localName, const XMLCh *qualifiedName) override;
+    void comment(const XMLCh *chars, XMLSize_t length) override;
+    
+private:
+    SyntaxTree::Builder    builder;
+    const TextRope         &text;
+    const xercesc::Locator *locator { nullptr };
+    std::vector<int>       lineStarts;
+    std::vector<int>       wideChars; // Offsets of the characters outside the BMP
+    bool                   skipNextEnd { false };
+    
+    //==================================================================================================================
+    int getLocatorOffset() const noexcept;
+    int findTagStart(int end) const noexcept;
+    
+    void addAttributes(int tagStart, int tagEnd);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SyntaxTreeHandler)
+};
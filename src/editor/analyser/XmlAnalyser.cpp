@@ -24,18 +24,90 @@
  */
 
 #include "XmlAnalyser.h"
+#include "XmlValidator.h"
 
+#include <xercesc/sax2/SAX2XMLReader.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
-#include <xercesc/parsers/XercesDOMParser.hpp>
-#include <xercesc/sax/HandlerBase.hpp>
 
 //======================================================================================================================
-XmlAnalyser::XmlAnalyser()
-    : juce::Thread("XAML-ANALYSER")
+namespace
+{
+    /** Turns the utf-16 columns xerces reports into character columns, a character outside the BMP takes two units. */
+    void toCharacterColumns(const TextRope &text, std::vector<XmlDiagnostic> &diagnostics)
+    {
+        std::vector<XmlDiagnostic*> pending;
+        pending.reserve(diagnostics.size());
+        
+        for (auto &diagnostic : diagnostics)
+        {
+            pending.emplace_back(&diagnostic);
+        }
+        
+        std::sort(pending.begin(), pending.end(), [](const XmlDiagnostic *left, const XmlDiagnostic *right)
+        {
+            return std::tie(left->line, left->column) < std::tie(right->line, right->column);
+        });
+        
+        auto next  = pending.begin();
+        int  line  = 1;
+        int  units = 0;
+        int  chars = 0;
+        
+        // Everything still pending on the current line lies at or past its end, the columns past it are kept as is
+        const auto resolve_line = [&next, &pending, &line, &units, &chars]
+        {
+            for (; next != pending.end() && (*next)->line <= line; ++next)
+            {
+                (*next)->column = chars + juce::jmax(1, (*next)->column - units);
+            }
+        };
+        
+        std::array<TextRope::Char, 4096> block {};
+        
+        for (int offset = 0; offset < text.getLength() && next != pending.end();)
+        {
+            const int num_read = text.read(offset, block.data(), static_cast<int>(block.size()));
+            
+            for (int i = 0; i < num_read && next != pending.end(); ++i)
+            {
+                for (; next != pending.end() && (*next)->line == line && (*next)->column - 1 <= units; ++next)
+                {
+                    (*next)->column = chars + 1;
+                }
+                
+                const TextRope::Char character = block[static_cast<std::size_t>(i)];
+                
+                if (character == '\n')
+                {
+                    resolve_line();
+                    ++line;
+                    units = 0;
+                    chars = 0;
+                }
+                else
+                {
+                    units += character > 0xffff ? 2 : 1;
+                    ++chars;
+                }
+            }
+            
+            offset += num_read;
+        }
+        
+        resolve_line();
+    }
+}
+
+//======================================================================================================================
+XmlAnalyser::XmlAnalyser(juce::File parSchemaDirectory, juce::File parCacheDirectory)
+    : juce::Thread("XAML-ANALYSER"),
+      schemaDirectory(std::move(parSchemaDirectory)),
+      cacheDirectory (std::move(parCacheDirectory))
 {
     try
     {
         xercesc::XMLPlatformUtils::Initialize();
+        grammarPool = std::make_unique<SchemaGrammarPool>(cacheDirectory);
     }
     catch (const xercesc::XMLException &ex)
     {
@@ -52,24 +124,205 @@ XmlAnalyser::~XmlAnalyser()
         DBG("CLEAN EXIT");
     }
     
+    cancelPendingUpdate();
+    
+    documents.clear();
+    grammarPool.reset();
     xercesc::XMLPlatformUtils::Terminate();
 }
 
 //======================================================================================================================
-void XmlAnalyser::run()
+std::unique_ptr<xercesc::SAX2XMLReader> XmlAnalyser::createSaxReader() const
+{
+    return XmlValidator::createSaxReader(grammarPool.get());
+}
+
+//======================================================================================================================
+void XmlAnalyser::postMessage(std::unique_ptr<jaut::IMessage> message)
 {
-    xercesc::XercesDOMParser parser;
-    parser.setValidationScheme(xercesc::XercesDOMParser::Val_Always);
-    parser.setDoNamespaces(true);
-    parser.setValidationSchemaFullChecking(true);
+    {
+        const juce::ScopedLock lock(messageQueueLock);
+        messageQueue.emplace_back(std::move(message));
+    }
     
-    xercesc::HandlerBase handler;
-    parser.setErrorHandler(&handler);
+    notify();
+}
+
+//======================================================================================================================
+void XmlAnalyser::addListener(Listener *listener)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    listeners.add(listener);
+}
+
+void XmlAnalyser::removeListener(Listener *listener)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    listeners.remove(listener);
+}
+
+//======================================================================================================================
+XmlAnalyser::Document& XmlAnalyser::openDocument(const juce::String &documentId, const juce::String &text,
+                                                 int revision)
+{
+    Document &document = documents[documentId];
+    document          = Document();
+    document.text     = TextRope(text);
+    document.revision = revision;
+    return document;
+}
+
+void XmlAnalyser::closeDocument(const juce::String &documentId)
+{
+    documents.erase(documentId);
+}
+
+XmlAnalyser::Document* XmlAnalyser::getDocument(const juce::String &documentId) noexcept
+{
+    const auto it = documents.find(documentId);
+    return it != documents.end() ? &it->second : nullptr;
+}
+
+//======================================================================================================================
+void XmlAnalyser::validateDocument(const juce::String &documentId, Document &document)
+{
+    if (!validator)
+    {
+        validator = std::make_unique<XmlValidator>(grammarPool.get());
+    }
     
-    XMLCh ch;
+    validator->validate(document.text, documentId, document.diagnostics, &document.syntaxTree);
+    toCharacterColumns(document.text, document.diagnostics);
     
-    try
+    if (schemaProblem)
     {
-        parser.parse
+        document.diagnostics.insert(document.diagnostics.begin(), *schemaProblem);
     }
+    
+    publishDiagnostics(documentId, document);
+}
+
+void XmlAnalyser::requestResync(const juce::String &documentId, Document &document)
+{
+    if (std::exchange(document.desynced, true))
+    {
+        return;
+    }
+    
+    unpublishedBatches.emplace_back(new DiagnosticBatch{ documentId, document.diagnostics, document.revision, true });
+    flushUnpublishedBatches();
+}
+
+//======================================================================================================================
+void XmlAnalyser::publishDiagnostics(const juce::String &documentId, const Document &document)
+{
+    // A batch that is still waiting for room in the queue would only be replaced by this one anyway
+    unpublishedBatches.erase(std::remove_if(unpublishedBatches.begin(), unpublishedBatches.end(),
+                                            [&documentId](const BatchPtr &batch)
+                                            {
+                                                return batch->documentId == documentId;
+                                            }),
+                             unpublishedBatches.end());
+    
+    unpublishedBatches.emplace_back(new DiagnosticBatch{ documentId, document.diagnostics, document.revision });
+    flushUnpublishedBatches();
+}
+
+void XmlAnalyser::flushUnpublishedBatches()
+{
+    bool published = false;
+    
+    while (!unpublishedBatches.empty() && publishQueue.push(unpublishedBatches.front()))
+    {
+        unpublishedBatches.pop_front();
+        published = true;
+    }
+    
+    if (published)
+    {
+        triggerAsyncUpdate();
+    }
+}
+
+void XmlAnalyser::handleAsyncUpdate()
+{
+    // Only the newest batch of every document is worth delivering, the ones before it are outdated already;
+    // the queue is first in, first out and there is only one producer, so the last one popped is the newest
+    std::vector<BatchPtr> newest;
+    BatchPtr              batch;
+    
+    while (publishQueue.pop(batch))
+    {
+        const auto it = std::find_if(newest.begin(), newest.end(), [&batch](const BatchPtr &other)
+        {
+            return other->documentId == batch->documentId;
+        });
+        
+        if (it != newest.end())
+        {
+            *it = std::move(batch);
+        }
+        else
+        {
+            newest.emplace_back(std::move(batch));
+        }
+    }
+    
+    for (const auto &document_batch : newest)
+    {
+        listeners.call([&document_batch](Listener &listener)
+        {
+            listener.diagnosticsChanged(*document_batch);
+        });
+    }
+}
+
+//======================================================================================================================
+void XmlAnalyser::run()
+{
+    if (grammarPool)
+    {
+        // Compiling the schemas can take a while, that's why it's done here and not on the caller's thread
+        const int status = grammarPool->load(schemaDirectory.findChildFiles(juce::File::findFiles, true, "*.xsd"));
+        
+        // Documents are still checked for well-formedness then, but they have to say why validation is missing
+        if (status == SchemaGrammarPool::LoadStatus::CompilationFailed)
+        {
+            schemaProblem = XmlDiagnostic{ "The schemas could not be loaded, documents are not validated: "
+                                               + grammarPool->getLoadError(),
+                                           XmlDiagnostic::Severity::Error, 1, 1 };
+        }
+    }
+    
+    while (!threadShouldExit())
+    {
+        std::unique_ptr<jaut::IMessage> message;
+        
+        {
+            const juce::ScopedLock lock(messageQueueLock);
+            
+            if (!messageQueue.empty())
+            {
+                message = std::move(messageQueue.front());
+                messageQueue.pop_front();
+            }
+        }
+        
+        if (!message)
+        {
+            if (!unpublishedBatches.empty())
+            {
+                (void) wait(Publish_Retry_Ms);
+                flushUnpublishedBatches();
+                continue;
+            }
+            
+            (void) wait(-1);
+            continue;
+        }
+        
+        message->handleMessage(this, jaut::MessageDirection{});
+    }
+    
+    validator.reset();
 }
@@ -25,24 +25,148 @@
 
 #pragma once
 
-#include <juce_core/juce_core.h>
+#include "SchemaGrammarPool.h"
+#include "SpscQueue.h"
+#include "XmlDiagnostic.h"
+#include "../document/TextRope.h"
+#include "../syntax/SyntaxTree.h"
+
+#include <juce_events/juce_events.h>
 #include <jaut_message/jaut_message.h>
+#include <xercesc/util/XercesDefs.hpp>
 
-namespace xerces
-{
-    class DOMDocument;
-}
+#include <optional>
 
-class XmlAnalyser : private juce::Thread
+XERCES_CPP_NAMESPACE_BEGIN
+class SAX2XMLReader;
+XERCES_CPP_NAMESPACE_END
+
+class XmlValidator;
+class XmlAnalyser : private juce::Thread, private juce::AsyncUpdater, public jaut::IMessageHandler
 {
 public:
-    XmlAnalyser();
+    /** Receives the diagnostics of documents on the message thread, once they were analysed. */
+    struct Listener
+    {
+        virtual ~Listener() = default;
+        
+        //==============================================================================================================
+        /**
+            Called with the newest diagnostics of a document.
+            
+            Batches for one document arrive in the order their revisions were analysed, but revisions may be skipped
+            if newer ones were published in the meantime. A batch can still be older than the document the listener
+            sees, it's up to the listener to compare the revision.
+            If the batch needs a resync, the listener has to reopen the document with its current text and revision.
+         */
+        virtual void diagnosticsChanged(const DiagnosticBatch &batch) = 0;
+    };
+    
+    /** The analyser's own copy of an open document, only ever touched on the analyser thread. */
+    struct Document
+    {
+        TextRope                   text;
+        SyntaxTree                 syntaxTree;
+        std::vector<XmlDiagnostic> diagnostics;
+        int                        revision { 0 };
+        bool                       desynced { false };
+    };
+    
+    //==================================================================================================================
+    /** How long to wait before trying again when the message thread hasn't caught up with the published batches. */
+    static constexpr int Publish_Retry_Ms = 50;
+    
+    /** The number of batches that can be published before the message thread has to pick them up. */
+    static constexpr std::size_t Publish_Queue_Size = 32;
+    
+    //==================================================================================================================
+    /**
+        Creates the analyser and starts its thread.
+        
+        @param schemaDirectory The directory all xsd files for validation will be looked up in
+        @param cacheDirectory  The directory compiled schema grammars are cached in
+     */
+    XmlAnalyser(juce::File schemaDirectory, juce::File cacheDirectory);
     ~XmlAnalyser() override;
     
+    //==================================================================================================================
+    /**
+        Creates a new SAX reader that validates against the shared, pre-compiled schema grammars.
+        This must only be called from the analyser thread.
+     */
+    std::unique_ptr<xercesc::SAX2XMLReader> createSaxReader() const;
+    
+    //==================================================================================================================
+    /**
+        Queues a message to be handled on the analyser thread.
+        This can be called from any thread.
+     */
+    void postMessage(std::unique_ptr<jaut::IMessage> message);
+    
+    //==================================================================================================================
+    /** Adds a listener that is told about new diagnostics, this must only be called from the message thread. */
+    void addListener(Listener *listener);
+    
+    /** Removes a listener, this must only be called from the message thread. */
+    void removeListener(Listener *listener);
+    
+    //==================================================================================================================
+    /** Creates or replaces the document with the given id, this must only be called from the analyser thread. */
+    Document& openDocument(const juce::String &documentId, const juce::String &text, int revision = 0);
+    
+    /** Removes a document, this must only be called from the analyser thread. */
+    void closeDocument(const juce::String &documentId);
+    
+    /** Gets an open document or nullptr if there is none, this must only be called from the analyser thread. */
+    Document* getDocument(const juce::String &documentId) noexcept;
+    
+    //==================================================================================================================
+    /**
+        Checks a document for well-formedness and validity and replaces its diagnostics and syntax tree.
+        This streams the text through a SAX reader and allocates no DOM, which makes it cheap enough to do
+        after every edit.
+        If the schemas failed to load, the reason is reported as the first diagnostic.
+        
+        This must only be called from the analyser thread.
+     */
+    void validateDocument(const juce::String &documentId, Document &document);
+    
+    /**
+        Marks a document whose text can no longer be trusted, because an edit didn't fit it, and asks the listeners
+        to send the whole text again. Edits are dropped until then, the diagnostics of the last good revision stay.
+        
+        This must only be called from the analyser thread.
+     */
+    void requestResync(const juce::String &documentId, Document &document);
+    
 private:
-    std::vector<std::unique_ptr<xerces::DOMDocument>> documents;
+    using BatchPtr = std::unique_ptr<const DiagnosticBatch>;
+    
+    //==================================================================================================================
+    
+    std::unordered_map<juce::String, Document>  documents;
+    std::deque<std::unique_ptr<jaut::IMessage>> messageQueue;
+    juce::CriticalSection                       messageQueueLock;
+    std::unique_ptr<SchemaGrammarPool>          grammarPool;
+    std::unique_ptr<XmlValidator>               validator;
+    juce::File                                  schemaDirectory;
+    juce::File                                  cacheDirectory;
+    
+    // Set if the schemas could not be compiled, it is reported with the diagnostics of every document
+    std::optional<XmlDiagnostic> schemaProblem;
+    
+    // Batches go from the analyser thread to the message thread without a lock, those that didn't fit into the
+    // queue are held back on the analyser thread until there is room again
+    SpscQueue<BatchPtr, Publish_Queue_Size> publishQueue;
+    std::deque<BatchPtr>                    unpublishedBatches;
+    juce::ListenerList<Listener>            listeners;
     
     //==================================================================================================================
     void run() override;
+    void handleAsyncUpdate() override;
+    
+    //==================================================================================================================
+    void publishDiagnostics(const juce::String &documentId, const Document &document);
+    void flushUnpublishedBatches();
 };
 
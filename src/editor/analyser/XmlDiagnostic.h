@@ -0,0 +1,56 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   XmlDiagnostic.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+struct XmlDiagnostic
+{
+    enum class Severity
+    {
+        Warning,
+        Error,
+        Fatal
+    };
+    
+    //==================================================================================================================
+    juce::String message;
+    Severity     severity;
+    int          line;   // 1-based, as reported by xerces
+    int          column; // 1-based, in characters once published; xerces reports utf-16 units
+};
+
+/** The diagnostics of one revision of a document, a batch is never modified once it was published. */
+struct DiagnosticBatch
+{
+    juce::String               documentId;
+    std::vector<XmlDiagnostic> diagnostics;
+    int                        revision;
+    
+    // Set when the analyser lost track of the document's text, it ignores all edits until the whole text and the
+    // revision it belongs to are sent again with a MessageOpenDocument
+    bool                       needsResync { false };
+};
@@ -0,0 +1,108 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   XmlValidator.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "XmlValidator.h"
+#include "DiagnosticCollector.h"
+#include "RopeInputSource.h"
+#include "SchemaGrammarPool.h"
+#include "SyntaxTreeHandler.h"
+
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+//**********************************************************************************************************************
+// region XmlValidator
+//======================================================================================================================
+std::unique_ptr<xercesc::SAX2XMLReader> XmlValidator::createSaxReader(const SchemaGrammarPool *grammarPool)
+{
+    xercesc::XMLGrammarPool *const pool = (grammarPool ? grammarPool->getPool() : nullptr);
+    
+    std::unique_ptr<xercesc::SAX2XMLReader> reader(
+        xercesc::XMLReaderFactory::createXMLReader(xercesc::XMLPlatformUtils::fgMemoryManager, pool));
+    // Without grammars there is nothing to validate against, every element would be reported as undeclared
+    reader->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpaces, true);
+    reader->setFeature(xercesc::XMLUni::fgSAX2CoreValidation, pool != nullptr);
+    reader->setFeature(xercesc::XMLUni::fgXercesDynamic,      false);
+    
+    if (pool)
+    {
+        reader->setFeature(xercesc::XMLUni::fgXercesSchema,                  true);
+        reader->setFeature(xercesc::XMLUni::fgXercesLoadSchema,              false);
+        reader->setFeature(xercesc::XMLUni::fgXercesUseCachedGrammarInParse, true);
+        reader->setFeature(xercesc::XMLUni::fgXercesCacheGrammarFromParse,   false);
+    }
+    
+    return reader;
+}
+
+//======================================================================================================================
+XmlValidator::XmlValidator(const SchemaGrammarPool *grammarPool)
+    : saxReader(createSaxReader(grammarPool))
+{}
+
+XmlValidator::~XmlValidator() = default;
+
+//======================================================================================================================
+void XmlValidator::validate(const TextRope &text, const juce::String &systemId,
+                            std::vector<XmlDiagnostic> &diagnostics, SyntaxTree *syntaxTree)
+{
+    diagnostics.clear();
+    
+    DiagnosticCollector              collector(diagnostics);
+    std::optional<SyntaxTreeHandler> tree_handler;
+    saxReader->setErrorHandler(&collector);
+    
+    if (syntaxTree)
+    {
+        tree_handler.emplace(*syntaxTree, text);
+        saxReader->setContentHandler(&*tree_handler);
+        saxReader->setLexicalHandler(&*tree_handler);
+    }
+    
+    const RopeInputSource source(text, systemId);
+    
+    try
+    {
+        saxReader->parse(source);
+    }
+    catch (const xercesc::SAXException&)
+    {}
+    catch (const xercesc::XMLException&)
+    {}
+    
+    if (tree_handler)
+    {
+        tree_handler->finish();
+    }
+    
+    saxReader->setErrorHandler(nullptr);
+    saxReader->setContentHandler(nullptr);
+    saxReader->setLexicalHandler(nullptr);
+}
+//======================================================================================================================
+// endregion XmlValidator
+//**********************************************************************************************************************
@@ -0,0 +1,78 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   XmlValidator.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "XmlDiagnostic.h"
+#include "../document/TextRope.h"
+#include "../syntax/SyntaxTree.h"
+
+#include <xercesc/util/XercesDefs.hpp>
+
+XERCES_CPP_NAMESPACE_BEGIN
+class SAX2XMLReader;
+XERCES_CPP_NAMESPACE_END
+
+class SchemaGrammarPool;
+
+/**
+    Checks xml documents for well-formedness and validity against the schemas of a grammar pool.
+    
+    A validator keeps its SAX reader around for any number of documents, but must only be used by one thread at a
+    time. Validators on different threads can share the same pool once it was loaded, since it is locked then.
+    Xerces must have been initialised before a validator is created.
+ */
+class XmlValidator
+{
+public:
+    /**
+        Creates a SAX reader that validates against the pre-compiled grammars of a pool.
+        
+        @param grammarPool The pool to look schemas up in, or nullptr to only check for well-formedness
+     */
+    static std::unique_ptr<xercesc::SAX2XMLReader> createSaxReader(const SchemaGrammarPool *grammarPool);
+    
+    //==================================================================================================================
+    /** @param grammarPool The pool to look schemas up in, or nullptr to only check for well-formedness */
+    explicit XmlValidator(const SchemaGrammarPool *grammarPool);
+    ~XmlValidator();
+    
+    //==================================================================================================================
+    /**
+        Validates a text and replaces the diagnostics with the problems that were found.
+        
+        @param text        The text to validate
+        @param systemId    The name the text is reported by, like its path
+        @param diagnostics The list to replace with the problems that were found
+        @param syntaxTree  The tree to fill with the structure of the text, or nullptr if it is not needed
+     */
+    void validate(const TextRope &text, const juce::String &systemId, std::vector<XmlDiagnostic> &diagnostics,
+                  SyntaxTree *syntaxTree = nullptr);
+                  
+private:
+    std::unique_ptr<xercesc::SAX2XMLReader> saxReader;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(XmlValidator)
+};
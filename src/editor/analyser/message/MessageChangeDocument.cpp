@@ -0,0 +1,67 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   MessageChangeDocument.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "MessageChangeDocument.h"
+#include "../XmlAnalyser.h"
+
+//======================================================================================================================
+MessageChangeDocument::MessageChangeDocument(juce::String parDocumentId, int parRevision, int parOffset,
+                                             int parRemovedLength, juce::String parInsertedText)
+    : documentId(std::move(parDocumentId)), insertedText(std::move(parInsertedText)),
+      revision(parRevision), offset(parOffset), removedLength(parRemovedLength)
+{}
+
+//======================================================================================================================
+void MessageChangeDocument::handleMessage(jaut::IMessageHandler *context, jaut::MessageDirection messageDirection)
+{
+    juce::ignoreUnused(messageDirection);
+    
+    auto *const analyser = static_cast<XmlAnalyser*>(context);
+    XmlAnalyser::Document *const document = analyser->getDocument(documentId);
+    
+    if (!document)
+    {
+        return;
+    }
+    
+    // Edits that were sent before the editor got to resend the text don't fit it, the resend covers them
+    if (document->desynced)
+    {
+        return;
+    }
+    
+    // Deltas only make sense when applied in order, a gap means we lost track of the editor's text
+    if (revision != document->revision + 1
+        || offset < 0 || removedLength < 0 || offset + removedLength > document->text.getLength())
+    {
+        analyser->requestResync(documentId, *document);
+        return;
+    }
+    
+    document->text.replace(offset, removedLength, insertedText);
+    document->revision = revision;
+    
+    analyser->validateDocument(documentId, *document);
+}
@@ -0,0 +1,53 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   MessageChangeDocument.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+ 
+#pragma once
+
+#include <jaut_message/jaut_message.h>
+
+/** Carries a single edit of an open document to the analyser, instead of the whole text. */
+class MessageChangeDocument : public jaut::IMessage
+{
+public:
+    /**
+        @param documentId    The id the document was opened with
+        @param revision      The revision of the document after this edit, must be exactly one above the last one
+        @param offset        The character offset the edit starts at
+        @param removedLength The number of characters removed at offset
+        @param insertedText  The text inserted at offset, after removing
+     */
+    MessageChangeDocument(juce::String documentId, int revision, int offset, int removedLength,
+                          juce::String insertedText);
+    
+    //==================================================================================================================
+    void handleMessage(jaut::IMessageHandler *context, jaut::MessageDirection messageDirection) override;
+
+private:
+    juce::String documentId;
+    juce::String insertedText;
+    int          revision;
+    int          offset;
+    int          removedLength;
+};
@@ -26,20 +26,16 @@
 #include "MessageOpenDocument.h"
 #include "../XmlAnalyser.h"
 
-#include <xercesc/parsers/XercesDOMParser.hpp>
-
 //======================================================================================================================
-MessageOpenDocument::MessageOpenDocument(juce::String parDocumentId, juce::String parText)
-    : documentId(std::move(parDocumentId)), text(std::move(parText))
+MessageOpenDocument::MessageOpenDocument(juce::String parDocumentId, juce::String parText, int parRevision)
+    : documentId(std::move(parDocumentId)), text(std::move(parText)), revision(parRevision)
 {}
 
 //======================================================================================================================
 void MessageOpenDocument::handleMessage(jaut::IMessageHandler *context, jaut::MessageDirection messageDirection)
 {
-    auto *const analyser = static_cast<XmlAnalyser*>(context);
+    juce::ignoreUnused(messageDirection);
     
-    xercesc::XercesDOMParser parser;
-    parser.setValidationScheme(xercesc::XercesDOMParser::Val_Always);
-    parser.setDoNamespaces(true);
+    auto *const analyser = static_cast<XmlAnalyser*>(context);
+    analyser->validateDocument(documentId, analyser->openDocument(documentId, text, revision));
 }
-
@@ -27,10 +27,16 @@
 
 #include <jaut_message/jaut_message.h>
 
+/** Carries the whole text of a document to the analyser, to open it or to resync it after an edit got lost. */
 class MessageOpenDocument : public jaut::IMessage
 {
 public:
-    MessageOpenDocument(juce::String documentId, juce::String document);
+    /**
+        @param documentId The id the document is known by, an open document with the same id is replaced
+        @param document   The whole text of the document
+        @param revision   The revision the text belongs to, edits that follow have to continue from it
+     */
+    MessageOpenDocument(juce::String documentId, juce::String document, int revision = 0);
     
     //==================================================================================================================
     void handleMessage(jaut::IMessageHandler *context, jaut::MessageDirection messageDirection) override;
@@ -38,4 +44,5 @@ public:
 private:
     juce::String documentId;
     juce::String text;
+    int          revision;
 };
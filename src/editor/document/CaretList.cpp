@@ -0,0 +1,324 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   CaretList.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+
+#include "CaretList.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    juce::CodeDocument::Position getLineEnd(const juce::CodeDocument &document, int line)
+    {
+        // The index is clamped to the line's length without its line break
+        return { document, line, std::numeric_limits<int>::max() };
+    }
+    
+    // A \r\n is one line break, removing only half of it would leave a lone \r that is a line break of its own
+    bool isCrLfAt(const juce::CodeDocument &document, int start)
+    {
+        return start >= 0 && document.getTextBetween({ document, start }, { document, start + 2 }) == "\r\n";
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region CaretList
+//======================================================================================================================
+CaretList::CaretList()
+    : carets{ Caret{ 0, 0 } }
+{}
+
+//======================================================================================================================
+void CaretList::reset(int position)
+{
+    carets.assign(1, Caret{ position, position });
+    mainIndex = 0;
+}
+
+void CaretList::setCarets(std::vector<Caret> newCarets, std::size_t newMainIndex)
+{
+    if (newCarets.empty())
+    {
+        reset(0);
+        return;
+    }
+    
+    carets    = std::move(newCarets);
+    mainIndex = juce::jmin(newMainIndex, carets.size() - 1);
+    normalise();
+}
+
+void CaretList::addCaret(Caret caret)
+{
+    carets.emplace_back(caret);
+    mainIndex = carets.size() - 1;
+    normalise();
+}
+
+void CaretList::setMainCaretPosition(int position, bool selecting)
+{
+    Caret &caret = carets[mainIndex];
+    
+    caret.position        = position;
+    caret.anchor          = selecting ? caret.anchor : position;
+    caret.preferredColumn = -1;
+    
+    normalise();
+}
+
+//======================================================================================================================
+std::size_t CaretList::findFirstCaretFrom(int offset) const noexcept
+{
+    const auto it = std::lower_bound(carets.begin(), carets.end(), offset, [](const Caret &caret, int value)
+    {
+        return caret.getSelection().getEnd() < value;
+    });
+    
+    return static_cast<std::size_t>(std::distance(carets.begin(), it));
+}
+
+//======================================================================================================================
+void CaretList::insertText(juce::CodeDocument &document, const juce::String &text)
+{
+    std::vector<Edit> edits;
+    edits.reserve(carets.size());
+    
+    for (const Caret &caret : carets)
+    {
+        const juce::Range<int> selection = caret.getSelection();
+        edits.push_back({ selection.getStart(), selection.getEnd(), text });
+    }
+    
+    applyEdits(document, edits);
+}
+
+void CaretList::deleteBackwards(juce::CodeDocument &document)
+{
+    std::vector<Edit> edits;
+    edits.reserve(carets.size());
+    
+    for (const Caret &caret : carets)
+    {
+        if (caret.hasSelection())
+        {
+            edits.push_back({ caret.getSelection().getStart(), caret.getSelection().getEnd(), {} });
+            continue;
+        }
+        
+        const int length = ::isCrLfAt(document, caret.position - 2) ? 2 : 1;
+        edits.push_back({ juce::jmax(0, caret.position - length), caret.position, {} });
+    }
+    
+    applyEdits(document, edits);
+}
+
+void CaretList::deleteForwards(juce::CodeDocument &document)
+{
+    const int num_characters = document.getNumCharacters();
+    
+    std::vector<Edit> edits;
+    edits.reserve(carets.size());
+    
+    for (const Caret &caret : carets)
+    {
+        if (caret.hasSelection())
+        {
+            edits.push_back({ caret.getSelection().getStart(), caret.getSelection().getEnd(), {} });
+            continue;
+        }
+        
+        const int length = ::isCrLfAt(document, caret.position) ? 2 : 1;
+        edits.push_back({ caret.position, juce::jmin(num_characters, caret.position + length), {} });
+    }
+    
+    applyEdits(document, edits);
+}
+
+//======================================================================================================================
+void CaretList::moveHorizontally(const juce::CodeDocument &document, int delta, bool selecting)
+{
+    const int num_characters = document.getNumCharacters();
+    
+    moveEach(selecting, [&](const Caret &caret)
+    {
+        // Without shift, a selection collapses to the side the caret moves to
+        if (!selecting && caret.hasSelection())
+        {
+            return delta < 0 ? caret.getSelection().getStart() : caret.getSelection().getEnd();
+        }
+        
+        return juce::jlimit(0, num_characters, caret.position + delta);
+    });
+}
+
+void CaretList::moveVertically(const juce::CodeDocument &document, int delta, bool selecting)
+{
+    for (Caret &caret : carets)
+    {
+        const juce::CodeDocument::Position current(document, caret.position);
+        const int column = caret.preferredColumn >= 0 ? caret.preferredColumn : current.getIndexInLine();
+        const int line   = juce::jlimit(0, document.getNumLines() - 1, current.getLineNumber() + delta);
+        
+        caret.position        = juce::CodeDocument::Position(document, line, column).getPosition();
+        caret.anchor          = selecting ? caret.anchor : caret.position;
+        caret.preferredColumn = column;
+    }
+    
+    normalise();
+}
+
+void CaretList::moveToLineStart(const juce::CodeDocument &document, bool selecting)
+{
+    moveEach(selecting, [&](const Caret &caret)
+    {
+        const juce::CodeDocument::Position current(document, caret.position);
+        return juce::CodeDocument::Position(document, current.getLineNumber(), 0).getPosition();
+    });
+}
+
+void CaretList::moveToLineEnd(const juce::CodeDocument &document, bool selecting)
+{
+    moveEach(selecting, [&](const Caret &caret)
+    {
+        const juce::CodeDocument::Position current(document, caret.position);
+        return ::getLineEnd(document, current.getLineNumber()).getPosition();
+    });
+}
+
+//======================================================================================================================
+void CaretList::shiftForEdit(int start, int removedLength, int insertedLength)
+{
+    const auto shift = [start, removedLength, delta = insertedLength - removedLength](int offset)
+    {
+        if (offset <= start)
+        {
+            return offset;
+        }
+        
+        return offset >= start + removedLength ? offset + delta : start;
+    };
+    
+    for (auto i = findFirstCaretFrom(start); i < carets.size(); ++i)
+    {
+        Caret &caret = carets[i];
+        caret.anchor   = shift(caret.anchor);
+        caret.position = shift(caret.position);
+    }
+    
+    normalise();
+}
+
+//======================================================================================================================
+void CaretList::normalise()
+{
+    const Caret main_caret = carets[mainIndex];
+    
+    std::sort(carets.begin(), carets.end(), [](const Caret &left, const Caret &right)
+    {
+        return left.getSelection().getStart() < right.getSelection().getStart();
+    });
+    
+    std::size_t last = 0;
+    
+    for (std::size_t i = 1; i < carets.size(); ++i)
+    {
+        Caret       &previous = carets[last];
+        const Caret &caret    = carets[i];
+        
+        const juce::Range<int> previous_selection = previous.getSelection();
+        const juce::Range<int> selection          = caret.getSelection();
+        
+        if (selection.getStart() < previous_selection.getEnd() || selection.getStart() == previous.position)
+        {
+            // Overlapping carets become one, which keeps the direction of the first
+            const juce::Range<int> merged = previous_selection.getUnionWith(selection);
+            const bool             forward = previous.anchor <= previous.position;
+            
+            previous.anchor   = forward ? merged.getStart() : merged.getEnd();
+            previous.position = forward ? merged.getEnd()   : merged.getStart();
+            continue;
+        }
+        
+        carets[++last] = caret;
+    }
+    
+    carets.resize(last + 1);
+    
+    const std::size_t main_index = findFirstCaretFrom(main_caret.position);
+    mainIndex = juce::jmin(main_index, carets.size() - 1);
+}
+
+void CaretList::applyEdits(juce::CodeDocument &document, std::vector<Edit> &edits)
+{
+    // Deletions of neighbouring carets can reach into each other, clip them so no two edits overlap
+    for (std::size_t i = 1; i < edits.size(); ++i)
+    {
+        edits[i].start = juce::jmax(edits[i].start, edits[i - 1].end);
+        edits[i].end   = juce::jmax(edits[i].end,   edits[i].start);
+    }
+    
+    // One transaction, so the edits of all carets are undone together
+    document.newTransaction();
+    
+    for (auto it = edits.rbegin(); it != edits.rend(); ++it)
+    {
+        if (it->end > it->start || it->text.isNotEmpty())
+        {
+            document.replaceSection(it->start, it->end, it->text);
+        }
+    }
+    
+    int shift = 0;
+    
+    for (std::size_t i = 0; i < edits.size(); ++i)
+    {
+        const Edit &edit    = edits[i];
+        const int  inserted = edit.text.length();
+        const int  position = edit.start + shift + inserted;
+        
+        carets[i] = Caret{ position, position };
+        shift    += inserted - (edit.end - edit.start);
+    }
+    
+    normalise();
+}
+
+template<class Fn>
+void CaretList::moveEach(bool selecting, Fn &&getNewPosition)
+{
+    for (Caret &caret : carets)
+    {
+        caret.position        = getNewPosition(caret);
+        caret.anchor          = selecting ? caret.anchor : caret.position;
+        caret.preferredColumn = -1;
+    }
+    
+    normalise();
+}
+//======================================================================================================================
+// endregion CaretList
+//**********************************************************************************************************************
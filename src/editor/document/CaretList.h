@@ -0,0 +1,118 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   CaretList.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+
+#pragma once
+
+#include <juce_gui_extra/juce_gui_extra.h>
+
+/**
+    The carets of an editor and the edits they make to a document.
+    
+    Carets are plain offsets kept sorted and without overlaps, so there is no listener or component per caret.
+    An edit is applied at every caret at once as a single undo transaction, back to front so that no edit moves
+    the offsets of the ones still to come, and the carets are then moved by the summed length changes of the edits
+    before them in one pass. Every caret only replaces its own selection, so the text between carets is never
+    copied or touched, however many carets there are.
+ */
+class CaretList
+{
+public:
+    struct Caret
+    {
+        int anchor;
+        int position;
+        int preferredColumn { -1 }; // The column vertical movement tries to stay in, -1 if there is none
+        
+        //==============================================================================================================
+        juce::Range<int> getSelection() const noexcept { return juce::Range<int>::between(anchor, position); }
+        bool             hasSelection() const noexcept { return anchor != position; }
+    };
+    
+    //==================================================================================================================
+    CaretList();
+    
+    //==================================================================================================================
+    /** Removes all carets but one at the given offset. */
+    void reset(int position);
+    
+    /** Replaces all carets, for example with the matches of a search. */
+    void setCarets(std::vector<Caret> newCarets, std::size_t newMainIndex = 0);
+    
+    /** Adds a caret and makes it the main one, it is merged with the carets it overlaps. */
+    void addCaret(Caret caret);
+    
+    /** Moves the main caret, for clicks and drags. */
+    void setMainCaretPosition(int position, bool selecting);
+    
+    //==================================================================================================================
+    const std::vector<Caret>& getCarets()    const noexcept { return carets; }
+    const Caret&              getMainCaret() const noexcept { return carets[mainIndex]; }
+    std::size_t               getNumCarets() const noexcept { return carets.size(); }
+    
+    /** Gets the index of the first caret whose selection ends at or after an offset. */
+    std::size_t findFirstCaretFrom(int offset) const noexcept;
+    
+    //==================================================================================================================
+    /** Replaces the selection of every caret with the text, or inserts it if there is none. */
+    void insertText(juce::CodeDocument &document, const juce::String &text);
+    
+    /** Deletes the selection of every caret, or the character before it if there is none; a \r\n counts as one. */
+    void deleteBackwards(juce::CodeDocument &document);
+    
+    /** Deletes the selection of every caret, or the character after it if there is none; a \r\n counts as one. */
+    void deleteForwards(juce::CodeDocument &document);
+    
+    //==================================================================================================================
+    void moveHorizontally(const juce::CodeDocument &document, int delta, bool selecting);
+    void moveVertically  (const juce::CodeDocument &document, int delta, bool selecting);
+    void moveToLineStart (const juce::CodeDocument &document, bool selecting);
+    void moveToLineEnd   (const juce::CodeDocument &document, bool selecting);
+    
+    //==================================================================================================================
+    /** Moves the carets after an edit that didn't come from this list, like an undo. */
+    void shiftForEdit(int start, int removedLength, int insertedLength);
+
+private:
+    struct Edit
+    {
+        int          start;
+        int          end;
+        juce::String text;
+    };
+    
+    //==================================================================================================================
+    std::vector<Caret> carets;
+    std::size_t        mainIndex { 0 };
+    
+    //==================================================================================================================
+    void normalise();
+    void applyEdits(juce::CodeDocument &document, std::vector<Edit> &edits);
+    
+    template<class Fn>
+    void moveEach(bool selecting, Fn &&getNewPosition);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CaretList)
+};
@@ -0,0 +1,63 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   CodeDocumentTextSource.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "CodeDocumentTextSource.h"
+
+//======================================================================================================================
+CodeDocumentTextSource::CodeDocumentTextSource(const juce::CodeDocument &parDocument)
+    : document(parDocument)
+{}
+
+//======================================================================================================================
+int CodeDocumentTextSource::getLength() const
+{
+    return document.getNumCharacters();
+}
+
+int CodeDocumentTextSource::read(int offset, juce::juce_wchar *buffer, int count) const
+{
+    // Position only reads, so casting away const here doesn't modify the document
+    const juce::CodeDocument::Position position(const_cast<juce::CodeDocument&>(document), offset);
+    
+    const int num_lines = document.getNumLines();
+    int       line      = position.getLineNumber();
+    int       index     = position.getIndexInLine();
+    int       copied    = 0;
+    
+    while (copied < count && line < num_lines)
+    {
+        const juce::String text = document.getLine(line);
+        
+        for (auto it = text.getCharPointer() + index; copied < count && !it.isEmpty();)
+        {
+            buffer[copied++] = it.getAndAdvance();
+        }
+        
+        ++line;
+        index = 0;
+    }
+    
+    return copied;
+}
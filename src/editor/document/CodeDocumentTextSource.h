@@ -0,0 +1,44 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   CodeDocumentTextSource.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "ITextSource.h"
+
+#include <juce_gui_extra/juce_gui_extra.h>
+
+/** Exposes a juce::CodeDocument as a text source, reading it line by line. */
+class CodeDocumentTextSource : public ITextSource
+{
+public:
+    explicit CodeDocumentTextSource(const juce::CodeDocument &document);
+    
+    //==================================================================================================================
+    int getLength() const override;
+    int read(int offset, juce::juce_wchar *buffer, int count) const override;
+    
+private:
+    const juce::CodeDocument &document;
+};
@@ -0,0 +1,484 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DocumentJournal.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "DocumentJournal.h"
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    constexpr int Snapshot_Magic = 0x534c4d4a; // "JMLS"
+    constexpr int Log_Magic      = 0x574c4d4a; // "JMLW"
+    
+    /** The magic number and generation both files start with. */
+    constexpr int Header_Size = 12;
+    
+    /** The payload size and checksum each record of the log starts with. */
+    constexpr int Record_Header_Size = 8;
+    
+    /** The number of characters that are converted to utf-8 at once when writing a rope. */
+    constexpr int Text_Block_Size = 1 << 16;
+    
+    constexpr std::uint32_t Checksum_Seed = 2166136261u;
+    
+    //==================================================================================================================
+    juce::File getJournalFile(const juce::File &journalDirectory, const juce::File &documentFile,
+                              const char *extension)
+    {
+        // Documents with the same name in different directories must not share a journal
+        return journalDirectory.getChildFile(documentFile.getFileName() + "-"
+                                             + juce::String::toHexString(documentFile.getFullPathName().hashCode64())
+                                             + extension);
+    }
+    
+    /** FNV-1a, it only has to catch records that were cut off or garbled by a crash. */
+    std::uint32_t updateChecksum(std::uint32_t checksum, const void *data, std::size_t numBytes) noexcept
+    {
+        const auto *bytes = static_cast<const std::uint8_t*>(data);
+        
+        for (std::size_t i = 0; i < numBytes; ++i)
+        {
+            checksum = (checksum ^ bytes[i]) * 16777619u;
+        }
+        
+        return checksum;
+    }
+    
+    //==================================================================================================================
+    bool writeText(juce::OutputStream &output, const TextRope &text, std::uint32_t &checksum)
+    {
+        juce::HeapBlock<TextRope::Char> block(Text_Block_Size + 1);
+        
+        for (int offset = 0; offset < text.getLength();)
+        {
+            const int count = text.read(offset, block.get(), Text_Block_Size);
+            
+            if (count <= 0)
+            {
+                return false;
+            }
+            
+            block[count] = 0;
+            
+            const juce::String part(juce::CharPointer_UTF32(block.get()), static_cast<std::size_t>(count));
+            const std::size_t  num_bytes = part.getNumBytesAsUTF8();
+            
+            if (!output.write(part.toRawUTF8(), num_bytes))
+            {
+                return false;
+            }
+            
+            checksum  = ::updateChecksum(checksum, part.toRawUTF8(), num_bytes);
+            offset   += count;
+        }
+        
+        return true;
+    }
+    
+    /** Syncs a directory, so a file that was renamed into it is still there after a crash. */
+    bool syncDirectory(const juce::File &directory)
+    {
+       #if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+        const int descriptor = ::open(directory.getFullPathName().toRawUTF8(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        
+        if (descriptor < 0)
+        {
+            return false;
+        }
+        
+        const bool synced = (::fsync(descriptor) == 0);
+        (void) ::close(descriptor);
+        return synced;
+       #else
+        // Elsewhere there is no way to sync a directory, the file system's own journal has to do
+        (void) directory;
+        return true;
+       #endif
+    }
+    
+    /** Writes a file next to the target first and then moves it over the target, so it's never half written. */
+    template<class Fn>
+    bool replaceFile(const juce::File &file, Fn &&write)
+    {
+        juce::TemporaryFile temporary_file(file);
+        
+        {
+            juce::FileOutputStream output(temporary_file.getFile());
+            
+            if (output.failedToOpen() || !write(output))
+            {
+                return false;
+            }
+            
+            // This syncs the data to disk, so the rename can't be persisted before what it points to
+            output.flush();
+            
+            if (output.getStatus().failed())
+            {
+                return false;
+            }
+        }
+        
+        // The rename is only durable once the directory entry pointing to the new file is on disk as well
+        return temporary_file.overwriteTargetFileWithTemporary() && ::syncDirectory(file.getParentDirectory());
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region DocumentJournal
+//======================================================================================================================
+DocumentJournal::DocumentJournal(juce::File journalDirectory, juce::File parDocumentFile, const TextRope &parText)
+    : juce::Thread("DOCUMENT-JOURNAL"),
+      documentFile(std::move(parDocumentFile)),
+      snapshotFile(::getJournalFile(journalDirectory, documentFile, ".snapshot")),
+      logFile     (::getJournalFile(journalDirectory, documentFile, ".log")),
+      text(parText)
+{
+    (void) journalDirectory.createDirectory();
+    startThread();
+}
+
+DocumentJournal::~DocumentJournal()
+{
+    // The thread writes what is still pending before it exits
+    (void) stopThread(30000);
+    cancelPendingUpdate();
+}
+
+//======================================================================================================================
+void DocumentJournal::recordEdit(int start, int removedLength, const juce::String &inserted)
+{
+    jassert(start >= 0 && removedLength >= 0);
+    
+    bool first_of_batch;
+    
+    {
+        const juce::ScopedLock lock(pendingLock);
+        first_of_batch = pendingRecords.empty();
+        pendingRecords.push_back({ Record::Type::Edit, start, removedLength, inserted });
+    }
+    
+    // The thread waits for the rest of the batch by itself, there's no need to wake it for every edit
+    if (first_of_batch)
+    {
+        notify();
+    }
+}
+
+void DocumentJournal::save()
+{
+    {
+        const juce::ScopedLock lock(pendingLock);
+        pendingRecords.push_back({ Record::Type::Save, 0, 0, {} });
+    }
+    
+    notify();
+}
+
+//======================================================================================================================
+void DocumentJournal::addListener(Listener *listener)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    listeners.add(listener);
+}
+
+void DocumentJournal::removeListener(Listener *listener)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    listeners.remove(listener);
+}
+
+//======================================================================================================================
+bool DocumentJournal::recover(const juce::File &journalDirectory, const juce::File &documentFile, TextRope &text)
+{
+    juce::MemoryBlock snapshot;
+    
+    if (!::getJournalFile(journalDirectory, documentFile, ".snapshot").loadFileAsData(snapshot)
+        || snapshot.getSize() < static_cast<std::size_t>(Header_Size + 4))
+    {
+        return false;
+    }
+    
+    const auto        *snapshot_data = static_cast<const char*>(snapshot.getData());
+    const std::size_t text_size      = snapshot.getSize() - Header_Size - 4;
+    const auto        checksum       = juce::ByteOrder::littleEndianInt(snapshot_data + Header_Size + text_size);
+    
+    if (static_cast<int>(juce::ByteOrder::littleEndianInt(snapshot_data)) != Snapshot_Magic
+        || checksum != ::updateChecksum(Checksum_Seed, snapshot_data + Header_Size, text_size))
+    {
+        return false;
+    }
+    
+    const auto generation = juce::ByteOrder::littleEndianInt64(snapshot_data + 4);
+    TextRope   recovered(juce::String::fromUTF8(snapshot_data + Header_Size, static_cast<int>(text_size)));
+    snapshot.reset();
+    
+    // A log of another generation was left behind by a crash between writing a snapshot and starting its log,
+    // everything in it is part of the snapshot already
+    juce::MemoryBlock log;
+    
+    if (::getJournalFile(journalDirectory, documentFile, ".log").loadFileAsData(log)
+        && log.getSize() >= static_cast<std::size_t>(Header_Size)
+        && static_cast<int>(juce::ByteOrder::littleEndianInt(log.getData())) == Log_Magic
+        && juce::ByteOrder::littleEndianInt64(static_cast<const char*>(log.getData()) + 4) == generation)
+    {
+        juce::MemoryInputStream input(log, false);
+        (void) input.setPosition(Header_Size);
+        
+        // Replaying stops at the first record that was cut off or doesn't fit, nothing after it can be trusted
+        while (input.getNumBytesRemaining() >= Record_Header_Size)
+        {
+            const int  size            = input.readInt();
+            const auto record_checksum = static_cast<std::uint32_t>(input.readInt());
+            
+            if (size < 0 || input.getNumBytesRemaining() < size)
+            {
+                break;
+            }
+            
+            const char *payload = static_cast<const char*>(log.getData()) + input.getPosition();
+            
+            if (::updateChecksum(Checksum_Seed, payload, static_cast<std::size_t>(size)) != record_checksum)
+            {
+                break;
+            }
+            
+            juce::MemoryInputStream record(payload, static_cast<std::size_t>(size), false);
+            
+            const int start          = record.readCompressedInt();
+            const int removed_length = record.readCompressedInt();
+            const int num_bytes      = record.readCompressedInt();
+            
+            if (start < 0 || removed_length < 0 || num_bytes < 0
+                || start > recovered.getLength() - removed_length
+                || record.getNumBytesRemaining() < num_bytes)
+            {
+                break;
+            }
+            
+            recovered.replace(start, removed_length,
+                              juce::String::fromUTF8(payload + record.getPosition(), num_bytes));
+            (void) input.skipNextBytes(size);
+        }
+    }
+    
+    text = std::move(recovered);
+    return true;
+}
+
+void DocumentJournal::discard(const juce::File &journalDirectory, const juce::File &documentFile)
+{
+    // The snapshot goes first, a log without one is never replayed
+    (void) ::getJournalFile(journalDirectory, documentFile, ".snapshot").deleteFile();
+    (void) ::getJournalFile(journalDirectory, documentFile, ".log")     .deleteFile();
+}
+
+//======================================================================================================================
+void DocumentJournal::run()
+{
+    while (!threadShouldExit())
+    {
+        (void) wait(-1);
+        
+        // Gives a burst of typing the chance to end up in one batch
+        if (!threadShouldExit())
+        {
+            (void) wait(Flush_Delay_Ms);
+        }
+        
+        writePendingRecords();
+    }
+    
+    writePendingRecords();
+}
+
+void DocumentJournal::handleAsyncUpdate()
+{
+    std::vector<bool> results;
+    
+    {
+        const juce::ScopedLock lock(pendingLock);
+        results.swap(saveResults);
+    }
+    
+    for (const bool succeeded : results)
+    {
+        listeners.call([this, succeeded](Listener &listener)
+        {
+            listener.documentSaved(documentFile, succeeded);
+        });
+    }
+}
+
+//======================================================================================================================
+void DocumentJournal::writePendingRecords()
+{
+    std::vector<Record> records;
+    
+    {
+        const juce::ScopedLock lock(pendingLock);
+        records.swap(pendingRecords);
+    }
+    
+    for (const Record &record : records)
+    {
+        if (record.type == Record::Type::Save)
+        {
+            writeBatch();
+            const bool succeeded = saveDocument();
+            
+            {
+                const juce::ScopedLock lock(pendingLock);
+                saveResults.push_back(succeeded);
+            }
+            
+            triggerAsyncUpdate();
+            continue;
+        }
+        
+        // If the journal can't be written the rope is still kept up to date, so saving keeps working
+        if (logStream == nullptr)
+        {
+            (void) startJournal();
+        }
+        
+        if (logStream != nullptr)
+        {
+            const std::size_t        num_bytes = record.inserted.getNumBytesAsUTF8();
+            juce::MemoryOutputStream payload;
+            
+            (void) payload.writeCompressedInt(record.start);
+            (void) payload.writeCompressedInt(record.removedLength);
+            (void) payload.writeCompressedInt(static_cast<int>(num_bytes));
+            (void) payload.write(record.inserted.toRawUTF8(), num_bytes);
+            
+            const auto checksum = ::updateChecksum(Checksum_Seed, payload.getData(), payload.getDataSize());
+            
+            (void) batch.writeInt(static_cast<int>(payload.getDataSize()));
+            (void) batch.writeInt(static_cast<int>(checksum));
+            (void) batch.write(payload.getData(), payload.getDataSize());
+        }
+        
+        text.replace(record.start, record.removedLength, record.inserted);
+    }
+    
+    writeBatch();
+    
+    if (logStream != nullptr && logStream->getPosition() > Snapshot_Threshold)
+    {
+        (void) startJournal();
+    }
+}
+
+void DocumentJournal::writeBatch()
+{
+    if (batch.getDataSize() == 0)
+    {
+        return;
+    }
+    
+    if (logStream != nullptr)
+    {
+        const bool written = logStream->write(batch.getData(), batch.getDataSize());
+        
+        // This syncs the log to disk, once for the whole batch
+        logStream->flush();
+        
+        if (!written || logStream->getStatus().failed())
+        {
+            // The log can't be trusted anymore, the next edit starts a new journal from the rope
+            logStream.reset();
+        }
+    }
+    
+    batch.reset();
+}
+
+bool DocumentJournal::startJournal()
+{
+    logStream.reset();
+    
+    const juce::int64 generation = juce::Random::getSystemRandom().nextInt64();
+    
+    // The snapshot is written first, the old log doesn't match its generation anymore and is ignored from then on
+    const bool snapshot_written = ::replaceFile(snapshotFile, [this, generation](juce::OutputStream &output)
+    {
+        std::uint32_t checksum = Checksum_Seed;
+        
+        return output.writeInt(Snapshot_Magic)
+            && output.writeInt64(generation)
+            && ::writeText(output, text, checksum)
+            && output.writeInt(static_cast<int>(checksum));
+    });
+    
+    if (!snapshot_written)
+    {
+        return false;
+    }
+    
+    auto stream = std::make_unique<juce::FileOutputStream>(logFile);
+    
+    if (stream->failedToOpen()
+        || !stream->setPosition(0)
+        || stream->truncate().failed()
+        || !stream->writeInt(Log_Magic)
+        || !stream->writeInt64(generation))
+    {
+        return false;
+    }
+    
+    stream->flush();
+    logStream = std::move(stream);
+    return true;
+}
+
+bool DocumentJournal::saveDocument()
+{
+    const bool saved = ::replaceFile(documentFile, [this](juce::OutputStream &output)
+    {
+        std::uint32_t checksum = Checksum_Seed;
+        return ::writeText(output, text, checksum);
+    });
+    
+    if (saved)
+    {
+        // Everything the journal holds is in the file now, the next edit starts a new one
+        logStream.reset();
+        (void) snapshotFile.deleteFile();
+        (void) logFile.deleteFile();
+    }
+    
+    return saved;
+}
+//======================================================================================================================
+// endregion DocumentJournal
+//**********************************************************************************************************************
@@ -0,0 +1,147 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DocumentJournal.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "TextRope.h"
+
+#include <juce_events/juce_events.h>
+
+/**
+    A crash-safe journal of the edits made to a document since it was last saved, written on its own thread.
+    
+    A journal is a snapshot of the document's text plus a write-ahead log of the edits made after it. Edits are
+    queued on the message thread and appended to the log in batches, which are synced to disk once per batch
+    instead of once per edit. The journal's thread keeps its own rope of the document, once the log has grown
+    big enough this is written out as a new snapshot and the log starts over. Snapshots and saves are written
+    to a temporary file that then replaces the target, so a crash leaves either the old or the new file behind.
+    
+    Saving also happens on the journal's thread, with the text as it was when save() was called, and discards
+    the journal. After a crash, recover() loads the snapshot and replays the log up to the last intact record.
+ */
+class DocumentJournal : private juce::Thread, private juce::AsyncUpdater
+{
+public:
+    /** Is told on the message thread when a save has finished. */
+    struct Listener
+    {
+        virtual ~Listener() = default;
+        
+        //==============================================================================================================
+        virtual void documentSaved(const juce::File &file, bool succeeded) = 0;
+    };
+    
+    //==================================================================================================================
+    /** How long the thread waits for more edits after the first one of a batch, before syncing the batch. */
+    static constexpr int Flush_Delay_Ms = 200;
+    
+    /** The size in bytes the log can grow to before a new snapshot is written. */
+    static constexpr juce::int64 Snapshot_Threshold = 1 << 24;
+    
+    //==================================================================================================================
+    /**
+        Creates the journal and starts its thread.
+        Nothing is written until the first edit, an existing journal of the document is kept until then.
+        
+        @param journalDirectory The directory the journals of all documents are kept in
+        @param documentFile     The file the document is saved to, the journal's files are named after it
+        @param text             The text of the document at the moment, edits are recorded from here on
+     */
+    DocumentJournal(juce::File journalDirectory, juce::File documentFile, const TextRope &text);
+    ~DocumentJournal() override;
+    
+    //==================================================================================================================
+    /** Records an edit made to the document, this must only be called from the message thread. */
+    void recordEdit(int start, int removedLength, const juce::String &inserted);
+    
+    /** Saves the text including all edits recorded so far to the document file, without waiting for it. */
+    void save();
+    
+    //==================================================================================================================
+    /** Adds a listener that is told about finished saves, this must only be called from the message thread. */
+    void addListener(Listener *listener);
+    
+    /** Removes a listener, this must only be called from the message thread. */
+    void removeListener(Listener *listener);
+    
+    //==================================================================================================================
+    /**
+        Restores the text of a document from its journal, if the document has one.
+        
+        @param journalDirectory The directory the journal was kept in
+        @param documentFile     The file of the document
+        @param text             The rope to put the restored text into
+        @return False if there is no journal or its snapshot is damaged, in which case text is left untouched
+     */
+    static bool recover(const juce::File &journalDirectory, const juce::File &documentFile, TextRope &text);
+    
+    /** Deletes the journal of a document. */
+    static void discard(const juce::File &journalDirectory, const juce::File &documentFile);
+    
+private:
+    struct Record
+    {
+        enum class Type
+        {
+            Edit,
+            Save
+        };
+        
+        //==============================================================================================================
+        Type         type;
+        int          start;
+        int          removedLength;
+        juce::String inserted;
+    };
+    
+    //==================================================================================================================
+    juce::File documentFile;
+    juce::File snapshotFile;
+    juce::File logFile;
+    
+    // Handed from the message thread to the journal's thread
+    std::vector<Record>   pendingRecords;
+    std::vector<bool>     saveResults;
+    juce::CriticalSection pendingLock;
+    
+    // Only touched on the journal's thread
+    TextRope                                text;
+    std::unique_ptr<juce::FileOutputStream> logStream;
+    juce::MemoryOutputStream                batch;
+    
+    juce::ListenerList<Listener> listeners;
+    
+    //==================================================================================================================
+    void run() override;
+    void handleAsyncUpdate() override;
+    
+    //==================================================================================================================
+    void writePendingRecords();
+    void writeBatch();
+    bool startJournal();
+    bool saveDocument();
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DocumentJournal)
+};
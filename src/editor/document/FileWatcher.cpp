@@ -0,0 +1,262 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FileWatcher.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "FileWatcher.h"
+
+#if JUCE_LINUX
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+//**********************************************************************************************************************
+// region FileWatcher
+//======================================================================================================================
+FileWatcher::FileWatcher()
+    : juce::Thread("FILE-WATCHER")
+{
+   #if JUCE_LINUX
+    inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+   #endif
+    
+    startThread();
+}
+
+FileWatcher::~FileWatcher()
+{
+    (void) stopThread(Poll_Interval_Ms * 4);
+    cancelPendingUpdate();
+   
+   #if JUCE_LINUX
+    if (inotifyDescriptor >= 0)
+    {
+        (void) ::close(inotifyDescriptor);
+    }
+   #endif
+}
+
+//======================================================================================================================
+void FileWatcher::addFile(const juce::File &file)
+{
+    const juce::ScopedLock lock(filesLock);
+    
+    const bool already_watched = std::any_of(watchedFiles.begin(), watchedFiles.end(),
+                                             [&file](const WatchedFile &watched)
+                                             {
+                                                 return watched.file == file;
+                                             });
+    
+    if (already_watched)
+    {
+        return;
+    }
+    
+    WatchedFile watched { file, file.getLastModificationTime(), file.getSize(), -1 };
+   
+   #if JUCE_LINUX
+    // The directory is watched rather than the file, replacing the file would end a watch on the file itself;
+    // files in the same directory share the directory's watch descriptor
+    if (inotifyDescriptor >= 0)
+    {
+        watched.watchDescriptor = inotify_add_watch(inotifyDescriptor,
+                                                    file.getParentDirectory().getFullPathName().toRawUTF8(),
+                                                    IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_MODIFY);
+    }
+   #endif
+    
+    watchedFiles.push_back(std::move(watched));
+}
+
+void FileWatcher::removeFile(const juce::File &file)
+{
+    const juce::ScopedLock lock(filesLock);
+    
+    const auto it = std::find_if(watchedFiles.begin(), watchedFiles.end(), [&file](const WatchedFile &watched)
+    {
+        return watched.file == file;
+    });
+    
+    if (it == watchedFiles.end())
+    {
+        return;
+    }
+    
+    const int watch_descriptor = it->watchDescriptor;
+    watchedFiles.erase(it);
+   
+   #if JUCE_LINUX
+    const bool directory_in_use = std::any_of(watchedFiles.begin(), watchedFiles.end(),
+                                              [watch_descriptor](const WatchedFile &watched)
+                                              {
+                                                  return watched.watchDescriptor == watch_descriptor;
+                                              });
+    
+    if (watch_descriptor >= 0 && !directory_in_use)
+    {
+        (void) inotify_rm_watch(inotifyDescriptor, watch_descriptor);
+    }
+   #else
+    juce::ignoreUnused(watch_descriptor);
+   #endif
+}
+
+//======================================================================================================================
+void FileWatcher::addListener(Listener *listener)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    listeners.add(listener);
+}
+
+void FileWatcher::removeListener(Listener *listener)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    listeners.remove(listener);
+}
+
+//======================================================================================================================
+void FileWatcher::run()
+{
+    while (!threadShouldExit())
+    {
+       #if JUCE_LINUX
+        if (inotifyDescriptor >= 0)
+        {
+            // While changes are waiting to settle, a quiet interval is what reports them
+            pollfd descriptor { inotifyDescriptor, POLLIN, 0 };
+            
+            if (::poll(&descriptor, 1, changedFiles.empty() ? Poll_Interval_Ms : Settle_Delay_Ms) > 0)
+            {
+                readEvents();
+            }
+            else
+            {
+                publishChanges();
+            }
+            
+            continue;
+        }
+       #endif
+        
+        (void) wait(Poll_Interval_Ms);
+        pollFiles();
+        publishChanges();
+    }
+}
+
+void FileWatcher::handleAsyncUpdate()
+{
+    std::set<juce::File> files;
+    
+    {
+        const juce::ScopedLock lock(filesLock);
+        files.swap(settledFiles);
+    }
+    
+    for (const juce::File &file : files)
+    {
+        listeners.call([&file](Listener &listener)
+        {
+            listener.fileChanged(file);
+        });
+    }
+}
+
+//======================================================================================================================
+void FileWatcher::readEvents()
+{
+   #if JUCE_LINUX
+    alignas(inotify_event) char buffer[4096];
+    
+    for (;;)
+    {
+        const ssize_t length = ::read(inotifyDescriptor, buffer, sizeof(buffer));
+        
+        if (length <= 0)
+        {
+            break;
+        }
+        
+        const juce::ScopedLock lock(filesLock);
+        
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const auto *event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            
+            if (event->len == 0)
+            {
+                continue;
+            }
+            
+            const juce::String name = juce::String::fromUTF8(event->name);
+            
+            for (const WatchedFile &watched : watchedFiles)
+            {
+                if (watched.watchDescriptor == event->wd && watched.file.getFileName() == name)
+                {
+                    changedFiles.insert(watched.file);
+                }
+            }
+        }
+    }
+   #endif
+}
+
+void FileWatcher::pollFiles()
+{
+    const juce::ScopedLock lock(filesLock);
+    
+    for (WatchedFile &watched : watchedFiles)
+    {
+        const juce::Time  modification = watched.file.getLastModificationTime();
+        const juce::int64 size         = watched.file.getSize();
+        
+        if (modification != watched.lastModification || size != watched.size)
+        {
+            watched.lastModification = modification;
+            watched.size             = size;
+            changedFiles.insert(watched.file);
+        }
+    }
+}
+
+void FileWatcher::publishChanges()
+{
+    if (changedFiles.empty())
+    {
+        return;
+    }
+    
+    {
+        const juce::ScopedLock lock(filesLock);
+        settledFiles.insert(changedFiles.begin(), changedFiles.end());
+    }
+    
+    changedFiles.clear();
+    triggerAsyncUpdate();
+}
+//======================================================================================================================
+// endregion FileWatcher
+//**********************************************************************************************************************
@@ -0,0 +1,108 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FileWatcher.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_events/juce_events.h>
+
+#include <set>
+
+/**
+    Watches files for changes made by other programs and tells its listeners on the message thread.
+    
+    On Linux this uses inotify on the directories of the watched files, which also catches files that are
+    replaced by renaming a new one over them, as generators and most editors do. Elsewhere the files'
+    modification times and sizes are polled instead. Events are collected until a file has been quiet for a
+    moment, so a file that is written in several steps is only reported once.
+ */
+class FileWatcher : private juce::Thread, private juce::AsyncUpdater
+{
+public:
+    struct Listener
+    {
+        virtual ~Listener() = default;
+        
+        //==============================================================================================================
+        /** Called on the message thread when a watched file was written, created or replaced. */
+        virtual void fileChanged(const juce::File &file) = 0;
+    };
+    
+    //==================================================================================================================
+    /** How long a file has to be left alone before a change to it is reported. */
+    static constexpr int Settle_Delay_Ms = 100;
+    
+    /** How often the thread checks whether it should stop, or polls files where there is no inotify. */
+    static constexpr int Poll_Interval_Ms = 500;
+    
+    //==================================================================================================================
+    /** Creates the watcher and starts its thread. */
+    FileWatcher();
+    ~FileWatcher() override;
+    
+    //==================================================================================================================
+    /** Starts watching a file, which doesn't have to exist yet. */
+    void addFile(const juce::File &file);
+    
+    /** Stops watching a file. */
+    void removeFile(const juce::File &file);
+    
+    //==================================================================================================================
+    /** Adds a listener that is told about changed files, this must only be called from the message thread. */
+    void addListener(Listener *listener);
+    
+    /** Removes a listener, this must only be called from the message thread. */
+    void removeListener(Listener *listener);
+    
+private:
+    struct WatchedFile
+    {
+        juce::File  file;
+        juce::Time  lastModification;
+        juce::int64 size;
+        int         watchDescriptor;
+    };
+    
+    //==================================================================================================================
+    std::vector<WatchedFile> watchedFiles;
+    std::set<juce::File>     settledFiles;
+    juce::CriticalSection    filesLock;
+    int                      inotifyDescriptor { -1 };
+    
+    // Only touched on the watcher's thread
+    std::set<juce::File> changedFiles;
+    
+    juce::ListenerList<Listener> listeners;
+    
+    //==================================================================================================================
+    void run() override;
+    void handleAsyncUpdate() override;
+    
+    //==================================================================================================================
+    void readEvents();
+    void pollFiles();
+    void publishChanges();
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FileWatcher)
+};
@@ -0,0 +1,48 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   ITextSource.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/** Random access to the characters of a text, however it is stored. */
+struct ITextSource
+{
+    //==================================================================================================================
+    virtual ~ITextSource() = default;
+    
+    //==================================================================================================================
+    virtual int getLength() const = 0;
+    
+    /**
+        Copies characters into a buffer.
+        
+        @param offset The offset to start reading at
+        @param buffer The buffer to copy the characters to
+        @param count  The maximum number of characters to copy
+        @return The number of characters that were copied
+     */
+    virtual int read(int offset, juce::juce_wchar *buffer, int count) const = 0;
+};
@@ -0,0 +1,213 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   LineDiff.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "LineDiff.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    std::vector<std::uint64_t> hashLines(const juce::StringArray &lines, int start, int end)
+    {
+        std::vector<std::uint64_t> hashes;
+        hashes.reserve(static_cast<std::size_t>(end - start));
+        
+        for (int i = start; i < end; ++i)
+        {
+            hashes.push_back(static_cast<std::uint64_t>(lines.getReference(i).hashCode64()));
+        }
+        
+        return hashes;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region LineDiff
+//======================================================================================================================
+juce::StringArray LineDiff::splitLines(const juce::String &text)
+{
+    juce::StringArray lines;
+    auto              line_start = text.getCharPointer();
+    auto              position   = line_start;
+    
+    while (!position.isEmpty())
+    {
+        const juce::juce_wchar character = position.getAndAdvance();
+        
+        if (character == '\r' && *position == '\n')
+        {
+            ++position;
+        }
+        
+        if (character == '\r' || character == '\n')
+        {
+            lines.add(juce::String(line_start, position));
+            line_start = position;
+        }
+    }
+    
+    lines.add(juce::String(line_start, position));
+    return lines;
+}
+
+std::vector<LineDiff::Hunk> LineDiff::compute(const juce::StringArray &oldLines, const juce::StringArray &newLines,
+                                              int maxEditDistance)
+{
+    const int old_size = oldLines.size();
+    const int new_size = newLines.size();
+    
+    int prefix = 0;
+    int suffix = 0;
+    
+    while (prefix < old_size && prefix < new_size && oldLines[prefix] == newLines[prefix])
+    {
+        ++prefix;
+    }
+    
+    while (suffix < old_size - prefix && suffix < new_size - prefix
+           && oldLines[old_size - 1 - suffix] == newLines[new_size - 1 - suffix])
+    {
+        ++suffix;
+    }
+    
+    const int n = old_size - prefix - suffix;
+    const int m = new_size - prefix - suffix;
+    
+    if (n == 0 && m == 0)
+    {
+        return {};
+    }
+    
+    if (n == 0 || m == 0)
+    {
+        return { Hunk { prefix, n, prefix, m } };
+    }
+    
+    const std::vector<std::uint64_t> old_hashes = ::hashLines(oldLines, prefix, prefix + n);
+    const std::vector<std::uint64_t> new_hashes = ::hashLines(newLines, prefix, prefix + m);
+    
+    const auto equal = [&](int x, int y)
+    {
+        return old_hashes[static_cast<std::size_t>(x)] == new_hashes[static_cast<std::size_t>(y)]
+               && oldLines[prefix + x] == newLines[prefix + y];
+    };
+    
+    // Forward pass, v holds the furthest x reached on every diagonal k = x - y, indexed by k + offset;
+    // after each round the part of v that round could reach is kept to walk the path back afterwards
+    const int                     max_distance = juce::jmin(n + m, maxEditDistance);
+    const int                     offset       = max_distance + 1;
+    std::vector<int>              v(static_cast<std::size_t>(2 * max_distance + 3), 0);
+    std::vector<std::vector<int>> trace;
+    int                           distance = -1;
+    
+    for (int d = 0; d <= max_distance && distance < 0; ++d)
+    {
+        for (int k = -d; k <= d; k += 2)
+        {
+            int x = (k == -d || (k != d && v[k - 1 + offset] < v[k + 1 + offset])) ? v[k + 1 + offset]
+                                                                                   : v[k - 1 + offset] + 1;
+            int y = x - k;
+            
+            while (x < n && y < m && equal(x, y))
+            {
+                ++x;
+                ++y;
+            }
+            
+            v[k + offset] = x;
+            
+            if (x >= n && y >= m)
+            {
+                distance = d;
+            }
+        }
+        
+        trace.emplace_back(v.begin() + (offset - d), v.begin() + (offset + d + 1));
+    }
+    
+    if (distance < 0)
+    {
+        return { Hunk { prefix, n, prefix, m } };
+    }
+    
+    // Walking back from the end marks every line that was deleted or inserted on the way
+    std::vector<bool> old_changed(static_cast<std::size_t>(n), false);
+    std::vector<bool> new_changed(static_cast<std::size_t>(m), false);
+    
+    for (int d = distance, x = n, y = m; d > 0; --d)
+    {
+        const std::vector<int> &previous = trace[static_cast<std::size_t>(d - 1)];
+        const auto at = [&previous, d](int diagonal)
+        {
+            return previous[static_cast<std::size_t>(diagonal + d - 1)];
+        };
+        
+        const int  k          = x - y;
+        const bool inserted   = (k == -d || (k != d && at(k - 1) < at(k + 1)));
+        const int  previous_k = inserted ? k + 1 : k - 1;
+        const int  previous_x = at(previous_k);
+        const int  previous_y = previous_x - previous_k;
+        
+        if (inserted)
+        {
+            new_changed[static_cast<std::size_t>(previous_y)] = true;
+        }
+        else
+        {
+            old_changed[static_cast<std::size_t>(previous_x)] = true;
+        }
+        
+        x = previous_x;
+        y = previous_y;
+    }
+    
+    // Unchanged lines pair up in order, so both sides can be walked together to gather the hunks
+    std::vector<Hunk> hunks;
+    
+    for (int x = 0, y = 0; x < n || y < m;)
+    {
+        if ((x < n && old_changed[static_cast<std::size_t>(x)]) || (y < m && new_changed[static_cast<std::size_t>(y)]))
+        {
+            Hunk hunk { prefix + x, 0, prefix + y, 0 };
+            
+            for (; x < n && old_changed[static_cast<std::size_t>(x)]; ++x, ++hunk.oldCount) {}
+            for (; y < m && new_changed[static_cast<std::size_t>(y)]; ++y, ++hunk.newCount) {}
+            
+            hunks.push_back(hunk);
+        }
+        else
+        {
+            ++x;
+            ++y;
+        }
+    }
+    
+    return hunks;
+}
+//======================================================================================================================
+// endregion LineDiff
+//**********************************************************************************************************************
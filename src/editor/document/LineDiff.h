@@ -0,0 +1,71 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   LineDiff.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+    Compares two versions of a text line by line, to turn a change made outside the editor into the smallest edits.
+    
+    Lines are compared by a 64 bit hash first and only by their text if the hashes match. Common lines at the start
+    and end are skipped before the rest is diffed with Myers' algorithm, which finds the shortest edit script in
+    O((N + M) D) time, where D is the number of lines that differ. If D grows beyond a limit, the part that is left
+    is treated as one changed block, which is still correct but no longer minimal.
+ */
+class LineDiff
+{
+public:
+    /** The default number of differing lines after which the diff gives up on finding the shortest script. */
+    static constexpr int Max_Edit_Distance = 2048;
+    
+    //==================================================================================================================
+    /** A block of old lines that is replaced by a block of new lines, either may be empty. */
+    struct Hunk
+    {
+        int oldStart;
+        int oldCount;
+        int newStart;
+        int newCount;
+    };
+    
+    //==================================================================================================================
+    /**
+        Splits a text into lines that keep their line breaks, the same way juce::CodeDocument does.
+        A text that ends with a line break, or is empty, has an empty last line.
+     */
+    static juce::StringArray splitLines(const juce::String &text);
+    
+    /**
+        Finds the blocks of lines that differ between two texts.
+        
+        @param oldLines        The lines of the text as it is now
+        @param newLines        The lines of the text it should become
+        @param maxEditDistance The number of differing lines after which the rest is one block
+        @return The hunks in order, none of them overlap or touch
+     */
+    static std::vector<Hunk> compute(const juce::StringArray &oldLines, const juce::StringArray &newLines,
+                                     int maxEditDistance = Max_Edit_Distance);
+};
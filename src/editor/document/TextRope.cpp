@@ -0,0 +1,195 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextRope.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "TextRope.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    void appendText(TextRope::Chunk &destination, const juce::String &text)
+    {
+        for (auto it = text.getCharPointer(); !it.isEmpty();)
+        {
+            destination.push_back(it.getAndAdvance());
+        }
+    }
+    
+    juce::String toJuceString(const TextRope::Chunk &text)
+    {
+        return { juce::CharPointer_UTF32(text.data()), text.size() };
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region TextRope
+//======================================================================================================================
+TextRope::TextRope(const juce::String &text)
+{
+    replace(0, 0, text);
+}
+
+//======================================================================================================================
+void TextRope::replace(int offset, int removeLength, const juce::String &text)
+{
+    jassert(offset >= 0 && removeLength >= 0 && offset + removeLength <= length);
+    
+    if (removeLength == 0 && text.isEmpty())
+    {
+        return;
+    }
+    
+    Chunk merged;
+    std::size_t first = chunks.size();
+    std::size_t last  = chunks.size();
+    
+    if (!chunks.empty())
+    {
+        first = findChunk(offset);
+        last  = findChunk(offset + removeLength);
+        
+        const Chunk &first_chunk = *chunks[first];
+        const Chunk &last_chunk  = *chunks[last];
+        
+        merged.reserve(static_cast<std::size_t>(offset - getChunkStart(first)) + first_chunk.size()
+                       + static_cast<std::size_t>(text.length()));
+        merged.append(first_chunk, 0, static_cast<std::size_t>(offset - getChunkStart(first)));
+        appendText(merged, text);
+        merged.append(last_chunk, static_cast<std::size_t>(offset + removeLength - getChunkStart(last)));
+        
+        // Keep chunks from fragmenting into tiny pieces after lots of deletions
+        if (merged.size() < static_cast<std::size_t>(Min_Chunk_Size) && last + 1 < chunks.size())
+        {
+            merged.append(*chunks[++last]);
+        }
+        
+        ++last;
+    }
+    else
+    {
+        appendText(merged, text);
+    }
+    
+    std::vector<ChunkPtr> replacement;
+    
+    if (!merged.empty())
+    {
+        // Split evenly instead of filling up to the maximum, so that the next insertion into any of these chunks
+        // doesn't immediately force another split
+        const std::size_t num_chunks = (merged.size() + Max_Chunk_Size - 1) / Max_Chunk_Size;
+        const std::size_t chunk_size = (merged.size() + num_chunks - 1) / num_chunks;
+        
+        replacement.reserve(num_chunks);
+        
+        for (std::size_t i = 0; i < merged.size(); i += chunk_size)
+        {
+            replacement.emplace_back(std::make_shared<const Chunk>(merged, i, chunk_size));
+        }
+    }
+    
+    const auto first_it = chunks.begin() + static_cast<std::ptrdiff_t>(first);
+    const auto last_it  = chunks.begin() + static_cast<std::ptrdiff_t>(last);
+    chunks.insert(chunks.erase(first_it, last_it), replacement.begin(), replacement.end());
+    
+    length += text.length() - removeLength;
+    updateChunkEnds(first);
+}
+
+//======================================================================================================================
+int TextRope::read(int offset, Char *buffer, int count) const noexcept
+{
+    if (offset < 0 || offset >= length || count <= 0)
+    {
+        return 0;
+    }
+    
+    int copied = 0;
+    
+    for (std::size_t i = findChunk(offset); i < chunks.size() && copied < count; ++i)
+    {
+        const Chunk &chunk  = *chunks[i];
+        const int    start  = offset + copied - getChunkStart(i);
+        const int    amount = juce::jmin(count - copied, static_cast<int>(chunk.size()) - start);
+        
+        std::copy_n(chunk.data() + start, amount, buffer + copied);
+        copied += amount;
+    }
+    
+    return copied;
+}
+
+//======================================================================================================================
+TextRope::Char TextRope::getCharAt(int offset) const noexcept
+{
+    if (offset < 0 || offset >= length)
+    {
+        return 0;
+    }
+    
+    const std::size_t index = findChunk(offset);
+    return (*chunks[index])[static_cast<std::size_t>(offset - getChunkStart(index))];
+}
+
+juce::String TextRope::getText(juce::Range<int> range) const
+{
+    range = range.getIntersectionWith({ 0, length });
+    
+    Chunk text(static_cast<std::size_t>(range.getLength()), 0);
+    text.resize(static_cast<std::size_t>(read(range.getStart(), text.data(), range.getLength())));
+    
+    return ::toJuceString(text);
+}
+
+juce::String TextRope::toString() const
+{
+    return getText({ 0, length });
+}
+
+//======================================================================================================================
+std::size_t TextRope::findChunk(int offset) const noexcept
+{
+    const auto it = std::upper_bound(chunkEnds.begin(), chunkEnds.end(), offset);
+    return juce::jmin(static_cast<std::size_t>(std::distance(chunkEnds.begin(), it)), chunks.size() - 1);
+}
+
+int TextRope::getChunkStart(std::size_t index) const noexcept
+{
+    return index == 0 ? 0 : chunkEnds[index - 1];
+}
+
+void TextRope::updateChunkEnds(std::size_t fromIndex)
+{
+    chunkEnds.resize(chunks.size());
+    
+    for (std::size_t i = fromIndex; i < chunks.size(); ++i)
+    {
+        chunkEnds[i] = getChunkStart(i) + static_cast<int>(chunks[i]->size());
+    }
+}
+//======================================================================================================================
+// endregion TextRope
+//**********************************************************************************************************************
@@ -0,0 +1,103 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextRope.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "ITextSource.h"
+
+#include <juce_core/juce_core.h>
+
+/**
+    A chunked rope holding the text of a document as code points.
+    
+    The text is split into immutable chunks of a bounded size, an edit only rebuilds the chunks it touches.
+    Since chunks are shared and never modified, copying a rope only copies chunk pointers, which makes it cheap
+    to hand out a snapshot of a large document to another thread.
+    
+    Offsets are in characters, the same as juce::CodeDocument positions.
+ */
+class TextRope : public ITextSource
+{
+public:
+    using Char  = juce::juce_wchar;
+    using Chunk = std::basic_string<Char>;
+    
+    //==================================================================================================================
+    static constexpr int Max_Chunk_Size = 4096;
+    static constexpr int Min_Chunk_Size = 1024;
+    
+    //==================================================================================================================
+    TextRope() = default;
+    explicit TextRope(const juce::String &text);
+    
+    //==================================================================================================================
+    /**
+        Replaces a range of the text with new text.
+        
+        @param offset       The character offset the edit starts at
+        @param removeLength The number of characters to remove from offset on
+        @param text         The text to insert at offset after removing
+     */
+    void replace(int offset, int removeLength, const juce::String &text);
+    
+    void insert(int offset, const juce::String &text) { replace(offset, 0, text); }
+    void remove(int offset, int length)               { replace(offset, length, {}); }
+    
+    //==================================================================================================================
+    /**
+        Copies characters into a buffer.
+        
+        @param offset The offset to start reading at
+        @param buffer The buffer to copy the characters to
+        @param count  The maximum number of characters to copy
+        @return The number of characters that were copied
+     */
+    int read(int offset, Char *buffer, int count) const noexcept override;
+    
+    //==================================================================================================================
+    Char         getCharAt(int offset)          const noexcept;
+    juce::String getText(juce::Range<int> range) const;
+    juce::String toString()                     const;
+    
+    //==================================================================================================================
+    int getLength()    const noexcept override { return length; }
+    int getNumChunks() const noexcept { return static_cast<int>(chunks.size()); }
+    
+private:
+    using ChunkPtr = std::shared_ptr<const Chunk>;
+    
+    //==================================================================================================================
+    std::vector<ChunkPtr> chunks;
+    std::vector<int>      chunkEnds;
+    int                   length { 0 };
+    
+    //==================================================================================================================
+    std::size_t findChunk(int offset) const noexcept;
+    int         getChunkStart(std::size_t index) const noexcept;
+    
+    void updateChunkEnds(std::size_t fromIndex);
+    
+    JUCE_LEAK_DETECTOR(TextRope)
+};
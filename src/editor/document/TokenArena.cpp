@@ -0,0 +1,176 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TokenArena.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "TokenArena.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    /** Below this many entries an arena is not worth compacting, whatever the share of released runs. */
+    constexpr std::size_t Min_Compact_Size = 1 << 16;
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Builder
+//======================================================================================================================
+void TokenArena::Builder::add(int start, int style)
+{
+    jassert(start >= lastStart);
+    jassert(juce::isPositiveAndNotGreaterThan(style, Max_Style));
+    
+    // A gap of more than 65536 characters passes several multiples at once, each of them gets its own wrap
+    while (static_cast<std::size_t>(start >> 16) > wraps.size())
+    {
+        wraps.push_back(static_cast<std::uint32_t>(packed.size()));
+    }
+    
+    packed.push_back({ static_cast<std::uint16_t>(start & 0xffff),
+                       static_cast<std::uint16_t>(juce::jlimit(0, Max_Style, style)) });
+    lastStart = start;
+}
+
+void TokenArena::Builder::clear() noexcept
+{
+    packed.clear();
+    wraps.clear();
+    lastStart = 0;
+}
+
+//======================================================================================================================
+std::uint32_t TokenArena::Builder::getSize() const noexcept
+{
+    return static_cast<std::uint32_t>(packed.size() + wraps.size() * 2);
+}
+//======================================================================================================================
+// endregion Builder
+//**********************************************************************************************************************
+// region TokenArena
+//======================================================================================================================
+TokenArena::Run TokenArena::store(const Builder &builder, Run previous)
+{
+    const std::uint32_t size = builder.getSize();
+    
+    if (size <= previous.size)
+    {
+        write(builder, previous.offset);
+        numReleased += previous.size - size;
+        return { previous.offset, size };
+    }
+    
+    release(previous);
+    
+    const auto offset = static_cast<std::uint32_t>(packed.size());
+    packed.resize(packed.size() + size);
+    write(builder, offset);
+    return { offset, size };
+}
+
+TokenArena::Run TokenArena::copyFrom(const TokenArena &source, Run run)
+{
+    const auto offset = static_cast<std::uint32_t>(packed.size());
+    const auto first  = source.packed.begin() + run.offset;
+    
+    packed.insert(packed.end(), first, first + run.size);
+    return { offset, run.size };
+}
+
+void TokenArena::release(Run run) noexcept
+{
+    numReleased += run.size;
+}
+
+//======================================================================================================================
+TokenArena::Token TokenArena::getToken(Run run, int index) const noexcept
+{
+    const auto num_tokens  = static_cast<std::uint32_t>(getNumTokens(run));
+    const auto token_index = static_cast<std::uint32_t>(index);
+    
+    jassert(token_index < num_tokens);
+    
+    // Wraps are sorted, the ones at or before the token say how many multiples of 65536 its start is past
+    std::uint32_t low  = num_tokens;
+    std::uint32_t high = run.size;
+    
+    while (low < high)
+    {
+        const std::uint32_t middle = low + (high - low) / 4 * 2;
+        
+        if (getWrap(run, middle) <= token_index)
+        {
+            low = middle + 2;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    
+    const auto         num_wraps = static_cast<int>((low - num_tokens) / 2);
+    const PackedToken &token     = packed[run.offset + token_index];
+    return { (num_wraps << 16) | token.start, token.style };
+}
+
+int TokenArena::getNumTokens(Run run) const noexcept
+{
+    // Wraps come after the tokens, so the tokens are the part of the run before the first one
+    const auto first = packed.begin() + run.offset;
+    
+    return static_cast<int>(std::partition_point(first, first + run.size, [](const PackedToken &token)
+    {
+        return token.style != Wrap_Style;
+    }) - first);
+}
+
+//======================================================================================================================
+bool TokenArena::shouldCompact() const noexcept
+{
+    return packed.size() >= Min_Compact_Size && numReleased > packed.size() / 2;
+}
+
+//======================================================================================================================
+void TokenArena::write(const Builder &builder, std::uint32_t offset) noexcept
+{
+    const auto wraps_start = std::copy(builder.packed.begin(), builder.packed.end(), packed.begin() + offset);
+    auto       destination = wraps_start;
+    
+    for (const std::uint32_t wrap : builder.wraps)
+    {
+        *destination++ = { static_cast<std::uint16_t>(wrap & 0xffff), Wrap_Style };
+        *destination++ = { static_cast<std::uint16_t>(wrap >> 16),    Wrap_Style };
+    }
+}
+
+std::uint32_t TokenArena::getWrap(Run run, std::uint32_t entry) const noexcept
+{
+    const std::uint32_t position = run.offset + entry;
+    return static_cast<std::uint32_t>(packed[position].start)
+           | (static_cast<std::uint32_t>(packed[position + 1].start) << 16);
+}
+//======================================================================================================================
+// endregion TokenArena
+//**********************************************************************************************************************
@@ -0,0 +1,166 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TokenArena.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "small_vector/small_vector.h"
+
+/**
+    The syntax tokens of every line of a document, packed into one shared buffer.
+    
+    A token is stored as the lower 16 bits of its start and its style id, so it takes up 4 bytes and every token
+    of a line can be looked up directly by its index. Lines longer than 16 bit offsets can reach have the index of
+    the first token past every multiple of 65536 characters stored after their tokens, these are few and sorted,
+    so the rest of a start is found with a binary search. A line only keeps a Run, which is where its tokens are.
+    Tokens of a line are gathered in a Builder first, which keeps short lines in inline storage, and are then
+    copied into the buffer in one go. Runs that are replaced by longer ones leave a hole behind, once holes make
+    up most of the buffer the lines should be copied into a fresh arena.
+ */
+class TokenArena
+{
+public:
+    /** The number of tokens a builder can hold before it has to allocate. */
+    static constexpr std::size_t Inline_Tokens = 64;
+    
+    /** The highest style id a token can have. */
+    static constexpr int Max_Style = 0xfffe;
+    
+    //==================================================================================================================
+    struct Token
+    {
+        int start; // Relative to the start of the line
+        int style; // The index of the token's entry in the scheme
+    };
+    
+    /** Where the tokens of one line are, the default run has no tokens. */
+    struct Run
+    {
+        std::uint32_t offset { 0 };
+        std::uint32_t size   { 0 }; // In packed entries, which may be more than the number of tokens
+    };
+    
+private:
+    struct PackedToken
+    {
+        std::uint16_t start; // The lower 16 bits, or half of a wrap's token index
+        std::uint16_t style;
+    };
+    
+    /**
+        Marks the two entries after the tokens that hold the index of the first token whose start is past another
+        multiple of 65536, the lower half first.
+     */
+    static constexpr std::uint16_t Wrap_Style = 0xffff;
+    
+public:
+    /** Collects the tokens of a line before they are stored. */
+    class Builder
+    {
+    public:
+        /** Adds a token, tokens must be added in order of their start. */
+        void add(int start, int style);
+        
+        /** Forgets all tokens so the builder can be used for the next line. */
+        void clear() noexcept;
+    
+    private:
+        friend class TokenArena;
+        
+        //==============================================================================================================
+        sbo::small_vector<PackedToken, Inline_Tokens> packed;
+        std::vector<std::uint32_t>                    wraps; // Only lines past 65535 characters have any
+        int                                           lastStart { 0 };
+        
+        //==============================================================================================================
+        std::uint32_t getSize() const noexcept;
+    };
+    
+    //==================================================================================================================
+    TokenArena() = default;
+    
+    TokenArena(TokenArena&&) noexcept            = default;
+    TokenArena& operator=(TokenArena&&) noexcept = default;
+    
+    //==================================================================================================================
+    /**
+        Stores the tokens of a builder for a line.
+        
+        @param builder  The tokens of the line
+        @param previous The line's old run or an empty one, its space is reused if the new tokens fit
+        @return The line's new run
+     */
+    Run store(const Builder &builder, Run previous);
+    
+    /** Copies the tokens of a run from another arena, used to compact an arena into a fresh one. */
+    Run copyFrom(const TokenArena &source, Run run);
+    
+    /** Marks the space of a run as unused, for lines that were removed. */
+    void release(Run run) noexcept;
+    
+    //==================================================================================================================
+    /** Calls a function with each token of a run, in order. */
+    template<class Fn>
+    void forEachToken(Run run, Fn &&callback) const
+    {
+        const auto    num_tokens = static_cast<std::uint32_t>(getNumTokens(run));
+        std::uint32_t next_wrap  = num_tokens;
+        int           high       = 0;
+        
+        for (std::uint32_t i = 0; i < num_tokens; ++i)
+        {
+            for (; next_wrap < run.size && getWrap(run, next_wrap) <= i; next_wrap += 2)
+            {
+                high += 1 << 16;
+            }
+            
+            const PackedToken &token = packed[run.offset + i];
+            callback(Token { high | token.start, token.style });
+        }
+    }
+    
+    /** Gets a token of a run by its index, which must be below getNumTokens(). */
+    Token getToken(Run run, int index) const noexcept;
+    
+    /** Gets the number of tokens in a run. */
+    int getNumTokens(Run run) const noexcept;
+    
+    //==================================================================================================================
+    /** Checks whether most of the buffer is taken up by released runs. */
+    bool shouldCompact() const noexcept;
+    
+    /** Gets the number of bytes this arena has reserved. */
+    std::size_t getMemoryUsage() const noexcept { return packed.capacity() * sizeof(PackedToken); }
+    
+private:
+    std::vector<PackedToken> packed;
+    std::size_t              numReleased { 0 };
+    
+    //==================================================================================================================
+    void          write(const Builder &builder, std::uint32_t offset) noexcept;
+    std::uint32_t getWrap(Run run, std::uint32_t entry) const noexcept;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TokenArena)
+};
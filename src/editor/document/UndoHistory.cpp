@@ -0,0 +1,547 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   UndoHistory.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "UndoHistory.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    /** The most bytes a 32 bit value takes up as a variable length integer. */
+    constexpr std::size_t Max_Var_Int_Size = 5;
+    
+    //==================================================================================================================
+    std::size_t writeVarInt(std::uint8_t *destination, std::uint32_t value) noexcept
+    {
+        std::size_t size = 0;
+        
+        while (value >= 0x80)
+        {
+            destination[size++] = static_cast<std::uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        
+        destination[size++] = static_cast<std::uint8_t>(value);
+        return size;
+    }
+    
+    bool readVarInt(const std::uint8_t *&position, const std::uint8_t *end, std::uint32_t &value) noexcept
+    {
+        value = 0;
+        
+        for (int shift = 0; position < end && shift < 35; shift += 7)
+        {
+            const std::uint8_t byte = *position++;
+            value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+            
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region UndoHistory
+//======================================================================================================================
+UndoHistory::UndoHistory() = default;
+
+UndoHistory::~UndoHistory()
+{
+    if (spillStream != nullptr)
+    {
+        spillStream.reset();
+        (void) spillFile.deleteFile();
+    }
+}
+
+//======================================================================================================================
+void UndoHistory::setMemoryBudget(std::size_t numBytes)
+{
+    memoryBudget = numBytes;
+    
+    if (!inAction)
+    {
+        enforceBudgets();
+    }
+}
+
+void UndoHistory::setSpillBudget(std::size_t numBytes)
+{
+    spillBudget = numBytes;
+    
+    if (!inAction)
+    {
+        enforceBudgets();
+    }
+}
+
+//======================================================================================================================
+void UndoHistory::beginAction(EditKind kind)
+{
+    if (inAction)
+    {
+        endAction();
+    }
+    
+    inAction     = true;
+    actionOpened = false;
+    actionKind   = kind;
+}
+
+void UndoHistory::endAction()
+{
+    inAction     = false;
+    actionOpened = false;
+    
+    enforceBudgets();
+}
+
+void UndoHistory::addEdit(int start, const juce::String &removed, const juce::String &inserted)
+{
+    jassert(start >= 0);
+    
+    if (!inAction || !actionOpened)
+    {
+        startTransaction(inAction ? actionKind : EditKind::Other);
+        actionOpened = inAction;
+    }
+    
+    const std::size_t removed_bytes  = removed .getNumBytesAsUTF8();
+    const std::size_t inserted_bytes = inserted.getNumBytesAsUTF8();
+    
+    std::uint8_t header[Max_Var_Int_Size * 3];
+    std::size_t  header_size = 0;
+    
+    header_size += ::writeVarInt(header + header_size, static_cast<std::uint32_t>(start));
+    header_size += ::writeVarInt(header + header_size, static_cast<std::uint32_t>(removed_bytes));
+    header_size += ::writeVarInt(header + header_size, static_cast<std::uint32_t>(inserted_bytes));
+    
+    append(header, header_size);
+    append(removed .toRawUTF8(), removed_bytes);
+    append(inserted.toRawUTF8(), inserted_bytes);
+    
+    Transaction &transaction = transactions.back();
+    transaction.end          = streamEnd;
+    transaction.lastEditTime = juce::Time::getMillisecondCounter();
+    
+    if (!inAction)
+    {
+        enforceBudgets();
+    }
+}
+
+void UndoHistory::clear()
+{
+    transactions.clear();
+    chunks.clear();
+    numDone      = 0;
+    memoryStart  = 0;
+    streamEnd    = 0;
+    actionOpened = false;
+    sealed       = true;
+    
+    resetSpillFile();
+}
+
+//======================================================================================================================
+std::vector<UndoHistory::Edit> UndoHistory::undo()
+{
+    std::vector<Edit> edits;
+    
+    if (!canUndo())
+    {
+        return edits;
+    }
+    
+    if (!readEdits(transactions[numDone - 1], edits))
+    {
+        clear();
+        return {};
+    }
+    
+    --numDone;
+    sealed = true;
+    
+    std::reverse(edits.begin(), edits.end());
+    
+    for (Edit &edit : edits)
+    {
+        std::swap(edit.removed, edit.inserted);
+    }
+    
+    return edits;
+}
+
+std::vector<UndoHistory::Edit> UndoHistory::redo()
+{
+    std::vector<Edit> edits;
+    
+    if (!canRedo())
+    {
+        return edits;
+    }
+    
+    if (!readEdits(transactions[numDone], edits))
+    {
+        clear();
+        return {};
+    }
+    
+    ++numDone;
+    sealed = true;
+    
+    return edits;
+}
+
+//======================================================================================================================
+std::size_t UndoHistory::getMemoryUsage() const noexcept
+{
+    return chunks.size() * Chunk_Size + transactions.size() * sizeof(Transaction);
+}
+
+std::size_t UndoHistory::getSpilledSize() const noexcept
+{
+    const std::uint64_t history_start = getHistoryStart();
+    return static_cast<std::size_t>(memoryStart > history_start ? memoryStart - history_start : 0);
+}
+
+std::size_t UndoHistory::getSpillFileSize() const noexcept
+{
+    // The file holds the stream from spillStart up to where the history in memory begins
+    return static_cast<std::size_t>(spillStream != nullptr ? memoryStart - spillStart : 0);
+}
+
+//======================================================================================================================
+void UndoHistory::startTransaction(EditKind kind)
+{
+    if (canRedo())
+    {
+        dropRedoTransactions();
+    }
+    
+    const juce::uint32 now = juce::Time::getMillisecondCounter();
+    
+    if (!sealed && kind != EditKind::Other && !transactions.empty())
+    {
+        const Transaction &last = transactions.back();
+        
+        if (last.kind == kind && now - last.lastEditTime <= Coalesce_Interval)
+        {
+            return;
+        }
+    }
+    
+    transactions.push_back({ streamEnd, streamEnd, now, kind });
+    numDone = transactions.size();
+    sealed  = false;
+}
+
+void UndoHistory::dropRedoTransactions()
+{
+    const std::uint64_t new_end = (numDone > 0 ? transactions[numDone - 1].end : getHistoryStart());
+    
+    transactions.erase(transactions.begin() + static_cast<std::ptrdiff_t>(numDone), transactions.end());
+    truncate(new_end);
+}
+
+bool UndoHistory::readEdits(const Transaction &transaction, std::vector<Edit> &edits)
+{
+    const auto                    size = static_cast<std::size_t>(transaction.end - transaction.begin);
+    juce::HeapBlock<std::uint8_t> data(size);
+    
+    if (!read(transaction.begin, transaction.end, data.get()))
+    {
+        return false;
+    }
+    
+    const std::uint8_t *position = data.get();
+    const std::uint8_t *end      = position + size;
+    
+    while (position < end)
+    {
+        std::uint32_t start, removed_bytes, inserted_bytes;
+        
+        if (!::readVarInt(position, end, start)
+            || !::readVarInt(position, end, removed_bytes)
+            || !::readVarInt(position, end, inserted_bytes)
+            || static_cast<std::size_t>(end - position) < std::size_t { removed_bytes } + inserted_bytes)
+        {
+            return false;
+        }
+        
+        const auto *removed  = reinterpret_cast<const char*>(position);
+        const auto *inserted = removed + removed_bytes;
+        position += removed_bytes + inserted_bytes;
+        
+        edits.push_back({ static_cast<int>(start),
+                          juce::String::fromUTF8(removed,  static_cast<int>(removed_bytes)),
+                          juce::String::fromUTF8(inserted, static_cast<int>(inserted_bytes)) });
+    }
+    
+    return true;
+}
+
+//======================================================================================================================
+std::uint64_t UndoHistory::getHistoryStart() const noexcept
+{
+    return (transactions.empty() ? streamEnd : transactions.front().begin);
+}
+
+void UndoHistory::append(const void *data, std::size_t numBytes)
+{
+    const auto *source = static_cast<const std::uint8_t*>(data);
+    
+    while (numBytes > 0)
+    {
+        const auto index  = static_cast<std::size_t>((streamEnd - memoryStart) / Chunk_Size);
+        const auto offset = static_cast<std::size_t>(streamEnd % Chunk_Size);
+        const auto count  = std::min(numBytes, Chunk_Size - offset);
+        
+        if (index == chunks.size())
+        {
+            chunks.push_back(std::make_unique<std::uint8_t[]>(Chunk_Size));
+        }
+        
+        std::memcpy(chunks[index].get() + offset, source, count);
+        source    += count;
+        numBytes  -= count;
+        streamEnd += count;
+    }
+}
+
+bool UndoHistory::read(std::uint64_t begin, std::uint64_t end, std::uint8_t *destination)
+{
+    if (begin < memoryStart)
+    {
+        const std::uint64_t spilled_end = std::min(end, memoryStart);
+        const auto          num_bytes   = static_cast<int>(spilled_end - begin);
+        
+        if (spillStream == nullptr || begin < spillStart)
+        {
+            return false;
+        }
+        
+        spillStream->flush();
+        juce::FileInputStream input(spillFile);
+        
+        if (input.failedToOpen()
+            || !input.setPosition(static_cast<juce::int64>(begin - spillStart))
+            || input.read(destination, num_bytes) != num_bytes)
+        {
+            return false;
+        }
+        
+        destination += num_bytes;
+        begin        = spilled_end;
+    }
+    
+    while (begin < end)
+    {
+        const auto index  = static_cast<std::size_t>((begin - memoryStart) / Chunk_Size);
+        const auto offset = static_cast<std::size_t>(begin % Chunk_Size);
+        const auto count  = static_cast<std::size_t>(std::min<std::uint64_t>(end - begin, Chunk_Size - offset));
+        
+        std::memcpy(destination, chunks[index].get() + offset, count);
+        destination += count;
+        begin       += count;
+    }
+    
+    return true;
+}
+
+void UndoHistory::truncate(std::uint64_t newEnd)
+{
+    if (newEnd >= memoryStart)
+    {
+        chunks.resize(static_cast<std::size_t>((newEnd - memoryStart + Chunk_Size - 1) / Chunk_Size));
+        streamEnd = newEnd;
+        return;
+    }
+    
+    // The stream now ends in spilled history, so the chunk it ends in has to be brought back into memory
+    const std::uint64_t chunk_start = newEnd - newEnd % Chunk_Size;
+    const std::uint64_t read_start  = std::max(chunk_start, spillStart);
+    auto                chunk       = std::make_unique<std::uint8_t[]>(Chunk_Size);
+    
+    if (!read(read_start, newEnd, chunk.get() + (read_start - chunk_start)))
+    {
+        clear();
+        return;
+    }
+    
+    chunks.clear();
+    
+    if (newEnd > chunk_start)
+    {
+        chunks.push_back(std::move(chunk));
+    }
+    
+    memoryStart = chunk_start;
+    streamEnd   = newEnd;
+    
+    if (memoryStart <= spillStart)
+    {
+        resetSpillFile();
+    }
+    else
+    {
+        (void) spillStream->setPosition(static_cast<juce::int64>(memoryStart - spillStart));
+        (void) spillStream->truncate();
+    }
+}
+
+//======================================================================================================================
+void UndoHistory::enforceBudgets()
+{
+    // The chunk that is written to stays in memory whatever the budget
+    while (chunks.size() * Chunk_Size > memoryBudget && streamEnd - memoryStart >= Chunk_Size)
+    {
+        if (!spillFrontChunk())
+        {
+            forgetBefore(memoryStart + Chunk_Size);
+        }
+    }
+    
+    while (getSpilledSize() > spillBudget)
+    {
+        forgetBefore(getHistoryStart() + 1);
+    }
+}
+
+void UndoHistory::forgetBefore(std::uint64_t offset)
+{
+    while (!transactions.empty() && transactions.front().begin < offset)
+    {
+        transactions.pop_front();
+        numDone -= (numDone > 0 ? 1 : 0);
+    }
+    
+    const std::uint64_t history_start = getHistoryStart();
+    
+    while (!chunks.empty() && history_start >= memoryStart + Chunk_Size)
+    {
+        chunks.pop_front();
+        memoryStart += Chunk_Size;
+    }
+    
+    if (history_start >= memoryStart)
+    {
+        resetSpillFile();
+    }
+    else if (history_start - spillStart > std::max<std::uint64_t>(memoryStart - history_start, Chunk_Size))
+    {
+        compactSpillFile(history_start);
+    }
+}
+
+bool UndoHistory::spillFrontChunk()
+{
+    if (spillFailed || spillBudget < Chunk_Size || !openSpillFile())
+    {
+        return false;
+    }
+    
+    if (!spillStream->write(chunks.front().get(), Chunk_Size))
+    {
+        // Whatever part of the chunk made it into the file is cut off again, the history is forgotten instead
+        (void) spillStream->setPosition(static_cast<juce::int64>(memoryStart - spillStart));
+        (void) spillStream->truncate();
+        spillFailed = true;
+        return false;
+    }
+    
+    chunks.pop_front();
+    memoryStart += Chunk_Size;
+    return true;
+}
+
+bool UndoHistory::openSpillFile()
+{
+    if (spillStream != nullptr)
+    {
+        return true;
+    }
+    
+    spillFile   = juce::File::createTempFile(".undo");
+    spillStream = std::make_unique<juce::FileOutputStream>(spillFile);
+    spillStart  = memoryStart;
+    
+    if (spillStream->failedToOpen())
+    {
+        spillStream.reset();
+        spillFailed = true;
+        return false;
+    }
+    
+    return true;
+}
+
+void UndoHistory::resetSpillFile()
+{
+    spillStart = memoryStart;
+    
+    if (spillStream != nullptr)
+    {
+        (void) spillStream->setPosition(0);
+        (void) spillStream->truncate();
+    }
+}
+
+void UndoHistory::compactSpillFile(std::uint64_t newStart)
+{
+    const juce::File compacted_file = juce::File::createTempFile(".undo");
+    const auto       num_bytes      = static_cast<juce::int64>(memoryStart - newStart);
+    
+    auto stream = std::make_unique<juce::FileOutputStream>(compacted_file);
+    spillStream->flush();
+    
+    juce::FileInputStream input(spillFile);
+    
+    if (stream->failedToOpen()
+        || input.failedToOpen()
+        || !input.setPosition(static_cast<juce::int64>(newStart - spillStart))
+        || stream->writeFromInputStream(input, num_bytes) != num_bytes)
+    {
+        // The old file is still valid, it only stays bigger than it has to be
+        stream.reset();
+        (void) compacted_file.deleteFile();
+        return;
+    }
+    
+    spillStream = std::move(stream);
+    (void) spillFile.deleteFile();
+    
+    spillFile  = compacted_file;
+    spillStart = newStart;
+}
+//======================================================================================================================
+// endregion UndoHistory
+//**********************************************************************************************************************
@@ -0,0 +1,174 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   UndoHistory.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <deque>
+
+/**
+    The undo history of a document, kept apart from juce::CodeDocument's own so its memory can be bounded.
+    
+    Every edit is stored as a delta, which is its start and the text it removed and inserted, written as variable
+    length integers followed by the utf-8 text. Deltas are appended to a stream of fixed size chunks and a
+    transaction only remembers which part of the stream its deltas are in, so a keystroke costs a few bytes.
+    Keystrokes of the same kind that follow each other closely are coalesced into one transaction.
+    
+    Once the chunks take up more than the memory budget, the oldest ones are spilled to a temporary file and read
+    back when they are undone. History beyond the spill budget, or beyond the memory budget if spilling is disabled
+    or fails, is forgotten; the spill file is compacted once most of it has been forgotten.
+ */
+class UndoHistory
+{
+public:
+    static constexpr std::size_t Chunk_Size            = 1 << 16;
+    static constexpr std::size_t Default_Memory_Budget = 1 << 23;
+    static constexpr std::size_t Default_Spill_Budget  = 1 << 28;
+    
+    /** Actions of the same kind that are at most this many milliseconds apart are coalesced. */
+    static constexpr juce::uint32 Coalesce_Interval = 1000;
+    
+    //==================================================================================================================
+    enum class EditKind
+    {
+        Other, // Never coalesced, like pasting or inserting a new line
+        Typing,
+        Deleting
+    };
+    
+    struct Edit
+    {
+        int          start;
+        juce::String removed;
+        juce::String inserted;
+    };
+    
+    //==================================================================================================================
+    UndoHistory();
+    ~UndoHistory();
+    
+    //==================================================================================================================
+    /** Sets how many bytes of history are kept in memory before the oldest is spilled or forgotten. */
+    void setMemoryBudget(std::size_t numBytes);
+    
+    /** Sets how many bytes of history may be spilled to a temporary file, 0 forgets it right away instead. */
+    void setSpillBudget(std::size_t numBytes);
+    
+    //==================================================================================================================
+    /**
+        Starts an action of the user, all edits until endAction() are undone together.
+        If the last transaction is of the same kind, was not sealed and had an edit a moment ago, the action is
+        coalesced into it. Edits that are recorded outside of an action each become a transaction of their own.
+     */
+    void beginAction(EditKind kind);
+    void endAction();
+    
+    /** Records an edit that was made to the document, with the offset as it was when the edit was made. */
+    void addEdit(int start, const juce::String &removed, const juce::String &inserted);
+    
+    /** Stops the next action from being coalesced into the last transaction, for example when the caret moved. */
+    void seal() noexcept { sealed = true; }
+    
+    /** Forgets all history. */
+    void clear();
+    
+    //==================================================================================================================
+    bool canUndo() const noexcept { return numDone > 0; }
+    bool canRedo() const noexcept { return numDone < transactions.size(); }
+    
+    /**
+        Gets the edits that revert the last transaction, in the order they have to be applied.
+        If the transaction could not be read back from the spill file, all history is forgotten and this is empty.
+     */
+    std::vector<Edit> undo();
+    
+    /** Gets the edits of the last undone transaction, in the order they have to be applied. */
+    std::vector<Edit> redo();
+    
+    //==================================================================================================================
+    int getNumTransactions() const noexcept { return static_cast<int>(transactions.size()); }
+    
+    /** Gets the number of bytes the history has reserved in memory. */
+    std::size_t getMemoryUsage() const noexcept;
+    
+    /** Gets the number of bytes of history that are only in the spill file. */
+    std::size_t getSpilledSize() const noexcept;
+    
+    /** Gets the size of the spill file, which also counts forgotten history until the file is compacted. */
+    std::size_t getSpillFileSize() const noexcept;
+    
+private:
+    struct Transaction
+    {
+        std::uint64_t begin; // Offsets in the stream of deltas
+        std::uint64_t end;
+        juce::uint32  lastEditTime;
+        EditKind      kind;
+    };
+    
+    //==================================================================================================================
+    std::deque<Transaction>                     transactions;
+    std::deque<std::unique_ptr<std::uint8_t[]>> chunks;
+    std::size_t                                 numDone { 0 };
+    
+    // The stream is spilled up to memoryStart, the file starts at spillStart; memoryStart is a multiple of a chunk
+    std::uint64_t memoryStart { 0 };
+    std::uint64_t spillStart  { 0 };
+    std::uint64_t streamEnd   { 0 };
+    
+    juce::File                               spillFile;
+    std::unique_ptr<juce::FileOutputStream> spillStream;
+    
+    std::size_t memoryBudget { Default_Memory_Budget };
+    std::size_t spillBudget  { Default_Spill_Budget };
+    EditKind    actionKind   { EditKind::Other };
+    bool        inAction     { false };
+    bool        actionOpened { false };
+    bool        sealed       { true };
+    bool        spillFailed  { false };
+    
+    //==================================================================================================================
+    void startTransaction(EditKind kind);
+    void dropRedoTransactions();
+    bool readEdits(const Transaction &transaction, std::vector<Edit> &edits);
+    
+    //==================================================================================================================
+    std::uint64_t getHistoryStart() const noexcept;
+    
+    void append(const void *data, std::size_t numBytes);
+    bool read(std::uint64_t begin, std::uint64_t end, std::uint8_t *destination);
+    void truncate(std::uint64_t newEnd);
+    
+    //==================================================================================================================
+    void enforceBudgets();
+    void forgetBefore(std::uint64_t offset);
+    bool spillFrontChunk();
+    bool openSpillFile();
+    void resetSpillFile();
+    void compactSpillFile(std::uint64_t newStart);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UndoHistory)
+};
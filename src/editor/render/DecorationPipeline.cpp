@@ -0,0 +1,202 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DecorationPipeline.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "DecorationPipeline.h"
+
+#include "SquiggleRenderer.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    constexpr float Dot_Size   = 2.0f;
+    constexpr float Dot_Period = 6.0f;
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region DecorationPipeline
+//======================================================================================================================
+void DecorationPipeline::beginFrame(juce::Rectangle<float> newViewport)
+{
+    viewport = newViewport;
+    
+    // Batches are only marked unused, so their storage is there for the next frame
+    for (auto &layer : layers)
+    {
+        for (std::size_t i = 0; i < layer.numUsed; ++i)
+        {
+            layer.batches[i].bounds.clear();
+        }
+        
+        layer.numUsed = 0;
+    }
+}
+
+void DecorationPipeline::add(TextDecorationRenderMode mode, DecorationStyle style, juce::Colour colour,
+                             juce::Rectangle<float> bounds)
+{
+    bounds = bounds.getIntersection(viewport);
+    
+    if (bounds.isEmpty())
+    {
+        return;
+    }
+    
+    Layer      &layer = layers[static_cast<std::size_t>(mode)];
+    const auto begin  = layer.batches.begin();
+    const auto end    = begin + static_cast<std::ptrdiff_t>(layer.numUsed);
+    
+    // There are only ever a handful of styles per frame, a linear search beats hashing them
+    auto batch = std::find_if(begin, end, [style, colour](const Batch &candidate)
+    {
+        return candidate.style == style && candidate.colour == colour;
+    });
+    
+    if (batch == end)
+    {
+        if (layer.numUsed == layer.batches.size())
+        {
+            layer.batches.emplace_back();
+        }
+        
+        batch = layer.batches.begin() + static_cast<std::ptrdiff_t>(layer.numUsed++);
+        batch->style  = style;
+        batch->colour = colour;
+    }
+    
+    batch->bounds.push_back(bounds);
+}
+
+void DecorationPipeline::render(juce::Graphics &g, TextDecorationRenderMode mode)
+{
+    Layer &layer = layers[static_cast<std::size_t>(mode)];
+    numFills = 0;
+    
+    for (std::size_t i = 0; i < layer.numUsed; ++i)
+    {
+        Batch &batch = layer.batches[i];
+        
+        if (batch.style == DecorationStyle::Waved)
+        {
+            fillWaves(g, batch);
+            continue;
+        }
+        
+        scratch.clear();
+        addShapes(batch);
+        
+        g.setColour(batch.colour);
+        g.fillRectList(scratch);
+        ++numFills;
+    }
+}
+
+//======================================================================================================================
+void DecorationPipeline::fillWaves(juce::Graphics &g, Batch &batch)
+{
+    const float       scale  = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const juce::Image &tile  = getWaveTile(batch.colour, scale);
+    const auto        height = static_cast<float>(SquiggleRendererWaved::Height);
+    
+    std::sort(batch.bounds.begin(), batch.bounds.end(), [](const auto &a, const auto &b)
+    {
+        return a.getBottom() < b.getBottom();
+    });
+    
+    for (auto it = batch.bounds.begin(); it != batch.bounds.end();)
+    {
+        const float bottom = it->getBottom();
+        scratch.clear();
+        
+        for (; it != batch.bounds.end() && it->getBottom() == bottom; ++it)
+        {
+            scratch.addWithoutMerging(it->withTop(bottom - height));
+        }
+        
+        // Anchored at the bottom of the row and the left of the viewport, so waves of one row are in phase
+        g.setFillType(juce::FillType(tile, juce::AffineTransform::scale(1.0f / scale)
+                                                                   .translated(viewport.getX(), bottom - height)));
+        g.fillRectList(scratch);
+        ++numFills;
+    }
+}
+
+void DecorationPipeline::addShapes(const Batch &batch)
+{
+    scratch.ensureStorageAllocated(static_cast<int>(batch.bounds.size()));
+    
+    for (const auto &bounds : batch.bounds)
+    {
+        switch (batch.style)
+        {
+            case DecorationStyle::Fill:
+                scratch.addWithoutMerging(bounds);
+                break;
+            
+            case DecorationStyle::Underlined:
+                scratch.addWithoutMerging(bounds.withTop(bounds.getBottom() - 1.0f));
+                break;
+            
+            case DecorationStyle::Bordered:
+                scratch.addWithoutMerging(bounds.withHeight(1.0f));
+                scratch.addWithoutMerging(bounds.withTop(bounds.getBottom() - 1.0f));
+                scratch.addWithoutMerging(bounds.withWidth(1.0f));
+                scratch.addWithoutMerging(bounds.withLeft(bounds.getRight() - 1.0f));
+                break;
+            
+            case DecorationStyle::Dotted:
+                for (float x = bounds.getX(); x < bounds.getRight(); x += ::Dot_Period)
+                {
+                    scratch.addWithoutMerging({ x, bounds.getBottom() - ::Dot_Size,
+                                                juce::jmin(::Dot_Size, bounds.getRight() - x), ::Dot_Size });
+                }
+                
+                break;
+            
+            case DecorationStyle::Waved:
+                break;
+        }
+    }
+}
+
+const juce::Image& DecorationPipeline::getWaveTile(juce::Colour colour, float scale)
+{
+    const std::uint64_t key = (static_cast<std::uint64_t>(colour.getARGB()) << 32)
+                              | static_cast<std::uint32_t>(juce::roundToInt(scale * 100.0f));
+    
+    auto it = waveTiles.find(key);
+    
+    if (it == waveTiles.end())
+    {
+        it = waveTiles.emplace(key, SquiggleRendererWaved::createTile(colour, scale)).first;
+    }
+    
+    return it->second;
+}
+//======================================================================================================================
+// endregion DecorationPipeline
+//**********************************************************************************************************************
@@ -0,0 +1,102 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DecorationPipeline.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "TextDecorationRenderMode.h"
+
+#include <juce_graphics/juce_graphics.h>
+
+enum class DecorationStyle
+{
+    Fill,
+    Waved,
+    Bordered,
+    Dotted,
+    Underlined
+};
+
+/**
+    Collects the decorations of a frame and draws them grouped by layer, style and colour.
+    
+    Decorations are added in pixel bounds, anything outside the viewport is dropped and the rest clipped to it.
+    Each group is then drawn with a single fill of a rectangle list: borders, dots and underlines are made of thin
+    rectangles and waved squiggles are filled with a pre-rendered tile of one wave, which is cached per colour and
+    pixel scale. Waves have to line up with the bottom of their row, so those take one fill per row instead.
+    
+    The collected rectangles are kept between frames, so a steady frame allocates nothing.
+ */
+class DecorationPipeline
+{
+public:
+    DecorationPipeline() = default;
+    
+    //==================================================================================================================
+    /** Drops all decorations and sets the area of the next frame. */
+    void beginFrame(juce::Rectangle<float> viewport);
+    
+    /** Adds a decoration to the current frame. */
+    void add(TextDecorationRenderMode mode, DecorationStyle style, juce::Colour colour, juce::Rectangle<float> bounds);
+    
+    /** Draws all decorations of a layer. */
+    void render(juce::Graphics &g, TextDecorationRenderMode mode);
+    
+    //==================================================================================================================
+    /** Gets the number of separate fills the last call to render() needed, for profiling. */
+    int getNumFills() const noexcept { return numFills; }
+
+private:
+    struct Batch
+    {
+        DecorationStyle                     style;
+        juce::Colour                        colour;
+        std::vector<juce::Rectangle<float>> bounds;
+    };
+    
+    struct Layer
+    {
+        std::vector<Batch> batches;
+        std::size_t        numUsed { 0 };
+    };
+    
+    //==================================================================================================================
+    static constexpr std::size_t Num_Layers = 3;
+    
+    //==================================================================================================================
+    std::array<Layer, Num_Layers>                  layers;
+    std::unordered_map<std::uint64_t, juce::Image> waveTiles;
+    juce::RectangleList<float>                     scratch;
+    juce::Rectangle<float>                         viewport;
+    int                                            numFills { 0 };
+    
+    //==================================================================================================================
+    void fillWaves(juce::Graphics &g, Batch &batch);
+    void addShapes(const Batch &batch);
+    
+    const juce::Image& getWaveTile(juce::Colour colour, float scale);
+    
+    //==================================================================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecorationPipeline)
+};
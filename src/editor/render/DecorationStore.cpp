@@ -0,0 +1,317 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DecorationStore.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "DecorationStore.h"
+
+//**********************************************************************************************************************
+// region DecorationStore
+//======================================================================================================================
+void DecorationStore::add(const Decoration &decoration)
+{
+    if (decoration.range.isEmpty())
+    {
+        return;
+    }
+    
+    const NodeId id            = createNode(decoration);
+    const auto   [left, right] = split(root, decoration.range.getStart());
+    
+    root = merge(merge(left, id), right);
+}
+
+void DecorationStore::removeGroup(std::uint16_t group)
+{
+    std::vector<NodeId> all;
+    all.reserve(static_cast<std::size_t>(numDecorations));
+    collect(root, all);
+    
+    root = Invalid_Id;
+    
+    // Nodes come out sorted, so rebuilding only ever appends to the right edge of the tree
+    for (const NodeId id : all)
+    {
+        if (nodes[id].decoration.group == group)
+        {
+            freeNode(id);
+        }
+        else
+        {
+            root = merge(root, id);
+        }
+    }
+}
+
+void DecorationStore::removeGroup(std::uint16_t group, juce::Range<int> range)
+{
+    const auto [left, rest]   = split(root, range.getStart());
+    const auto [inner, right] = split(rest, range.getEnd());
+    
+    std::vector<NodeId> candidates;
+    collect(inner, candidates);
+    
+    NodeId middle = Invalid_Id;
+    
+    for (const NodeId id : candidates)
+    {
+        if (nodes[id].decoration.group == group)
+        {
+            freeNode(id);
+        }
+        else
+        {
+            middle = merge(middle, id);
+        }
+    }
+    
+    root = merge(merge(left, middle), right);
+}
+
+void DecorationStore::clear()
+{
+    nodes    .clear();
+    freeNodes.clear();
+    root           = Invalid_Id;
+    numDecorations = 0;
+}
+
+//======================================================================================================================
+void DecorationStore::applyEdit(int start, int removedLength, int insertedLength)
+{
+    if (root == Invalid_Id)
+    {
+        return;
+    }
+    
+    const int old_end = start + removedLength;
+    const int delta   = insertedLength - removedLength;
+    
+    // Decorations starting before the edit, inside the removed text and after it
+    const auto [left, rest]   = split(root, start);
+    const auto [inner, right] = split(rest, old_end);
+    
+    if (right != Invalid_Id)
+    {
+        shift(right, delta);
+    }
+    
+    clampEnds(left, start, old_end, delta);
+    
+    std::vector<NodeId> moved;
+    collect(inner, moved);
+    
+    NodeId middle = Invalid_Id;
+    
+    for (const NodeId id : moved)
+    {
+        Node      &node    = nodes[id];
+        const int end     = node.decoration.range.getEnd();
+        const int new_end = end >= old_end ? end + delta : start;
+        
+        if (new_end > start)
+        {
+            node.decoration.range = { start, new_end };
+            update(id);
+            middle = merge(middle, id);
+        }
+        else
+        {
+            freeNode(id);
+        }
+    }
+    
+    root = merge(merge(left, middle), right);
+}
+
+//======================================================================================================================
+DecorationStore::NodeId DecorationStore::createNode(const Decoration &decoration)
+{
+    // xorshift, the priorities only need to look random to keep the tree balanced
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    
+    const Node node { decoration, decoration.range.getEnd(), 0, seed, Invalid_Id, Invalid_Id };
+    ++numDecorations;
+    
+    if (!freeNodes.empty())
+    {
+        const NodeId id = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[id] = node;
+        return id;
+    }
+    
+    nodes.push_back(node);
+    return static_cast<NodeId>(nodes.size() - 1);
+}
+
+void DecorationStore::freeNode(NodeId id)
+{
+    freeNodes.push_back(id);
+    --numDecorations;
+}
+
+//======================================================================================================================
+void DecorationStore::shift(NodeId id, int delta) noexcept
+{
+    Node &node = nodes[id];
+    node.decoration.range += delta;
+    node.maxEnd           += delta;
+    node.pendingShift     += delta;
+}
+
+void DecorationStore::push(NodeId id) noexcept
+{
+    Node &node = nodes[id];
+    
+    if (node.pendingShift != 0)
+    {
+        if (node.left != Invalid_Id)
+        {
+            shift(node.left, node.pendingShift);
+        }
+        
+        if (node.right != Invalid_Id)
+        {
+            shift(node.right, node.pendingShift);
+        }
+        
+        node.pendingShift = 0;
+    }
+}
+
+void DecorationStore::update(NodeId id) noexcept
+{
+    Node &node = nodes[id];
+    node.maxEnd = node.decoration.range.getEnd();
+    
+    if (node.left != Invalid_Id)
+    {
+        node.maxEnd = juce::jmax(node.maxEnd, nodes[node.left].maxEnd + node.pendingShift);
+    }
+    
+    if (node.right != Invalid_Id)
+    {
+        node.maxEnd = juce::jmax(node.maxEnd, nodes[node.right].maxEnd + node.pendingShift);
+    }
+}
+
+//======================================================================================================================
+std::pair<DecorationStore::NodeId, DecorationStore::NodeId> DecorationStore::split(NodeId id, int start)
+{
+    if (id == Invalid_Id)
+    {
+        return { Invalid_Id, Invalid_Id };
+    }
+    
+    push(id);
+    Node &node = nodes[id];
+    
+    if (node.decoration.range.getStart() < start)
+    {
+        const auto [left, right] = split(node.right, start);
+        nodes[id].right = left;
+        update(id);
+        return { id, right };
+    }
+    
+    const auto [left, right] = split(node.left, start);
+    nodes[id].left = right;
+    update(id);
+    return { left, id };
+}
+
+DecorationStore::NodeId DecorationStore::merge(NodeId left, NodeId right)
+{
+    if (left == Invalid_Id)
+    {
+        return right;
+    }
+    
+    if (right == Invalid_Id)
+    {
+        return left;
+    }
+    
+    if (nodes[left].priority > nodes[right].priority)
+    {
+        push(left);
+        const NodeId merged = merge(nodes[left].right, right);
+        nodes[left].right = merged;
+        update(left);
+        return left;
+    }
+    
+    push(right);
+    const NodeId merged = merge(left, nodes[right].left);
+    nodes[right].left = merged;
+    update(right);
+    return right;
+}
+
+//======================================================================================================================
+void DecorationStore::clampEnds(NodeId id, int editStart, int oldEnd, int delta)
+{
+    if (id == Invalid_Id || nodes[id].maxEnd <= editStart)
+    {
+        return;
+    }
+    
+    push(id);
+    clampEnds(nodes[id].left,  editStart, oldEnd, delta);
+    clampEnds(nodes[id].right, editStart, oldEnd, delta);
+    
+    // Decorations before the edit can only lose their tail or grow and shrink with text inside them
+    juce::Range<int> &range = nodes[id].decoration.range;
+    
+    if (range.getEnd() > editStart)
+    {
+        range.setEnd(range.getEnd() >= oldEnd ? range.getEnd() + delta : editStart);
+    }
+    
+    update(id);
+}
+
+void DecorationStore::collect(NodeId id, std::vector<NodeId> &result)
+{
+    if (id == Invalid_Id)
+    {
+        return;
+    }
+    
+    push(id);
+    collect(nodes[id].left, result);
+    
+    const NodeId right = nodes[id].right;
+    nodes[id].left  = Invalid_Id;
+    nodes[id].right = Invalid_Id;
+    update(id);
+    result.push_back(id);
+    
+    collect(right, result);
+}
+//======================================================================================================================
+// endregion DecorationStore
+//**********************************************************************************************************************
@@ -0,0 +1,173 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DecorationStore.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "DecorationPipeline.h"
+
+struct Decoration
+{
+    juce::Range<int>         range;  // In document offsets
+    juce::Colour             colour;
+    DecorationStyle          style;
+    TextDecorationRenderMode mode;
+    std::uint16_t            group;  // Who added the decoration, so everything of one source can be replaced at once
+};
+
+/**
+    Holds decorations by the range of the document they cover and keeps them in place while the document is edited.
+    
+    The decorations live in a treap ordered by their start, where every node also knows the largest end in its
+    subtree, so all decorations overlapping a range are found in O(log n + k). An edit splits the tree at the edited
+    range: everything after it is shifted through a lazy offset on the root of that part, only decorations that
+    overlap the edit are touched one by one, and those that are removed entirely are dropped.
+    
+    Text inserted right at the start of a decoration pushes it along, text inserted at its end doesn't extend it.
+ */
+class DecorationStore
+{
+public:
+    DecorationStore() = default;
+    
+    //==================================================================================================================
+    void add(const Decoration &decoration);
+    void removeGroup(std::uint16_t group);
+    
+    /** Removes the decorations of a group that start inside a range, leaving everything else where it is. */
+    void removeGroup(std::uint16_t group, juce::Range<int> range);
+    void clear();
+    
+    /** Moves all decorations to where their text went after an edit. */
+    void applyEdit(int start, int removedLength, int insertedLength);
+    
+    //==================================================================================================================
+    /** Calls back with every decoration that overlaps a range, ordered by their start. */
+    template<class Fn>
+    void forEachInRange(juce::Range<int> range, Fn &&callback) const
+    {
+        visit(root, 0, range, callback);
+    }
+    
+    /** Calls back with every decoration of a group, ordered by their start. */
+    template<class Fn>
+    void forEachInGroup(std::uint16_t group, Fn &&callback) const
+    {
+        visit(root, 0, { std::numeric_limits<int>::min(), std::numeric_limits<int>::max() },
+              [group, &callback](const Decoration &decoration)
+              {
+                  if (decoration.group == group)
+                  {
+                      callback(decoration);
+                  }
+              });
+    }
+    
+    //==================================================================================================================
+    int  size()    const noexcept { return numDecorations; }
+    bool isEmpty() const noexcept { return numDecorations == 0; }
+
+private:
+    using NodeId = std::uint32_t;
+    
+    //==================================================================================================================
+    static constexpr NodeId Invalid_Id = std::numeric_limits<std::uint32_t>::max();
+    
+    //==================================================================================================================
+    struct Node
+    {
+        Decoration    decoration;
+        int           maxEnd;
+        int           pendingShift;   // Still to be added to both children
+        std::uint32_t priority;
+        NodeId        left;
+        NodeId        right;
+    };
+    
+    //==================================================================================================================
+    std::vector<Node>   nodes;
+    std::vector<NodeId> freeNodes;
+    NodeId              root           { Invalid_Id };
+    int                 numDecorations { 0 };
+    std::uint32_t       seed           { 0x9e3779b9 };
+    
+    //==================================================================================================================
+    NodeId createNode(const Decoration &decoration);
+    void   freeNode(NodeId id);
+    
+    void shift (NodeId id, int delta) noexcept;
+    void push  (NodeId id) noexcept;
+    void update(NodeId id) noexcept;
+    
+    std::pair<NodeId, NodeId> split(NodeId id, int start);
+    NodeId                    merge(NodeId left, NodeId right);
+    
+    void clampEnds(NodeId id, int editStart, int oldEnd, int delta);
+    void collect  (NodeId id, std::vector<NodeId> &result);
+    
+    //==================================================================================================================
+    template<class Fn>
+    void visit(NodeId id, int shift, juce::Range<int> range, Fn &&callback) const
+    {
+        // shift is the sum of the pending shifts above this node, which are not in its stored offsets yet
+        while (id != Invalid_Id)
+        {
+            const Node &node = nodes[id];
+            
+            if (node.maxEnd + shift <= range.getStart())
+            {
+                return;
+            }
+            
+            visit(node.left, shift + node.pendingShift, range, callback);
+            
+            const Decoration &decoration = node.decoration;
+            
+            if (decoration.range.getStart() + shift >= range.getEnd())
+            {
+                return;
+            }
+            
+            if (decoration.range.getEnd() + shift > range.getStart())
+            {
+                if (shift == 0)
+                {
+                    callback(decoration);
+                }
+                else
+                {
+                    Decoration shifted = decoration;
+                    shifted.range += shift;
+                    callback(shifted);
+                }
+            }
+            
+            shift += node.pendingShift;
+            id     = node.right;
+        }
+    }
+    
+    //==================================================================================================================
+    JUCE_LEAK_DETECTOR(DecorationStore)
+};
@@ -0,0 +1,105 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DigitGlyphCache.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "DigitGlyphCache.h"
+
+//**********************************************************************************************************************
+// region DigitGlyphCache
+//======================================================================================================================
+void DigitGlyphCache::setFont(const juce::Font &newFont)
+{
+    font = newFont;
+    
+    juce::Array<int>   glyph_numbers;
+    juce::Array<float> x_offsets;
+    font.getGlyphPositions("0123456789", glyph_numbers, x_offsets);
+    
+    // A font without digits draws nothing instead of reading past the shaped glyphs
+    if (glyph_numbers.size() != 10 || x_offsets.size() != 11)
+    {
+        glyphs.fill(0);
+        offsets.fill(0.0f);
+        digitWidth = 0.0f;
+        return;
+    }
+    
+    digitWidth = 0.0f;
+    
+    for (int i = 0; i < 10; ++i)
+    {
+        digitWidth = juce::jmax(digitWidth, x_offsets[i + 1] - x_offsets[i]);
+    }
+    
+    for (int i = 0; i < 10; ++i)
+    {
+        const auto index = static_cast<std::size_t>(i);
+        
+        glyphs [index] = glyph_numbers[i];
+        offsets[index] = (digitWidth - (x_offsets[i + 1] - x_offsets[i])) / 2.0f;
+    }
+}
+
+int DigitGlyphCache::getNumDigits(int number) noexcept
+{
+    int num_digits = 1;
+    
+    while (number >= 10)
+    {
+        number /= 10;
+        ++num_digits;
+    }
+    
+    return num_digits;
+}
+
+//======================================================================================================================
+void DigitGlyphCache::drawNumber(juce::Graphics &g, int number, float right, float baseline) const
+{
+    jassert(number >= 0);
+    
+    if (digitWidth <= 0.0f)
+    {
+        return;
+    }
+    
+    juce::LowLevelGraphicsContext &context = g.getInternalContext();
+    context.setFont(font);
+    
+    // Digits are drawn from the last to the first, so the number never has to be measured
+    float x = right;
+    
+    do
+    {
+        const auto digit = static_cast<std::size_t>(number % 10);
+        number /= 10;
+        x      -= digitWidth;
+        
+        context.drawGlyph(glyphs[digit], juce::AffineTransform::translation(x + offsets[digit], baseline));
+    }
+    while (number > 0);
+}
+//======================================================================================================================
+// endregion DigitGlyphCache
+//**********************************************************************************************************************
@@ -0,0 +1,70 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DigitGlyphCache.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+
+/**
+    The glyphs of the ten digits of a font, shaped once so that numbers can be drawn without building strings.
+    
+    Drawing a number splits it into its digits with integer division and puts the glyph of each of them straight
+    into the graphics context; nothing is formatted, laid out or shaped per call. Every digit is centred in a cell
+    as wide as the widest digit, so numbers line up in columns even if the font's digits are proportional.
+ */
+class DigitGlyphCache
+{
+public:
+    DigitGlyphCache() = default;
+    
+    //==================================================================================================================
+    /** Sets the font to draw with and shapes its digits. */
+    void setFont(const juce::Font &newFont);
+    
+    const juce::Font& getFont()       const noexcept { return font; }
+    float             getDigitWidth() const noexcept { return digitWidth; }
+    
+    /** Gets how many digits a non-negative number has, which is at least one. */
+    static int getNumDigits(int number) noexcept;
+    
+    //==================================================================================================================
+    /**
+        Draws a non-negative number in the current colour of the graphics context.
+        
+        @param g        The context to draw into
+        @param number   The number to draw
+        @param right    Where the last digit ends
+        @param baseline The baseline of the digits
+     */
+    void drawNumber(juce::Graphics &g, int number, float right, float baseline) const;
+    
+private:
+    juce::Font            font;
+    std::array<int, 10>   glyphs  {};
+    std::array<float, 10> offsets {}; // Moves each digit to the middle of its cell
+    float                 digitWidth { 0.0f };
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DigitGlyphCache)
+};
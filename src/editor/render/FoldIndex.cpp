@@ -0,0 +1,555 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FoldIndex.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+
+#include "FoldIndex.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    template<class Node>
+    int getVisibleRows(const Node &node, int offset) noexcept
+    {
+        return node.minHidden + offset == 0 ? node.numAtMin : 0;
+    }
+    
+    template<class Node>
+    double getVisibleExtra(const Node &node, int offset) noexcept
+    {
+        return node.minHidden + offset == 0 ? node.extraAtMin : 0.0;
+    }
+    
+    std::uint32_t nextPriority(std::uint32_t &seed) noexcept
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region FoldIndex
+//======================================================================================================================
+void FoldIndex::reset(int parNumLines)
+{
+    nodes.clear();
+    freeNodes.clear();
+    
+    numLines = juce::jmax(0, parNumLines);
+    root     = buildTree(numLines, 0);
+}
+
+void FoldIndex::insertLines(int line, int count)
+{
+    jassert(juce::isPositiveAndNotGreaterThan(line, numLines) && count >= 0);
+    
+    if (count <= 0)
+    {
+        return;
+    }
+    
+    int fill = 0;
+    
+    if (line > 0)
+    {
+        (void) findLine(line - 1, fill);
+    }
+    
+    const auto [before, after] = split(root, line);
+    root      = merge(merge(before, buildTree(count, fill)), after);
+    numLines += count;
+}
+
+void FoldIndex::removeLines(int line, int count)
+{
+    jassert(juce::isPositiveAndNotGreaterThan(line + count, numLines) && line >= 0 && count >= 0);
+    
+    if (count <= 0)
+    {
+        return;
+    }
+    
+    const auto [before, rest]    = split(root, line);
+    const auto [removed, after] = split(rest, count);
+    
+    freeTree(removed);
+    root      = merge(before, after);
+    numLines -= count;
+}
+
+//======================================================================================================================
+void FoldIndex::hideLines(juce::Range<int> lineRange)
+{
+    addToRange(lineRange, 1);
+}
+
+void FoldIndex::showLines(juce::Range<int> lineRange)
+{
+    addToRange(lineRange, -1);
+}
+
+//======================================================================================================================
+void FoldIndex::setDefaultHeight(double newHeight) noexcept
+{
+    jassert(newHeight > 0.0);
+    defaultHeight = newHeight;
+}
+
+void FoldIndex::setExtraHeight(int line, double extraHeight)
+{
+    if (juce::isPositiveAndBelow(line, numLines))
+    {
+        setExtra(root, line, extraHeight);
+    }
+}
+
+double FoldIndex::getLineHeight(int line) const noexcept
+{
+    int hidden = 0;
+    return defaultHeight + (juce::isPositiveAndBelow(line, numLines) ? getNode(findLine(line, hidden)).extra : 0.0);
+}
+
+double FoldIndex::getTotalHeight() const noexcept
+{
+    return getSpanHeight(getVisible(root, 0));
+}
+
+//======================================================================================================================
+bool FoldIndex::isLineVisible(int line) const noexcept
+{
+    int hidden = 0;
+    return juce::isPositiveAndBelow(line, numLines) && (findLine(line, hidden), hidden == 0);
+}
+
+int FoldIndex::getNumRows() const noexcept
+{
+    return getVisible(root, 0).numRows;
+}
+
+//======================================================================================================================
+int FoldIndex::getRowForLine(int line) const noexcept
+{
+    return juce::jmax(0, getVisibleBefore(juce::jlimit(0, numLines, line + 1)).numRows - 1);
+}
+
+int FoldIndex::getLineForRow(int row) const noexcept
+{
+    if (row < 0 || row >= getNumRows())
+    {
+        return row < 0 ? 0 : numLines;
+    }
+    
+    int index  = root;
+    int first  = 0;
+    int offset = 0;
+    
+    for (;;)
+    {
+        const Node &node          = getNode(index);
+        const int  child_offset = offset + node.pending;
+        const int  left_rows    = getVisible(node.left, child_offset).numRows;
+        
+        if (row < left_rows)
+        {
+            index  = node.left;
+            offset = child_offset;
+            continue;
+        }
+        
+        row   -= left_rows;
+        first += getSize(node.left);
+        
+        if (node.hidden + offset == 0)
+        {
+            if (row == 0)
+            {
+                return first;
+            }
+            
+            --row;
+        }
+        
+        index  = node.right;
+        offset = child_offset;
+        first += 1;
+    }
+}
+
+//======================================================================================================================
+double FoldIndex::getYForLine(int line) const noexcept
+{
+    const int shown_line = getLineForRow(getRowForLine(line));
+    return getSpanHeight(getVisibleBefore(shown_line));
+}
+
+int FoldIndex::getLineAtY(double y) const noexcept
+{
+    if (getNumRows() == 0 || y >= getTotalHeight())
+    {
+        return numLines;
+    }
+    
+    int index  = root;
+    int first  = 0;
+    int offset = 0;
+    
+    y = juce::jmax(0.0, y);
+    
+    for (;;)
+    {
+        const Node   &node          = getNode(index);
+        const int    child_offset = offset + node.pending;
+        const double left_height  = getSpanHeight(getVisible(node.left, child_offset));
+        
+        if (y < left_height)
+        {
+            index  = node.left;
+            offset = child_offset;
+            continue;
+        }
+        
+        y     -= left_height;
+        first += getSize(node.left);
+        
+        if (node.hidden + offset == 0)
+        {
+            const double height = defaultHeight + node.extra;
+            
+            // The last visible line takes whatever is left, so rounding never runs past the end
+            if (y < height || node.right < 0 || getVisible(node.right, child_offset).numRows == 0)
+            {
+                return first;
+            }
+            
+            y -= height;
+        }
+        
+        index  = node.right;
+        offset = child_offset;
+        first += 1;
+    }
+}
+
+//======================================================================================================================
+int FoldIndex::buildTree(int count, int hidden)
+{
+    // The lines come in order, so the tree only ever grows along its right spine; a node that is pushed off
+    // the spine has its final children and can be summed up right away
+    std::vector<int> spine;
+    
+    for (int i = 0; i < count; ++i)
+    {
+        int index = 0;
+        
+        if (!freeNodes.empty())
+        {
+            index = freeNodes.back();
+            freeNodes.pop_back();
+        }
+        else
+        {
+            index = static_cast<int>(nodes.size());
+            nodes.emplace_back();
+        }
+        
+        Node &node = getNode(index);
+        node = { -1, -1, ::nextPriority(seed), 1, hidden, 0.0, hidden, 1, 0.0, 0 };
+        
+        while (!spine.empty() && getNode(spine.back()).priority < node.priority)
+        {
+            node.left = spine.back();
+            spine.pop_back();
+            pull(node.left);
+        }
+        
+        if (!spine.empty())
+        {
+            getNode(spine.back()).right = index;
+        }
+        
+        spine.emplace_back(index);
+    }
+    
+    for (auto it = spine.rbegin(); it != spine.rend(); ++it)
+    {
+        pull(*it);
+    }
+    
+    return spine.empty() ? -1 : spine.front();
+}
+
+void FoldIndex::freeTree(int index)
+{
+    std::vector<int> stack;
+    
+    if (index >= 0)
+    {
+        stack.emplace_back(index);
+    }
+    
+    while (!stack.empty())
+    {
+        const Node &node = getNode(stack.back());
+        freeNodes.emplace_back(stack.back());
+        stack.pop_back();
+        
+        for (const int child : { node.left, node.right })
+        {
+            if (child >= 0)
+            {
+                stack.emplace_back(child);
+            }
+        }
+    }
+}
+
+//======================================================================================================================
+int FoldIndex::merge(int left, int right) noexcept
+{
+    if (left < 0 || right < 0)
+    {
+        return left >= 0 ? left : right;
+    }
+    
+    if (getNode(left).priority > getNode(right).priority)
+    {
+        push(left);
+        getNode(left).right = merge(getNode(left).right, right);
+        pull(left);
+        return left;
+    }
+    
+    push(right);
+    getNode(right).left = merge(left, getNode(right).left);
+    pull(right);
+    return right;
+}
+
+std::pair<int, int> FoldIndex::split(int index, int count) noexcept
+{
+    if (index < 0)
+    {
+        return { -1, -1 };
+    }
+    
+    push(index);
+    Node &node = getNode(index);
+    
+    if (const int left_size = getSize(node.left); count <= left_size)
+    {
+        const auto [left, right] = split(node.left, count);
+        getNode(index).left = right;
+        pull(index);
+        return { left, index };
+    }
+    else
+    {
+        const auto [left, right] = split(node.right, count - left_size - 1);
+        getNode(index).right = left;
+        pull(index);
+        return { index, right };
+    }
+}
+
+//======================================================================================================================
+void FoldIndex::apply(int index, int delta) noexcept
+{
+    if (index >= 0)
+    {
+        Node &node = getNode(index);
+        node.hidden    += delta;
+        node.minHidden += delta;
+        node.pending   += delta;
+    }
+}
+
+void FoldIndex::push(int index) noexcept
+{
+    Node &node = getNode(index);
+    
+    if (node.pending != 0)
+    {
+        apply(node.left,  node.pending);
+        apply(node.right, node.pending);
+        node.pending = 0;
+    }
+}
+
+void FoldIndex::pull(int index) noexcept
+{
+    Node &node = getNode(index);
+    
+    node.size       = 1 + getSize(node.left) + getSize(node.right);
+    node.minHidden  = node.hidden;
+    node.numAtMin   = 1;
+    node.extraAtMin = node.extra;
+    
+    for (const int child : { node.left, node.right })
+    {
+        if (child < 0)
+        {
+            continue;
+        }
+        
+        // A child's counts don't include what is still pending here
+        const Node &other  = getNode(child);
+        const int  lowest = other.minHidden + node.pending;
+        
+        if (lowest < node.minHidden)
+        {
+            node.minHidden  = lowest;
+            node.numAtMin   = other.numAtMin;
+            node.extraAtMin = other.extraAtMin;
+        }
+        else if (lowest == node.minHidden)
+        {
+            node.numAtMin   += other.numAtMin;
+            node.extraAtMin += other.extraAtMin;
+        }
+    }
+}
+
+void FoldIndex::setExtra(int index, int line, double extraHeight) noexcept
+{
+    push(index);
+    Node &node = getNode(index);
+    
+    if (const int left_size = getSize(node.left); line < left_size)
+    {
+        setExtra(node.left, line, extraHeight);
+    }
+    else if (line > left_size)
+    {
+        setExtra(node.right, line - left_size - 1, extraHeight);
+    }
+    else
+    {
+        node.extra = extraHeight;
+    }
+    
+    pull(index);
+}
+
+void FoldIndex::addToRange(juce::Range<int> lineRange, int delta) noexcept
+{
+    lineRange = lineRange.getIntersectionWith({ 0, numLines });
+    
+    if (lineRange.isEmpty())
+    {
+        return;
+    }
+    
+    const auto [before, rest]  = split(root, lineRange.getStart());
+    const auto [range, after] = split(rest, lineRange.getLength());
+    
+    apply(range, delta);
+    root = merge(merge(before, range), after);
+}
+
+//======================================================================================================================
+int FoldIndex::findLine(int line, int &hidden) const noexcept
+{
+    int index  = root;
+    int offset = 0;
+    
+    for (;;)
+    {
+        const Node &node      = getNode(index);
+        const int  left_size = getSize(node.left);
+        
+        if (line == left_size)
+        {
+            hidden = node.hidden + offset;
+            return index;
+        }
+        
+        offset += node.pending;
+        
+        if (line < left_size)
+        {
+            index = node.left;
+        }
+        else
+        {
+            line -= left_size + 1;
+            index = node.right;
+        }
+    }
+}
+
+FoldIndex::Span FoldIndex::getVisible(int index, int offset) const noexcept
+{
+    if (index < 0)
+    {
+        return { 0, 0.0 };
+    }
+    
+    const Node &node = getNode(index);
+    return { ::getVisibleRows(node, offset), ::getVisibleExtra(node, offset) };
+}
+
+FoldIndex::Span FoldIndex::getVisibleBefore(int line) const noexcept
+{
+    Span span   { 0, 0.0 };
+    int  index  = root;
+    int  offset = 0;
+    
+    while (index >= 0 && line > 0)
+    {
+        const Node &node          = getNode(index);
+        const int  child_offset = offset + node.pending;
+        const int  left_size    = getSize(node.left);
+        
+        if (line <= left_size)
+        {
+            index  = node.left;
+            offset = child_offset;
+            continue;
+        }
+        
+        const Span left = getVisible(node.left, child_offset);
+        span.numRows     += left.numRows;
+        span.extraHeight += left.extraHeight;
+        
+        if (node.hidden + offset == 0)
+        {
+            span.numRows     += 1;
+            span.extraHeight += node.extra;
+        }
+        
+        line  -= left_size + 1;
+        index  = node.right;
+        offset = child_offset;
+    }
+    
+    return span;
+}
+//======================================================================================================================
+// endregion FoldIndex
+//**********************************************************************************************************************
@@ -0,0 +1,157 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FoldIndex.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+    Maps between document lines, the rows they are shown in when parts of the document are folded away and the
+    vertical position of those rows.
+    
+    Every line keeps a count of the collapsed folds that hide it and is shown only if that count is zero.
+    The lines are the nodes of an implicit treap, ordered by their position, and every subtree stores the smallest
+    count in it, how many lines share it and the summed extra height of those lines. Hiding or showing a range of
+    lines, changing the height of a line and looking up a row, line or y position are thus all O(log n) no matter
+    how many folds are nested or collapsed, inserting or removing lines is O(log n) plus the lines that change.
+    
+    A line is as high as the default height plus its own extra height, which is where description lines or inline
+    annotations go. Keeping the default apart means a font change doesn't have to touch every line.
+ */
+class FoldIndex
+{
+public:
+    FoldIndex() = default;
+    
+    //==================================================================================================================
+    /** Removes all folds and extra heights and resizes the index to the given number of lines. */
+    void reset(int numLines);
+    
+    /**
+        Inserts lines before the given line.
+        The new lines are hidden by the same folds as the line before them, so typing inside a collapsed region
+        doesn't make it pop open.
+     */
+    void insertLines(int line, int count);
+    void removeLines(int line, int count);
+    
+    //==================================================================================================================
+    /** Hides a range of lines because a fold containing them was collapsed. */
+    void hideLines(juce::Range<int> lineRange);
+    
+    /** Undoes a previous call to hideLines() with the same range. */
+    void showLines(juce::Range<int> lineRange);
+    
+    //==================================================================================================================
+    /** Sets the height every line has at least. */
+    void setDefaultHeight(double newHeight) noexcept;
+    
+    /** Sets how much higher than the default height a line is. */
+    void setExtraHeight(int line, double extraHeight);
+    
+    double getDefaultHeight()      const noexcept { return defaultHeight; }
+    double getLineHeight(int line) const noexcept;
+    
+    /** Gets the height of all visible rows together. */
+    double getTotalHeight() const noexcept;
+    
+    //==================================================================================================================
+    bool isLineVisible(int line) const noexcept;
+    
+    int getNumLines() const noexcept { return numLines; }
+    int getNumRows()  const noexcept;
+    
+    //==================================================================================================================
+    /** Gets the row a line is shown in, for a hidden line this is the row of the fold that hides it. */
+    int getRowForLine(int line) const noexcept;
+    
+    /** Gets the line that is shown in a row, or the number of lines if the row is past the end. */
+    int getLineForRow(int row) const noexcept;
+    
+    //==================================================================================================================
+    /** Gets the top of the row a line is shown in. */
+    double getYForLine(int line) const noexcept;
+    
+    /** Gets the line that is shown in the row covering a y position, or the number of lines if it is past the end. */
+    int getLineAtY(double y) const noexcept;
+
+private:
+    struct Node
+    {
+        int           left;       // The lines before this one in the subtree, or -1
+        int           right;      // The lines after this one in the subtree, or -1
+        std::uint32_t priority;
+        int           size;       // How many lines this subtree has
+        int           hidden;     // This line's own hide count
+        double        extra;      // This line's own extra height
+        int           minHidden;  // The smallest hide count in this subtree
+        int           numAtMin;   // How many lines in this subtree have that count
+        double        extraAtMin; // The extra height of these lines together
+        int           pending;    // Added to all children, but not yet to them
+    };
+    
+    struct Span
+    {
+        int    numRows;
+        double extraHeight;
+    };
+    
+    //==================================================================================================================
+    std::vector<Node> nodes;
+    std::vector<int>  freeNodes;
+    double            defaultHeight { 1.0 };
+    int               root          { -1 };
+    int               numLines      { 0 };
+    std::uint32_t     seed          { 0x9e3779b9u };
+    
+    //==================================================================================================================
+    int  buildTree(int count, int hidden);
+    void freeTree(int index);
+    
+    int                 merge(int left, int right) noexcept;
+    std::pair<int, int> split(int index, int count) noexcept;
+    
+    void apply(int index, int delta) noexcept;
+    void push(int index) noexcept;
+    void pull(int index) noexcept;
+    void setExtra(int index, int line, double extraHeight) noexcept;
+    
+    /** Adds to the hide counts of a range of lines, splitting it off and merging it back in. */
+    void addToRange(juce::Range<int> lineRange, int delta) noexcept;
+    
+    /** Finds the node of a line, along with its hide count including everything still pending above it. */
+    int findLine(int line, int &hidden) const noexcept;
+    
+    Node&       getNode(int index)       noexcept { return nodes[static_cast<std::size_t>(index)]; }
+    const Node& getNode(int index) const noexcept { return nodes[static_cast<std::size_t>(index)]; }
+    
+    int    getSize(int index) const noexcept { return index >= 0 ? getNode(index).size : 0; }
+    Span   getVisible(int index, int offset) const noexcept;
+    Span   getVisibleBefore(int line) const noexcept;
+    double getSpanHeight(Span span) const noexcept { return defaultHeight * span.numRows + span.extraHeight; }
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FoldIndex)
+};
@@ -0,0 +1,46 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   ITextLayoutStyle.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+
+/** The font and token styles a TextViewLayout lays out text with, so it doesn't depend on a component. */
+struct ITextLayoutStyle
+{
+    struct TokenType
+    {
+        juce::Colour colour;     // Colour of this token type
+        int          styleFlags; // Bit mask for juce::Font style flags
+    };
+    
+    //==================================================================================================================
+    virtual ~ITextLayoutStyle() = default;
+    
+    //==================================================================================================================
+    virtual const TokenType&  getTokenType(int id) const noexcept = 0;
+    virtual const juce::Font& getFont()            const noexcept = 0;
+    virtual float             getLineSpacing()     const noexcept = 0;
+};
@@ -0,0 +1,329 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   MinimapModel.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "MinimapModel.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    /** Below this many runs the buffer is not worth compacting, whatever the share of released runs. */
+    constexpr std::size_t Min_Compact_Size = 1 << 16;
+    
+    /** The highest column a run can start at. */
+    constexpr int Max_Column = std::numeric_limits<std::uint16_t>::max();
+    
+    /** How opaque the runs are drawn, so the minimap stays in the background. */
+    constexpr float Run_Alpha = 0.7f;
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region MinimapModel
+//======================================================================================================================
+void MinimapModel::reset(int numLines)
+{
+    runs.clear();
+    slots.assign(static_cast<std::size_t>(juce::jmax(0, numLines)), Slot{});
+    numReleased = 0;
+    
+    markDirtyFrom(0);
+}
+
+void MinimapModel::insertLines(int line, int count)
+{
+    jassert(juce::isPositiveAndNotGreaterThan(line, getNumLines()) && count >= 0);
+    
+    slots.insert(slots.begin() + line, static_cast<std::size_t>(count), Slot{});
+    markDirtyFrom(line);
+}
+
+void MinimapModel::removeLines(int line, int count)
+{
+    jassert(line >= 0 && count >= 0 && line + count <= getNumLines());
+    
+    const auto first = slots.begin() + line;
+    const auto last  = first + count;
+    
+    for (auto it = first; it != last; ++it)
+    {
+        numReleased += it->size;
+    }
+    
+    slots.erase(first, last);
+    markDirtyFrom(line);
+}
+
+void MinimapModel::setLine(int line, const juce::String &text, const TokenArena &arena, TokenArena::Run tokens)
+{
+    jassert(juce::isPositiveAndBelow(line, getNumLines()));
+    
+    lineTokens.clear();
+    lineRuns.clear();
+    
+    arena.forEachToken(tokens, [this](TokenArena::Token token)
+    {
+        lineTokens.push_back(token);
+    });
+    
+    // Tokens are in order of their start, so they are walked alongside the characters
+    std::size_t next_token = 0;
+    int         style      = Default_Style;
+    int         column     = 0;
+    int         index      = 0;
+    
+    for (auto it = text.getCharPointer(); !it.isEmpty() && column < Max_Column; ++index)
+    {
+        const juce::juce_wchar character = it.getAndAdvance();
+        
+        while (next_token < lineTokens.size() && lineTokens[next_token].start <= index)
+        {
+            style = lineTokens[next_token++].style;
+        }
+        
+        if (character == '\r' || character == '\n')
+        {
+            break;
+        }
+        
+        if (character == '\t')
+        {
+            column = (column / Tab_Size + 1) * Tab_Size;
+            continue;
+        }
+        
+        if (!juce::CharacterFunctions::isWhitespace(character))
+        {
+            if (!lineRuns.empty() && lineRuns.back().style == style
+                && lineRuns.back().start + lineRuns.back().length == column)
+            {
+                ++lineRuns.back().length;
+            }
+            else
+            {
+                lineRuns.push_back({ static_cast<std::uint16_t>(column), 1, static_cast<std::uint16_t>(style) });
+            }
+        }
+        
+        ++column;
+    }
+    
+    Slot       &slot = slots[static_cast<std::size_t>(line)];
+    const auto size  = static_cast<std::uint32_t>(lineRuns.size());
+    
+    if (size <= slot.size)
+    {
+        std::copy(lineRuns.begin(), lineRuns.end(), runs.begin() + slot.offset);
+        numReleased += slot.size - size;
+        slot.size    = size;
+    }
+    else
+    {
+        numReleased += slot.size;
+        slot         = { static_cast<std::uint32_t>(runs.size()), size };
+        runs.insert(runs.end(), lineRuns.begin(), lineRuns.end());
+    }
+    
+    if (runs.size() >= Min_Compact_Size && numReleased > runs.size() / 2)
+    {
+        compact();
+    }
+    
+    markLineDirty(line);
+}
+
+//======================================================================================================================
+void MinimapModel::setColours(const std::vector<juce::Colour> &styleColours, juce::Colour defaultColour)
+{
+    stylePixels.clear();
+    stylePixels.reserve(styleColours.size());
+    
+    for (const juce::Colour &colour : styleColours)
+    {
+        stylePixels.push_back(colour.withMultipliedAlpha(Run_Alpha).getPixelARGB());
+    }
+    
+    defaultPixel = defaultColour.withMultipliedAlpha(Run_Alpha).getPixelARGB();
+    std::fill(dirtyRows.begin(), dirtyRows.end(), 1);
+}
+
+const juce::Image& MinimapModel::render(int firstLine, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        image = juce::Image();
+        dirtyRows.clear();
+        return image;
+    }
+    
+    if (!image.isValid() || image.getWidth() != width || image.getHeight() != height)
+    {
+        image          = juce::Image(juce::Image::ARGB, width, height, true);
+        imageFirstLine = firstLine;
+        dirtyRows.assign(static_cast<std::size_t>((height + Row_Height - 1) / Row_Height), 1);
+    }
+    else if (firstLine != imageFirstLine)
+    {
+        scrollImage(firstLine);
+    }
+    
+    for (std::size_t row = 0; row < dirtyRows.size(); ++row)
+    {
+        if (dirtyRows[row] != 0)
+        {
+            drawRow(static_cast<int>(row));
+            dirtyRows[row] = 0;
+        }
+    }
+    
+    return image;
+}
+
+//======================================================================================================================
+std::size_t MinimapModel::getMemoryUsage() const noexcept
+{
+    return runs.capacity() * sizeof(PackedRun) + slots.capacity() * sizeof(Slot);
+}
+
+//======================================================================================================================
+void MinimapModel::compact()
+{
+    std::vector<PackedRun> compacted;
+    compacted.reserve(runs.size() - numReleased);
+    
+    for (Slot &slot : slots)
+    {
+        const auto offset = static_cast<std::uint32_t>(compacted.size());
+        
+        compacted.insert(compacted.end(), runs.begin() + slot.offset, runs.begin() + slot.offset + slot.size);
+        slot.offset = offset;
+    }
+    
+    runs        = std::move(compacted);
+    numReleased = 0;
+}
+
+//======================================================================================================================
+void MinimapModel::markLineDirty(int line) noexcept
+{
+    const int row = line - imageFirstLine;
+    
+    if (juce::isPositiveAndBelow(row, static_cast<int>(dirtyRows.size())))
+    {
+        dirtyRows[static_cast<std::size_t>(row)] = 1;
+    }
+}
+
+void MinimapModel::markDirtyFrom(int line) noexcept
+{
+    // Lines that were inserted or removed move every line after them to another row
+    const auto row = static_cast<std::size_t>(juce::jmax(0, line - imageFirstLine));
+    
+    if (row < dirtyRows.size())
+    {
+        std::fill(dirtyRows.begin() + static_cast<std::ptrdiff_t>(row), dirtyRows.end(), 1);
+    }
+}
+
+void MinimapModel::scrollImage(int firstLine)
+{
+    const int num_rows = static_cast<int>(dirtyRows.size());
+    const int delta    = firstLine - imageFirstLine;
+    const int shift    = delta * Row_Height;
+    
+    imageFirstLine = firstLine;
+    
+    if (std::abs(delta) >= num_rows)
+    {
+        std::fill(dirtyRows.begin(), dirtyRows.end(), 1);
+        return;
+    }
+    
+    // Rows that are still in view keep their pixels, only the rows that came into view have to be drawn
+    if (delta > 0)
+    {
+        image.moveImageSection(0, 0, 0, shift, image.getWidth(), image.getHeight() - shift);
+        std::move(dirtyRows.begin() + delta, dirtyRows.end(), dirtyRows.begin());
+        std::fill(dirtyRows.end() - delta, dirtyRows.end(), 1);
+        
+        // The bottom row may have been cut off by the edge of the image, it has to be drawn in full now
+        dirtyRows[static_cast<std::size_t>(num_rows - 1 - delta)] = 1;
+    }
+    else
+    {
+        image.moveImageSection(0, -shift, 0, 0, image.getWidth(), image.getHeight() + shift);
+        std::move_backward(dirtyRows.begin(), dirtyRows.end() + delta, dirtyRows.end());
+        std::fill(dirtyRows.begin(), dirtyRows.begin() - delta, 1);
+    }
+}
+
+void MinimapModel::drawRow(int row)
+{
+    const int width  = image.getWidth();
+    const int y      = row * Row_Height;
+    const int height = juce::jmin(Row_Height, image.getHeight() - y);
+    
+    juce::Image::BitmapData pixels(image, 0, y, width, height, juce::Image::BitmapData::writeOnly);
+    
+    for (int i = 0; i < height; ++i)
+    {
+        std::memset(pixels.getLinePointer(i), 0, static_cast<std::size_t>(width * pixels.pixelStride));
+    }
+    
+    const int line = imageFirstLine + row;
+    
+    if (!juce::isPositiveAndBelow(line, getNumLines()))
+    {
+        return;
+    }
+    
+    const Slot &slot       = slots[static_cast<std::size_t>(line)];
+    const int  filled_rows = juce::jmin(height, Row_Height - 1);
+    
+    for (std::uint32_t i = slot.offset; i < slot.offset + slot.size; ++i)
+    {
+        const PackedRun &run = runs[i];
+        
+        if (run.start >= width)
+        {
+            break;
+        }
+        
+        const juce::PixelARGB pixel = (run.style < stylePixels.size() ? stylePixels[run.style] : defaultPixel);
+        const int             end   = juce::jmin(width, run.start + run.length);
+        
+        for (int pixel_row = 0; pixel_row < filled_rows; ++pixel_row)
+        {
+            for (int x = run.start; x < end; ++x)
+            {
+                *reinterpret_cast<juce::PixelARGB*>(pixels.getPixelPointer(x, pixel_row)) = pixel;
+            }
+        }
+    }
+}
+//======================================================================================================================
+// endregion MinimapModel
+//**********************************************************************************************************************
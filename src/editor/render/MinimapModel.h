@@ -0,0 +1,133 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   MinimapModel.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "../document/TokenArena.h"
+
+#include <juce_graphics/juce_graphics.h>
+
+/**
+    The downsampled picture of a document that is shown beside the editor's scroll bar.
+    
+    Every line is summarized once as runs of columns that share the style of the token they are in, whitespace is
+    left out. A run takes up 6 bytes and the runs of all lines are packed into one buffer the same way TokenArena
+    packs tokens, so even a million lines only take a few megabytes.
+    
+    The picture is drawn into a cached image that shows a window of lines, one row of pixels per line and one pixel
+    per column, by writing the pixels directly without rendering any text. Changing a line only marks its row dirty
+    and only dirty rows are drawn again the next time the image is asked for; moving the window moves the pixels
+    that are still in it and draws the rows that came into view.
+ */
+class MinimapModel
+{
+public:
+    /** The height of a line in pixels, the last row of pixels is left empty as a gap between lines. */
+    static constexpr int Row_Height = 2;
+    
+    /** The number of columns a tab is expanded to. */
+    static constexpr int Tab_Size = 4;
+    
+    /** The style of text that is not in a token. */
+    static constexpr int Default_Style = 0xffff;
+    
+    //==================================================================================================================
+    MinimapModel() = default;
+    
+    //==================================================================================================================
+    /** Forgets all summaries and resizes the model to the given number of empty lines. */
+    void reset(int numLines);
+    
+    /** Inserts empty lines before the given line. */
+    void insertLines(int line, int count);
+    void removeLines(int line, int count);
+    
+    /**
+        Summarizes a line from its text and its syntax tokens, the run may be empty if the line has no tokens yet.
+        Columns past the highest a run can start at are left out, they would be far outside the image anyway.
+     */
+    void setLine(int line, const juce::String &text, const TokenArena &arena, TokenArena::Run tokens);
+    
+    int getNumLines() const noexcept { return static_cast<int>(slots.size()); }
+    
+    //==================================================================================================================
+    /** Sets the colours of the styles, the index of a colour being its style; this redraws the whole image. */
+    void setColours(const std::vector<juce::Colour> &styleColours, juce::Colour defaultColour);
+    
+    /**
+        Gets the picture of the lines from the given line on, drawing the rows that changed since the last call.
+        
+        @param firstLine The line shown in the top row
+        @param width     The width of the image in pixels
+        @param height    The height of the image in pixels
+        @return The cached image, which stays valid until the next call
+     */
+    const juce::Image& render(int firstLine, int width, int height);
+    
+    //==================================================================================================================
+    /** Gets the number of bytes the summaries take up. */
+    std::size_t getMemoryUsage() const noexcept;
+    
+private:
+    struct PackedRun
+    {
+        std::uint16_t start;
+        std::uint16_t length;
+        std::uint16_t style;
+    };
+    
+    struct Slot
+    {
+        std::uint32_t offset { 0 };
+        std::uint32_t size   { 0 };
+    };
+    
+    //==================================================================================================================
+    std::vector<PackedRun> runs;
+    std::vector<Slot>      slots;
+    std::size_t            numReleased { 0 };
+    
+    // Reused for every line that is summarized
+    std::vector<TokenArena::Token> lineTokens;
+    std::vector<PackedRun>         lineRuns;
+    
+    std::vector<juce::PixelARGB> stylePixels;
+    juce::PixelARGB              defaultPixel { juce::Colours::grey.getPixelARGB() };
+    
+    juce::Image               image;
+    std::vector<std::uint8_t> dirtyRows;
+    int                       imageFirstLine { 0 };
+    
+    //==================================================================================================================
+    void compact();
+    
+    //==================================================================================================================
+    void markLineDirty(int line) noexcept;
+    void markDirtyFrom(int line) noexcept;
+    void scrollImage(int firstLine);
+    void drawRow(int row);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MinimapModel)
+};
@@ -29,6 +29,30 @@
 
 struct SquiggleRendererWaved
 {
+    /** The width of one wave and the height of the strip it is drawn into. */
+    static constexpr int Period = 12;
+    static constexpr int Height =  4;
+    
+    //==================================================================================================================
+    /**
+        Renders a single wave into an image that lines up with itself when it is tiled horizontally.
+        
+        @param colour The colour of the wave
+        @param scale  The number of physical pixels per logical pixel the tile will be drawn at
+     */
+    static juce::Image createTile(juce::Colour colour, float scale)
+    {
+        juce::Image tile(juce::Image::ARGB, juce::roundToInt(static_cast<float>(Period) * scale),
+                         juce::roundToInt(static_cast<float>(Height) * scale), true);
+        
+        juce::Graphics g(tile);
+        g.addTransform(juce::AffineTransform::scale(scale));
+        g.setColour(colour);
+        render(g, { 0.0f, 0.0f, static_cast<float>(Period), static_cast<float>(Height) });
+        
+        return tile;
+    }
+    
     static void render(juce::Graphics &g, juce::Rectangle<float> bounds)
     {
         const float line_bottom = bounds.getBottom();
@@ -0,0 +1,80 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextLine.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "TextLine.h"
+
+//**********************************************************************************************************************
+// region TextLine
+//======================================================================================================================
+TextLine::TextLine(const TokenArena &parArena, TokenArena::Run parTokens, juce::String parText)
+    : arena(&parArena), tokens(parTokens), text(std::move(parText))
+{}
+
+//======================================================================================================================
+void TextLine::updateSize(const juce::Font &font, double lineSpacingFactor)
+{
+    width  = font.getStringWidthFloat(text);
+    height = font.getHeight() * lineSpacingFactor;
+}
+
+//======================================================================================================================
+const juce::String& TextLine::getText() const noexcept
+{
+    return text;
+}
+
+TextLine::Token TextLine::getToken(int index) const noexcept
+{
+    const TokenArena::Token token = arena->getToken(tokens, index);
+    return { token.start, token.style };
+}
+
+juce::String TextLine::getTokenText(int index) const noexcept
+{
+    const int num_tokens = getNumTokens();
+    
+    if (index >= 0 && index < num_tokens)
+    {
+        int token_end = text.length();
+        
+        if (index < (num_tokens - 1))
+        {
+            token_end = getToken(index + 1).startPos;
+        }
+        
+        return text.substring(getToken(index).startPos, token_end).trimEnd();
+    }
+    
+    return "";
+}
+
+//======================================================================================================================
+int TextLine::getNumTokens() const noexcept
+{
+    return arena->getNumTokens(tokens);
+}
+//======================================================================================================================
+// endregion TextLine
+//**********************************************************************************************************************
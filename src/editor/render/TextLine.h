@@ -0,0 +1,90 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextLine.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "../document/TokenArena.h"
+
+#include <juce_graphics/juce_graphics.h>
+
+/** A line of text together with its tokens, this is what a TextViewLayout lays out. */
+class TextLine
+{
+public:
+    struct Token
+    {
+        int startPos; // Token start pos for that line
+        int id;       // The syntax id for this token
+    };
+    
+    //==================================================================================================================
+    /**
+        @param arena  The arena that holds the tokens of this line, it must outlive the line
+        @param tokens Where the tokens of this line are in the arena
+        @param text   The text of this line
+     */
+    TextLine(const TokenArena &arena, TokenArena::Run tokens, juce::String text);
+    
+    //==================================================================================================================
+    void updateSize(const juce::Font &font, double lineSpacingFactor);
+    
+    //==================================================================================================================
+    /** Gets a token by its index, which must be below getNumTokens(). */
+    Token               getToken(int index)     const noexcept;
+    const juce::String& getText()               const noexcept;
+    juce::String        getTokenText(int index) const noexcept;
+    
+    /** Calls a function with each token of this line and the offset it ends at. */
+    template<class Fn>
+    void forEachToken(Fn &&callback) const
+    {
+        std::optional<Token> previous;
+        
+        arena->forEachToken(tokens, [&previous, &callback](TokenArena::Token token)
+        {
+            if (previous)
+            {
+                callback(*previous, token.start);
+            }
+            
+            previous = Token { token.start, token.style };
+        });
+        
+        if (previous)
+        {
+            callback(*previous, text.length());
+        }
+    }
+    
+    //==================================================================================================================
+    int getNumTokens() const noexcept;
+    
+private:
+    const TokenArena *arena;
+    TokenArena::Run  tokens;
+    juce::String     text;
+    double           width  { 0.0 };
+    double           height { 0.0 };
+};
@@ -49,7 +49,7 @@ struct TokenList
 {
     TokenList() noexcept = default;
     
-    void createLayout (const TextView& text, const TextView::Line &line, TextViewLayout& layout)
+    void createLayout (const ITextLayoutStyle& text, const TextLine &line, TextViewLayout& layout)
     {
         layout.ensureStorageAllocated (totalLines);
         
@@ -259,23 +259,20 @@ private:
         }
     }
     
-    void addTextRuns (const TextView& text, const TextView::Line &line)
+    void addTextRuns (const ITextLayoutStyle& text, const TextLine &line)
     {
         auto numAttributes = line.getNumTokens();
         tokens.ensureStorageAllocated(juce::jmax(64, numAttributes));
         
         juce::Font font = text.getFont();
         
-        for (int i = 0; i < numAttributes; ++i)
+        line.forEachToken([this, &text, &line, &font](const TextLine::Token &token, int rangeEnd)
         {
-            const TextView::Token     &token    = line.getToken(i);
-            const TextView::TokenType &type     = text.getTokenType(token.id);
-            const int                 range_end = (i == (numAttributes - 1) ? line.getText().length()
-                                                                            : line.getToken(i + 1).startPos);
+            const ITextLayoutStyle::TokenType &type = text.getTokenType(token.id);
             
             font.setStyleFlags(type.styleFlags);
-            appendText(line.getText().substring(token.startPos, range_end), font, type.colour);
-        }
+            appendText(line.getText().substring(token.startPos, rangeEnd), font, type.colour);
+        });
     }
     
     static juce::String getTrimmedEndIfNotAllWhitespace (const juce::String& s)
@@ -415,7 +412,7 @@ void TextViewLayout::addLine (std::unique_ptr<Line> line)
     lines.add (line.release());
 }
 
-void TextViewLayout::createLine(const TextView &view, const TextView::Line &line, float maxWidth)
+void TextViewLayout::createLine(const ITextLayoutStyle &view, const TextLine &line, float maxWidth)
 {
     width = maxWidth;
     height = 1.0e7f;
@@ -472,7 +469,7 @@ void TextViewLayout::draw(juce::Graphics& g, juce::Rectangle<float> area) const
     context.restoreState();
 }
 
-void TextViewLayout::createLayout(const TextView& text, const TextView::Line &line, float maxWidth)
+void TextViewLayout::createLayout(const ITextLayoutStyle& text, const TextLine &line, float maxWidth)
 {
     lines.clear();
     width = maxWidth;
@@ -506,7 +503,7 @@ void TextViewLayout::recalculateSize()
     }
 }
 
-void TextViewLayout::createStandardLayout(const TextView& text, const TextView::Line &line)
+void TextViewLayout::createStandardLayout(const ITextLayoutStyle& text, const TextLine &line)
 {
     (TokenList()).createLayout(text, line, *this);
 }
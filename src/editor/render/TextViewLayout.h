@@ -25,7 +25,9 @@
 
 #pragma once
 
-#include "../TextView.h"
+#include "ITextLayoutStyle.h"
+#include "TextLine.h"
+
 #include <juce_graphics/juce_graphics.h>
 
 class TextViewLayout
@@ -98,12 +100,12 @@ public:
     TextViewLayout();
     
     //==================================================================================================================
-    void createLayout (const TextView&, const TextView::Line &line, float maxWidth);
+    void createLayout (const ITextLayoutStyle&, const TextLine &line, float maxWidth);
     void draw (juce::Graphics&, juce::Rectangle<float> area) const;
     
     //==================================================================================================================
     void addLine(std::unique_ptr<Line>);
-    void createLine(const TextView&, const TextView::Line &line, float maxWidth);
+    void createLine(const ITextLayoutStyle&, const TextLine &line, float maxWidth);
     
     //==================================================================================================================
     void ensureStorageAllocated (int numLinesNeeded);
@@ -119,7 +121,7 @@ private:
     float width, height;
     juce::Justification justification;
     
-    void createStandardLayout(const TextView&, const TextView::Line &line);
+    void createStandardLayout(const ITextLayoutStyle&, const TextLine &line);
     
     JUCE_LEAK_DETECTOR (TextViewLayout)
 };
@@ -0,0 +1,796 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FileSearch.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "FileSearch.h"
+
+#include "TrigramIndex.h"
+
+#include <regex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define JAMAL_SEARCH_USE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define JAMAL_SEARCH_USE_SSE2 0
+#endif
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    constexpr int Idle_Wait_Ms = 5;
+    
+    //==================================================================================================================
+    char toLowerAscii(char c) noexcept
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    
+    char toUpperAscii(char c) noexcept
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+    
+    bool isWordByte(char c) noexcept
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        
+        // Anything outside of ASCII is part of a multi-byte character, which is assumed to be a letter
+        return (byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z') || (byte >= '0' && byte <= '9')
+               || byte == '_' || byte >= 0x80;
+    }
+    
+    /** Finds the next occurrence of either byte, or returns nullptr. */
+    const char* scanFor(const char *from, const char *to, char first, char alternative) noexcept
+    {
+       #if JAMAL_SEARCH_USE_SSE2
+        const __m128i first_mask       = _mm_set1_epi8(first);
+        const __m128i alternative_mask = _mm_set1_epi8(alternative);
+        
+        for (; to - from >= 16; from += 16)
+        {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from));
+            const __m128i equal = _mm_or_si128(_mm_cmpeq_epi8(block, first_mask),
+                                               _mm_cmpeq_epi8(block, alternative_mask));
+            
+            if (const int mask = _mm_movemask_epi8(equal); mask != 0)
+            {
+                for (int lane = 0; lane < 16; ++lane)
+                {
+                    if (mask & (1 << lane))
+                    {
+                        return from + lane;
+                    }
+                }
+            }
+        }
+       #else
+        if (first == alternative)
+        {
+            return static_cast<const char*>(std::memchr(from, first, static_cast<std::size_t>(to - from)));
+        }
+       #endif
+        
+        for (; from < to; ++from)
+        {
+            if (*from == first || *from == alternative)
+            {
+                return from;
+            }
+        }
+        
+        return nullptr;
+    }
+    
+    const char* findLineEnd(const char *from, const char *end) noexcept
+    {
+        const auto line_break = static_cast<const char*>(std::memchr(from, '\n', static_cast<std::size_t>(end - from)));
+        return line_break ? line_break : end;
+    }
+    
+    int countCharacters(const char *from, const char *to) noexcept
+    {
+        // Every UTF-8 character has exactly one byte that isn't a continuation byte
+        return static_cast<int>(std::count_if(from, to, [](char c)
+        {
+            return (static_cast<unsigned char>(c) & 0xc0) != 0x80;
+        }));
+    }
+    
+    juce::String makePreview(const char *lineStart, const char *lineEnd)
+    {
+        if (lineEnd > lineStart && lineEnd[-1] == '\r')
+        {
+            --lineEnd;
+        }
+        
+        if (lineEnd - lineStart > FileSearch::Max_Preview_Length)
+        {
+            lineEnd = lineStart + FileSearch::Max_Preview_Length;
+            
+            // Don't cut a character in half
+            while (lineEnd > lineStart && (static_cast<unsigned char>(*lineEnd) & 0xc0) == 0x80)
+            {
+                --lineEnd;
+            }
+        }
+        
+        return juce::String::fromUTF8(lineStart, static_cast<int>(lineEnd - lineStart));
+    }
+    
+    //==================================================================================================================
+    struct SearchCancelled {};
+    
+    struct CancelCheck
+    {
+        const std::atomic<bool> &cancelled;
+        int                     stepsLeft;
+        
+        //==============================================================================================================
+        void step()
+        {
+            if (--stepsLeft > 0)
+            {
+                return;
+            }
+            
+            stepsLeft = FileSearch::Cancel_Check_Interval;
+            
+            if (cancelled.load(std::memory_order_relaxed))
+            {
+                throw SearchCancelled{};
+            }
+        }
+    };
+    
+    /**
+        A pointer into the text that counts every step the regex engine takes with it.
+        std::regex can't be interrupted and one long line without a match is scanned in a single call, so this
+        checks for cancellation every Cancel_Check_Interval steps and throws out of the engine if it was.
+     */
+    class CheckedIterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = char;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const char*;
+        using reference         = const char&;
+        
+        //==============================================================================================================
+        CheckedIterator() = default;
+        
+        CheckedIterator(const char *parPosition, CancelCheck &parCheck) noexcept
+            : position(parPosition),
+              check(&parCheck)
+        {}
+        
+        //==============================================================================================================
+        const char* get() const noexcept { return position; }
+        
+        reference operator*() const noexcept { return *position; }
+        
+        CheckedIterator& operator++() { ++position; check->step(); return *this; }
+        CheckedIterator& operator--() { --position; check->step(); return *this; }
+        
+        CheckedIterator operator++(int) { CheckedIterator old = *this; ++*this; return old; }
+        CheckedIterator operator--(int) { CheckedIterator old = *this; --*this; return old; }
+        
+        bool operator==(const CheckedIterator &other) const noexcept { return position == other.position; }
+        bool operator!=(const CheckedIterator &other) const noexcept { return position != other.position; }
+        
+    private:
+        const char  *position { nullptr };
+        CancelCheck *check    { nullptr };
+    };
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Matcher
+//======================================================================================================================
+class FileSearch::Matcher
+{
+public:
+    explicit Matcher(const SearchQuery &parQuery)
+        : query(parQuery)
+    {
+        if (query.pattern.isEmpty())
+        {
+            return;
+        }
+        
+        if (!query.isRegex)
+        {
+            needle = query.pattern.toStdString();
+            
+            if (!query.matchCase)
+            {
+                std::transform(needle.begin(), needle.end(), needle.begin(), ::toLowerAscii);
+            }
+            
+            valid = true;
+            return;
+        }
+        
+        try
+        {
+            const auto flags = std::regex::ECMAScript | std::regex::optimize
+                               | (query.matchCase ? std::regex::flag_type{} : std::regex::icase);
+            regex = std::regex(query.pattern.toStdString(), flags);
+            valid = true;
+        }
+        catch (const std::regex_error&) {}
+    }
+    
+    //==================================================================================================================
+    bool isValid() const noexcept { return valid; }
+    
+    /**
+        Calls back with the start and end of every match in a block of UTF-8 text, in ascending order.
+        Returns false if the search was cancelled before it got to the end.
+     */
+    template<class Fn>
+    bool find(const char *data, std::size_t size, const std::atomic<bool> &cancelled, Fn &&callback) const
+    {
+        return query.isRegex ? findRegex  (data, data + size, cancelled, callback)
+                             : findLiteral(data, data + size, cancelled, callback);
+    }
+
+private:
+    SearchQuery query;
+    std::string needle;
+    std::regex  regex;
+    bool        valid { false };
+    
+    //==================================================================================================================
+    bool isWholeWord(const char *data, const char *end, const char *matchStart, const char *matchEnd) const noexcept
+    {
+        return !query.wholeWord || ((matchStart == data || !::isWordByte(matchStart[-1]))
+                                    && (matchEnd == end || !::isWordByte(*matchEnd)));
+    }
+    
+    template<class Fn>
+    bool findLiteral(const char *data, const char *end, const std::atomic<bool> &cancelled, Fn &callback) const
+    {
+        const auto length      = static_cast<std::ptrdiff_t>(needle.size());
+        const char first       = needle.front();
+        const char alternative = query.matchCase ? first : ::toUpperAscii(first);
+        
+        if (end - data < length)
+        {
+            return true;
+        }
+        
+        const char *last_start = end - length;
+        const char *next_check = data;
+        
+        for (const char *it = data; it <= last_start;)
+        {
+            if (it >= next_check)
+            {
+                if (cancelled.load(std::memory_order_relaxed))
+                {
+                    return false;
+                }
+                
+                next_check = it + Cancel_Check_Interval;
+            }
+            
+            const char *limit = std::min(last_start + 1, next_check);
+            const char *found = ::scanFor(it, limit, first, alternative);
+            
+            if (!found)
+            {
+                it = limit;
+                continue;
+            }
+            
+            bool equal = true;
+            
+            for (std::ptrdiff_t i = 1; equal && i < length; ++i)
+            {
+                const char c = found[i];
+                equal = (query.matchCase ? c : ::toLowerAscii(c)) == needle[static_cast<std::size_t>(i)];
+            }
+            
+            if (equal && isWholeWord(data, end, found, found + length))
+            {
+                callback(found, found + length);
+                it = found + length;
+            }
+            else
+            {
+                it = found + 1;
+            }
+        }
+        
+        return true;
+    }
+    
+    template<class Fn>
+    bool findRegex(const char *data, const char *end, const std::atomic<bool> &cancelled, Fn &callback) const
+    {
+        using MatchIterator = std::regex_iterator<CheckedIterator>;
+        
+        // Counted in steps of the regex engine rather than at line breaks, so a long line can be cancelled as well
+        CancelCheck check { cancelled, Cancel_Check_Interval };
+        
+        try
+        {
+            for (const char *line_start = data; line_start < end;)
+            {
+                const char *line_end = ::findLineEnd(line_start, end);
+                
+                for (auto it = MatchIterator(CheckedIterator(line_start, check), CheckedIterator(line_end, check),
+                                             regex);
+                     it != MatchIterator(); ++it)
+                {
+                    const char *match_start = (*it)[0].first .get();
+                    const char *match_end   = (*it)[0].second.get();
+                    
+                    if (match_end > match_start && isWholeWord(data, end, match_start, match_end))
+                    {
+                        callback(match_start, match_end);
+                    }
+                }
+                
+                line_start = line_end + 1;
+                check.step();
+            }
+        }
+        catch (const SearchCancelled&)
+        {
+            return false;
+        }
+        
+        return true;
+    }
+};
+//======================================================================================================================
+// endregion Matcher
+//**********************************************************************************************************************
+// region Session
+//======================================================================================================================
+struct FileSearch::Session
+{
+    struct WorkQueue
+    {
+        juce::SpinLock         lock;
+        std::deque<juce::File> files;
+    };
+    
+    //==================================================================================================================
+    FileSearch &owner;
+    juce::File  root;
+    Options     options;
+    Matcher     matcher;
+    
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    juce::WaitableEvent                     workAvailable;
+    
+    juce::CriticalSection resultLock;
+    std::deque<Match>     results;
+    juce::WaitableEvent   spaceAvailable;
+    
+    std::atomic<bool> cancelled      { false };
+    std::atomic<bool> enumerated     { false };
+    std::atomic<int>  runningWorkers { 0 };
+    bool              finished       { false }; // Only touched on the message thread
+    
+    //==================================================================================================================
+    Session(FileSearch &parOwner, juce::File parRoot, const SearchQuery &query, Options parOptions, int numWorkers)
+        : owner(parOwner),
+          root(std::move(parRoot)),
+          options(std::move(parOptions)),
+          matcher(query),
+          runningWorkers(numWorkers)
+    {
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            queues.push_back(std::make_unique<WorkQueue>());
+        }
+    }
+    
+    //==================================================================================================================
+    void enumerate()
+    {
+        std::size_t next_queue = 0;
+        
+        const auto queue_file = [this, &next_queue](const juce::File &file, const juce::String&)
+        {
+            WorkQueue &queue = *queues[next_queue++ % queues.size()];
+            
+            {
+                const juce::SpinLock::ScopedLockType lock(queue.lock);
+                queue.files.push_back(file);
+            }
+            
+            workAvailable.signal();
+            return !cancelled;
+        };
+        
+        if (options.candidateFiles)
+        {
+            for (const auto &file : *options.candidateFiles)
+            {
+                const juce::String relative = file.getRelativePathFrom(root).replaceCharacter('\\', '/');
+                
+                if (FileSearch::isSearchable(relative, options) && !queue_file(file, relative))
+                {
+                    break;
+                }
+            }
+        }
+        else
+        {
+            FileSearch::forEachFile(root, options, queue_file);
+        }
+        
+        enumerated = true;
+        workAvailable.signal();
+    }
+    
+    void work(std::size_t index)
+    {
+        std::vector<Match> matches;
+        juce::File         file;
+        
+        while (!cancelled)
+        {
+            // Read before looking for work, so no file that was queued in between is missed
+            const bool all_enumerated = enumerated;
+            
+            if (takeFile(index, file))
+            {
+                scanFile(file, matches);
+                publish(matches);
+                continue;
+            }
+            
+            if (all_enumerated)
+            {
+                break;
+            }
+            
+            (void) workAvailable.wait(Idle_Wait_Ms);
+        }
+        
+        if (--runningWorkers == 0)
+        {
+            owner.triggerAsyncUpdate();
+        }
+    }
+    
+    //==================================================================================================================
+    bool takeFile(std::size_t index, juce::File &file)
+    {
+        {
+            WorkQueue &own = *queues[index];
+            const juce::SpinLock::ScopedLockType lock(own.lock);
+            
+            if (!own.files.empty())
+            {
+                file = std::move(own.files.back());
+                own.files.pop_back();
+                return true;
+            }
+        }
+        
+        for (std::size_t i = 1; i < queues.size(); ++i)
+        {
+            WorkQueue &other = *queues[(index + i) % queues.size()];
+            const juce::SpinLock::ScopedLockType lock(other.lock);
+            
+            if (!other.files.empty())
+            {
+                file = std::move(other.files.front());
+                other.files.pop_front();
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    void scanFile(const juce::File &file, std::vector<Match> &matches)
+    {
+        const juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+        const auto                   *data = static_cast<const char*>(mapped.getData());
+        const std::size_t            size  = mapped.getSize();
+        
+        if (data == nullptr || size == 0
+            || std::memchr(data, 0, std::min(size, static_cast<std::size_t>(Binary_Probe_Size))) != nullptr)
+        {
+            return;
+        }
+        
+        const char *end        = data + size;
+        const char *counted    = data;
+        const char *line_start = data;
+        int        line        = 0;
+        
+        (void) matcher.find(data, size, cancelled, [&](const char *matchStart, const char *matchEnd)
+        {
+            // Matches come in order, so lines only have to be counted from the last match on
+            while (const void *line_break = std::memchr(counted, '\n', static_cast<std::size_t>(matchStart - counted)))
+            {
+                ++line;
+                counted = line_start = static_cast<const char*>(line_break) + 1;
+            }
+            
+            counted = matchStart;
+            
+            const int column = ::countCharacters(line_start, matchStart);
+            matches.push_back({
+                file,
+                ::makePreview(line_start, ::findLineEnd(matchStart, end)),
+                line,
+                { column, column + ::countCharacters(matchStart, matchEnd) }
+            });
+            
+            if (matches.size() >= static_cast<std::size_t>(Max_Batch_Size))
+            {
+                publish(matches);
+            }
+        });
+    }
+    
+    void publish(std::vector<Match> &matches)
+    {
+        if (matches.empty())
+        {
+            return;
+        }
+        
+        {
+            const juce::ScopedLock lock(resultLock);
+            
+            // Wait for the message thread to catch up instead of buffering results without bounds
+            while (results.size() >= static_cast<std::size_t>(Queue_Capacity) && !cancelled)
+            {
+                const juce::ScopedUnlock unlock(resultLock);
+                owner.triggerAsyncUpdate();
+                (void) spaceAvailable.wait(Idle_Wait_Ms);
+            }
+            
+            std::move(matches.begin(), matches.end(), std::back_inserter(results));
+        }
+        
+        matches.clear();
+        owner.triggerAsyncUpdate();
+    }
+};
+//======================================================================================================================
+// endregion Session
+//**********************************************************************************************************************
+// region FileSearch
+//======================================================================================================================
+FileSearch::FileSearch(int parNumWorkers)
+    : numWorkers(parNumWorkers > 0 ? parNumWorkers : juce::SystemStats::getNumCpus()),
+      pool(numWorkers + 1)
+{}
+
+FileSearch::~FileSearch()
+{
+    cancel();
+}
+
+//======================================================================================================================
+bool FileSearch::start(const juce::File &root, const SearchQuery &query, const Options &options,
+                       ResultCallback parCallback)
+{
+    cancel();
+    
+    if (!root.isDirectory())
+    {
+        return false;
+    }
+    
+    Options session_options = options;
+    
+    // The index isn't thread safe, so it is asked here rather than on the walker's thread
+    if (!session_options.candidateFiles && session_options.index != nullptr)
+    {
+        session_options.candidateFiles = session_options.index->findCandidates(query);
+    }
+    
+    auto new_session = std::make_shared<Session>(*this, root, query, std::move(session_options), numWorkers);
+    
+    if (!new_session->matcher.isValid())
+    {
+        return false;
+    }
+    
+    session  = new_session;
+    callback = std::move(parCallback);
+    
+    // The pool has a thread for each of these, so the workers never wait for a walker that can't start;
+    // jobs of a cancelled search that are still queued return right away
+    pool.addJob([new_session]
+    {
+        if (!new_session->cancelled)
+        {
+            new_session->enumerate();
+        }
+        
+        return juce::ThreadPoolJob::jobHasFinished;
+    });
+    
+    for (std::size_t i = 0; i < static_cast<std::size_t>(numWorkers); ++i)
+    {
+        pool.addJob([new_session, i]
+        {
+            new_session->work(i);
+            return juce::ThreadPoolJob::jobHasFinished;
+        });
+    }
+    
+    return true;
+}
+
+void FileSearch::cancel()
+{
+    if (!session)
+    {
+        return;
+    }
+    
+    // Waiting for the jobs would block the message thread, they hold on to the session until they stopped
+    session->cancelled = true;
+    session->workAvailable .signal();
+    session->spaceAvailable.signal();
+    
+    session.reset();
+    callback = nullptr;
+}
+
+bool FileSearch::isSearching() const noexcept
+{
+    return session && !session->finished;
+}
+
+//======================================================================================================================
+bool FileSearch::matchesAnyGlob(const juce::String &relativePath, const juce::StringArray &globs)
+{
+    const bool         ignore_case = !juce::File::areFileNamesCaseSensitive();
+    const juce::String name        = relativePath.fromLastOccurrenceOf("/", false, false);
+    
+    for (const auto &glob : globs)
+    {
+        if (glob.containsChar('/') ? relativePath.matchesWildcard(glob.trimCharactersAtStart("/"), ignore_case)
+                                   : name.matchesWildcard(glob, ignore_case))
+        {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+bool FileSearch::isSearchable(const juce::String &relativePath, const Options &options)
+{
+    // Check every directory on the way, an ignored directory hides everything inside it
+    for (int separator = relativePath.indexOfChar('/'); separator >= 0;
+         separator = relativePath.indexOfChar(separator + 1, '/'))
+    {
+        if (matchesAnyGlob(relativePath.substring(0, separator), options.ignoreGlobs))
+        {
+            return false;
+        }
+    }
+    
+    return !matchesAnyGlob(relativePath, options.ignoreGlobs)
+           && (options.fileGlobs.isEmpty() || matchesAnyGlob(relativePath, options.fileGlobs));
+}
+
+void FileSearch::forEachFile(const juce::File &root, const Options &options, const FileCallback &callback)
+{
+    const int what = juce::File::findFilesAndDirectories
+                     | (options.searchHiddenFiles ? 0 : juce::File::ignoreHiddenFiles);
+    
+    std::vector<juce::File> directories { root };
+    
+    while (!directories.empty())
+    {
+        const juce::File directory = std::move(directories.back());
+        directories.pop_back();
+        
+        for (const auto &entry : juce::RangedDirectoryIterator(directory, false, "*", what))
+        {
+            const juce::File   file     = entry.getFile();
+            const juce::String relative = file.getRelativePathFrom(root).replaceCharacter('\\', '/');
+            
+            if (matchesAnyGlob(relative, options.ignoreGlobs))
+            {
+                continue;
+            }
+            
+            if (entry.isDirectory())
+            {
+                // Following links could walk in circles
+                if (!file.isSymbolicLink())
+                {
+                    directories.push_back(file);
+                }
+                
+                continue;
+            }
+            
+            if (!options.fileGlobs.isEmpty() && !matchesAnyGlob(relative, options.fileGlobs))
+            {
+                continue;
+            }
+            
+            if (!callback(file, relative))
+            {
+                return;
+            }
+        }
+    }
+}
+
+//======================================================================================================================
+void FileSearch::handleAsyncUpdate()
+{
+    if (!session || session->finished)
+    {
+        return;
+    }
+    
+    std::vector<Match> batch;
+    
+    {
+        const juce::ScopedLock lock(session->resultLock);
+        std::deque<Match> &results = session->results;
+        
+        const auto count = static_cast<std::ptrdiff_t>(std::min(results.size(),
+                                                                static_cast<std::size_t>(Max_Batch_Size)));
+        batch.assign(std::make_move_iterator(results.begin()), std::make_move_iterator(results.begin() + count));
+        results.erase(results.begin(), results.begin() + count);
+        
+        session->finished = results.empty() && session->runningWorkers == 0;
+        
+        if (!results.empty())
+        {
+            triggerAsyncUpdate();
+        }
+    }
+    
+    session->spaceAvailable.signal();
+    
+    if (batch.empty() && !session->finished)
+    {
+        return;
+    }
+    
+    // The callback may well start a new search, which replaces the current one
+    const ResultCallback current_callback = callback;
+    current_callback(std::move(batch), session->finished);
+}
+//======================================================================================================================
+// endregion FileSearch
+//**********************************************************************************************************************
@@ -0,0 +1,151 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FileSearch.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "TextSearch.h"
+
+#include <juce_events/juce_events.h>
+
+#include <optional>
+
+class TrigramIndex;
+
+/**
+    Searches all files below a directory for a query, on a pool of worker threads.
+    
+    One thread walks the directory tree, skipping everything that matches an ignore glob without descending into it,
+    and deals the files out to the workers' queues. Workers take files from the back of their own queue and steal
+    from the front of the others' when theirs runs dry, so a few large files don't hold up the rest of the search.
+    Every file is memory mapped and scanned in place as UTF-8, files that look binary are skipped.
+    
+    Matches are collected in a bounded queue that is drained on the message thread; once it is full, workers wait
+    until the message thread caught up instead of piling up results nobody looks at yet.
+    The walker and the workers are jobs on a thread pool that lives as long as the FileSearch, so searches don't
+    start any threads. Cancelling or starting a new search doesn't wait for the jobs of the old one, they stop after
+    at most Cancel_Check_Interval more bytes, or steps of the regex engine, and free their threads.
+ */
+class FileSearch : private juce::AsyncUpdater
+{
+public:
+    struct Options
+    {
+        /** Files and directories to skip, globs with a slash are matched against the path relative to the root. */
+        juce::StringArray ignoreGlobs { ".git", ".svn", ".vs", "bin", "obj", "node_modules" };
+        
+        /** The files to search, all files if this is empty. */
+        juce::StringArray fileGlobs;
+        
+        /**
+            If set, only these files are searched instead of everything below the root, for example the candidates
+            a TrigramIndex narrowed a query down to. The globs are still applied to them.
+         */
+        std::optional<std::vector<juce::File>> candidateFiles;
+        
+        /**
+            If set and there are no candidateFiles, the index is asked which files can contain a match before the
+            search starts, on the thread that starts it. The index has to be up to date, files it doesn't know
+            about or that changed since it last saw them may be missed.
+         */
+        const TrigramIndex *index { nullptr };
+        
+        bool searchHiddenFiles { false };
+    };
+    
+    struct Match
+    {
+        juce::File       file;
+        juce::String     lineText; // The line the match is in, cut off after Max_Preview_Length bytes
+        int              line;
+        juce::Range<int> columns;  // In characters
+    };
+    
+    using ResultCallback = std::function<void(std::vector<Match> matches, bool finished)>;
+    using FileCallback   = std::function<bool(const juce::File &file, const juce::String &relativePath)>;
+    
+    //==================================================================================================================
+    static constexpr int Queue_Capacity        = 8192;
+    static constexpr int Max_Batch_Size        = 1024;
+    static constexpr int Binary_Probe_Size     = 8192;
+    static constexpr int Max_Preview_Length    = 512;
+    static constexpr int Cancel_Check_Interval = 1 << 16;
+    
+    //==================================================================================================================
+    /**
+        Creates the thread pool that searches run on.
+        
+        @param numWorkers The number of threads that scan files, 0 for one per cpu core; one more walks the directories
+     */
+    explicit FileSearch(int numWorkers = 0);
+    ~FileSearch() override;
+    
+    //==================================================================================================================
+    /**
+        Starts searching all files below a directory, cancelling the previous search.
+        Regular expressions are matched line by line and case-insensitive literals only fold ASCII letters.
+        
+        @param root     The directory to search
+        @param query    What to look for
+        @param options  Which files to look at
+        @param callback Called on the message thread with batches of matches, grouped by file but in no particular
+                        order of files; the last call has finished set to true
+        @return False if the directory doesn't exist or the query is empty or invalid, the callback isn't called then
+     */
+    bool start(const juce::File &root, const SearchQuery &query, const Options &options, ResultCallback callback);
+    
+    /** Stops the running search without waiting for it, the callback won't be called for it anymore. */
+    void cancel();
+    
+    bool isSearching() const noexcept;
+    
+    //==================================================================================================================
+    /** Determines whether a path relative to the search root matches any of the given globs. */
+    static bool matchesAnyGlob(const juce::String &relativePath, const juce::StringArray &globs);
+    
+    /** Determines whether the options allow searching a file, given its path relative to the search root. */
+    static bool isSearchable(const juce::String &relativePath, const Options &options);
+    
+    /**
+        Walks all files below a directory that the options allow searching, without descending into ignored
+        directories. This ignores Options::candidateFiles, the walk stops as soon as the callback returns false.
+     */
+    static void forEachFile(const juce::File &root, const Options &options, const FileCallback &callback);
+
+private:
+    struct Session;
+    class Matcher;
+    
+    //==================================================================================================================
+    const int                numWorkers;
+    juce::ThreadPool         pool;
+    std::shared_ptr<Session> session;
+    ResultCallback           callback;
+    
+    //==================================================================================================================
+    void handleAsyncUpdate() override;
+    
+    //==================================================================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FileSearch)
+};
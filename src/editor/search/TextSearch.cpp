@@ -0,0 +1,433 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextSearch.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+
+#include "TextSearch.h"
+
+#include <optional>
+#include <regex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define JAMAL_SEARCH_USE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define JAMAL_SEARCH_USE_SSE2 0
+#endif
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    using Char = TextRope::Char;
+    
+    //==================================================================================================================
+    constexpr int Read_Block_Size = 4096;
+    
+    //==================================================================================================================
+    bool isWordChar(Char c) noexcept
+    {
+        return juce::CharacterFunctions::isLetterOrDigit(c) || c == '_';
+    }
+    
+    Char toLower(Char c) noexcept
+    {
+        return juce::CharacterFunctions::toLowerCase(c);
+    }
+    
+    /** Finds the next occurrence of either character, or returns -1. */
+    int scanFor(const Char *data, int from, int to, Char first, Char alternative) noexcept
+    {
+        int i = from;
+       
+       #if JAMAL_SEARCH_USE_SSE2
+        const __m128i first_mask       = _mm_set1_epi32(static_cast<int>(first));
+        const __m128i alternative_mask = _mm_set1_epi32(static_cast<int>(alternative));
+        
+        for (; i + 4 <= to; i += 4)
+        {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i equal = _mm_or_si128(_mm_cmpeq_epi32(block, first_mask),
+                                               _mm_cmpeq_epi32(block, alternative_mask));
+            
+            if (const int mask = _mm_movemask_epi8(equal); mask != 0)
+            {
+                // Every lane sets four bits of the mask
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if ((mask >> (lane * 4)) & 0xf)
+                    {
+                        return i + lane;
+                    }
+                }
+            }
+        }
+       #endif
+        
+        for (; i < to; ++i)
+        {
+            if (data[i] == first || data[i] == alternative)
+            {
+                return i;
+            }
+        }
+        
+        return -1;
+    }
+    
+    /** Reads a range of a rope, plus whatever follows up to the end of the line it ends in. */
+    std::vector<Char> readLines(const TextRope &text, int start, int end)
+    {
+        std::vector<Char> buffer(static_cast<std::size_t>(end - start));
+        (void) text.read(start, buffer.data(), end - start);
+        
+        while (end < text.getLength() && (buffer.empty() || buffer.back() != '\n'))
+        {
+            const int         count    = juce::jmin(Read_Block_Size, text.getLength() - end);
+            const std::size_t old_size = buffer.size();
+            
+            buffer.resize(old_size + static_cast<std::size_t>(count));
+            (void) text.read(end, buffer.data() + old_size, count);
+            
+            const auto line_break = std::find(buffer.begin() + static_cast<std::ptrdiff_t>(old_size), buffer.end(),
+                                              static_cast<Char>('\n'));
+            
+            if (line_break != buffer.end())
+            {
+                buffer.erase(line_break + 1, buffer.end());
+                break;
+            }
+            
+            end += count;
+        }
+        
+        return buffer;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Matcher
+//======================================================================================================================
+class TextSearch::Matcher
+{
+public:
+    explicit Matcher(const SearchQuery &parQuery)
+        : query(parQuery)
+    {
+        if (query.pattern.isEmpty())
+        {
+            return;
+        }
+        
+        if (!query.isRegex)
+        {
+            for (auto it = query.pattern.getCharPointer(); !it.isEmpty();)
+            {
+                const Char c = it.getAndAdvance();
+                needle.push_back(query.matchCase ? c : ::toLower(c));
+            }
+            
+            valid = true;
+            return;
+        }
+        
+        try
+        {
+            const auto flags = std::regex::ECMAScript | std::regex::optimize
+                               | (query.matchCase ? std::regex::flag_type{} : std::regex::icase);
+            regex = std::wregex(query.pattern.toWideCharPointer(), flags);
+            valid = true;
+        }
+        catch (const std::regex_error&) {}
+    }
+    
+    //==================================================================================================================
+    bool isValid() const noexcept { return valid; }
+    
+    /** Finds all matches that start inside a range of the text. */
+    void find(const TextRope &text, juce::Range<int> range, const std::atomic<bool> &cancelled,
+              std::vector<juce::Range<int>> &matches) const
+    {
+        if (query.isRegex)
+        {
+            findRegex(text, range, cancelled, matches);
+        }
+        else
+        {
+            findLiteral(text, range, cancelled, matches);
+        }
+    }
+
+private:
+    SearchQuery             query;
+    std::basic_string<Char> needle;
+    std::wregex             regex;
+    bool                    valid { false };
+    
+    //==================================================================================================================
+    bool isWholeWord(const Char *data, int size, int start, int end) const noexcept
+    {
+        return !query.wholeWord || ((start == 0 || !::isWordChar(data[start - 1]))
+                                    && (end >= size || !::isWordChar(data[end])));
+    }
+    
+    void findLiteral(const TextRope &text, juce::Range<int> range, const std::atomic<bool> &cancelled,
+                     std::vector<juce::Range<int>> &matches) const
+    {
+        const int needle_length = static_cast<int>(needle.size());
+        
+        // One character before the range and the pattern's length past it, for word borders and overlaps
+        const int begin = juce::jmax(0, range.getStart() - 1);
+        const int end   = juce::jmin(text.getLength(), range.getEnd() + needle_length);
+        
+        std::vector<Char> buffer(static_cast<std::size_t>(end - begin));
+        (void) text.read(begin, buffer.data(), end - begin);
+        
+        const Char *data       = buffer.data();
+        const int  size        = static_cast<int>(buffer.size());
+        const int  limit       = range.getEnd() - begin;
+        const Char first       = needle.front();
+        const Char alternative = query.matchCase ? first : juce::CharacterFunctions::toUpperCase(first);
+        
+        for (int i = range.getStart() - begin; i < limit && !cancelled.load(std::memory_order_relaxed);)
+        {
+            i = ::scanFor(data, i, limit, first, alternative);
+            
+            if (i < 0)
+            {
+                break;
+            }
+            
+            const int match_end = i + needle_length;
+            bool      equal     = match_end <= size;
+            
+            for (int j = 1; equal && j < needle_length; ++j)
+            {
+                const Char c = data[i + j];
+                equal = (query.matchCase ? c : ::toLower(c)) == needle[static_cast<std::size_t>(j)];
+            }
+            
+            if (equal && isWholeWord(data, size, i, match_end))
+            {
+                matches.emplace_back(begin + i, begin + match_end);
+                i = match_end;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+    
+    void findRegex(const TextRope &text, juce::Range<int> range, const std::atomic<bool> &cancelled,
+                   std::vector<juce::Range<int>> &matches) const
+    {
+        const int               begin  = juce::jmax(0, range.getStart() - 1);
+        const std::vector<Char> buffer = ::readLines(text, begin, range.getEnd());
+        
+        const int size  = static_cast<int>(buffer.size());
+        const int limit = range.getEnd() - begin;
+        
+        // The job owns the lines that start inside its range
+        int line_start = range.getStart() - begin;
+        
+        if (range.getStart() > 0)
+        {
+            const auto line_break = std::find(buffer.begin(), buffer.end(), static_cast<Char>('\n'));
+            line_start = static_cast<int>(std::distance(buffer.begin(), line_break)) + 1;
+        }
+        
+        std::wstring line;
+        
+        while (line_start < limit && !cancelled.load(std::memory_order_relaxed))
+        {
+            const auto line_begin = buffer.begin() + line_start;
+            const auto line_end   = std::find(line_begin, buffer.end(), static_cast<Char>('\n'));
+            
+            // std::regex only knows wchar_t, which holds a whole code point on all platforms but Windows
+            line.assign(line_begin, line_end);
+            
+            for (auto it = std::wsregex_iterator(line.begin(), line.end(), regex); it != std::wsregex_iterator(); ++it)
+            {
+                const int start = line_start + static_cast<int>(it->position(0));
+                const int end   = start + static_cast<int>(it->length(0));
+                
+                if (end > start && isWholeWord(buffer.data(), size, start, end))
+                {
+                    matches.emplace_back(begin + start, begin + end);
+                }
+            }
+            
+            line_start = static_cast<int>(std::distance(buffer.begin(), line_end)) + 1;
+        }
+    }
+};
+//======================================================================================================================
+// endregion Matcher
+//**********************************************************************************************************************
+// region TextSearch
+//======================================================================================================================
+struct TextSearch::Session
+{
+    using Matches = std::vector<juce::Range<int>>;
+    
+    //==================================================================================================================
+    ResultCallback        callback;
+    std::atomic<bool>     cancelled { false };
+    
+    // Only touched on the message thread
+    std::vector<std::optional<Matches>> jobMatches;
+    std::size_t                         nextJob { 0 };
+    int                                 lastEnd { 0 };
+    
+    //==================================================================================================================
+    void deliver(std::size_t job, Matches matches)
+    {
+        jobMatches[job] = std::move(matches);
+        
+        // Jobs only know their own matches, one that overlaps the last match of the job before it can only be
+        // told apart here, where they are handed on in order
+        while (!cancelled && nextJob < jobMatches.size() && jobMatches[nextJob])
+        {
+            Matches next = std::move(*jobMatches[nextJob]);
+            jobMatches[nextJob].reset();
+            
+            const int  last_end   = lastEnd;
+            const auto first_kept = std::find_if(next.begin(), next.end(), [last_end](juce::Range<int> match)
+            {
+                return match.getStart() >= last_end;
+            });
+            
+            next.erase(next.begin(), first_kept);
+            
+            if (!next.empty())
+            {
+                lastEnd = next.back().getEnd();
+            }
+            
+            // The callback may start another search, which cancels this one
+            ++nextJob;
+            callback(std::move(next), nextJob == jobMatches.size());
+        }
+    }
+};
+
+//======================================================================================================================
+TextSearch::TextSearch()
+    : pool(juce::SystemStats::getNumCpus())
+{}
+
+TextSearch::~TextSearch()
+{
+    cancel();
+}
+
+//======================================================================================================================
+bool TextSearch::start(const TextRope &text, const SearchQuery &query, ResultCallback callback)
+{
+    cancel();
+    
+    auto matcher = std::make_shared<const Matcher>(query);
+    
+    if (!matcher->isValid())
+    {
+        return false;
+    }
+    
+    const auto snapshot = std::make_shared<const TextRope>(text);
+    const int  length   = text.getLength();
+    const int  num_jobs = juce::jmax(1, (length + Job_Size - 1) / Job_Size);
+    
+    auto new_session = std::make_shared<Session>();
+    new_session->callback = std::move(callback);
+    new_session->jobMatches.resize(static_cast<std::size_t>(num_jobs));
+    session = new_session;
+    
+    for (int i = 0; i < num_jobs; ++i)
+    {
+        const juce::Range<int> range(i * Job_Size, juce::jmin(length, (i + 1) * Job_Size));
+        
+        pool.addJob([new_session, matcher, snapshot, range, job = static_cast<std::size_t>(i)]
+        {
+            std::vector<juce::Range<int>> matches;
+            
+            if (!new_session->cancelled)
+            {
+                matcher->find(*snapshot, range, new_session->cancelled, matches);
+                
+                juce::MessageManager::callAsync([new_session, job, matches = std::move(matches)]() mutable
+                {
+                    if (!new_session->cancelled)
+                    {
+                        new_session->deliver(job, std::move(matches));
+                    }
+                });
+            }
+            
+            return juce::ThreadPoolJob::jobHasFinished;
+        });
+    }
+    
+    return true;
+}
+
+void TextSearch::cancel()
+{
+    if (session)
+    {
+        session->cancelled = true;
+        session.reset();
+    }
+}
+
+bool TextSearch::isSearching() const noexcept
+{
+    return session && session->nextJob < session->jobMatches.size();
+}
+
+//======================================================================================================================
+std::vector<juce::Range<int>> TextSearch::findAll(const TextRope &text, const SearchQuery &query)
+{
+    return findAll(text, query, { 0, text.getLength() });
+}
+
+std::vector<juce::Range<int>> TextSearch::findAll(const TextRope &text, const SearchQuery &query,
+                                                  juce::Range<int> range)
+{
+    const Matcher                 matcher(query);
+    const std::atomic<bool>       cancelled { false };
+    std::vector<juce::Range<int>> matches;
+    
+    if (matcher.isValid())
+    {
+        matcher.find(text, range.getIntersectionWith({ 0, text.getLength() }), cancelled, matches);
+    }
+    
+    return matches;
+}
+//======================================================================================================================
+// endregion TextSearch
+//**********************************************************************************************************************
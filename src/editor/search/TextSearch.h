@@ -0,0 +1,105 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextSearch.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+
+#pragma once
+
+#include "../document/TextRope.h"
+
+#include <juce_events/juce_events.h>
+
+struct SearchQuery
+{
+    juce::String pattern;
+    bool         isRegex   { false };
+    bool         matchCase { true };
+    bool         wholeWord { false };
+};
+
+/**
+    Finds all occurrences of a query in a snapshot of a document, in parallel.
+    
+    The text is split into jobs of Job_Size characters that run on a thread pool, every job owns the matches that
+    start inside its range and reads a little past its end so that matches across the border are still found.
+    Literal searches scan for the first character of the pattern four characters at a time with SSE2, where it is
+    available, and only compare the rest where it matches. Regular expressions are matched line by line, so job
+    borders are moved to the next line start for them.
+    
+    Matches are handed to a callback on the message thread in the order of the text, each job's as soon as it and
+    the ones before it have finished. A match that overlaps the last one of the job before it is dropped then, so an
+    occurrence that overlaps another across a job border isn't reported on top of it.
+    Starting a new search or cancelling drops everything still in flight.
+ */
+class TextSearch
+{
+public:
+    using ResultCallback = std::function<void(std::vector<juce::Range<int>> matches, bool finished)>;
+    
+    //==================================================================================================================
+    static constexpr int Job_Size = 1 << 18;
+    
+    //==================================================================================================================
+    TextSearch();
+    ~TextSearch();
+    
+    //==================================================================================================================
+    /**
+        Starts searching a snapshot of a text, cancelling the previous search.
+        
+        @param text     The text to search, copying a rope is cheap and keeps it alive for the search
+        @param query    What to look for
+        @param callback Called on the message thread with the matches of every job, in ascending order across all
+                        calls; the last call has finished set to true
+        @return False if the query is empty or not a valid regular expression, the callback isn't called then
+     */
+    bool start(const TextRope &text, const SearchQuery &query, ResultCallback callback);
+    
+    /** Stops the running search, the callback won't be called for it anymore. */
+    void cancel();
+    
+    bool isSearching() const noexcept;
+    
+    //==================================================================================================================
+    /** Finds all matches in a text on the calling thread. */
+    static std::vector<juce::Range<int>> findAll(const TextRope &text, const SearchQuery &query);
+    
+    /**
+        Finds the matches that start inside a range of a text on the calling thread, reading past the range as far as
+        a match needs. Regular expressions are matched against the lines that start inside the range.
+     */
+    static std::vector<juce::Range<int>> findAll(const TextRope &text, const SearchQuery &query,
+                                                 juce::Range<int> range);
+
+private:
+    struct Session;
+    class Matcher;
+    
+    //==================================================================================================================
+    juce::ThreadPool         pool;
+    std::shared_ptr<Session> session;
+    
+    //==================================================================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TextSearch)
+};
@@ -0,0 +1,634 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TrigramIndex.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "TrigramIndex.h"
+
+#include <unordered_set>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    using Trigram = TrigramIndex::Trigram;
+    using FileId  = TrigramIndex::FileId;
+    
+    //==================================================================================================================
+    constexpr std::size_t Small_File_Size  = 1 << 16;
+    constexpr std::size_t Num_Trigrams     = 1 << 24;
+    constexpr std::size_t Index_Batch_Size = 256;
+    
+    //==================================================================================================================
+    std::uint32_t foldByte(char c) noexcept
+    {
+        const auto byte = static_cast<std::uint8_t>(c);
+        return (byte >= 'A' && byte <= 'Z') ? byte - 'A' + 'a' : byte;
+    }
+    
+    template<class Fn>
+    void forEachTrigram(const char *data, std::size_t size, Fn &&callback)
+    {
+        if (size < 3)
+        {
+            return;
+        }
+        
+        Trigram trigram = (::foldByte(data[0]) << 8) | ::foldByte(data[1]);
+        
+        for (std::size_t i = 2; i < size; ++i)
+        {
+            trigram = ((trigram << 8) | ::foldByte(data[i])) & (Num_Trigrams - 1);
+            callback(trigram);
+        }
+    }
+    
+    /** Gets the distinct trigrams of a file in ascending order, or nothing if the file looks binary. */
+    std::vector<Trigram> extractTrigrams(const juce::File &file)
+    {
+        const juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+        const auto                   *data = static_cast<const char*>(mapped.getData());
+        const std::size_t            size  = mapped.getSize();
+        
+        std::vector<Trigram> trigrams;
+        
+        if (data == nullptr
+            || std::memchr(data, 0, std::min(size, static_cast<std::size_t>(FileSearch::Binary_Probe_Size))) != nullptr)
+        {
+            return trigrams;
+        }
+        
+        if (size <= Small_File_Size)
+        {
+            trigrams.reserve(size);
+            ::forEachTrigram(data, size, [&trigrams](Trigram trigram) { trigrams.push_back(trigram); });
+            
+            std::sort(trigrams.begin(), trigrams.end());
+            trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+            return trigrams;
+        }
+        
+        // Large files have far fewer distinct trigrams than positions, a bitmap of all of them stays at 2 MiB
+        std::vector<std::uint64_t> present(Num_Trigrams / 64);
+        ::forEachTrigram(data, size, [&present](Trigram trigram) { present[trigram / 64] |= 1ull << (trigram % 64); });
+        
+        for (std::size_t word = 0; word < present.size(); ++word)
+        {
+            for (std::uint64_t bits = present[word]; bits != 0; bits &= bits - 1)
+            {
+                int bit = 0;
+                
+                while (((bits >> bit) & 1) == 0)
+                {
+                    ++bit;
+                }
+                
+                trigrams.push_back(static_cast<Trigram>(word * 64 + static_cast<std::size_t>(bit)));
+            }
+        }
+        
+        return trigrams;
+    }
+    
+    //==================================================================================================================
+    void appendVarint(std::vector<std::uint8_t> &bytes, std::uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        
+        bytes.push_back(static_cast<std::uint8_t>(value));
+    }
+    
+    bool isValidPostingList(const std::vector<std::uint8_t> &bytes, FileId lastId, std::size_t numFiles)
+    {
+        std::uint64_t value  = 0;
+        std::uint64_t id     = 0;
+        int           shift  = 0;
+        bool          has_id = false;
+        
+        for (const std::uint8_t byte : bytes)
+        {
+            if (shift > 28)
+            {
+                return false;
+            }
+            
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            shift += 7;
+            
+            if ((byte & 0x80) == 0)
+            {
+                // Every file is only added once to a list, so all deltas after the first id must be positive
+                if (has_id && value == 0)
+                {
+                    return false;
+                }
+                
+                id     = has_id ? id + value : value;
+                has_id = true;
+                value  = 0;
+                shift  = 0;
+                
+                if (id >= numFiles)
+                {
+                    return false;
+                }
+            }
+        }
+        
+        return has_id && shift == 0 && id == lastId;
+    }
+    
+    juce::String getRelativePath(const juce::File &root, const juce::File &file)
+    {
+        return file.getRelativePathFrom(root).replaceCharacter('\\', '/');
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region TrigramIndex
+//======================================================================================================================
+TrigramIndex::TrigramIndex(juce::File parRoot, FileSearch::Options parOptions)
+    : root(std::move(parRoot)),
+      options(std::move(parOptions))
+{
+    // The index decides which files are searched, handing it a list of them would make no sense
+    options.candidateFiles.reset();
+    options.index = nullptr;
+}
+
+TrigramIndex::~TrigramIndex()
+{
+    setFileWatcher(nullptr);
+}
+
+//======================================================================================================================
+bool TrigramIndex::load(const juce::File &indexFile)
+{
+    juce::MemoryBlock data;
+    
+    if (!indexFile.loadFileAsData(data))
+    {
+        return false;
+    }
+    
+    juce::MemoryInputStream input(data, false);
+    
+    if (static_cast<std::uint32_t>(input.readInt()) != Format_Magic
+        || static_cast<std::uint32_t>(input.readInt()) != Format_Version
+        || input.readString() != root.getFullPathName())
+    {
+        return false;
+    }
+    
+    std::vector<FileEntry>                   new_files;
+    std::unordered_map<Trigram, PostingList> new_postings;
+    
+    const int num_files = input.readInt();
+    
+    if (num_files < 0)
+    {
+        return false;
+    }
+    
+    for (int i = 0; i < num_files && !input.isExhausted(); ++i)
+    {
+        FileEntry entry;
+        entry.relativePath     = input.readString();
+        entry.size             = input.readInt64();
+        entry.modificationTime = input.readInt64();
+        entry.live             = input.readBool();
+        new_files.push_back(std::move(entry));
+    }
+    
+    const int num_postings = input.readInt();
+    
+    if (static_cast<int>(new_files.size()) != num_files || num_postings < 0)
+    {
+        return false;
+    }
+    
+    for (int i = 0; i < num_postings; ++i)
+    {
+        const auto trigram = static_cast<Trigram>(input.readInt());
+        
+        PostingList list;
+        list.lastId = static_cast<FileId>(input.readInt());
+        
+        const int num_bytes = input.readInt();
+        
+        if (num_bytes <= 0 || num_bytes > input.getNumBytesRemaining())
+        {
+            return false;
+        }
+        
+        list.bytes.resize(static_cast<std::size_t>(num_bytes));
+        (void) input.read(list.bytes.data(), num_bytes);
+        
+        // Searching and compacting trust the ids of a list to index into the files, a damaged list must not get in
+        if (!::isValidPostingList(list.bytes, list.lastId, new_files.size()))
+        {
+            return false;
+        }
+        
+        new_postings.emplace(trigram, std::move(list));
+    }
+    
+    files    = std::move(new_files);
+    postings = std::move(new_postings);
+    
+    fileLookup.clear();
+    numLiveFiles = 0;
+    
+    for (FileId id = 0; id < files.size(); ++id)
+    {
+        if (files[id].live)
+        {
+            fileLookup.emplace(files[id].relativePath, id);
+            ++numLiveFiles;
+        }
+    }
+    
+    return true;
+}
+
+bool TrigramIndex::save(const juce::File &indexFile) const
+{
+    juce::MemoryOutputStream output;
+    
+    (void) output.writeInt(static_cast<int>(Format_Magic));
+    (void) output.writeInt(static_cast<int>(Format_Version));
+    (void) output.writeString(root.getFullPathName());
+    
+    (void) output.writeInt(static_cast<int>(files.size()));
+    
+    for (const auto &entry : files)
+    {
+        (void) output.writeString(entry.relativePath);
+        (void) output.writeInt64(entry.size);
+        (void) output.writeInt64(entry.modificationTime);
+        (void) output.writeBool(entry.live);
+    }
+    
+    (void) output.writeInt(static_cast<int>(postings.size()));
+    
+    for (const auto &[trigram, list] : postings)
+    {
+        (void) output.writeInt(static_cast<int>(trigram));
+        (void) output.writeInt(static_cast<int>(list.lastId));
+        (void) output.writeInt(static_cast<int>(list.bytes.size()));
+        (void) output.write(list.bytes.data(), list.bytes.size());
+    }
+    
+    if (!indexFile.getParentDirectory().createDirectory())
+    {
+        return false;
+    }
+    
+    // Write next to the target first, so a crash mid-write never leaves a truncated index that looks valid
+    const juce::File temp_file = indexFile.getSiblingFile(indexFile.getFileName() + ".tmp");
+    
+    if (!temp_file.replaceWithData(output.getData(), output.getDataSize()) || !temp_file.moveFileTo(indexFile))
+    {
+        (void) temp_file.deleteFile();
+        return false;
+    }
+    
+    return true;
+}
+
+//======================================================================================================================
+int TrigramIndex::update()
+{
+    std::unordered_set<juce::String> existing;
+    std::vector<FileEntry>           changed;
+    
+    FileSearch::forEachFile(root, options, [this, &existing, &changed](const juce::File &file,
+                                                                        const juce::String &relativePath)
+    {
+        const juce::int64 size = file.getSize();
+        const juce::int64 time = file.getLastModificationTime().toMilliseconds();
+        
+        existing.insert(relativePath);
+        
+        if (const auto it = fileLookup.find(relativePath); it != fileLookup.end())
+        {
+            const FileEntry &entry = files[it->second];
+            
+            if (entry.size == size && entry.modificationTime == time)
+            {
+                return true;
+            }
+        }
+        
+        changed.push_back({ relativePath, size, time, true });
+        return true;
+    });
+    
+    std::vector<juce::String> removed;
+    
+    for (const auto &[path, id] : fileLookup)
+    {
+        if (existing.find(path) == existing.end())
+        {
+            removed.push_back(path);
+        }
+    }
+    
+    for (const auto &path : removed)
+    {
+        removeFile(path);
+    }
+    
+    addFiles(changed);
+    compactIfMostlyTombstones();
+    
+    return static_cast<int>(changed.size() + removed.size());
+}
+
+void TrigramIndex::updateFile(const juce::File &file)
+{
+    const juce::String relative = ::getRelativePath(root, file);
+    
+    if (!file.isAChildOf(root) || !file.existsAsFile() || !FileSearch::isSearchable(relative, options))
+    {
+        removeFile(relative);
+    }
+    else
+    {
+        addFiles({ { relative, file.getSize(), file.getLastModificationTime().toMilliseconds(), true } });
+    }
+    
+    compactIfMostlyTombstones();
+}
+
+void TrigramIndex::setFileWatcher(FileWatcher *watcher)
+{
+    if (fileWatcher != nullptr)
+    {
+        fileWatcher->removeListener(this);
+    }
+    
+    fileWatcher = watcher;
+    
+    if (fileWatcher != nullptr)
+    {
+        fileWatcher->addListener(this);
+    }
+}
+
+//======================================================================================================================
+std::optional<std::vector<juce::File>> TrigramIndex::findCandidates(const SearchQuery &query) const
+{
+    const std::string pattern = query.pattern.toStdString();
+    
+    if (query.isRegex || pattern.size() < 3)
+    {
+        return std::nullopt;
+    }
+    
+    std::vector<Trigram> trigrams;
+    ::forEachTrigram(pattern.data(), pattern.size(), [&trigrams](Trigram trigram) { trigrams.push_back(trigram); });
+    
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    
+    std::vector<const PostingList*> lists;
+    std::vector<juce::File>         candidates;
+    
+    for (const Trigram trigram : trigrams)
+    {
+        const auto it = postings.find(trigram);
+        
+        if (it == postings.end())
+        {
+            return candidates;
+        }
+        
+        lists.push_back(&it->second);
+    }
+    
+    // Start with the shortest list, the result can only get smaller
+    std::sort(lists.begin(), lists.end(), [](const PostingList *a, const PostingList *b)
+    {
+        return a->bytes.size() < b->bytes.size();
+    });
+    
+    std::vector<FileId> ids = decode(*lists.front());
+    
+    for (std::size_t i = 1; i < lists.size() && !ids.empty(); ++i)
+    {
+        const std::vector<FileId> other = decode(*lists[i]);
+        ids.erase(std::set_intersection(ids.begin(), ids.end(), other.begin(), other.end(), ids.begin()), ids.end());
+    }
+    
+    for (const FileId id : ids)
+    {
+        if (files[id].live)
+        {
+            candidates.push_back(root.getChildFile(files[id].relativePath));
+        }
+    }
+    
+    return candidates;
+}
+
+//======================================================================================================================
+std::size_t TrigramIndex::getPostingsSize() const noexcept
+{
+    std::size_t size = 0;
+    
+    for (const auto &[trigram, list] : postings)
+    {
+        size += list.bytes.size();
+    }
+    
+    return size;
+}
+
+//======================================================================================================================
+void TrigramIndex::fileChanged(const juce::File &file)
+{
+    // The watcher may be watching files for others too, those outside the root aren't ours to remove
+    if (file.isAChildOf(root))
+    {
+        updateFile(file);
+    }
+}
+
+//======================================================================================================================
+void TrigramIndex::addFiles(const std::vector<FileEntry> &newFiles)
+{
+    if (newFiles.empty())
+    {
+        return;
+    }
+    
+    juce::ThreadPool pool(juce::jmin(juce::SystemStats::getNumCpus(), static_cast<int>(newFiles.size())));
+    
+    // Reading files is what takes time, so that happens in parallel; the results are then added in order,
+    // a batch at a time to keep the trigrams waiting to be added from piling up
+    for (std::size_t batch_start = 0; batch_start < newFiles.size(); batch_start += Index_Batch_Size)
+    {
+        const std::size_t batch_size = std::min(Index_Batch_Size, newFiles.size() - batch_start);
+        
+        std::vector<std::vector<Trigram>> trigrams(batch_size);
+        std::atomic<std::size_t>          remaining { batch_size };
+        juce::WaitableEvent               done;
+        
+        for (std::size_t i = 0; i < batch_size; ++i)
+        {
+            pool.addJob([this, &newFiles, &trigrams, &remaining, &done, batch_start, i]
+            {
+                trigrams[i] = ::extractTrigrams(root.getChildFile(newFiles[batch_start + i].relativePath));
+                
+                if (--remaining == 0)
+                {
+                    done.signal();
+                }
+                
+                return juce::ThreadPoolJob::jobHasFinished;
+            });
+        }
+        
+        (void) done.wait(-1);
+        
+        for (std::size_t i = 0; i < batch_size; ++i)
+        {
+            const FileEntry &entry = newFiles[batch_start + i];
+            const auto      id     = static_cast<FileId>(files.size());
+            
+            // The old version of a changed file stays behind as a tombstone, ids have to keep growing
+            removeFile(entry.relativePath);
+            
+            files.push_back(entry);
+            fileLookup[entry.relativePath] = id;
+            ++numLiveFiles;
+            
+            for (const Trigram trigram : trigrams[i])
+            {
+                PostingList &list = postings[trigram];
+                ::appendVarint(list.bytes, list.bytes.empty() ? id : id - list.lastId);
+                list.lastId = id;
+            }
+        }
+    }
+}
+
+void TrigramIndex::removeFile(const juce::String &relativePath)
+{
+    if (const auto it = fileLookup.find(relativePath); it != fileLookup.end())
+    {
+        files[it->second].live = false;
+        fileLookup.erase(it);
+        --numLiveFiles;
+    }
+}
+
+void TrigramIndex::compactIfMostlyTombstones()
+{
+    if (files.size() - static_cast<std::size_t>(numLiveFiles) > static_cast<std::size_t>(numLiveFiles))
+    {
+        compact();
+    }
+}
+
+void TrigramIndex::compact()
+{
+    constexpr FileId invalid_id = std::numeric_limits<FileId>::max();
+    
+    std::vector<FileId>    new_ids(files.size(), invalid_id);
+    std::vector<FileEntry> live_files;
+    
+    for (FileId id = 0; id < files.size(); ++id)
+    {
+        if (files[id].live)
+        {
+            new_ids[id] = static_cast<FileId>(live_files.size());
+            live_files.push_back(std::move(files[id]));
+        }
+    }
+    
+    // Renumbering keeps the order of ids, so every list stays sorted
+    for (auto it = postings.begin(); it != postings.end();)
+    {
+        PostingList list;
+        
+        for (const FileId id : decode(it->second))
+        {
+            if (const FileId new_id = new_ids[id]; new_id != invalid_id)
+            {
+                ::appendVarint(list.bytes, list.bytes.empty() ? new_id : new_id - list.lastId);
+                list.lastId = new_id;
+            }
+        }
+        
+        if (list.bytes.empty())
+        {
+            it = postings.erase(it);
+        }
+        else
+        {
+            it->second = std::move(list);
+            ++it;
+        }
+    }
+    
+    files = std::move(live_files);
+    fileLookup.clear();
+    
+    for (FileId id = 0; id < files.size(); ++id)
+    {
+        fileLookup.emplace(files[id].relativePath, id);
+    }
+}
+
+std::vector<TrigramIndex::FileId> TrigramIndex::decode(const PostingList &list)
+{
+    std::vector<FileId> ids;
+    FileId              value = 0;
+    int                 shift = 0;
+    
+    for (const std::uint8_t byte : list.bytes)
+    {
+        value |= static_cast<FileId>(byte & 0x7f) << shift;
+        shift += 7;
+        
+        if ((byte & 0x80) == 0)
+        {
+            ids.push_back(ids.empty() ? value : ids.back() + value);
+            value = 0;
+            shift = 0;
+        }
+    }
+    
+    return ids;
+}
+//======================================================================================================================
+// endregion TrigramIndex
+//**********************************************************************************************************************
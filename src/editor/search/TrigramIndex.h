@@ -0,0 +1,151 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TrigramIndex.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "FileSearch.h"
+#include "../document/FileWatcher.h"
+
+/**
+    An index of which files of a directory tree contain which trigrams, to narrow down a search before any file
+    content is scanned.
+    
+    Trigrams are taken from the raw UTF-8 bytes with ASCII letters folded to lowercase, so the index answers both
+    case-sensitive and case-insensitive queries; it only ever gives a superset of the files that match, the exact
+    scan is still up to FileSearch.
+    
+    Every trigram has a posting list of ascending file ids, stored as varint-encoded deltas. A changed file is given a
+    new id, which is always the highest, so reindexing it only appends to the lists of its trigrams; the old id is
+    left as a tombstone until there are more of those than live files, then all lists are rewritten once.
+    
+    The index isn't thread safe, update and query it from the same thread or guard it.
+ */
+class TrigramIndex : private FileWatcher::Listener
+{
+public:
+    using FileId  = std::uint32_t;
+    using Trigram = std::uint32_t;
+    
+    //==================================================================================================================
+    static constexpr std::uint32_t Format_Magic   = 0x4952544a; // "JTRI"
+    static constexpr std::uint32_t Format_Version = 1;
+    
+    //==================================================================================================================
+    /**
+        Creates an empty index for a directory.
+        
+        @param root    The directory whose files are indexed
+        @param options Which files to index, the same that should be passed to FileSearch
+     */
+    TrigramIndex(juce::File root, FileSearch::Options options);
+    ~TrigramIndex() override;
+    
+    //==================================================================================================================
+    /**
+        Replaces the index with the one stored in a file.
+        This fails if the file doesn't exist, is corrupted or belongs to another root.
+     */
+    bool load(const juce::File &indexFile);
+    
+    /** Writes the index to a file, through a temporary file so that a crash never leaves a truncated index behind. */
+    bool save(const juce::File &indexFile) const;
+    
+    //==================================================================================================================
+    /**
+        Walks the directory and reindexes every file that is new or whose size or modification time changed,
+        and forgets about files that are gone. Files are read in parallel.
+        
+        @return The number of files that were (re)indexed or removed
+     */
+    int update();
+    
+    /** Reindexes a single file, or removes it from the index if it no longer exists. */
+    void updateFile(const juce::File &file);
+    
+    /**
+        Reindexes the files below the root that a watcher reports as changed, as they are reported.
+        Which files are watched is up to the owner of the watcher, the files open in an editor for example; the
+        watcher must outlive the index or be replaced with nullptr before it goes away.
+        Like everything else this must be called on the message thread, where the watcher reports changes.
+     */
+    void setFileWatcher(FileWatcher *watcher);
+    
+    //==================================================================================================================
+    /**
+        Gets the files that might contain a match for a query.
+        Nothing is returned if the index can't narrow down the query, which is the case for regular expressions and
+        patterns shorter than three bytes; all files have to be searched then.
+     */
+    std::optional<std::vector<juce::File>> findCandidates(const SearchQuery &query) const;
+    
+    //==================================================================================================================
+    int getNumFiles() const noexcept { return numLiveFiles; }
+    
+    /** Gets the number of old file ids that are still in the posting lists, until the next compaction. */
+    int getNumTombstones() const noexcept { return static_cast<int>(files.size()) - numLiveFiles; }
+    
+    /** Gets the number of bytes the posting lists take up. */
+    std::size_t getPostingsSize() const noexcept;
+
+private:
+    struct FileEntry
+    {
+        juce::String relativePath;
+        juce::int64  size;
+        juce::int64  modificationTime;
+        bool         live;
+    };
+    
+    struct PostingList
+    {
+        std::vector<std::uint8_t> bytes;
+        FileId                    lastId;
+    };
+    
+    //==================================================================================================================
+    juce::File          root;
+    FileSearch::Options options;
+    
+    std::vector<FileEntry>                   files;
+    std::unordered_map<juce::String, FileId> fileLookup;
+    std::unordered_map<Trigram, PostingList> postings;
+    int                                      numLiveFiles { 0 };
+    
+    FileWatcher *fileWatcher { nullptr };
+    
+    //==================================================================================================================
+    void fileChanged(const juce::File &file) override;
+    
+    //==================================================================================================================
+    void addFiles(const std::vector<FileEntry> &newFiles);
+    void removeFile(const juce::String &relativePath);
+    void compactIfMostlyTombstones();
+    void compact();
+    
+    static std::vector<FileId> decode(const PostingList &list);
+    
+    //==================================================================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrigramIndex)
+};
@@ -0,0 +1,114 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   BumpArena.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+    Hands out trivially destructible objects from large fixed-size blocks, addressed by index.
+    
+    Nothing can be freed individually, the whole arena is discarded at once. Growing never moves existing
+    objects and a run of objects allocated with one call always has consecutive indices. A run of up to BlockSize
+    objects is also contiguous in memory, longer runs start a block of their own and go on through the next ones.
+ */
+template<class T, std::uint32_t BlockSize = 4096>
+class BumpArena
+{
+public:
+    static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed individually");
+    static_assert((BlockSize & (BlockSize - 1)) == 0,  "BlockSize must be a power of two");
+    
+    //==================================================================================================================
+    BumpArena() = default;
+    
+    BumpArena(BumpArena&&) noexcept            = default;
+    BumpArena& operator=(BumpArena&&) noexcept = default;
+    
+    //==================================================================================================================
+    /**
+        Allocates a contiguous run of default constructed objects.
+        
+        @param count The number of objects
+        @return The index of the first object
+     */
+    std::uint32_t allocate(std::uint32_t count = 1)
+    {
+        jassert(count > 0);
+        
+        const std::uint32_t block_offset = nextIndex & (BlockSize - 1);
+        
+        if (block_offset != 0 && block_offset + count > BlockSize)
+        {
+            // Not enough room left in this block, skip the rest so the run doesn't straddle two blocks
+            nextIndex += BlockSize - block_offset;
+        }
+        
+        const std::uint32_t index = nextIndex;
+        nextIndex += count;
+        
+        while ((nextIndex - 1) / BlockSize >= blocks.size())
+        {
+            blocks.emplace_back(std::make_unique<T[]>(BlockSize));
+        }
+        
+        for (std::uint32_t i = index; i < nextIndex;)
+        {
+            const std::uint32_t block_end = juce::jmin(nextIndex, (i | (BlockSize - 1)) + 1);
+            std::fill_n(&(*this)[i], block_end - i, T{});
+            i = block_end;
+        }
+        
+        return index;
+    }
+    
+    /** Forgets all objects but keeps the first block around for reuse. */
+    void clear() noexcept
+    {
+        if (blocks.size() > 1)
+        {
+            blocks.erase(blocks.begin() + 1, blocks.end());
+        }
+        
+        nextIndex = 0;
+    }
+    
+    //==================================================================================================================
+    T&       operator[](std::uint32_t index)       noexcept { return blocks[index / BlockSize][index & (BlockSize - 1)]; }
+    const T& operator[](std::uint32_t index) const noexcept { return blocks[index / BlockSize][index & (BlockSize - 1)]; }
+    
+    //==================================================================================================================
+    /** Gets the index the next allocation would start at, also an upper bound for all valid indices. */
+    std::uint32_t getEndIndex() const noexcept { return nextIndex; }
+    
+    /** Gets the number of bytes reserved by this arena. */
+    std::size_t getMemoryUsage() const noexcept { return blocks.size() * BlockSize * sizeof(T); }
+    
+private:
+    std::vector<std::unique_ptr<T[]>> blocks;
+    std::uint32_t                     nextIndex { 0 };
+    
+    JUCE_DECLARE_NON_COPYABLE(BumpArena)
+};
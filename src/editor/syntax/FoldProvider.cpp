@@ -0,0 +1,561 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FoldProvider.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+
+#include "FoldProvider.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    std::uint32_t nextPriority(std::uint32_t &seed) noexcept
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region DepthTree
+//======================================================================================================================
+/**
+    The markers of all lines in an implicit treap, ordered by line.
+    Every subtree knows the sum of its balances and the lowest depth reached in it, relative to the depth before it,
+    so lines can be inserted and removed without touching the lines after them and the next shallower line is found
+    by descending the tree.
+ */
+class FoldProvider::DepthTree
+{
+public:
+    explicit DepthTree(const std::vector<LineMarker> &markers)
+    {
+        root = build(markers);
+    }
+    
+    //==================================================================================================================
+    int getNumLines() const noexcept { return getSize(root); }
+    
+    LineMarker getMarker(int line) const noexcept
+    {
+        int index = root;
+        
+        for (;;)
+        {
+            const Node &node      = getNode(index);
+            const int  left_size = getSize(node.left);
+            
+            if (line == left_size)
+            {
+                return node.marker;
+            }
+            
+            if (line < left_size)
+            {
+                index = node.left;
+            }
+            else
+            {
+                line  -= left_size + 1;
+                index  = node.right;
+            }
+        }
+    }
+    
+    void setMarker(int line, LineMarker marker) noexcept
+    {
+        setMarker(root, line, marker);
+    }
+    
+    /** Replaces a number of lines with new ones. */
+    void replaceLines(int firstLine, int numOldLines, const std::vector<LineMarker> &newMarkers)
+    {
+        const auto [before, rest]    = split(root, firstLine);
+        const auto [removed, after] = split(rest, numOldLines);
+        
+        freeTree(removed);
+        root = merge(merge(before, build(newMarkers)), after);
+    }
+    
+    //==================================================================================================================
+    int getDepthAfter(int line) const noexcept
+    {
+        int index = root;
+        int depth = 0;
+        
+        for (;;)
+        {
+            const Node &node      = getNode(index);
+            const int  left_size = getSize(node.left);
+            
+            if (line < left_size)
+            {
+                index = node.left;
+                continue;
+            }
+            
+            depth += getSum(node.left) + node.marker.balance;
+            
+            if (line == left_size)
+            {
+                return depth;
+            }
+            
+            line  -= left_size + 1;
+            index  = node.right;
+        }
+    }
+    
+    /** Finds the first line at or after the given one whose depth is at most the threshold, or -1. */
+    int findFirstAtMost(int line, int threshold) const noexcept
+    {
+        return line < getNumLines() ? find(root, line, 0, threshold) : -1;
+    }
+
+private:
+    struct Node
+    {
+        int           left;
+        int           right;
+        std::uint32_t priority;
+        LineMarker    marker;
+        int           size;
+        int           sum;      // The change in depth over this subtree
+        int           minDepth; // The lowest depth after any line in this subtree, relative to the depth before it
+    };
+    
+    //==================================================================================================================
+    std::vector<Node> nodes;
+    std::vector<int>  freeNodes;
+    int               root { -1 };
+    std::uint32_t     seed { 0x9e3779b9u };
+    
+    //==================================================================================================================
+    Node&       getNode(int index)       noexcept { return nodes[static_cast<std::size_t>(index)]; }
+    const Node& getNode(int index) const noexcept { return nodes[static_cast<std::size_t>(index)]; }
+    
+    int getSize(int index) const noexcept { return index >= 0 ? getNode(index).size : 0; }
+    int getSum (int index) const noexcept { return index >= 0 ? getNode(index).sum  : 0; }
+    
+    //==================================================================================================================
+    int build(const std::vector<LineMarker> &markers)
+    {
+        // The lines come in order, so the tree only ever grows along its right spine
+        std::vector<int> spine;
+        
+        for (const LineMarker &marker : markers)
+        {
+            int index = 0;
+            
+            if (!freeNodes.empty())
+            {
+                index = freeNodes.back();
+                freeNodes.pop_back();
+            }
+            else
+            {
+                index = static_cast<int>(nodes.size());
+                nodes.emplace_back();
+            }
+            
+            Node &node = getNode(index);
+            node = { -1, -1, ::nextPriority(seed), marker, 1, marker.balance, marker.balance };
+            
+            while (!spine.empty() && getNode(spine.back()).priority < node.priority)
+            {
+                node.left = spine.back();
+                spine.pop_back();
+                pull(node.left);
+            }
+            
+            if (!spine.empty())
+            {
+                getNode(spine.back()).right = index;
+            }
+            
+            spine.emplace_back(index);
+        }
+        
+        for (auto it = spine.rbegin(); it != spine.rend(); ++it)
+        {
+            pull(*it);
+        }
+        
+        return spine.empty() ? -1 : spine.front();
+    }
+    
+    void freeTree(int index)
+    {
+        std::vector<int> stack;
+        
+        if (index >= 0)
+        {
+            stack.emplace_back(index);
+        }
+        
+        while (!stack.empty())
+        {
+            const Node &node = getNode(stack.back());
+            freeNodes.emplace_back(stack.back());
+            stack.pop_back();
+            
+            for (const int child : { node.left, node.right })
+            {
+                if (child >= 0)
+                {
+                    stack.emplace_back(child);
+                }
+            }
+        }
+    }
+    
+    //==================================================================================================================
+    int merge(int left, int right) noexcept
+    {
+        if (left < 0 || right < 0)
+        {
+            return left >= 0 ? left : right;
+        }
+        
+        if (getNode(left).priority > getNode(right).priority)
+        {
+            getNode(left).right = merge(getNode(left).right, right);
+            pull(left);
+            return left;
+        }
+        
+        getNode(right).left = merge(left, getNode(right).left);
+        pull(right);
+        return right;
+    }
+    
+    std::pair<int, int> split(int index, int count) noexcept
+    {
+        if (index < 0)
+        {
+            return { -1, -1 };
+        }
+        
+        if (const int left_size = getSize(getNode(index).left); count <= left_size)
+        {
+            const auto [left, right] = split(getNode(index).left, count);
+            getNode(index).left = right;
+            pull(index);
+            return { left, index };
+        }
+        else
+        {
+            const auto [left, right] = split(getNode(index).right, count - left_size - 1);
+            getNode(index).right = left;
+            pull(index);
+            return { index, right };
+        }
+    }
+    
+    void pull(int index) noexcept
+    {
+        Node &node = getNode(index);
+        
+        const int left_sum = getSum(node.left);
+        const int own      = left_sum + node.marker.balance;
+        
+        node.size     = 1 + getSize(node.left) + getSize(node.right);
+        node.sum      = own + getSum(node.right);
+        node.minDepth = own;
+        
+        if (node.left >= 0)
+        {
+            node.minDepth = juce::jmin(node.minDepth, getNode(node.left).minDepth);
+        }
+        
+        if (node.right >= 0)
+        {
+            node.minDepth = juce::jmin(node.minDepth, own + getNode(node.right).minDepth);
+        }
+    }
+    
+    void setMarker(int index, int line, LineMarker marker) noexcept
+    {
+        Node      &node      = getNode(index);
+        const int left_size = getSize(node.left);
+        
+        if (line < left_size)
+        {
+            setMarker(node.left, line, marker);
+        }
+        else if (line > left_size)
+        {
+            setMarker(node.right, line - left_size - 1, marker);
+        }
+        else
+        {
+            node.marker = marker;
+        }
+        
+        pull(index);
+    }
+    
+    //==================================================================================================================
+    int find(int index, int from, int before, int threshold) const noexcept
+    {
+        if (index < 0 || before + getNode(index).minDepth > threshold)
+        {
+            return -1;
+        }
+        
+        const Node &node      = getNode(index);
+        const int  left_size = getSize(node.left);
+        
+        if (from < left_size)
+        {
+            if (const int found = find(node.left, from, before, threshold); found >= 0)
+            {
+                return found;
+            }
+        }
+        
+        const int own = before + getSum(node.left) + node.marker.balance;
+        
+        if (from <= left_size && own <= threshold)
+        {
+            return left_size;
+        }
+        
+        const int found = find(node.right, juce::jmax(0, from - left_size - 1), own, threshold);
+        return found >= 0 ? left_size + 1 + found : -1;
+    }
+};
+//======================================================================================================================
+// endregion DepthTree
+//**********************************************************************************************************************
+// region FoldProvider
+//======================================================================================================================
+FoldProvider::FoldProvider(const juce::CodeDocument &parDocument)
+    : document(parDocument)
+{}
+
+FoldProvider::~FoldProvider() = default;
+
+//======================================================================================================================
+bool FoldProvider::setMarkers(const TextMateGrammar::Expression &parMarkers)
+{
+    hasMarkers = false;
+    
+    if (!parMarkers.beginOrMatch.isEmpty() && !parMarkers.end.isEmpty())
+    {
+        try
+        {
+            startMarker = std::wregex(parMarkers.beginOrMatch.toWideCharPointer(), std::regex::optimize);
+            stopMarker  = std::wregex(parMarkers.end         .toWideCharPointer(), std::regex::optimize);
+            hasMarkers  = true;
+        }
+        catch (const std::regex_error&)
+        {
+            // TextMate grammars are written for Oniguruma, not every expression has an ECMAScript equivalent
+        }
+    }
+    
+    rescan();
+    return hasMarkers;
+}
+
+void FoldProvider::setSyntaxTree(const SyntaxTree *tree) noexcept
+{
+    syntaxTree = tree;
+}
+
+//======================================================================================================================
+void FoldProvider::rescan()
+{
+    std::vector<LineMarker> markers;
+    
+    if (hasMarkers)
+    {
+        const int num_lines = document.getNumLines();
+        markers.reserve(static_cast<std::size_t>(num_lines));
+        
+        for (int i = 0; i < num_lines; ++i)
+        {
+            markers.emplace_back(matchLine(i));
+        }
+    }
+    
+    depths = std::make_unique<DepthTree>(markers);
+}
+
+void FoldProvider::updateLines(int firstLine, int numOldLines, int numNewLines)
+{
+    if (!hasMarkers)
+    {
+        return;
+    }
+    
+    jassert(juce::isPositiveAndNotGreaterThan(firstLine + numOldLines, depths->getNumLines()));
+    
+    if (numOldLines == numNewLines)
+    {
+        for (int i = firstLine; i < firstLine + numNewLines; ++i)
+        {
+            depths->setMarker(i, matchLine(i));
+        }
+        
+        return;
+    }
+    
+    // Only the edited lines go in and out of the tree, the lines after them keep their nodes
+    std::vector<LineMarker> new_markers;
+    new_markers.reserve(static_cast<std::size_t>(numNewLines));
+    
+    for (int i = firstLine; i < firstLine + numNewLines; ++i)
+    {
+        new_markers.emplace_back(matchLine(i));
+    }
+    
+    depths->replaceLines(firstLine, numOldLines, new_markers);
+}
+
+//======================================================================================================================
+FoldProvider::Region FoldProvider::getRegionAt(int line) const
+{
+    const std::vector<Region> regions = getRegions({ line, line + 1 });
+    return regions.empty() ? Region{ {}, 0, 0 } : regions.front();
+}
+
+std::vector<FoldProvider::Region> FoldProvider::getRegions(juce::Range<int> lineRange) const
+{
+    lineRange = lineRange.getIntersectionWith({ 0, document.getNumLines() });
+    
+    if (lineRange.isEmpty())
+    {
+        return {};
+    }
+    
+    if (syntaxTree && !syntaxTree->isEmpty())
+    {
+        return getElementRegions(lineRange);
+    }
+    
+    return getMarkerRegions(lineRange);
+}
+
+//======================================================================================================================
+FoldProvider::LineMarker FoldProvider::matchLine(int line) const
+{
+    const juce::String text  = document.getLine(line);
+    const wchar_t      *data = text.toWideCharPointer();
+    
+    std::wcmatch start_match;
+    std::wcmatch stop_match;
+    
+    const bool starts = std::regex_search(data, start_match, startMarker);
+    const bool stops  = std::regex_search(data, stop_match,  stopMarker);
+    
+    if (starts && !stops)
+    {
+        return { 1, static_cast<int>(start_match.position(0)) };
+    }
+    
+    if (stops && !starts)
+    {
+        return { -1, static_cast<int>(stop_match.position(0)) };
+    }
+    
+    return { 0, 0 };
+}
+
+//======================================================================================================================
+std::vector<FoldProvider::Region> FoldProvider::getMarkerRegions(juce::Range<int> lineRange) const
+{
+    std::vector<Region> regions;
+    
+    if (!hasMarkers)
+    {
+        return regions;
+    }
+    
+    for (int i = lineRange.getStart(); i < lineRange.getEnd(); ++i)
+    {
+        const LineMarker marker = depths->getMarker(i);
+        
+        if (marker.balance <= 0)
+        {
+            continue;
+        }
+        
+        // The region ends in the first line that brings the depth back to where it was before this one
+        const int depth_before = depths->getDepthAfter(i) - 1;
+        
+        if (const int end = depths->findFirstAtMost(i + 1, depth_before); end >= 0)
+        {
+            regions.push_back({ { i, end }, marker.column, depths->getMarker(end).column });
+        }
+    }
+    
+    return regions;
+}
+
+std::vector<FoldProvider::Region> FoldProvider::getElementRegions(juce::Range<int> lineRange) const
+{
+    std::vector<Region> regions;
+    
+    const juce::CodeDocument::Position range_start(document, lineRange.getStart(), 0);
+    const juce::CodeDocument::Position range_end  (document, lineRange.getEnd(),   0);
+    
+    const int start_offset = range_start.getPosition();
+    const int end_offset   = lineRange.getEnd() < document.getNumLines() ? range_end.getPosition()
+                                                                         : document.getNumCharacters() + 1;
+    
+    syntaxTree->forEachElementIn({ start_offset, end_offset }, [&](SyntaxTree::NodeId id, juce::Range<int> range, int)
+    {
+        if (range.getStart() >= start_offset)
+        {
+            const SyntaxTree::Node &node = syntaxTree->getNode(id);
+            
+            const juce::CodeDocument::Position open (document, range.getStart());
+            const juce::CodeDocument::Position close(document, range.getStart() + node.endTagStart);
+            
+            // Elements are visited before their children, so the outermost one claims a line
+            if (close.getLineNumber() > open.getLineNumber()
+                && (regions.empty() || regions.back().lines.getStart() != open.getLineNumber()))
+            {
+                regions.push_back({
+                    { open.getLineNumber(), close.getLineNumber() },
+                    open .getIndexInLine(),
+                    close.getIndexInLine()
+                });
+            }
+        }
+        
+        return true;
+    });
+    
+    return regions;
+}
+//======================================================================================================================
+// endregion FoldProvider
+//**********************************************************************************************************************
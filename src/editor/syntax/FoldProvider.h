@@ -0,0 +1,118 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FoldProvider.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+
+#pragma once
+
+#include "SyntaxTree.h"
+#include "textmate/TextMateGrammar.h"
+
+#include <juce_gui_extra/juce_gui_extra.h>
+#include <regex>
+
+/**
+    Finds the regions of a document that can be folded.
+    
+    If an xml tree is available, every element whose end tag is on a later line than its start tag is a region.
+    Otherwise lines are matched against the folding markers of a TextMate grammar, a line that matches the start
+    marker but not the stop marker opens a region that is closed by the matching stop line.
+    
+    Marker matches are cached per line and only the lines touched by an edit are matched again. Instead of pairing
+    markers with a stack walk over the whole document, the matches are kept in an implicit treap that knows how the
+    nesting depth changes over each subtree; an edit swaps out just the edited lines and the end of a region is the
+    first line after it that falls back to its depth, which is found by descending the tree. Both are O(log n) plus
+    the edited lines. Element regions are found by seeking to the range in the xml tree, not by walking it.
+ */
+class FoldProvider
+{
+public:
+    struct Region
+    {
+        juce::Range<int> lines;       // From the line the region opens in to the line that closes it
+        int              startColumn; // Where the region opens in its first line
+        int              endColumn;   // Where the region closes in its last line
+    };
+    
+    //==================================================================================================================
+    explicit FoldProvider(const juce::CodeDocument &document);
+    ~FoldProvider();
+    
+    //==================================================================================================================
+    /**
+        Sets the folding markers to match lines against.
+        The markers are compiled as ECMAScript expressions, if they fail to compile marker folding is disabled.
+        
+        @return True if the markers could be compiled
+     */
+    bool setMarkers(const TextMateGrammar::Expression &markers);
+    
+    /** Sets the xml tree to take regions from, or nullptr to use the folding markers. */
+    void setSyntaxTree(const SyntaxTree *tree) noexcept;
+    
+    //==================================================================================================================
+    /** Matches all lines of the document again. */
+    void rescan();
+    
+    /**
+        Updates the regions after an edit that replaced a number of lines with a different number of lines.
+        
+        @param firstLine    The first line that was changed
+        @param numOldLines  The number of lines the edit replaced, starting at firstLine
+        @param numNewLines  The number of lines that took their place
+     */
+    void updateLines(int firstLine, int numOldLines, int numNewLines);
+    
+    //==================================================================================================================
+    /** Gets the region that opens in a line, the returned region's line range is empty if there is none. */
+    Region getRegionAt(int line) const;
+    
+    /** Gets all regions that open in a range of lines, in order of their first line. */
+    std::vector<Region> getRegions(juce::Range<int> lineRange) const;
+    
+private:
+    class DepthTree;
+    
+    struct LineMarker
+    {
+        int balance; // 1 if the line opens a region, -1 if it closes one and 0 otherwise
+        int column;
+    };
+    
+    //==================================================================================================================
+    const juce::CodeDocument   &document;
+    const SyntaxTree           *syntaxTree { nullptr };
+    std::unique_ptr<DepthTree> depths;
+    std::wregex                startMarker;
+    std::wregex                stopMarker;
+    bool                       hasMarkers { false };
+    
+    //==================================================================================================================
+    LineMarker matchLine(int line) const;
+    
+    std::vector<Region> getMarkerRegions (juce::Range<int> lineRange) const;
+    std::vector<Region> getElementRegions(juce::Range<int> lineRange) const;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FoldProvider)
+};
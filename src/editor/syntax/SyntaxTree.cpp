@@ -1,5 +1,651 @@
-//
-// Created by elanda on 15.01.22.
-//
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   SyntaxTree.cpp
+    @date   15, January 2022
+
+    ===============================================================
+ */
 
 #include "SyntaxTree.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    // Child trees are treaps, a well mixed hash of the node id serves as the heap priority so it doesn't have to be
+    // stored and the shape of a tree only depends on the nodes in it
+    std::uint32_t getTreePriority(SyntaxTree::NodeId id) noexcept
+    {
+        id ^= id >> 16;
+        id *= 0x85ebca6bu;
+        id ^= id >> 13;
+        id *= 0xc2b2ae35u;
+        id ^= id >> 16;
+        return id;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region SyntaxTree
+//======================================================================================================================
+//======================================================================================================================
+//**********************************************************************************************************************
+// region Builder
+//======================================================================================================================
+SyntaxTree::Builder::Builder(SyntaxTree &parTree)
+    : Builder(parTree, Mode::Rebuild)
+{}
+
+SyntaxTree::Builder::Builder(SyntaxTree &parTree, Mode mode)
+    : tree(parTree), openStarts{ 0 }, previousEnds{ 0 }, current(0), rebuilding(mode == Mode::Rebuild)
+{
+    if (mode == Mode::Rebuild)
+    {
+        tree.reset();
+        return;
+    }
+    
+    // Keep the arena, old nodes may still be adopted into the new structure
+    Node &root = tree.nodes[0];
+    root.firstChild = Invalid_Id;
+    root.lastChild  = Invalid_Id;
+    root.childTree  = Invalid_Id;
+    root.flags      = 0;
+}
+
+SyntaxTree::Builder::Builder(SyntaxTree &parTree, NodeId parent, int parentStart, int previousEnd)
+    : tree(parTree), openStarts{ parentStart }, previousEnds{ previousEnd }, current(parent), rebuilding(false)
+{}
+
+//======================================================================================================================
+void SyntaxTree::Builder::openElement(const juce::String &name, int start)
+{
+    const NodeId id   = appendChild(NodeType::Element, start);
+    Node         &node = tree.nodes[id];
+    
+    node.name           = tree.intern(name);
+    node.startTagLength = -1;
+    
+    openStarts.emplace_back(start);
+    previousEnds.emplace_back(start);
+    current = id;
+    
+    pendingAttributes.clear();
+}
+
+void SyntaxTree::Builder::addAttribute(const juce::String &name, juce::Range<int> nameRange,
+                                       juce::Range<int> valueRange)
+{
+    const int element_start = openStarts.back();
+    const bool has_value    = valueRange.getStart() >= 0;
+    
+    pendingAttributes.push_back({
+        tree.intern(name),
+        nameRange.getStart() - element_start,
+        nameRange.getLength(),
+        has_value ? valueRange.getStart() - element_start : -1,
+        has_value ? valueRange.getLength() : 0
+    });
+}
+
+void SyntaxTree::Builder::finishStartTag(int end, bool selfClosing)
+{
+    Node &node = tree.nodes[current];
+    node.startTagLength = end - openStarts.back();
+    
+    if (!pendingAttributes.empty())
+    {
+        // Attributes are flushed in one go so they end up with consecutive indices in the arena
+        const auto count = static_cast<std::uint32_t>(pendingAttributes.size());
+        node.firstAttribute = tree.attributes.allocate(count);
+        node.numAttributes  = count;
+        
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            tree.attributes[node.firstAttribute + i] = pendingAttributes[i];
+        }
+        
+        pendingAttributes.clear();
+    }
+    
+    if (selfClosing)
+    {
+        node.flags |= NodeFlags::SelfClosing;
+        closeCurrent(end, end, false);
+    }
+}
+
+void SyntaxTree::Builder::closeElement(int endTagStart, int end)
+{
+    if (current != 0)
+    {
+        closeCurrent(endTagStart, end, false);
+    }
+}
+
+void SyntaxTree::Builder::addLeaf(NodeType type, juce::Range<int> range, bool terminated)
+{
+    const NodeId id   = appendChild(type, range.getStart());
+    Node         &node = tree.nodes[id];
+    
+    node.length         = range.getLength();
+    node.startTagLength = node.length;
+    node.endTagStart    = node.length;
+    
+    previousEnds.back() = range.getEnd();
+    
+    if (!terminated)
+    {
+        node.flags |= NodeFlags::Unclosed | NodeFlags::Dirty;
+        markDirty();
+    }
+}
+
+void SyntaxTree::Builder::markDirty() noexcept
+{
+    tree.nodes[current].flags |= NodeFlags::Dirty;
+}
+
+void SyntaxTree::Builder::markTagMalformed() noexcept
+{
+    tree.nodes[current].flags |= NodeFlags::Malformed | NodeFlags::Dirty;
+}
+
+void SyntaxTree::Builder::closeUnterminatedElement(int end)
+{
+    if (current != 0)
+    {
+        closeCurrent(end, end, true);
+    }
+}
+
+//======================================================================================================================
+void SyntaxTree::Builder::finish(int documentLength)
+{
+    while (current != 0)
+    {
+        closeCurrent(documentLength, documentLength, true);
+    }
+    
+    Node &root = tree.nodes[0];
+    root.length         = documentLength;
+    root.startTagLength = 0;
+    root.endTagStart    = documentLength;
+    root.childTree      = tree.buildChildTree(root.firstChild);
+    
+    if (rebuilding)
+    {
+        tree.nodesAfterRebuild = tree.nodes.getEndIndex();
+    }
+}
+
+//======================================================================================================================
+SyntaxTree::NodeId SyntaxTree::Builder::appendChild(NodeType type, int start)
+{
+    const NodeId id     = tree.nodes.allocate();
+    Node         &node   = tree.nodes[id];
+    Node         &parent = tree.nodes[current];
+    
+    node.offset          = start - previousEnds.back();
+    node.parent          = current;
+    node.firstChild      = Invalid_Id;
+    node.lastChild       = Invalid_Id;
+    node.previousSibling = parent.lastChild;
+    node.nextSibling     = Invalid_Id;
+    node.childTree       = Invalid_Id;
+    node.type            = type;
+    
+    if (parent.lastChild != Invalid_Id)
+    {
+        tree.nodes[parent.lastChild].nextSibling = id;
+    }
+    else
+    {
+        parent.firstChild = id;
+    }
+    
+    parent.lastChild = id;
+    return id;
+}
+
+void SyntaxTree::Builder::adoptNode(NodeId id, int start)
+{
+    Node &node   = tree.nodes[id];
+    Node &parent = tree.nodes[current];
+    
+    // Only the node's links to its new surroundings change, everything below it is relative and stays untouched
+    node.offset          = start - previousEnds.back();
+    node.parent          = current;
+    node.previousSibling = parent.lastChild;
+    node.nextSibling     = Invalid_Id;
+    
+    previousEnds.back() = start + node.length;
+    
+    if (parent.lastChild != Invalid_Id)
+    {
+        tree.nodes[parent.lastChild].nextSibling = id;
+    }
+    else
+    {
+        parent.firstChild = id;
+    }
+    
+    parent.lastChild = id;
+}
+
+void SyntaxTree::Builder::closeCurrent(int endTagStart, int end, bool unclosed)
+{
+    Node      &node  = tree.nodes[current];
+    const int start = openStarts.back();
+    
+    node.length      = end - start;
+    node.endTagStart = endTagStart - start;
+    node.childTree   = tree.buildChildTree(node.firstChild);
+    
+    if (node.startTagLength < 0)
+    {
+        // The start tag never ended, this happens at the end of an incomplete document
+        node.startTagLength = node.length;
+    }
+    
+    if (unclosed)
+    {
+        node.flags |= NodeFlags::Unclosed | NodeFlags::Dirty;
+    }
+    
+    openStarts.pop_back();
+    previousEnds.pop_back();
+    previousEnds.back() = end;
+    current = node.parent;
+    
+    if ((node.flags & NodeFlags::Dirty) != 0)
+    {
+        tree.nodes[current].flags |= NodeFlags::Dirty;
+    }
+}
+//======================================================================================================================
+// endregion Builder
+//**********************************************************************************************************************
+// region SyntaxTree
+//======================================================================================================================
+SyntaxTree::SyntaxTree()
+{
+    reset();
+}
+
+//======================================================================================================================
+int SyntaxTree::getStart(NodeId id) const noexcept
+{
+    int start = 0;
+    
+    for (; id != 0; id = nodes[id].parent)
+    {
+        start += getStartInParent(id);
+    }
+    
+    return start;
+}
+
+juce::Range<int> SyntaxTree::getRange(NodeId id) const noexcept
+{
+    return juce::Range<int>::withStartAndLength(getStart(id), nodes[id].length);
+}
+
+juce::Range<int> SyntaxTree::getStartTagRange(NodeId id) const noexcept
+{
+    return juce::Range<int>::withStartAndLength(getStart(id), nodes[id].startTagLength);
+}
+
+juce::Range<int> SyntaxTree::getEndTagRange(NodeId id) const noexcept
+{
+    const Node &node  = nodes[id];
+    const int  start = getStart(id);
+    
+    return { start + node.endTagStart, start + node.length };
+}
+
+//======================================================================================================================
+SyntaxTree::NameId SyntaxTree::findName(const juce::String &name) const noexcept
+{
+    const auto it = nameLookup.find(name);
+    return it != nameLookup.end() ? it->second : 0;
+}
+
+//======================================================================================================================
+const SyntaxTree::Attribute& SyntaxTree::getAttribute(NodeId id, int index) const noexcept
+{
+    jassert(juce::isPositiveAndBelow(static_cast<std::uint32_t>(index), nodes[id].numAttributes));
+    return attributes[nodes[id].firstAttribute + static_cast<std::uint32_t>(index)];
+}
+
+juce::Range<int> SyntaxTree::getAttributeValueRange(NodeId id, int index) const noexcept
+{
+    const Attribute &attribute = getAttribute(id, index);
+    
+    if (attribute.valueStart < 0)
+    {
+        return {};
+    }
+    
+    return juce::Range<int>::withStartAndLength(getStart(id) + attribute.valueStart, attribute.valueLength);
+}
+
+//======================================================================================================================
+SyntaxTree::NodeId SyntaxTree::findElementAt(int offset) const noexcept
+{
+    NodeId found = 0;
+    int    base  = 0;
+    
+    for (;;)
+    {
+        int          previous_end = 0;
+        const NodeId child        = seekChild(found, base, offset, previous_end);
+        
+        if (child == Invalid_Id)
+        {
+            break;
+        }
+        
+        const Node &node  = nodes[child];
+        const int  start = previous_end + node.offset;
+        
+        if (start > offset || node.type != NodeType::Element)
+        {
+            break;
+        }
+        
+        found = child;
+        base  = start;
+    }
+    
+    return found;
+}
+
+std::vector<SyntaxTree::NodeId> SyntaxTree::getAncestry(int offset) const
+{
+    std::vector<NodeId> ancestry;
+    
+    for (NodeId id = findElementAt(offset); id != 0; id = nodes[id].parent)
+    {
+        ancestry.emplace_back(id);
+    }
+    
+    std::reverse(ancestry.begin(), ancestry.end());
+    return ancestry;
+}
+
+juce::Range<int> SyntaxTree::findMatchingTag(int offset) const noexcept
+{
+    const NodeId id = findElementAt(offset);
+    
+    if (id == 0)
+    {
+        return {};
+    }
+    
+    const Node &node = nodes[id];
+    
+    if ((node.flags & (NodeFlags::SelfClosing | NodeFlags::Unclosed)) != 0)
+    {
+        return {};
+    }
+    
+    const int start = getStart(id);
+    
+    if (offset < start + node.startTagLength)
+    {
+        return { start + node.endTagStart, start + node.length };
+    }
+    
+    if (offset >= start + node.endTagStart)
+    {
+        return juce::Range<int>::withStartAndLength(start, node.startTagLength);
+    }
+    
+    return {};
+}
+
+//======================================================================================================================
+std::size_t SyntaxTree::getMemoryUsage() const noexcept
+{
+    std::size_t name_bytes = 0;
+    
+    for (const auto &name : names)
+    {
+        name_bytes += sizeof(juce::String) + name.getNumBytesAsUTF8();
+    }
+    
+    return nodes.getMemoryUsage() + attributes.getMemoryUsage() + name_bytes * 2;
+}
+
+//======================================================================================================================
+SyntaxTree::NameId SyntaxTree::intern(const juce::String &name)
+{
+    const auto [it, inserted] = nameLookup.try_emplace(name, static_cast<NameId>(names.size()));
+    
+    if (inserted)
+    {
+        names.emplace_back(name);
+    }
+    
+    return it->second;
+}
+
+void SyntaxTree::reset()
+{
+    nodes.clear();
+    attributes.clear();
+    names.clear();
+    nameLookup.clear();
+    
+    // Name 0 is reserved for nodes without a name
+    (void) intern({});
+    
+    const NodeId root_id = nodes.allocate();
+    Node         &root    = nodes[root_id];
+    
+    root.parent          = Invalid_Id;
+    root.firstChild      = Invalid_Id;
+    root.lastChild       = Invalid_Id;
+    root.previousSibling = Invalid_Id;
+    root.nextSibling     = Invalid_Id;
+    root.childTree       = Invalid_Id;
+    root.treeParent      = Invalid_Id;
+    root.treeLeft        = Invalid_Id;
+    root.treeRight       = Invalid_Id;
+    root.type            = NodeType::Document;
+}
+
+//======================================================================================================================
+int SyntaxTree::getStartInParent(NodeId id) const noexcept
+{
+    int start = getExtent(nodes[id].treeLeft) + nodes[id].offset;
+    
+    for (NodeId parent = nodes[id].treeParent; parent != Invalid_Id; id = parent, parent = nodes[id].treeParent)
+    {
+        const Node &node = nodes[parent];
+        
+        if (node.treeRight == id)
+        {
+            start += getExtent(node.treeLeft) + node.offset + node.length;
+        }
+    }
+    
+    return start;
+}
+
+SyntaxTree::NodeId SyntaxTree::seekChild(NodeId parent, int parentStart, int offset, int &previousEnd) const noexcept
+{
+    NodeId found = Invalid_Id;
+    int    base  = parentStart;
+    
+    for (NodeId id = nodes[parent].childTree; id != Invalid_Id;)
+    {
+        const Node &node      = nodes[id];
+        const int  node_base = base + getExtent(node.treeLeft);
+        const int  end       = node_base + node.offset + node.length;
+        
+        if (end > offset)
+        {
+            found       = id;
+            previousEnd = node_base;
+            id          = node.treeLeft;
+        }
+        else
+        {
+            base = end;
+            id   = node.treeRight;
+        }
+    }
+    
+    return found;
+}
+
+//======================================================================================================================
+SyntaxTree::NodeId SyntaxTree::buildChildTree(NodeId firstChild)
+{
+    // Siblings arrive in order, so the tree only ever grows along its right spine; a node that is pushed off
+    // the spine has its final children and can be summed up right away
+    treeSpine.clear();
+    
+    for (NodeId id = firstChild; id != Invalid_Id; id = nodes[id].nextSibling)
+    {
+        const std::uint32_t priority = ::getTreePriority(id);
+        NodeId              left     = Invalid_Id;
+        
+        while (!treeSpine.empty() && ::getTreePriority(treeSpine.back()) < priority)
+        {
+            left = treeSpine.back();
+            treeSpine.pop_back();
+            updateExtent(left);
+        }
+        
+        Node &node = nodes[id];
+        node.treeLeft   = left;
+        node.treeRight  = Invalid_Id;
+        node.treeParent = treeSpine.empty() ? Invalid_Id : treeSpine.back();
+        
+        if (left != Invalid_Id)
+        {
+            nodes[left].treeParent = id;
+        }
+        
+        if (node.treeParent != Invalid_Id)
+        {
+            nodes[node.treeParent].treeRight = id;
+        }
+        
+        treeSpine.emplace_back(id);
+    }
+    
+    const NodeId root = treeSpine.empty() ? Invalid_Id : treeSpine.front();
+    
+    for (auto it = treeSpine.rbegin(); it != treeSpine.rend(); ++it)
+    {
+        updateExtent(*it);
+    }
+    
+    return root;
+}
+
+SyntaxTree::NodeId SyntaxTree::mergeChildTrees(NodeId left, NodeId right) noexcept
+{
+    if (left == Invalid_Id || right == Invalid_Id)
+    {
+        return left != Invalid_Id ? left : right;
+    }
+    
+    if (::getTreePriority(left) > ::getTreePriority(right))
+    {
+        const NodeId child = mergeChildTrees(nodes[left].treeRight, right);
+        nodes[left].treeRight   = child;
+        nodes[child].treeParent = left;
+        updateExtent(left);
+        return left;
+    }
+    
+    const NodeId child = mergeChildTrees(left, nodes[right].treeLeft);
+    nodes[right].treeLeft   = child;
+    nodes[child].treeParent = right;
+    updateExtent(right);
+    return right;
+}
+
+std::pair<SyntaxTree::NodeId, SyntaxTree::NodeId> SyntaxTree::splitChildTree(NodeId root, int base,
+                                                                             int offset) noexcept
+{
+    if (root == Invalid_Id)
+    {
+        return { Invalid_Id, Invalid_Id };
+    }
+    
+    Node      &node  = nodes[root];
+    const int start = base + getExtent(node.treeLeft) + node.offset;
+    
+    node.treeParent = Invalid_Id;
+    
+    if (start < offset)
+    {
+        const auto [left, right] = splitChildTree(node.treeRight, start + node.length, offset);
+        node.treeRight = left;
+        
+        if (left != Invalid_Id)
+        {
+            nodes[left].treeParent = root;
+        }
+        
+        updateExtent(root);
+        return { root, right };
+    }
+    
+    const auto [left, right] = splitChildTree(node.treeLeft, base, offset);
+    node.treeLeft = right;
+    
+    if (right != Invalid_Id)
+    {
+        nodes[right].treeParent = root;
+    }
+    
+    updateExtent(root);
+    return { left, root };
+}
+
+void SyntaxTree::addToExtents(NodeId id, int delta) noexcept
+{
+    for (; id != Invalid_Id; id = nodes[id].treeParent)
+    {
+        nodes[id].extent += delta;
+    }
+}
+
+void SyntaxTree::updateExtent(NodeId id) noexcept
+{
+    Node &node = nodes[id];
+    node.extent = getExtent(node.treeLeft) + node.offset + node.length + getExtent(node.treeRight);
+}
+//======================================================================================================================
+// endregion SyntaxTree
+//**********************************************************************************************************************
+//======================================================================================================================
+//======================================================================================================================
+// endregion SyntaxTree
+//**********************************************************************************************************************
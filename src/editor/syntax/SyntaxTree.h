@@ -1,15 +1,349 @@
-//
-// Created by elanda on 15.01.22.
-//
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
 
-#ifndef JAMAL_SYNTAXTREE_H
-#define JAMAL_SYNTAXTREE_H
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
 
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
 
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   SyntaxTree.h
+    @date   15, January 2022
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "BumpArena.h"
+
+#include <juce_core/juce_core.h>
+
+/**
+    A compact structural tree of an xml document.
+    
+    Nodes and attributes live in bump arenas and refer to each other by index, names are interned once per tree.
+    A node's start is stored as its distance from the end of its previous sibling and everything else relative to
+    the node itself, so an edit changes no node after the edited one. Every node additionally keeps its children in
+    a balanced tree that sums up their extents, which resolves absolute offsets and finds the child at an offset in
+    logarithmic time, and lets a reparse replace a run of children without walking their siblings.
+    
+    Offsets are in characters, the same as juce::CodeDocument positions.
+ */
 class SyntaxTree
 {
+public:
+    using NodeId = std::uint32_t;
+    using NameId = std::uint32_t;
     
-};
-
+    //==================================================================================================================
+    static constexpr NodeId Invalid_Id = std::numeric_limits<std::uint32_t>::max();
+    
+    //==================================================================================================================
+    enum class NodeType : std::uint8_t
+    {
+        Document,
+        Element,
+        Comment,
+        CData,
+        ProcessingInstruction,
+        Declaration,
+        Text
+    };
+    
+    struct NodeFlags
+    {
+        enum : std::uint8_t
+        {
+            SelfClosing = 1, // The element was written as <name/>
+            Unclosed    = 2, // There was no end tag for this element, it ends where its parent was closed
+            Dirty       = 4, // The node or something inside it is malformed, so it can't be reused on a reparse
+            Malformed   = 8  // The element's own start or end tag is malformed
+        };
+    };
+    
+    struct Node
+    {
+        int           offset;         // From the previous sibling's end, or the parent's start for the first child
+        int           length;
+        int           startTagLength; // Length of the start tag, or the full length for non-element nodes
+        int           endTagStart;    // Relative to this node's start, equal to length if there is no end tag
+        int           extent;         // Sum of offsets and lengths of this node's subtree in the parent's child tree
+        NodeId        parent;
+        NodeId        firstChild;
+        NodeId        lastChild;
+        NodeId        previousSibling;
+        NodeId        nextSibling;
+        NodeId        childTree;      // Root of the balanced tree over this node's children
+        NodeId        treeParent;     // Links within the parent's child tree
+        NodeId        treeLeft;
+        NodeId        treeRight;
+        std::uint32_t firstAttribute;
+        std::uint32_t numAttributes;
+        NameId        name;
+        NodeType      type;
+        std::uint8_t  flags;
+    };
+    
+    struct Attribute
+    {
+        NameId name;
+        int    start;       // Relative to the owning element's start
+        int    nameLength;
+        int    valueStart;  // Relative to the owning element's start, without the quotes; -1 if there is no value
+        int    valueLength;
+    };
+    
+    //==================================================================================================================
+    /**
+        Fills a tree from the events of a parser, in document order and with absolute offsets.
+        Creating a builder discards everything the tree contained before.
+     */
+    class Builder
+    {
+    public:
+        explicit Builder(SyntaxTree &tree);
+        
+        //==============================================================================================================
+        void openElement(const juce::String &name, int start);
+        void addAttribute(const juce::String &name, juce::Range<int> nameRange, juce::Range<int> valueRange);
+        void finishStartTag(int end, bool selfClosing);
+        void closeElement(int endTagStart, int end);
+        void addLeaf(NodeType type, juce::Range<int> range, bool terminated = true);
+        
+        /** Marks the innermost open element as containing malformed markup. */
+        void markDirty() noexcept;
+        
+        /** Marks the tags of the innermost open element as malformed, which also makes it dirty. */
+        void markTagMalformed() noexcept;
+        
+        /** Closes the innermost open element without an end tag and marks it as unclosed. */
+        void closeUnterminatedElement(int end);
+        
+        //==============================================================================================================
+        /** Closes all elements that are still open, marking them as unclosed, and sets the document length. */
+        void finish(int documentLength);
+        
+        //==============================================================================================================
+        /** Gets the number of elements that are open at the moment. */
+        int getDepth() const noexcept { return static_cast<int>(openStarts.size()) - 1; }
+        
+    private:
+        friend class XmlParser;
+        
+        //==============================================================================================================
+        enum class Mode
+        {
+            Rebuild,
+            Reuse
+        };
+        
+        //==============================================================================================================
+        SyntaxTree             &tree;
+        std::vector<int>       openStarts;
+        std::vector<int>       previousEnds; // Where the last child of every open element ended
+        std::vector<Attribute> pendingAttributes;
+        NodeId                 current;
+        bool                   rebuilding;
+        
+        //==============================================================================================================
+        Builder(SyntaxTree &tree, Mode mode);
+        
+        /** Appends children to an element of a finished tree, starting after the given previous end. */
+        Builder(SyntaxTree &tree, NodeId parent, int parentStart, int previousEnd);
+        
+        //==============================================================================================================
+        NodeId appendChild(NodeType type, int start);
+        void   adoptNode(NodeId id, int start);
+        void   closeCurrent(int endTagStart, int end, bool unclosed);
+    };
+    
+    //==================================================================================================================
+    SyntaxTree();
+    
+    SyntaxTree(SyntaxTree&&) noexcept            = default;
+    SyntaxTree& operator=(SyntaxTree&&) noexcept = default;
+    
+    //==================================================================================================================
+    NodeId getRoot() const noexcept { return 0; }
+    bool   isEmpty() const noexcept { return nodes[0].firstChild == Invalid_Id; }
+    
+    const Node& getNode(NodeId id) const noexcept { return nodes[id]; }
+    
+    //==================================================================================================================
+    /** Gets the absolute start of a node, this walks up to the root through the child trees. */
+    int getStart(NodeId id) const noexcept;
+    
+    juce::Range<int> getRange        (NodeId id) const noexcept;
+    juce::Range<int> getStartTagRange(NodeId id) const noexcept;
+    juce::Range<int> getEndTagRange  (NodeId id) const noexcept;
+    
+    //==================================================================================================================
+    const juce::String& getName(NodeId id) const noexcept { return names[nodes[id].name]; }
+    
+    const juce::String& getNameForId(NameId id) const noexcept { return names[id]; }
+    NameId              findName(const juce::String &name) const noexcept;
+    
+    /** Gets all distinct element and attribute names in this tree, indexed by NameId. */
+    const std::vector<juce::String>& getNames() const noexcept { return names; }
+    
+    //==================================================================================================================
+    const Attribute& getAttribute(NodeId id, int index) const noexcept;
+    juce::Range<int> getAttributeValueRange(NodeId id, int index) const noexcept;
+    
+    //==================================================================================================================
+    /** Finds the innermost element that contains the offset, or the root if there is none. */
+    NodeId findElementAt(int offset) const noexcept;
+    
+    /** Gets all elements containing the offset, from the outermost to the innermost. */
+    std::vector<NodeId> getAncestry(int offset) const;
+    
+    /**
+        If the offset is inside an element's start or end tag, gets the range of its counterpart.
+        This returns an empty range if the offset is not inside a tag or the element has no counterpart.
+     */
+    juce::Range<int> findMatchingTag(int offset) const noexcept;
+    
+    /**
+        Walks all elements in document order.
+        The callback is called with the node id, its absolute range and its depth.
+        If the callback returns false, the element's children are skipped.
+     */
+    template<class Fn>
+    void forEachElement(Fn &&callback) const
+    {
+        struct Frame { NodeId child; int previousEnd; int depth; };
+        std::vector<Frame> stack { { nodes[0].firstChild, 0, 0 } };
+        
+        while (!stack.empty())
+        {
+            Frame &frame = stack.back();
+            
+            if (frame.child == Invalid_Id)
+            {
+                stack.pop_back();
+                continue;
+            }
+            
+            const NodeId id    = frame.child;
+            const Node   &node = nodes[id];
+            const int    start = frame.previousEnd + node.offset;
+            const int    depth = frame.depth;
+            
+            frame.child       = node.nextSibling;
+            frame.previousEnd = start + node.length;
+            
+            if (node.type == NodeType::Element
+                && callback(id, juce::Range<int>(start, start + node.length), depth)
+                && node.firstChild != Invalid_Id)
+            {
+                stack.push_back({ node.firstChild, start, depth + 1 });
+            }
+        }
+    }
+    
+    /**
+        Walks the elements that overlap a range in document order, like forEachElement().
+        The elements before the range are skipped by seeking through the child trees and the walk ends at the first
+        node that starts after it, so only the elements around the range are visited.
+     */
+    template<class Fn>
+    void forEachElementIn(juce::Range<int> range, Fn &&callback) const
+    {
+        struct Frame { NodeId child; int previousEnd; int depth; };
+        
+        int                previous_end = 0;
+        const NodeId       first_child  = seekChild(0, 0, range.getStart(), previous_end);
+        std::vector<Frame> stack { { first_child, previous_end, 0 } };
+        
+        while (!stack.empty())
+        {
+            Frame &frame = stack.back();
+            
+            if (frame.child == Invalid_Id)
+            {
+                stack.pop_back();
+                continue;
+            }
+            
+            const NodeId id    = frame.child;
+            const Node   &node = nodes[id];
+            const int    start = frame.previousEnd + node.offset;
+            const int    depth = frame.depth;
+            
+            // Everything after this node in document order starts even later
+            if (start >= range.getEnd())
+            {
+                return;
+            }
+            
+            frame.child       = node.nextSibling;
+            frame.previousEnd = start + node.length;
+            
+            if (node.type == NodeType::Element
+                && callback(id, juce::Range<int>(start, start + node.length), depth)
+                && node.firstChild != Invalid_Id)
+            {
+                // Only an element that contains the start of the range has children before it
+                int          child_end = start;
+                const NodeId child     = start < range.getStart() ? seekChild(id, start, range.getStart(), child_end)
+                                                                   : node.firstChild;
+                stack.push_back({ child, child_end, depth + 1 });
+            }
+        }
+    }
+    
+    //==================================================================================================================
+    /** Gets the number of bytes this tree has reserved. */
+    std::size_t getMemoryUsage() const noexcept;
 
-#endif //JAMAL_SYNTAXTREE_H
+private:
+    friend class XmlParser;
+    
+    //==================================================================================================================
+    BumpArena<Node>                          nodes;
+    BumpArena<Attribute>                     attributes;
+    std::vector<juce::String>                names;
+    std::unordered_map<juce::String, NameId> nameLookup;
+    std::vector<NodeId>                      treeSpine;
+    std::uint32_t                            nodesAfterRebuild { 0 };
+    
+    //==================================================================================================================
+    NameId intern(const juce::String &name);
+    void   reset();
+    
+    //==================================================================================================================
+    int getExtent(NodeId id) const noexcept { return id != Invalid_Id ? nodes[id].extent : 0; }
+    
+    /** Gets the start of a node relative to its parent's start. */
+    int getStartInParent(NodeId id) const noexcept;
+    
+    /** Finds the first child that ends after an offset and gets where its previous sibling ended. */
+    NodeId seekChild(NodeId parent, int parentStart, int offset, int &previousEnd) const noexcept;
+    
+    //==================================================================================================================
+    /** Builds the child tree of a list of siblings in one pass and returns its root. */
+    NodeId buildChildTree(NodeId firstChild);
+    
+    /** Joins two child trees, all nodes in the left one must come before those in the right one. */
+    NodeId mergeChildTrees(NodeId left, NodeId right) noexcept;
+    
+    /** Splits a child tree into the nodes starting before an offset and the rest, base is where it starts. */
+    std::pair<NodeId, NodeId> splitChildTree(NodeId root, int base, int offset) noexcept;
+    
+    /** Adds to the extent of a node and all its ancestors in the child tree, after its offset or length changed. */
+    void addToExtents(NodeId id, int delta) noexcept;
+    void updateExtent(NodeId id) noexcept;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SyntaxTree)
+};
@@ -0,0 +1,928 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   XmlParser.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "XmlParser.h"
+
+#include <optional>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    // Once this many garbage nodes piled up in the arena, an incremental reparse turns into a full one
+    constexpr std::uint32_t Compaction_Slack = 16384;
+    
+    //==================================================================================================================
+    bool isWhitespace(juce::juce_wchar c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+    
+    bool isNameChar(juce::juce_wchar c) noexcept
+    {
+        return c > ' ' && c != '<' && c != '>' && c != '/' && c != '=' && c != '"' && c != '\'';
+    }
+    
+    //==================================================================================================================
+    class Reader
+    {
+    public:
+        explicit Reader(const ITextSource &parSource)
+            : Reader(parSource, parSource.getLength())
+        {}
+        
+        /** Creates a reader that sees the text as if it ended at the given length. */
+        Reader(const ITextSource &parSource, int parLength)
+            : source(parSource), length(parLength)
+        {}
+        
+        //==============================================================================================================
+        juce::juce_wchar peek(int ahead = 0)
+        {
+            const int pos = position + ahead;
+            
+            if (pos >= length)
+            {
+                return 0;
+            }
+            
+            if (pos < bufferStart || pos >= bufferEnd)
+            {
+                bufferStart = pos;
+                bufferEnd   = pos + source.read(pos, buffer.data(), static_cast<int>(buffer.size()));
+            }
+            
+            return buffer[static_cast<std::size_t>(pos - bufferStart)];
+        }
+        
+        bool startsWith(const char *text)
+        {
+            for (int i = 0; text[i] != 0; ++i)
+            {
+                if (peek(i) != static_cast<juce::juce_wchar>(text[i]))
+                {
+                    return false;
+                }
+            }
+            
+            return true;
+        }
+        
+        //==============================================================================================================
+        void advance(int amount = 1) noexcept { position = juce::jmin(length, position + amount); }
+        void seek(int newPosition)   noexcept { position = juce::jlimit(0, length, newPosition); }
+        
+        void skipUntil(juce::juce_wchar c)
+        {
+            while (position < length && peek() != c)
+            {
+                ++position;
+            }
+        }
+        
+        void skipWhitespace()
+        {
+            while (position < length && ::isWhitespace(peek()))
+            {
+                ++position;
+            }
+        }
+        
+        //==============================================================================================================
+        int  getPosition() const noexcept { return position; }
+        int  getLength()   const noexcept { return length; }
+        bool isAtEnd()     const noexcept { return position >= length; }
+        bool isBounded()   const          { return length < source.getLength(); }
+    
+    private:
+        const ITextSource                   &source;
+        std::array<juce::juce_wchar, 4096>  buffer {};
+        int                                 bufferStart { 0 };
+        int                                 bufferEnd   { 0 };
+        int                                 position    { 0 };
+        int                                 length;
+    };
+    
+    struct Edit
+    {
+        int start;
+        int oldEnd;
+        int newEnd;
+        
+        //==============================================================================================================
+        /** Maps an offset in the new text to the old one, or -1 if it is inside the inserted text. */
+        int toOldOffset(int offset) const noexcept
+        {
+            if (offset < start)
+            {
+                return offset;
+            }
+            
+            return offset >= newEnd ? offset - (newEnd - oldEnd) : -1;
+        }
+    };
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Context
+//======================================================================================================================
+class XmlParser::Context
+{
+public:
+    /**
+        A run of children of one element that is parsed again after an edit, in the old text.
+        The element's tags and everything outside of it stay as they are.
+     */
+    struct Region
+    {
+        SyntaxTree::NodeId parent;
+        int                parentStart;
+        SyntaxTree::NodeId before; // The last child in front of the region that is kept
+        SyntaxTree::NodeId after;  // The first child behind the region that is kept
+        int                start;
+        int                end;
+    };
+    
+    //==================================================================================================================
+    /**
+        Finds the smallest region around an edit.
+        
+        This is the run of children touching the edit inside the deepest element whose content contains the whole
+        edit, or the top level of the document if there is no such element.
+     */
+    static Region findRegion(const SyntaxTree &tree, const Edit &edit) noexcept
+    {
+        Region region { 0, 0, SyntaxTree::Invalid_Id, SyntaxTree::Invalid_Id, 0, tree.nodes[0].length };
+        
+        for (;;)
+        {
+            int                      previous_end = 0;
+            const SyntaxTree::NodeId child = tree.seekChild(region.parent, region.parentStart, edit.start,
+                                                            previous_end);
+            
+            if (child == SyntaxTree::Invalid_Id)
+            {
+                break;
+            }
+            
+            // Unclosed elements end wherever an ancestor does, so their content can't be parsed on its own
+            const SyntaxTree::Node &node  = tree.nodes[child];
+            const int              start = previous_end + node.offset;
+            
+            if (node.type != SyntaxTree::NodeType::Element
+                || (node.flags & (SyntaxTree::NodeFlags::SelfClosing | SyntaxTree::NodeFlags::Unclosed)) != 0
+                || start + node.startTagLength > edit.start || start + node.endTagStart < edit.oldEnd)
+            {
+                break;
+            }
+            
+            region.parent      = child;
+            region.parentStart = start;
+            region.start       = start + node.startTagLength;
+            region.end         = start + node.endTagStart;
+        }
+        
+        // Like with reusing nodes, a child that ends right where the edit starts is read again
+        int                      previous_end = 0;
+        const SyntaxTree::NodeId first = tree.seekChild(region.parent, region.parentStart, edit.start - 1,
+                                                        previous_end);
+        
+        region.before = (first != SyntaxTree::Invalid_Id ? tree.nodes[first].previousSibling
+                                                          : tree.nodes[region.parent].lastChild);
+        
+        if (region.before != SyntaxTree::Invalid_Id)
+        {
+            region.start = first != SyntaxTree::Invalid_Id
+                               ? previous_end
+                               : region.parentStart + tree.getStartInParent(region.before)
+                                     + tree.nodes[region.before].length;
+        }
+        
+        const SyntaxTree::NodeId last = tree.seekChild(region.parent, region.parentStart, edit.oldEnd, previous_end);
+        
+        if (last != SyntaxTree::Invalid_Id)
+        {
+            const SyntaxTree::Node &node  = tree.nodes[last];
+            const int              start = previous_end + node.offset;
+            
+            if (start >= edit.oldEnd)
+            {
+                region.after = last;
+                region.end   = start;
+            }
+            else if (node.nextSibling != SyntaxTree::Invalid_Id)
+            {
+                region.after = node.nextSibling;
+                region.end   = start + node.length + tree.nodes[region.after].offset;
+            }
+        }
+        
+        return region;
+    }
+    
+    //==================================================================================================================
+    Context(SyntaxTree &parTree, const ITextSource &text, std::optional<Edit> parEdit)
+        : tree(parTree),
+          source(text),
+          reader(text),
+          edit(parEdit),
+          cursor(parEdit ? std::vector<Frame>{ { parTree.nodes[0].firstChild, 0 } } : std::vector<Frame>{}),
+          builder(parTree, parEdit ? SyntaxTree::Builder::Mode::Reuse : SyntaxTree::Builder::Mode::Rebuild)
+    {}
+    
+    Context(SyntaxTree &parTree, const ITextSource &text, const Edit &parEdit, const Region &parRegion)
+        : tree(parTree),
+          source(text),
+          reader(text, parRegion.end + parEdit.newEnd - parEdit.oldEnd),
+          edit(parEdit),
+          region(parRegion),
+          builder(parTree, parRegion.parent, parRegion.parentStart,
+                  parRegion.before != SyntaxTree::Invalid_Id ? parRegion.start : parRegion.parentStart)
+    {
+        reader.seek(parRegion.start);
+    }
+    
+    //==================================================================================================================
+    void run()
+    {
+        parseContent();
+        builder.finish(reader.getLength());
+    }
+    
+    /**
+        Parses the region again and puts the result in place of its old children.
+        
+        If what was parsed doesn't fit between the kept children because it opens or closes elements beyond the
+        region, this leaves the tree alone and returns false. The tree is only left unusable if old nodes were
+        already adopted, in which case hasAdoptedNodes() is true.
+     */
+    bool runRegion()
+    {
+        SyntaxTree::Node         &parent   = tree.nodes[region->parent];
+        const int                first_end = builder.previousEnds.back();
+        const SyntaxTree::NodeId first     = (region->before != SyntaxTree::Invalid_Id
+                                                  ? tree.nodes[region->before].nextSibling : parent.firstChild);
+        const SyntaxTree::NodeId last      = parent.lastChild;
+        
+        // The child tree is split while the old offsets can still be trusted, adopted nodes get new ones
+        const auto [front, rest] = tree.splitChildTree(parent.childTree, region->parentStart, region->start);
+        const auto [old, back]   = tree.splitChildTree(rest, first_end, region->end);
+        
+        detachRegion(SyntaxTree::Invalid_Id);
+        
+        // Whether the element is still dirty is worked out again once it's known what the region contains now
+        const bool was_dirty = (parent.flags & SyntaxTree::NodeFlags::Dirty) != 0;
+        parent.flags &= static_cast<std::uint8_t>(~SyntaxTree::NodeFlags::Dirty);
+        
+        if (first != SyntaxTree::Invalid_Id && first != region->after)
+        {
+            cursor.push_back({ first, first_end });
+        }
+        
+        parseContent();
+        
+        if (aborted || !canCloseOpenElements())
+        {
+            if (!adopted)
+            {
+                tree.nodes[region->parent].flags |= (was_dirty ? SyntaxTree::NodeFlags::Dirty : 0);
+                detachRegion(first);
+                tree.nodes[region->parent].lastChild = last;
+                setChildTree(tree.mergeChildTrees(tree.mergeChildTrees(front, old), back));
+            }
+            
+            return false;
+        }
+        
+        while (builder.current != region->parent)
+        {
+            builder.closeUnterminatedElement(reader.getLength());
+        }
+        
+        const SyntaxTree::NodeId tail     = tree.nodes[region->parent].lastChild;
+        const SyntaxTree::NodeId inserted = tree.buildChildTree(region->before != SyntaxTree::Invalid_Id
+                                                                    ? tree.nodes[region->before].nextSibling
+                                                                    : tree.nodes[region->parent].firstChild);
+        
+        if (region->after != SyntaxTree::Invalid_Id)
+        {
+            SyntaxTree::Node &next  = tree.nodes[region->after];
+            const int        shift = reader.getLength() - builder.previousEnds.back() - next.offset;
+            
+            next.offset          += shift;
+            next.previousSibling  = tail;
+            tree.addToExtents(region->after, shift);
+            
+            if (tail != SyntaxTree::Invalid_Id)
+            {
+                tree.nodes[tail].nextSibling = region->after;
+            }
+            else
+            {
+                tree.nodes[region->parent].firstChild = region->after;
+            }
+            
+            tree.nodes[region->parent].lastChild = last;
+        }
+        
+        setChildTree(tree.mergeChildTrees(tree.mergeChildTrees(front, inserted), back));
+        
+        const int delta = edit->newEnd - edit->oldEnd;
+        
+        for (SyntaxTree::NodeId id = region->parent;; id = tree.nodes[id].parent)
+        {
+            SyntaxTree::Node &node = tree.nodes[id];
+            node.length      += delta;
+            node.endTagStart += delta;
+            
+            if (id == 0)
+            {
+                break;
+            }
+            
+            tree.addToExtents(id, delta);
+        }
+        
+        updateDirtyFlags(was_dirty);
+        return true;
+    }
+    
+    //==================================================================================================================
+    bool hasAdoptedNodes() const noexcept { return adopted; }
+
+private:
+    struct Frame
+    {
+        SyntaxTree::NodeId node;
+        int                previousEnd;
+    };
+    
+    //==================================================================================================================
+    SyntaxTree                          &tree;
+    const ITextSource                   &source;
+    Reader                              reader;
+    std::optional<Edit>                 edit;
+    std::optional<Region>               region;
+    std::vector<Frame>                  cursor;
+    SyntaxTree::Builder                 builder;
+    std::basic_string<juce::juce_wchar> nameBuffer;
+    bool                                adopted { false };
+    bool                                aborted { false };
+    
+    //==================================================================================================================
+    void parseContent()
+    {
+        while (!reader.isAtEnd() && !aborted)
+        {
+            const int position = reader.getPosition();
+            
+            if (const SyntaxTree::NodeId reusable = takeReusable(position); reusable != SyntaxTree::Invalid_Id)
+            {
+                builder.adoptNode(reusable, position);
+                reader.seek(position + tree.nodes[reusable].length);
+                adopted = true;
+                continue;
+            }
+            
+            if (reader.peek() == '<')
+            {
+                parseMarkup();
+            }
+            else
+            {
+                reader.skipUntil('<');
+            }
+        }
+    }
+    
+    // Elements still open at the end of the region are closed by the end tag of its parent, unless they have the
+    // same name and take that end tag for themselves; if there are kept children after them, they would swallow those
+    bool canCloseOpenElements() const noexcept
+    {
+        if (builder.current == region->parent)
+        {
+            return true;
+        }
+        
+        if (region->after != SyntaxTree::Invalid_Id)
+        {
+            return false;
+        }
+        
+        const SyntaxTree::NameId name = tree.nodes[region->parent].name;
+        
+        for (SyntaxTree::NodeId id = builder.current; id != region->parent; id = tree.nodes[id].parent)
+        {
+            if (region->parent != 0 && tree.nodes[id].name == name)
+            {
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    // Lets the kept children in front of the region be followed by the given node, or end there
+    void detachRegion(SyntaxTree::NodeId next) noexcept
+    {
+        SyntaxTree::Node &parent = tree.nodes[region->parent];
+        
+        if (region->before != SyntaxTree::Invalid_Id)
+        {
+            tree.nodes[region->before].nextSibling = next;
+        }
+        else
+        {
+            parent.firstChild = next;
+        }
+        
+        parent.lastChild = region->before;
+    }
+    
+    //==================================================================================================================
+    // Errors in the region were flagged while parsing it; the rest of the element only has to be looked at if it was
+    // dirty before, and its ancestors only if that changed its flag
+    void updateDirtyFlags(bool wasDirty)
+    {
+        SyntaxTree::NodeId id    = region->parent;
+        bool               dirty = (tree.nodes[id].flags & SyntaxTree::NodeFlags::Dirty) != 0
+                                   || (wasDirty && containsErrors(id));
+        bool               was   = wasDirty;
+        
+        for (;;)
+        {
+            SyntaxTree::Node &node = tree.nodes[id];
+            node.flags = static_cast<std::uint8_t>(dirty ? node.flags |  SyntaxTree::NodeFlags::Dirty
+                                                         : node.flags & ~SyntaxTree::NodeFlags::Dirty);
+            
+            if (dirty == was || id == 0)
+            {
+                return;
+            }
+            
+            id    = node.parent;
+            was   = (tree.nodes[id].flags & SyntaxTree::NodeFlags::Dirty) != 0;
+            dirty = dirty || containsErrors(id);
+        }
+    }
+    
+    // This walks all children of the node, but only runs when an element might have become clean
+    bool containsErrors(SyntaxTree::NodeId id) const
+    {
+        const SyntaxTree::Node &node = tree.nodes[id];
+        
+        if ((node.flags & (SyntaxTree::NodeFlags::Malformed | SyntaxTree::NodeFlags::Unclosed)) != 0)
+        {
+            return true;
+        }
+        
+        for (SyntaxTree::NodeId child = node.firstChild; child != SyntaxTree::Invalid_Id;
+             child = tree.nodes[child].nextSibling)
+        {
+            if ((tree.nodes[child].flags & SyntaxTree::NodeFlags::Dirty) != 0)
+            {
+                return true;
+            }
+        }
+        
+        // Markup between the children that didn't become a node of its own is a lone '<' or a stray end tag
+        Reader    text(source);
+        const int start         = tree.getStart(id);
+        const int content_start = start + node.startTagLength;
+        int       previous_end  = start;
+        
+        for (SyntaxTree::NodeId child = node.firstChild; child != SyntaxTree::Invalid_Id;
+             child = tree.nodes[child].nextSibling)
+        {
+            const int child_start = previous_end + tree.nodes[child].offset;
+            
+            if (containsMarkup(text, juce::jmax(content_start, previous_end), child_start))
+            {
+                return true;
+            }
+            
+            previous_end = child_start + tree.nodes[child].length;
+        }
+        
+        return containsMarkup(text, juce::jmax(content_start, previous_end), start + node.endTagStart);
+    }
+    
+    static bool containsMarkup(Reader &text, int start, int end)
+    {
+        for (text.seek(start); text.getPosition() < end; text.advance())
+        {
+            if (text.peek() == '<')
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    void setChildTree(SyntaxTree::NodeId root) noexcept
+    {
+        tree.nodes[region->parent].childTree = root;
+        
+        if (root != SyntaxTree::Invalid_Id)
+        {
+            tree.nodes[root].treeParent = SyntaxTree::Invalid_Id;
+        }
+    }
+    
+    //==================================================================================================================
+    // An unterminated comment or declaration at the end of the region would go on into the kept children
+    void addUnterminatedLeaf(SyntaxTree::NodeType type, juce::Range<int> range)
+    {
+        if (region && reader.isBounded())
+        {
+            aborted = true;
+            return;
+        }
+        
+        builder.addLeaf(type, range, false);
+    }
+    
+    //==================================================================================================================
+    SyntaxTree::NodeId takeReusable(int position)
+    {
+        const int old_position = edit ? edit->toOldOffset(position) : -1;
+        
+        if (old_position < 0)
+        {
+            return SyntaxTree::Invalid_Id;
+        }
+        
+        // The cursor walks the old tree in document order, positions only ever grow so it never has to go back
+        while (!cursor.empty())
+        {
+            Frame &frame = cursor.back();
+            
+            if (frame.node == SyntaxTree::Invalid_Id)
+            {
+                cursor.pop_back();
+                continue;
+            }
+            
+            const SyntaxTree::NodeId id    = frame.node;
+            const SyntaxTree::Node   &node = tree.nodes[id];
+            const int                start = frame.previousEnd + node.offset;
+            const int                end   = start + node.length;
+            
+            if (start > old_position)
+            {
+                return SyntaxTree::Invalid_Id;
+            }
+            
+            // Read the old link now, adopting the node will relink it
+            frame.node        = node.nextSibling;
+            frame.previousEnd = end;
+            
+            if (end <= old_position)
+            {
+                continue;
+            }
+            
+            if (start == old_position && isReusable(node, start, end))
+            {
+                return id;
+            }
+            
+            if (node.firstChild != SyntaxTree::Invalid_Id)
+            {
+                cursor.push_back({ node.firstChild, start });
+            }
+        }
+        
+        return SyntaxTree::Invalid_Id;
+    }
+    
+    // A node that ends right where the edit starts is not taken, the lexer peeks one character past a node's end
+    // to find out where names and unterminated tags stop
+    bool isReusable(const SyntaxTree::Node &node, int start, int end) const noexcept
+    {
+        return node.type != SyntaxTree::NodeType::Document
+               && node.length > 0
+               && (node.flags & SyntaxTree::NodeFlags::Dirty) == 0
+               && (end < edit->start || start >= edit->oldEnd);
+    }
+    
+    //==================================================================================================================
+    void parseMarkup()
+    {
+        if (reader.startsWith("<!--"))
+        {
+            parseDelimited(SyntaxTree::NodeType::Comment, 4, "-->");
+        }
+        else if (reader.startsWith("<![CDATA["))
+        {
+            parseDelimited(SyntaxTree::NodeType::CData, 9, "]]>");
+        }
+        else if (reader.startsWith("<?"))
+        {
+            parseDelimited(SyntaxTree::NodeType::ProcessingInstruction, 2, "?>");
+        }
+        else if (reader.startsWith("<!"))
+        {
+            parseDeclaration();
+        }
+        else if (reader.startsWith("</"))
+        {
+            parseEndTag();
+        }
+        else if (::isNameChar(reader.peek(1)))
+        {
+            parseStartTag();
+        }
+        else
+        {
+            // A lone '<' in text, xml doesn't allow that but there is nothing to recover
+            builder.markDirty();
+            reader.advance();
+        }
+    }
+    
+    void parseDelimited(SyntaxTree::NodeType type, int openLength, const char *close)
+    {
+        const int start = reader.getPosition();
+        reader.advance(openLength);
+        
+        while (!reader.isAtEnd())
+        {
+            if (reader.startsWith(close))
+            {
+                reader.advance(static_cast<int>(std::strlen(close)));
+                builder.addLeaf(type, { start, reader.getPosition() });
+                return;
+            }
+            
+            reader.advance();
+        }
+        
+        addUnterminatedLeaf(type, { start, reader.getPosition() });
+    }
+    
+    void parseDeclaration()
+    {
+        const int start = reader.getPosition();
+        int       depth = 0;
+        
+        reader.advance(2);
+        
+        // Doctypes can have an internal subset in brackets, which again contains '>'
+        while (!reader.isAtEnd())
+        {
+            const juce::juce_wchar c = reader.peek();
+            reader.advance();
+            
+            if (c == '[')
+            {
+                ++depth;
+            }
+            else if (c == ']')
+            {
+                depth = juce::jmax(0, depth - 1);
+            }
+            else if (c == '>' && depth == 0)
+            {
+                builder.addLeaf(SyntaxTree::NodeType::Declaration, { start, reader.getPosition() });
+                return;
+            }
+        }
+        
+        addUnterminatedLeaf(SyntaxTree::NodeType::Declaration, { start, reader.getPosition() });
+    }
+    
+    void parseStartTag()
+    {
+        const int start = reader.getPosition();
+        reader.advance();
+        
+        builder.openElement(readName(), start);
+        
+        for (;;)
+        {
+            reader.skipWhitespace();
+            
+            const juce::juce_wchar c = reader.peek();
+            
+            if (c == '>')
+            {
+                reader.advance();
+                builder.finishStartTag(reader.getPosition(), false);
+                return;
+            }
+            
+            if (c == '/' && reader.peek(1) == '>')
+            {
+                reader.advance(2);
+                builder.finishStartTag(reader.getPosition(), true);
+                return;
+            }
+            
+            if (reader.isAtEnd() || c == '<')
+            {
+                // An unterminated start tag is closed right away, otherwise every following sibling would be
+                // swallowed as its child while the tag is being typed
+                builder.markTagMalformed();
+                builder.finishStartTag(reader.getPosition(), true);
+                return;
+            }
+            
+            if (::isNameChar(c))
+            {
+                parseAttribute();
+            }
+            else
+            {
+                builder.markTagMalformed();
+                reader.advance();
+            }
+        }
+    }
+    
+    void parseAttribute()
+    {
+        const int              name_start = reader.getPosition();
+        const juce::String     name       = readName();
+        const juce::Range<int> name_range (name_start, reader.getPosition());
+        
+        reader.skipWhitespace();
+        
+        if (reader.peek() != '=')
+        {
+            builder.markTagMalformed();
+            builder.addAttribute(name, name_range, { -1, -1 });
+            return;
+        }
+        
+        reader.advance();
+        reader.skipWhitespace();
+        
+        const juce::juce_wchar quote = reader.peek();
+        
+        if (quote != '"' && quote != '\'')
+        {
+            const int value_start = reader.getPosition();
+            
+            while (::isNameChar(reader.peek()))
+            {
+                reader.advance();
+            }
+            
+            builder.markTagMalformed();
+            builder.addAttribute(name, name_range, { value_start, reader.getPosition() });
+            return;
+        }
+        
+        reader.advance();
+        
+        const int value_start = reader.getPosition();
+        
+        while (!reader.isAtEnd() && reader.peek() != quote && reader.peek() != '<')
+        {
+            reader.advance();
+        }
+        
+        builder.addAttribute(name, name_range, { value_start, reader.getPosition() });
+        
+        if (reader.peek() == quote)
+        {
+            reader.advance();
+        }
+        else
+        {
+            builder.markTagMalformed();
+        }
+    }
+    
+    void parseEndTag()
+    {
+        const int start = reader.getPosition();
+        reader.advance(2);
+        
+        const SyntaxTree::NameId name = tree.findName(readName());
+        reader.skipWhitespace();
+        
+        const bool terminated = reader.peek() == '>';
+        
+        if (terminated)
+        {
+            reader.advance();
+        }
+        
+        SyntaxTree::NodeId match        = builder.current;
+        bool               leaves_region = false;
+        
+        while (match != 0 && tree.nodes[match].name != name)
+        {
+            leaves_region |= (region && match == region->parent);
+            match = tree.nodes[match].parent;
+        }
+        
+        if (match == 0 || name == 0)
+        {
+            // Nothing open with that name, a stray end tag
+            builder.markDirty();
+            return;
+        }
+        
+        if (region && (leaves_region || match == region->parent))
+        {
+            // This closes the element the region is in, the kept children after it would end up elsewhere
+            aborted = true;
+            return;
+        }
+        
+        while (builder.current != match)
+        {
+            builder.closeUnterminatedElement(start);
+        }
+        
+        if (!terminated)
+        {
+            builder.markTagMalformed();
+        }
+        
+        builder.closeElement(start, reader.getPosition());
+    }
+    
+    juce::String readName()
+    {
+        nameBuffer.clear();
+        
+        while (::isNameChar(reader.peek()))
+        {
+            nameBuffer.push_back(reader.peek());
+            reader.advance();
+        }
+        
+        return { juce::CharPointer_UTF32(nameBuffer.data()), nameBuffer.size() };
+    }
+};
+//======================================================================================================================
+// endregion Context
+//**********************************************************************************************************************
+// region XmlParser
+//======================================================================================================================
+void XmlParser::parse(SyntaxTree &tree, const ITextSource &text)
+{
+    Context(tree, text, std::nullopt).run();
+}
+
+void XmlParser::reparse(SyntaxTree &tree, const ITextSource &text, int offset, int removedLength, int insertedLength)
+{
+    if (tree.nodes.getEndIndex() > tree.nodesAfterRebuild * 2 + Compaction_Slack)
+    {
+        // Replaced nodes are never freed individually, so every now and then start over with a fresh arena
+        parse(tree, text);
+        return;
+    }
+    
+    const Edit edit { offset, offset + removedLength, offset + insertedLength };
+    
+    {
+        Context context(tree, text, edit, Context::findRegion(tree, edit));
+        
+        if (context.runRegion())
+        {
+            return;
+        }
+        
+        if (context.hasAdoptedNodes())
+        {
+            parse(tree, text);
+            return;
+        }
+    }
+    
+    // The edit changed which elements are open around it, the following nodes can only be taken over one by one
+    Context(tree, text, edit).run();
+}
+//======================================================================================================================
+// endregion XmlParser
+//**********************************************************************************************************************
@@ -0,0 +1,63 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   XmlParser.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "SyntaxTree.h"
+#include "../document/ITextSource.h"
+
+/**
+    An error tolerant xml parser that fills a SyntaxTree for structural editor features.
+    
+    It never gives up on malformed input: unterminated tags are closed where they stop, elements without an end tag
+    are closed by the next end tag of an ancestor and stray end tags are ignored. Nodes that contain such errors are
+    marked dirty.
+    
+    After an edit, the tree can be reparsed incrementally. Only the children touching the edit inside the deepest
+    element that contains it are read again and put in place of the old ones, everything else is kept without being
+    walked. If what was read opens or closes elements beyond that, the rest of the document is parsed again: every
+    clean node that lies completely outside the edited range parses the same in any context, so whenever the parser
+    reaches the offset such a node started at before, it adopts the old node as a whole and skips over it.
+ */
+class XmlParser
+{
+public:
+    /** Parses the whole text, replacing everything the tree contained. */
+    static void parse(SyntaxTree &tree, const ITextSource &text);
+    
+    /**
+        Updates a tree after a single edit of the text it was parsed from.
+        
+        @param tree           The tree that matched the text before the edit
+        @param text           The text after the edit
+        @param offset         The offset the edit starts at
+        @param removedLength  The number of characters that were removed at offset
+        @param insertedLength The number of characters that were inserted at offset
+     */
+    static void reparse(SyntaxTree &tree, const ITextSource &text, int offset, int removedLength, int insertedLength);
+
+private:
+    class Context;
+};
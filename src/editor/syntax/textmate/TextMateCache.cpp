@@ -38,7 +38,7 @@ TextMateCache& TextMateCache::getInstance() noexcept
 //======================================================================================================================
 void TextMateCache::addGrammar(TextMateGrammar grammar)
 {
-    if (grammarDefinitions.find(grammar.languageInfo.scopeName) != grammarDefinitions.end())
+    if (grammarDefinitions.find(grammar.languageInfo.scopeName) == grammarDefinitions.end())
     {
         grammarDefinitions.emplace(grammar.languageInfo.scopeName, std::move(grammar));
     }
@@ -47,7 +47,8 @@ void TextMateCache::addGrammar(TextMateGrammar grammar)
 //======================================================================================================================
 const TextMateGrammar* TextMateCache::fromFile(const juce::File &file)
 {
-    if (file.exists() && !file.isDirectory() && file.getFileExtension() == "tmLanguage")
+    // Grammars are read from their json form, like "xml.tmLanguage.json"
+    if (file.existsAsFile() && file.hasFileExtension("json"))
     {
         const juce::String          data   = file.loadFileAsString();
         TextMateParser::ParseResult result = TextMateParser::parse(data);
@@ -57,10 +58,8 @@ const TextMateGrammar* TextMateCache::fromFile(const juce::File &file)
             TextMateGrammar    &grammar = result.second;
             const juce::String name     = grammar.languageInfo.scopeName;
             
-            if (grammarDefinitions.find(name) != grammarDefinitions.end())
-            {
-                return &grammarDefinitions.emplace(name, std::move(grammar)).first->second;
-            }
+            // A grammar that was loaded before is kept, so pointers to it stay valid
+            return &grammarDefinitions.emplace(name, std::move(grammar)).first->second;
         }
     }
     
@@ -79,10 +78,7 @@ const TextMateGrammar* TextMateCache::fromMemory(const void *jsonData, std::size
         TextMateGrammar    &grammar = result.second;
         const juce::String name     = grammar.languageInfo.scopeName;
         
-        if (grammarDefinitions.find(name) != grammarDefinitions.end())
-        {
-            return &grammarDefinitions.emplace(name, std::move(grammar)).first->second;
-        }
+        return &grammarDefinitions.emplace(name, std::move(grammar)).first->second;
     }
     
     return nullptr;
@@ -91,6 +87,19 @@ const TextMateGrammar* TextMateCache::fromMemory(const void *jsonData, std::size
 //======================================================================================================================
 const TextMateGrammar *TextMateCache::findForExtension(const juce::String &extension) const
 {
+    const juce::String file_type = extension.trimCharactersAtStart(".");
+    
+    for (const auto &[name, grammar] : grammarDefinitions)
+    {
+        for (const auto &type : grammar.languageInfo.fileTypes)
+        {
+            if (type.equalsIgnoreCase(file_type))
+            {
+                return &grammar;
+            }
+        }
+    }
+    
     return nullptr;
 }
 
@@ -0,0 +1,198 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextMateScopeStacks.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "TextMateScopeStacks.h"
+#include "TextMateGrammar.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    using Rule = TextMateGrammar::Rule;
+    
+    //==================================================================================================================
+    const Rule* resolveInclude(const TextMateGrammar &grammar, const Rule &rule)
+    {
+        if (rule.include.startsWithChar('#'))
+        {
+            const auto it = grammar.repository.find(rule.include.substring(1));
+            return it != grammar.repository.end() ? &it->second : nullptr;
+        }
+        
+        return nullptr;
+    }
+    
+    void addCaptures(TextMateScopeStacks &stacks, TextMateScopeStacks::StackId stack,
+                     const Rule::CaptureList::CaptureArray &captures)
+    {
+        for (const auto &[index, name] : captures)
+        {
+            (void) stacks.push(stack, name);
+        }
+    }
+    
+    //==================================================================================================================
+    /** Follows the rules of a grammar and pushes the scopes they can produce. */
+    class GrammarWalker
+    {
+    public:
+        GrammarWalker(TextMateScopeStacks &parStacks, const TextMateGrammar &parGrammar)
+            : stacks(parStacks), grammar(parGrammar)
+        {}
+        
+        //==============================================================================================================
+        void addRules(const std::vector<Rule> &rules, TextMateScopeStacks::StackId stack, int depth)
+        {
+            for (const auto &rule : rules)
+            {
+                addRule(rule, stack, depth);
+            }
+        }
+    
+    private:
+        TextMateScopeStacks                                            &stacks;
+        const TextMateGrammar                                          &grammar;
+        std::set<std::pair<const Rule*, TextMateScopeStacks::StackId>> visited;
+        
+        //==============================================================================================================
+        void addRule(const Rule &rule, TextMateScopeStacks::StackId stack, int depth)
+        {
+            // Grammars are recursive, every rule only needs to be expanded once on top of the same stack
+            if (stacks.size() >= TextMateScopeStacks::Max_Grammar_Stacks || !visited.emplace(&rule, stack).second)
+            {
+                return;
+            }
+            
+            if (rule.include.isNotEmpty())
+            {
+                // Includes don't push anything themselves, they only pull other rules in at the same place
+                if (rule.include == "$self" || rule.include == "$base")
+                {
+                    addRules(grammar.patterns, stack, depth);
+                }
+                else if (const Rule *const included = ::resolveInclude(grammar, rule))
+                {
+                    addRule(*included, stack, depth);
+                }
+                
+                return;
+            }
+            
+            const TextMateScopeStacks::StackId rule_stack = stacks.push(stack, rule.name);
+            
+            ::addCaptures(stacks, rule_stack, rule.captures.captures);
+            ::addCaptures(stacks, rule_stack, rule.captures.begin);
+            ::addCaptures(stacks, rule_stack, rule.captures.end);
+            
+            if (depth < TextMateScopeStacks::Max_Grammar_Depth)
+            {
+                addRules(rule.patterns, stacks.push(rule_stack, rule.contentName), depth + 1);
+            }
+        }
+    };
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region TextMateScopeStacks
+//======================================================================================================================
+TextMateScopeStacks::TextMateScopeStacks()
+{
+    entries.push_back({ Root_Stack, 0, 0 });
+    scopeNames.emplace_back();
+}
+
+//======================================================================================================================
+TextMateScopeStacks::StackId TextMateScopeStacks::push(StackId parent, const juce::String &scopes)
+{
+    StackId stack = parent;
+    int     start = 0;
+    
+    while (start < scopes.length())
+    {
+        const int space = scopes.indexOfChar(start, ' ');
+        const int end   = (space < 0 ? scopes.length() : space);
+        
+        if (end > start)
+        {
+            stack = pushScope(stack, scopes.substring(start, end));
+        }
+        
+        start = end + 1;
+    }
+    
+    return stack;
+}
+
+void TextMateScopeStacks::addGrammar(const TextMateGrammar &grammar)
+{
+    ::GrammarWalker(*this, grammar).addRules(grammar.patterns, push(Root_Stack, grammar.languageInfo.scopeName), 0);
+}
+
+//======================================================================================================================
+std::vector<const juce::String*> TextMateScopeStacks::getScopeNames(StackId stack) const
+{
+    std::vector<const juce::String*> names(static_cast<std::size_t>(entries[stack].depth));
+    
+    for (auto it = names.rbegin(); it != names.rend(); ++it, stack = entries[stack].parent)
+    {
+        *it = &scopeNames[entries[stack].scope];
+    }
+    
+    return names;
+}
+
+//======================================================================================================================
+TextMateScopeStacks::StackId TextMateScopeStacks::pushScope(StackId parent, const juce::String &scope)
+{
+    ScopeId scope_id;
+    
+    if (const auto it = scopeLookup.find(scope); it != scopeLookup.end())
+    {
+        scope_id = it->second;
+    }
+    else
+    {
+        scope_id = static_cast<ScopeId>(scopeNames.size());
+        scopeNames.emplace_back(scope);
+        scopeLookup.emplace(scope, scope_id);
+    }
+    
+    const std::uint64_t key = (static_cast<std::uint64_t>(parent) << 32) | scope_id;
+    
+    if (const auto it = children.find(key); it != children.end())
+    {
+        return it->second;
+    }
+    
+    const auto stack = static_cast<StackId>(entries.size());
+    entries.push_back({ parent, scope_id, entries[parent].depth + 1 });
+    children.emplace(key, stack);
+    return stack;
+}
+//======================================================================================================================
+// endregion TextMateScopeStacks
+//**********************************************************************************************************************
@@ -0,0 +1,103 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextMateScopeStacks.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+struct TextMateGrammar;
+
+/**
+    Interns the scope stacks a tokenizer produces, so every distinct stack is identified by one small integer.
+    
+    Stacks form a tree, each one is its parent plus one scope pushed on top of it. Ids are handed out densely and
+    never change, so anything derived from a stack can be kept in a plain array indexed by its id.
+ */
+class TextMateScopeStacks
+{
+public:
+    using StackId = std::uint32_t;
+    using ScopeId = std::uint32_t;
+    
+    //==================================================================================================================
+    /** The empty stack every other stack is built on. */
+    static constexpr StackId Root_Stack = 0;
+    
+    /** How many begin/end rules deep the stacks of a grammar are collected, deeper ones are added when needed. */
+    static constexpr int Max_Grammar_Depth = 4;
+    
+    /** The number of stacks after which no more are collected from a grammar. */
+    static constexpr std::size_t Max_Grammar_Stacks = 1 << 16;
+    
+    //==================================================================================================================
+    TextMateScopeStacks();
+    
+    //==================================================================================================================
+    /**
+        Gets the stack that results from pushing scopes onto another one, creating it if it doesn't exist yet.
+        
+        @param parent The stack to push onto
+        @param scopes One or more scope names separated by spaces, as in a rule's name
+        @return The resulting stack, or the parent if there were no scopes
+     */
+    StackId push(StackId parent, const juce::String &scopes);
+    
+    /**
+        Adds the stacks the rules of a grammar can produce, up to Max_Grammar_Depth nested rules.
+        Rules that are included from other grammars are skipped.
+     */
+    void addGrammar(const TextMateGrammar &grammar);
+    
+    //==================================================================================================================
+    StackId getParent(StackId stack) const noexcept { return entries[stack].parent; }
+    ScopeId getScope (StackId stack) const noexcept { return entries[stack].scope; }
+    
+    const juce::String& getScopeName(ScopeId scope) const noexcept { return scopeNames[scope]; }
+    
+    /** Gets the names of the scopes in a stack, from the outermost to the innermost. */
+    std::vector<const juce::String*> getScopeNames(StackId stack) const;
+    
+    /** Gets the number of stacks, including the root, which is also one above the highest id. */
+    std::size_t size() const noexcept { return entries.size(); }
+    
+private:
+    struct Entry
+    {
+        StackId parent;
+        ScopeId scope;
+        int     depth;
+    };
+    
+    //==================================================================================================================
+    std::vector<Entry>                         entries;
+    std::vector<juce::String>                  scopeNames;
+    std::unordered_map<juce::String, ScopeId>  scopeLookup;
+    std::unordered_map<std::uint64_t, StackId> children; // Keyed by the parent stack and the pushed scope
+    
+    //==================================================================================================================
+    StackId pushScope(StackId parent, const juce::String &scope);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TextMateScopeStacks)
+};
@@ -0,0 +1,45 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextMateTheme.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+
+struct TextMateTheme
+{
+    //==================================================================================================================
+    struct Rule
+    {
+        juce::String                scopeSelector; // Empty for the theme's default settings
+        std::optional<juce::Colour> foreground;
+        std::optional<int>          fontStyle;     // A combination of juce::Font::FontStyleFlags
+    };
+    
+    //==================================================================================================================
+    juce::String      name;
+    juce::Colour      defaultForeground { juce::Colours::white };
+    int               defaultFontStyle  { juce::Font::plain };
+    std::vector<Rule> rules;
+};
@@ -0,0 +1,274 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextMateThemeMatcher.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "TextMateThemeMatcher.h"
+#include "TextMateTheme.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    /**
+        How well a path matched, for each of its parts from the innermost on: the depth of the scope it matched,
+        then the number of dot separated segments of the part. Higher compares better.
+     */
+    using Score = std::vector<int>;
+    
+    //==================================================================================================================
+    bool matchesScope(const juce::String &part, const juce::String &scope) noexcept
+    {
+        // "string.quoted" matches "string.quoted" and "string.quoted.double", but not "string.quotedx"
+        return scope.startsWith(part) && (scope.length() == part.length() || scope[part.length()] == '.');
+    }
+    
+    int countSegments(const juce::String &part) noexcept
+    {
+        int segments = 1;
+        
+        for (auto it = part.getCharPointer(); !it.isEmpty(); ++it)
+        {
+            segments += (*it == '.');
+        }
+        
+        return segments;
+    }
+    
+    /** Matches the parts of a path against a stack from the inside out, each part as deep as it can be found. */
+    bool matchPath(const std::vector<juce::String> &path, const std::vector<const juce::String*> &scopes,
+                   Score *score)
+    {
+        int next = static_cast<int>(scopes.size()) - 1;
+        
+        for (auto part = path.rbegin(); part != path.rend(); ++part, --next)
+        {
+            while (next >= 0 && !::matchesScope(*part, *scopes[static_cast<std::size_t>(next)]))
+            {
+                --next;
+            }
+            
+            if (next < 0)
+            {
+                return false;
+            }
+            
+            if (score)
+            {
+                score->push_back(next + 1);
+                score->push_back(::countSegments(*part));
+            }
+        }
+        
+        return true;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region TextMateThemeMatcher
+//======================================================================================================================
+struct TextMateThemeMatcher::Selector
+{
+    std::vector<juce::String>              path;
+    std::vector<std::vector<juce::String>> exclusions;
+    
+    //==================================================================================================================
+    /** Parses a comma separated list of selectors, parts this doesn't understand are left out. */
+    static std::vector<Selector> parseList(const juce::String &text)
+    {
+        std::vector<Selector> selectors;
+        
+        for (const auto &alternative : juce::StringArray::fromTokens(text, ",", ""))
+        {
+            Selector                  selector;
+            std::vector<juce::String> *target = &selector.path;
+            
+            for (juce::String token : juce::StringArray::fromTokens(alternative, " \t", ""))
+            {
+                if (token.startsWithChar('-'))
+                {
+                    selector.exclusions.emplace_back();
+                    target = &selector.exclusions.back();
+                    token  = token.substring(1);
+                }
+                
+                // Side prefixes and grouping only matter to editors that match against both sides of the caret
+                token = token.fromLastOccurrenceOf(":", false, false).removeCharacters("()");
+                
+                if (token.isNotEmpty() && token != ">")
+                {
+                    target->emplace_back(std::move(token));
+                }
+            }
+            
+            selector.exclusions.erase(std::remove_if(selector.exclusions.begin(), selector.exclusions.end(),
+                                                     [](const auto &exclusion) { return exclusion.empty(); }),
+                                      selector.exclusions.end());
+            
+            if (!selector.path.empty())
+            {
+                selectors.emplace_back(std::move(selector));
+            }
+        }
+        
+        return selectors;
+    }
+    
+    //==================================================================================================================
+    bool match(const std::vector<const juce::String*> &scopes, Score &score) const
+    {
+        for (const auto &exclusion : exclusions)
+        {
+            if (::matchPath(exclusion, scopes, nullptr))
+            {
+                return false;
+            }
+        }
+        
+        score.clear();
+        return ::matchPath(path, scopes, &score);
+    }
+};
+
+struct TextMateThemeMatcher::Rule
+{
+    std::vector<Selector>       selectors;
+    std::optional<juce::Colour> foreground;
+    std::optional<int>          fontStyle;
+};
+
+//======================================================================================================================
+TextMateThemeMatcher::TextMateThemeMatcher(const TextMateScopeStacks &parStacks)
+    : stacks(parStacks)
+{
+    setTheme(TextMateTheme());
+}
+
+TextMateThemeMatcher::~TextMateThemeMatcher() = default;
+
+//======================================================================================================================
+void TextMateThemeMatcher::setTheme(const TextMateTheme &theme)
+{
+    rules.clear();
+    scheme.clear();
+    schemeLookup.clear();
+    stackSchemes.clear();
+    
+    (void) addSchemeEntry({ theme.defaultForeground, theme.defaultFontStyle });
+    
+    for (const auto &theme_rule : theme.rules)
+    {
+        if (theme_rule.scopeSelector.isEmpty() || (!theme_rule.foreground && !theme_rule.fontStyle))
+        {
+            continue;
+        }
+        
+        Rule rule { Selector::parseList(theme_rule.scopeSelector), theme_rule.foreground, theme_rule.fontStyle };
+        
+        if (!rule.selectors.empty())
+        {
+            rules.emplace_back(std::move(rule));
+        }
+    }
+}
+
+void TextMateThemeMatcher::precompute()
+{
+    for (std::size_t stack = 0; stack < stacks.size(); ++stack)
+    {
+        (void) getSchemeIndex(static_cast<TextMateScopeStacks::StackId>(stack));
+    }
+}
+
+//======================================================================================================================
+int TextMateThemeMatcher::resolve(TextMateScopeStacks::StackId stack)
+{
+    const std::vector<const juce::String*> scopes = stacks.getScopeNames(stack);
+    
+    // Colour and font style are decided separately, each by the best rule that sets it;
+    // on equal scores the rule that comes later in the theme wins
+    SchemeEntry entry = scheme.front();
+    Score       best_colour_score;
+    Score       best_style_score;
+    Score       rule_score;
+    Score       score;
+    
+    for (const auto &rule : rules)
+    {
+        bool matched = false;
+        
+        for (const auto &selector : rule.selectors)
+        {
+            if (selector.match(scopes, score) && (!matched || rule_score < score))
+            {
+                rule_score = score;
+                matched    = true;
+            }
+        }
+        
+        if (!matched)
+        {
+            continue;
+        }
+        
+        if (rule.foreground && !(rule_score < best_colour_score))
+        {
+            best_colour_score = rule_score;
+            entry.colour      = *rule.foreground;
+        }
+        
+        if (rule.fontStyle && !(rule_score < best_style_score))
+        {
+            best_style_score = rule_score;
+            entry.styleFlags = *rule.fontStyle;
+        }
+    }
+    
+    if (stackSchemes.size() < stacks.size())
+    {
+        stackSchemes.resize(stacks.size(), -1);
+    }
+    
+    return stackSchemes[stack] = addSchemeEntry(entry);
+}
+
+int TextMateThemeMatcher::addSchemeEntry(SchemeEntry entry)
+{
+    const std::uint64_t key = (static_cast<std::uint64_t>(entry.colour.getARGB()) << 32)
+                              | static_cast<std::uint32_t>(entry.styleFlags);
+    
+    if (const auto it = schemeLookup.find(key); it != schemeLookup.end())
+    {
+        return it->second;
+    }
+    
+    const int index = static_cast<int>(scheme.size());
+    scheme.push_back(entry);
+    schemeLookup.emplace(key, index);
+    return index;
+}
+//======================================================================================================================
+// endregion TextMateThemeMatcher
+//**********************************************************************************************************************
@@ -0,0 +1,91 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextMateThemeMatcher.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "TextMateScopeStacks.h"
+
+#include <juce_graphics/juce_graphics.h>
+
+struct TextMateTheme;
+
+struct SchemeEntry
+{
+    juce::Colour colour;
+    int          styleFlags; // A combination of juce::Font::FontStyleFlags
+};
+
+/**
+    Applies a theme to the scope stacks of a tokenizer.
+    
+    The theme's scope selectors are parsed once, with descendant paths like "meta.tag string" and exclusions like
+    "string - string.regexp". The winning style of a stack is worked out the first time it is asked for and kept
+    in an array indexed by the stack's id, so styling a token afterwards is a single lookup.
+    Each distinct style gets one entry in the scheme, entry 0 is always the theme's default style.
+ */
+class TextMateThemeMatcher
+{
+public:
+    explicit TextMateThemeMatcher(const TextMateScopeStacks &stacks);
+    ~TextMateThemeMatcher();
+    
+    //==================================================================================================================
+    /** Compiles the selectors of a theme and forgets all styles that were worked out for the last one. */
+    void setTheme(const TextMateTheme &theme);
+    
+    /** Works out the styles of all stacks there are at the moment, so later lookups don't have to. */
+    void precompute();
+    
+    //==================================================================================================================
+    /** Gets the index of the scheme entry for a stack. */
+    int getSchemeIndex(TextMateScopeStacks::StackId stack)
+    {
+        if (stack < stackSchemes.size() && stackSchemes[stack] >= 0)
+        {
+            return stackSchemes[stack];
+        }
+        
+        return resolve(stack);
+    }
+    
+    const std::vector<SchemeEntry>& getScheme() const noexcept { return scheme; }
+    
+private:
+    struct Selector;
+    struct Rule;
+    
+    //==================================================================================================================
+    const TextMateScopeStacks              &stacks;
+    std::vector<Rule>                      rules;
+    std::vector<SchemeEntry>               scheme;
+    std::unordered_map<std::uint64_t, int> schemeLookup;
+    std::vector<int>                       stackSchemes; // Indexed by stack id, -1 if not worked out yet
+    
+    //==================================================================================================================
+    int resolve(TextMateScopeStacks::StackId stack);
+    int addSchemeEntry(SchemeEntry entry);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TextMateThemeMatcher)
+};
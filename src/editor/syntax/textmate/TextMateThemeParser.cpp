@@ -0,0 +1,214 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextMateThemeParser.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "TextMateThemeParser.h"
+#include "TextMateTheme.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    bool parseColour(const juce::var &property, std::optional<juce::Colour> &destination)
+    {
+        if (property.isVoid())
+        {
+            return true;
+        }
+        
+        // Themes write colours as #rgb, #rrggbb or #rrggbbaa, juce wants the alpha first
+        const juce::String text = property.toString().trim();
+        
+        if (!text.startsWithChar('#') || !text.substring(1).containsOnly("0123456789abcdefABCDEF"))
+        {
+            return false;
+        }
+        
+        juce::String hex = text.substring(1);
+        
+        if (hex.length() == 3 || hex.length() == 4)
+        {
+            juce::String expanded;
+            
+            for (int i = 0; i < hex.length(); ++i)
+            {
+                expanded << juce::String::charToString(hex[i]) << juce::String::charToString(hex[i]);
+            }
+            
+            hex = expanded;
+        }
+        
+        if (hex.length() == 6)
+        {
+            destination = juce::Colour(static_cast<juce::uint32>(0xff000000u | hex.getHexValue32()));
+            return true;
+        }
+        
+        if (hex.length() == 8)
+        {
+            const auto rgba = static_cast<juce::uint32>(hex.getHexValue32());
+            destination = juce::Colour((rgba >> 8) | (rgba << 24));
+            return true;
+        }
+        
+        return false;
+    }
+    
+    void parseFontStyle(const juce::var &property, std::optional<int> &destination)
+    {
+        if (!property.isString())
+        {
+            return;
+        }
+        
+        juce::StringArray words;
+        words.addTokens(property.toString(), " ", "");
+        
+        // An empty font style is meaningful, it resets whatever a less specific rule set
+        int style = juce::Font::plain;
+        
+        for (const auto &word : words)
+        {
+            if      (word == "bold")      style |= juce::Font::bold;
+            else if (word == "italic")    style |= juce::Font::italic;
+            else if (word == "underline") style |= juce::Font::underlined;
+        }
+        
+        destination = style;
+    }
+    
+    int parseRule(const juce::DynamicObject &ruleRoot, std::vector<TextMateTheme::Rule> &rules)
+    {
+        const juce::var &prop_settings = ruleRoot.getProperty("settings");
+        const juce::var &prop_scope    = ruleRoot.getProperty("scope");
+        
+        TextMateTheme::Rule rule;
+        
+        if (!::parseColour(prop_settings.getProperty("foreground", {}), rule.foreground))
+        {
+            return TextMateThemeParser::ParseStatus::InvalidColour;
+        }
+        
+        ::parseFontStyle(prop_settings.getProperty("fontStyle", {}), rule.fontStyle);
+        
+        if (prop_scope.isVoid())
+        {
+            rules.emplace_back(std::move(rule));
+        }
+        else if (prop_scope.isString())
+        {
+            rule.scopeSelector = prop_scope.toString();
+            rules.emplace_back(std::move(rule));
+        }
+        else if (const juce::Array<juce::var> *const scopes = prop_scope.getArray())
+        {
+            // A list of scopes is the same as one selector with all of them separated by commas
+            juce::StringArray selectors;
+            
+            for (const auto &scope : *scopes)
+            {
+                if (!scope.isString())
+                {
+                    return TextMateThemeParser::ParseStatus::InvalidRuleScope;
+                }
+                
+                selectors.add(scope.toString());
+            }
+            
+            rule.scopeSelector = selectors.joinIntoString(", ");
+            rules.emplace_back(std::move(rule));
+        }
+        else
+        {
+            return TextMateThemeParser::ParseStatus::InvalidRuleScope;
+        }
+        
+        return TextMateThemeParser::ParseStatus::Success;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region TextMateThemeParser
+//======================================================================================================================
+TextMateThemeParser::ParseResult TextMateThemeParser::parse(const juce::String &text)
+{
+    juce::var     theme_root;
+    TextMateTheme theme;
+    
+    if (juce::JSON::parse(text, theme_root).failed() || !theme_root.getDynamicObject())
+    {
+        return std::make_pair(ParseStatus::InvalidJson, std::move(theme));
+    }
+    
+    const juce::DynamicObject &root_obj = *theme_root.getDynamicObject();
+    theme.name = root_obj.getProperty("name").toString();
+    
+    {
+        std::optional<juce::Colour> foreground;
+        
+        if (!::parseColour(root_obj.getProperty("colors").getProperty("editor.foreground", {}), foreground))
+        {
+            return std::make_pair(ParseStatus::InvalidColour, std::move(theme));
+        }
+        
+        theme.defaultForeground = foreground.value_or(theme.defaultForeground);
+    }
+    
+    const juce::var &prop_rules = (root_obj.hasProperty("tokenColors") ? root_obj.getProperty("tokenColors")
+                                                                       : root_obj.getProperty("settings"));
+    const juce::Array<juce::var> *const rules = prop_rules.getArray();
+    
+    if (!rules)
+    {
+        return std::make_pair(ParseStatus::MissingRules, std::move(theme));
+    }
+    
+    for (const auto &rule : *rules)
+    {
+        if (const juce::DynamicObject *const rule_root = rule.getDynamicObject())
+        {
+            if (const int result = ::parseRule(*rule_root, theme.rules))
+            {
+                return std::make_pair(result, std::move(theme));
+            }
+        }
+    }
+    
+    // Rules without a scope are the defaults, as in a tmTheme's first settings entry
+    for (const auto &rule : theme.rules)
+    {
+        if (rule.scopeSelector.isEmpty())
+        {
+            theme.defaultForeground = rule.foreground.value_or(theme.defaultForeground);
+            theme.defaultFontStyle  = rule.fontStyle .value_or(theme.defaultFontStyle);
+        }
+    }
+    
+    return std::make_pair(ParseStatus::Success, std::move(theme));
+}
+//======================================================================================================================
+// endregion TextMateThemeParser
+//**********************************************************************************************************************
@@ -0,0 +1,55 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextMateThemeParser.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+struct TextMateTheme;
+class TextMateThemeParser
+{
+public:
+    using ParseResult = std::pair<int, TextMateTheme>;
+    
+    //==================================================================================================================
+    struct ParseStatus
+    {
+        enum
+        {
+            Success,
+            InvalidJson,
+            MissingRules,
+            InvalidRuleScope,
+            InvalidColour
+        };
+    };
+    
+    //==================================================================================================================
+    /**
+        Parses a theme in the json format used by vscode themes, with its rules in "tokenColors",
+        or a tmTheme converted to json, with its rules in "settings".
+     */
+    static ParseResult parse(const juce::String &text);
+};
@@ -0,0 +1,820 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextMateTokenizer.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "TextMateTokenizer.h"
+
+#include <cwchar>
+#include <regex>
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    using Rule    = TextMateGrammar::Rule;
+    using StackId = TextMateScopeStacks::StackId;
+    
+    //==================================================================================================================
+    /** How an expression that starts with \G relates to the position \G stands for. */
+    enum class Anchor
+    {
+        None,
+        AtStart,
+        NotAtStart
+    };
+    
+    //==================================================================================================================
+    /** How often a line can match without moving on before a character is skipped, so empty matches can't loop. */
+    constexpr int Max_Stalled_Matches = 16;
+    
+    /** The number of end expressions with back-references that are kept compiled. */
+    constexpr std::size_t Max_Dynamic_Ends = 256;
+    
+    //==================================================================================================================
+    const Rule* resolveInclude(const TextMateGrammar &grammar, const Rule &rule)
+    {
+        if (rule.include.startsWithChar('#'))
+        {
+            const auto it = grammar.repository.find(rule.include.substring(1));
+            return it != grammar.repository.end() ? &it->second : nullptr;
+        }
+        
+        return nullptr;
+    }
+    
+    //==================================================================================================================
+    bool isHexEscape(wchar_t character) noexcept
+    {
+        return character == L'h' || character == L'H';
+    }
+    
+    /** Checks whether an ECMAScript expression has alternatives outside of any group. */
+    bool hasTopLevelAlternatives(const std::wstring &expression)
+    {
+        int  depth    = 0;
+        bool in_class = false;
+        
+        for (std::size_t i = 0; i < expression.size(); ++i)
+        {
+            const wchar_t character = expression[i];
+            
+            if (character == L'\\')
+            {
+                ++i;
+            }
+            else if (in_class)
+            {
+                in_class = (character != L']');
+            }
+            else if (character == L'[')
+            {
+                in_class = true;
+            }
+            else if (character == L'(' || character == L')')
+            {
+                depth += (character == L'(' ? 1 : -1);
+            }
+            else if (character == L'|' && depth == 0)
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    /**
+        Translates an Oniguruma expression to ECMAScript where there is an equivalent.
+        Anything without one is left as is, std::regex will then refuse to compile it.
+        
+        There is no \G in ECMAScript, which stands for the end of the begin match of the innermost rule. A \G or
+        (?!\G) at the very start is dropped and reported through anchor, so the search can be held at or kept off
+        that position instead. A \G anywhere else can't be expressed and never matches.
+     */
+    std::wstring translateExpression(const juce::String &source, bool &ignoreCase, Anchor &anchor)
+    {
+        const std::wstring input  = source.toWideCharPointer();
+        const std::size_t  length = input.size();
+        
+        std::wstring result;
+        std::size_t  i        = 0;
+        bool         extended = false;
+        bool         in_class = false;
+        
+        // Options for the whole expression, like (?i) or (?x), can only be given at the start in ECMAScript
+        while (input.compare(i, 2, L"(?") == 0)
+        {
+            std::size_t end = i + 2;
+            
+            while (end < length && std::wcschr(L"imx", input[end]) != nullptr)
+            {
+                ++end;
+            }
+            
+            if (end == i + 2 || end >= length || input[end] != L')')
+            {
+                break;
+            }
+            
+            for (std::size_t option = i + 2; option < end; ++option)
+            {
+                ignoreCase |= (input[option] == L'i');
+                extended   |= (input[option] == L'x');
+            }
+            
+            i = end + 1;
+        }
+        
+        result.reserve(length - i);
+        
+        if (input.compare(i, 2, L"\\G") == 0)
+        {
+            anchor = Anchor::AtStart;
+            i     += 2;
+        }
+        else if (input.compare(i, 6, L"(?!\\G)") == 0)
+        {
+            anchor = Anchor::NotAtStart;
+            i     += 6;
+        }
+        
+        while (i < length)
+        {
+            const wchar_t character = input[i];
+            
+            if (character == L'\\' && i + 1 < length)
+            {
+                const wchar_t escaped = input[i + 1];
+                i += 2;
+                
+                if (isHexEscape(escaped))
+                {
+                    result += (in_class ? L"0-9A-Fa-f" : (escaped == L'h' ? L"[0-9A-Fa-f]" : L"[^0-9A-Fa-f]"));
+                }
+                else if (!in_class && escaped == L'A')
+                {
+                    result += L'^';
+                }
+                else if (!in_class && escaped == L'z')
+                {
+                    result += L'$';
+                }
+                else if (!in_class && escaped == L'Z')
+                {
+                    result += L"(?=\\n)";
+                }
+                else if (!in_class && escaped == L'G')
+                {
+                    result += L"[^\\s\\S]";
+                }
+                else
+                {
+                    result += character;
+                    result += escaped;
+                }
+                
+                continue;
+            }
+            
+            ++i;
+            
+            if (in_class)
+            {
+                in_class = (character != L']');
+                result  += character;
+                continue;
+            }
+            
+            if (extended && (character == L' ' || character == L'\t' || character == L'\n'))
+            {
+                continue;
+            }
+            
+            if (extended && character == L'#')
+            {
+                while (i < length && input[i] != L'\n')
+                {
+                    ++i;
+                }
+                
+                continue;
+            }
+            
+            if (character == L'[')
+            {
+                in_class = true;
+                result  += character;
+                
+                // A closing bracket right at the start of a class is a literal
+                if (i < length && input[i] == L'^')
+                {
+                    result += input[i++];
+                }
+                
+                if (i < length && input[i] == L']')
+                {
+                    result += L"\\]";
+                    ++i;
+                }
+                
+                continue;
+            }
+            
+            if (character == L'(' && input.compare(i, 2, L"?<") == 0 && i + 2 < length
+                && input[i + 2] != L'=' && input[i + 2] != L'!')
+            {
+                // Named groups are numbered like any other group, only the name has to go
+                const std::size_t name_end = input.find(L'>', i);
+                result += character;
+                i       = (name_end == std::wstring::npos ? length : name_end + 1);
+                continue;
+            }
+            
+            if (character == L'(' && input.compare(i, 2, L"?>") == 0)
+            {
+                // Atomic groups only change how a match is found, not what matches in the end
+                result += L"(?:";
+                i      += 2;
+                continue;
+            }
+            
+            if (character == L'$')
+            {
+                // The line break is part of the text, a line ends before it
+                result += L"(?=\\n)";
+                continue;
+            }
+            
+            result += character;
+            
+            // Possessive quantifiers have the same meaning as greedy ones for the first match
+            if ((character == L'*' || character == L'+' || character == L'?' || character == L'}')
+                && i < length && input[i] == L'+')
+            {
+                ++i;
+            }
+        }
+        
+        // Only the first alternative starts with the \G, the others can match anywhere
+        if (anchor != Anchor::None && ::hasTopLevelAlternatives(result))
+        {
+            if (anchor == Anchor::AtStart)
+            {
+                result.insert(0, L"[^\\s\\S]");
+            }
+            
+            anchor = Anchor::None;
+        }
+        
+        return result;
+    }
+    
+    //==================================================================================================================
+    bool hasBackReferences(const juce::String &expression)
+    {
+        for (auto it = expression.getCharPointer(); !it.isEmpty();)
+        {
+            if (it.getAndAdvance() == '\\')
+            {
+                const juce::juce_wchar escaped = it.getAndAdvance();
+                
+                if (escaped >= '1' && escaped <= '9')
+                {
+                    return true;
+                }
+                
+                if (escaped == 0)
+                {
+                    break;
+                }
+            }
+        }
+        
+        return false;
+    }
+    
+    /** Replaces the back-references of an end expression with the text of the groups of its begin match. */
+    juce::String substituteBackReferences(const juce::String &expression, const std::wstring &text,
+                                          const std::vector<juce::Range<int>> &groups)
+    {
+        static const juce::String special_characters = "\\^$.|?*+()[]{}/-";
+        
+        juce::String result;
+        result.preallocateBytes(expression.getNumBytesAsUTF8() + 16);
+        
+        for (auto it = expression.getCharPointer(); !it.isEmpty();)
+        {
+            const juce::juce_wchar character = it.getAndAdvance();
+            
+            if (character != '\\' || it.isEmpty())
+            {
+                result << juce::String::charToString(character);
+                continue;
+            }
+            
+            const juce::juce_wchar escaped = it.getAndAdvance();
+            const int              group   = static_cast<int>(escaped) - '0';
+            
+            if (group < 1 || group > 9)
+            {
+                result << juce::String::charToString(character) << juce::String::charToString(escaped);
+                continue;
+            }
+            
+            if (group < static_cast<int>(groups.size()) && !groups[static_cast<std::size_t>(group)].isEmpty())
+            {
+                const juce::Range<int> range = groups[static_cast<std::size_t>(group)];
+                
+                for (int i = range.getStart(); i < range.getEnd(); ++i)
+                {
+                    const auto captured = static_cast<juce::juce_wchar>(text[static_cast<std::size_t>(i)]);
+                    
+                    if (special_characters.containsChar(captured))
+                    {
+                        result << '\\';
+                    }
+                    
+                    result << juce::String::charToString(captured);
+                }
+            }
+        }
+        
+        return result;
+    }
+    
+    //==================================================================================================================
+    void addToken(std::vector<TextMateTokenizer::Token> &tokens, int start, StackId stack, int lineLength)
+    {
+        if (start >= lineLength)
+        {
+            return;
+        }
+        
+        // A token that starts where the last one did means the last one was empty
+        if (!tokens.empty() && tokens.back().start == start)
+        {
+            tokens.pop_back();
+        }
+        
+        if (tokens.empty() || tokens.back().stack != stack)
+        {
+            tokens.push_back({ start, stack });
+        }
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region Expression
+//======================================================================================================================
+struct TextMateTokenizer::Match
+{
+    static constexpr int Unknown  = -2;
+    static constexpr int No_Match = -1;
+    
+    //==================================================================================================================
+    std::vector<juce::Range<int>> groups; // Offsets into the line, empty if the group didn't take part in the match
+    int                           start { Unknown };
+};
+
+struct TextMateTokenizer::Expression
+{
+    std::wregex regex;
+    Anchor      anchor { Anchor::None }; // Whether it has to match at or away from the \G position
+    bool        valid  { false };
+    
+    //==================================================================================================================
+    Expression() = default;
+    
+    explicit Expression(const juce::String &source)
+    {
+        try
+        {
+            bool               ignore_case = false;
+            const std::wstring translated  = ::translateExpression(source, ignore_case, anchor);
+            const auto         flags       = std::regex::ECMAScript | std::regex::optimize
+                                             | (ignore_case ? std::regex::icase : std::regex::flag_type{});
+            regex = std::wregex(translated, flags);
+            valid = true;
+        }
+        catch (const std::regex_error&) {}
+    }
+    
+    //==================================================================================================================
+    /**
+        Finds the first match at or after from.
+        
+        @param text           The line with its line break
+        @param from           The offset to start searching at
+        @param anchorPosition The offset \G stands for, or -1 if it doesn't match anywhere in the line
+        @param match          The match to fill in
+     */
+    void search(const std::wstring &text, int from, int anchorPosition, Match &match) const
+    {
+        match.groups.clear();
+        match.start = Match::No_Match;
+        
+        if (!valid || (anchor == Anchor::AtStart && anchorPosition != from))
+        {
+            return;
+        }
+        
+        // The characters before the start are still there for anchors like \b and lookaheads
+        const auto   flags = (from > 0 ? std::regex_constants::match_prev_avail
+                                       : std::regex_constants::match_default)
+                             | (anchor == Anchor::AtStart ? std::regex_constants::match_continuous
+                                                          : std::regex_constants::match_default);
+        std::wsmatch results;
+        bool         found = std::regex_search(text.begin() + from, text.end(), results, regex, flags);
+        
+        if (found && anchor == Anchor::NotAtStart && anchorPosition == from && results.position(0) == 0)
+        {
+            found = (from < static_cast<int>(text.size())
+                     && std::regex_search(text.begin() + from + 1, text.end(), results, regex,
+                                          flags | std::regex_constants::match_prev_avail));
+        }
+        
+        if (found)
+        {
+            for (const auto &group : results)
+            {
+                if (group.matched)
+                {
+                    match.groups.emplace_back(static_cast<int>(group.first  - text.begin()),
+                                              static_cast<int>(group.second - text.begin()));
+                }
+                else
+                {
+                    match.groups.push_back(juce::Range<int>::emptyRange(-1));
+                }
+            }
+            
+            match.start = match.groups.front().getStart();
+        }
+    }
+};
+
+struct TextMateTokenizer::CompiledRule
+{
+    const Rule       *rule;
+    Expression       match; // The match or begin expression
+    Expression       end;
+    std::vector<int> patterns;
+    bool             isBlock;
+    bool             endHasBackReferences;
+};
+//======================================================================================================================
+// endregion Expression
+//**********************************************************************************************************************
+// region TextMateTokenizer
+//======================================================================================================================
+TextMateTokenizer::TextMateTokenizer(const TextMateGrammar &parGrammar, TextMateScopeStacks &parStacks)
+    : grammar(parGrammar), stacks(parStacks),
+      rootStack(parStacks.push(TextMateScopeStacks::Root_Stack, parGrammar.languageInfo.scopeName))
+{
+    std::vector<const std::vector<Rule>*> expanding;
+    expandPatterns(grammar.patterns, rootPatterns, expanding);
+}
+
+TextMateTokenizer::~TextMateTokenizer() = default;
+
+//======================================================================================================================
+void TextMateTokenizer::tokenizeLine(const juce::String &line, State &state, std::vector<Token> &tokens)
+{
+    tokens.clear();
+    
+    // The line break is part of the text, so expressions can find the end of a line with \n like in TextMate
+    const std::wstring text   = std::wstring(line.toWideCharPointer()) + L'\n';
+    const int          length = line.length();
+    
+    // The next match of each candidate of the innermost rule, the end expression is the last one; a match that
+    // starts after the position the line was matched up to is still the next one, so it doesn't need another search
+    std::vector<Match> candidate_matches;
+    bool               candidates_changed = true;
+    
+    // Where \G matches, the end of the begin match of the innermost rule that began on this line
+    std::vector<int> outer_anchors;
+    int              anchor_position = -1;
+    
+    int position = 0;
+    int stalled  = 0;
+    
+    ::addToken(tokens, 0, state.frames.empty() ? rootStack : state.frames.back().contentStack, length);
+    
+    while (position <= length)
+    {
+        const State::Frame *const frame         = (state.frames.empty() ? nullptr : &state.frames.back());
+        const std::vector<int>    &candidates   = (frame ? rules[static_cast<std::size_t>(frame->rule)].patterns
+                                                         : rootPatterns);
+        const StackId             content_stack = (frame ? frame->contentStack : rootStack);
+        const std::size_t         end_index     = candidates.size();
+        
+        if (candidates_changed)
+        {
+            candidate_matches.assign(candidates.size() + 1, Match{});
+            candidates_changed = false;
+        }
+        
+        std::size_t best       = end_index + 1;
+        int         best_start = std::numeric_limits<int>::max();
+        
+        const auto find_next = [&](std::size_t index, const Expression &expression)
+        {
+            Match &match = candidate_matches[index];
+            
+            // Whether an anchored expression matches depends on where the search starts, so it is always redone
+            if (match.start == Match::Unknown || (match.start >= 0 && match.start < position)
+                || expression.anchor != Anchor::None)
+            {
+                expression.search(text, position, anchor_position, match);
+            }
+            
+            if (match.start >= 0 && match.start < best_start)
+            {
+                best       = index;
+                best_start = match.start;
+            }
+        };
+        
+        // The end expression goes first, so it wins over any pattern that matches at the same position
+        if (frame)
+        {
+            find_next(end_index, getEndExpression(*frame));
+        }
+        
+        for (std::size_t i = 0; i < end_index; ++i)
+        {
+            find_next(i, rules[static_cast<std::size_t>(candidates[i])].match);
+        }
+        
+        if (best > end_index)
+        {
+            break;
+        }
+        
+        const Match            &match        = candidate_matches[best];
+        const juce::Range<int> whole         = match.groups.front();
+        bool                   changed_state = false;
+        
+        if (whole.getStart() > position)
+        {
+            ::addToken(tokens, position, content_stack, length);
+        }
+        
+        if (best == end_index)
+        {
+            const Rule::CaptureList &captures = rules[static_cast<std::size_t>(frame->rule)].rule->captures;
+            addMatchTokens(tokens, match, frame->ruleStack, captures.end.empty() ? captures.captures : captures.end,
+                           length);
+            
+            state.frames.pop_back();
+            
+            if (outer_anchors.empty())
+            {
+                anchor_position = -1;
+            }
+            else
+            {
+                anchor_position = outer_anchors.back();
+                outer_anchors.pop_back();
+            }
+            
+            changed_state = true;
+        }
+        else
+        {
+            const int          rule_id    = candidates[best];
+            const CompiledRule &compiled  = rules[static_cast<std::size_t>(rule_id)];
+            const Rule         &rule      = *compiled.rule;
+            const StackId      rule_stack = stacks.push(content_stack, rule.name);
+            
+            if (compiled.isBlock && state.getDepth() < Max_Depth)
+            {
+                addMatchTokens(tokens, match, rule_stack,
+                               rule.captures.begin.empty() ? rule.captures.captures : rule.captures.begin, length);
+                
+                const juce::String end_pattern = compiled.endHasBackReferences
+                                                     ? ::substituteBackReferences(rule.expression.end, text,
+                                                                                  match.groups)
+                                                     : juce::String();
+                state.frames.push_back({ rule_id, rule_stack, stacks.push(rule_stack, rule.contentName),
+                                         end_pattern });
+                outer_anchors.push_back(anchor_position);
+                anchor_position = whole.getEnd();
+                changed_state   = true;
+            }
+            else
+            {
+                addMatchTokens(tokens, match, rule_stack, rule.captures.captures, length);
+            }
+        }
+        
+        if (changed_state)
+        {
+            candidates_changed = true;
+        }
+        
+        if (whole.getEnd() > position)
+        {
+            position = whole.getEnd();
+            stalled  = 0;
+        }
+        else if (!changed_state || ++stalled >= Max_Stalled_Matches)
+        {
+            // Nothing was consumed, skip a character or the same empty match would be found over and over
+            ++position;
+            stalled = 0;
+        }
+        
+        const StackId next_stack = (state.frames.empty() ? rootStack : state.frames.back().contentStack);
+        
+        if (whole.getEnd() < position)
+        {
+            ::addToken(tokens, whole.getEnd(), next_stack, length);
+        }
+    }
+    
+    if (position < length)
+    {
+        ::addToken(tokens, position, state.frames.empty() ? rootStack : state.frames.back().contentStack, length);
+    }
+}
+
+//======================================================================================================================
+int TextMateTokenizer::compileRule(const Rule &rule)
+{
+    if (const auto it = ruleIds.find(&rule); it != ruleIds.end())
+    {
+        return it->second;
+    }
+    
+    const int  id                = static_cast<int>(rules.size());
+    const bool is_block          = rule.expression.end.isNotEmpty();
+    const bool has_back_refences = is_block && ::hasBackReferences(rule.expression.end);
+    
+    ruleIds.emplace(&rule, id);
+    rules.push_back({
+        &rule,
+        Expression(rule.expression.beginOrMatch),
+        (is_block && !has_back_refences ? Expression(rule.expression.end) : Expression()),
+        {},
+        is_block,
+        has_back_refences
+    });
+    
+    if (is_block)
+    {
+        // The rule is registered before its patterns are expanded, so rules that include themselves end here
+        std::vector<int>                      patterns;
+        std::vector<const std::vector<Rule>*> expanding;
+        expandPatterns(rule.patterns, patterns, expanding);
+        rules[static_cast<std::size_t>(id)].patterns = std::move(patterns);
+    }
+    
+    return id;
+}
+
+void TextMateTokenizer::expandPatterns(const std::vector<Rule> &patterns, std::vector<int> &destination,
+                                       std::vector<const std::vector<Rule>*> &expanding)
+{
+    // Includes that lead back into a list that is being expanded would add the same rules again
+    if (std::find(expanding.begin(), expanding.end(), &patterns) != expanding.end())
+    {
+        return;
+    }
+    
+    expanding.push_back(&patterns);
+    
+    for (const Rule &rule : patterns)
+    {
+        const Rule *target = &rule;
+        
+        while (target && target->include.isNotEmpty())
+        {
+            if (target->include == "$self" || target->include == "$base")
+            {
+                expandPatterns(grammar.patterns, destination, expanding);
+                target = nullptr;
+            }
+            else
+            {
+                // Includes of other grammars are not supported, they are skipped
+                const Rule *const included = ::resolveInclude(grammar, *target);
+                target = (included != target ? included : nullptr);
+            }
+        }
+        
+        if (!target)
+        {
+            continue;
+        }
+        
+        if (target->expression.beginOrMatch.isEmpty())
+        {
+            // Rules without an expression only group other rules
+            expandPatterns(target->patterns, destination, expanding);
+        }
+        else
+        {
+            destination.push_back(compileRule(*target));
+        }
+    }
+    
+    expanding.pop_back();
+}
+
+//======================================================================================================================
+const TextMateTokenizer::Expression& TextMateTokenizer::getEndExpression(const State::Frame &frame)
+{
+    if (frame.endPattern.isEmpty())
+    {
+        return rules[static_cast<std::size_t>(frame.rule)].end;
+    }
+    
+    if (const auto it = dynamicEnds.find(frame.endPattern); it != dynamicEnds.end())
+    {
+        return *it->second;
+    }
+    
+    if (dynamicEnds.size() >= Max_Dynamic_Ends)
+    {
+        dynamicEnds.clear();
+    }
+    
+    return *dynamicEnds.emplace(frame.endPattern, std::make_unique<Expression>(frame.endPattern)).first->second;
+}
+
+//======================================================================================================================
+void TextMateTokenizer::addMatchTokens(std::vector<Token> &tokens, const Match &match, StackId stack,
+                                       const CaptureArray &captures, int lineLength)
+{
+    const juce::Range<int> whole = match.groups.front();
+    
+    if (captures.empty() || whole.isEmpty())
+    {
+        ::addToken(tokens, whole.getStart(), stack, lineLength);
+        return;
+    }
+    
+    // Groups are numbered by their opening parenthesis, so a group comes before the groups nested in it
+    std::vector<std::pair<int, const juce::String*>> ordered;
+    
+    for (const auto &[index, name] : captures)
+    {
+        const int group = index.getIntValue();
+        
+        if (group >= 0 && group < static_cast<int>(match.groups.size()))
+        {
+            ordered.emplace_back(group, &name);
+        }
+    }
+    
+    std::sort(ordered.begin(), ordered.end());
+    
+    std::vector<StackId> character_stacks(static_cast<std::size_t>(whole.getLength()), stack);
+    
+    for (const auto &[group, name] : ordered)
+    {
+        const juce::Range<int> range = match.groups[static_cast<std::size_t>(group)].getIntersectionWith(whole);
+        
+        if (range.isEmpty())
+        {
+            continue;
+        }
+        
+        const auto    first          = static_cast<std::size_t>(range.getStart() - whole.getStart());
+        const StackId capture_stack  = stacks.push(character_stacks[first], *name);
+        
+        std::fill_n(character_stacks.begin() + static_cast<std::ptrdiff_t>(first), range.getLength(), capture_stack);
+    }
+    
+    for (std::size_t i = 0; i < character_stacks.size(); ++i)
+    {
+        ::addToken(tokens, whole.getStart() + static_cast<int>(i), character_stacks[i], lineLength);
+    }
+}
+//======================================================================================================================
+// endregion TextMateTokenizer
+//**********************************************************************************************************************
@@ -0,0 +1,144 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TextMateTokenizer.h
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#pragma once
+
+#include "TextMateGrammar.h"
+#include "TextMateScopeStacks.h"
+
+#include <juce_core/juce_core.h>
+
+/**
+    Splits lines of text into tokens with the rules of a TextMate grammar.
+    
+    Lines are tokenized one after another, the begin/end rules that are still open at the end of a line are kept in
+    a State that is handed to the next one. Each token is tagged with the scope stack it is in, which can be styled
+    with a TextMateThemeMatcher.
+    
+    The grammar's expressions are written for Oniguruma but run on std::regex, they are translated where there is an
+    equivalent; rules with expressions that can't be translated, like lookbehinds, never match.
+ */
+class TextMateTokenizer
+{
+public:
+    struct Token
+    {
+        int                          start; // The offset into the line in characters
+        TextMateScopeStacks::StackId stack;
+    };
+    
+    /** The begin/end rules that are open at the end of a line, from the outermost to the innermost. */
+    class State
+    {
+    public:
+        bool operator==(const State &other) const noexcept { return frames == other.frames; }
+        bool operator!=(const State &other) const noexcept { return frames != other.frames; }
+        
+        /** Gets the number of rules that are open. */
+        int getDepth() const noexcept { return static_cast<int>(frames.size()); }
+        
+    private:
+        friend class TextMateTokenizer;
+        
+        //==============================================================================================================
+        struct Frame
+        {
+            int                          rule;
+            TextMateScopeStacks::StackId ruleStack;    // The stack the begin and end matches are in
+            TextMateScopeStacks::StackId contentStack; // The stack of the text between them
+            juce::String                 endPattern;   // The end expression if it refers to captures of the begin one
+            
+            bool operator==(const Frame &other) const noexcept
+            {
+                return rule == other.rule && contentStack == other.contentStack && endPattern == other.endPattern;
+            }
+        };
+        
+        //==============================================================================================================
+        std::vector<Frame> frames;
+    };
+    
+    //==================================================================================================================
+    /** How many begin/end rules can be open at once, rules that would open more are ignored. */
+    static constexpr int Max_Depth = 128;
+    
+    //==================================================================================================================
+    /**
+        Compiles the expressions of a grammar.
+        
+        @param grammar The grammar to tokenize with, it must outlive the tokenizer
+        @param stacks  The stacks to intern the scopes of tokens in
+     */
+    TextMateTokenizer(const TextMateGrammar &grammar, TextMateScopeStacks &stacks);
+    ~TextMateTokenizer();
+    
+    //==================================================================================================================
+    /** Gets the state the first line of a document starts in. */
+    State getInitialState() const { return {}; }
+    
+    /** Gets the stack of text that no rule matched, outside of any begin/end rule. */
+    TextMateScopeStacks::StackId getRootStack() const noexcept { return rootStack; }
+    
+    //==================================================================================================================
+    /**
+        Tokenizes one line, without its line break.
+        Adjacent tokens in the same stack are merged into one, the first token always starts at 0 unless the line
+        is empty.
+        
+        @param line   The text of the line
+        @param state  The state at the end of the previous line, this is updated to the one at the end of this line
+        @param tokens The list to replace with the tokens of the line
+     */
+    void tokenizeLine(const juce::String &line, State &state, std::vector<Token> &tokens);
+    
+private:
+    using Rule         = TextMateGrammar::Rule;
+    using CaptureArray = Rule::CaptureList::CaptureArray;
+    
+    struct CompiledRule;
+    struct Expression;
+    struct Match;
+    
+    //==================================================================================================================
+    const TextMateGrammar                                         &grammar;
+    TextMateScopeStacks                                           &stacks;
+    std::vector<CompiledRule>                                     rules;
+    std::unordered_map<const Rule*, int>                          ruleIds;
+    std::vector<int>                                              rootPatterns;
+    std::unordered_map<juce::String, std::unique_ptr<Expression>> dynamicEnds; // End expressions with back-references
+    TextMateScopeStacks::StackId                                  rootStack;
+    
+    //==================================================================================================================
+    int  compileRule(const Rule &rule);
+    void expandPatterns(const std::vector<Rule> &patterns, std::vector<int> &destination,
+                        std::vector<const std::vector<Rule>*> &expanding);
+    
+    const Expression& getEndExpression(const State::Frame &frame);
+    
+    void addMatchTokens(std::vector<Token> &tokens, const Match &match, TextMateScopeStacks::StackId stack,
+                        const CaptureArray &captures, int lineLength);
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TextMateTokenizer)
+};
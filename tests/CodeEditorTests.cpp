@@ -0,0 +1,115 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   CodeEditorTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/CodeEditor.h"
+
+//**********************************************************************************************************************
+// region CodeEditorTests
+//======================================================================================================================
+class CodeEditorTests : public juce::UnitTest
+{
+public:
+    CodeEditorTests()
+        : juce::UnitTest("CodeEditor", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Collapsing a region hides its lines and keeps them hidden through edits around it");
+        {
+            juce::CodeDocument document;
+            document.replaceAllContent("<root>\n"
+                                       "    <item>\n"
+                                       "        <value/>\n"
+                                       "    </item>\n"
+                                       "    <other/>\n"
+                                       "</root>");
+            
+            CodeEditor       editor(document);
+            const FoldIndex &fold_index = editor.getFoldIndex();
+            const int        num_rows   = fold_index.getNumRows();
+            
+            expectEquals(fold_index.getNumLines(), document.getNumLines());
+            
+            editor.setFoldCollapsed(1, true);
+            
+            expectEquals(fold_index.getNumRows(), num_rows - 2);
+            expect( fold_index.isLineVisible(1));
+            expect(!fold_index.isLineVisible(2));
+            expect(!fold_index.isLineVisible(3));
+            expect( fold_index.isLineVisible(4));
+            
+            // A line added above moves the collapsed region down with it
+            document.insertText(0, "<!-- comment -->\n");
+            
+            expectEquals(fold_index.getNumRows(), num_rows - 1);
+            expect( fold_index.isLineVisible(2));
+            expect(!fold_index.isLineVisible(3));
+            expect(!fold_index.isLineVisible(4));
+            expect( fold_index.isLineVisible(5));
+            
+            editor.setFoldCollapsed(2, false);
+            
+            expectEquals(fold_index.getNumRows(), num_rows + 1);
+            expect(fold_index.isLineVisible(4));
+        }
+        
+        beginTest("Errors make their line one row higher until the next diagnostics replace them");
+        {
+            juce::CodeDocument document;
+            document.replaceAllContent("<root>\n"
+                                       "    <item>\n"
+                                       "</root>");
+            
+            CodeEditor       editor(document);
+            const FoldIndex &fold_index   = editor.getFoldIndex();
+            const double     row_height   = fold_index.getDefaultHeight();
+            const double     total_height = fold_index.getTotalHeight();
+            
+            editor.setDiagnostics({
+                { "Expected end of tag 'item'", XmlDiagnostic::Severity::Error,   3, 3 },
+                { "Unknown element 'item'",     XmlDiagnostic::Severity::Warning, 2, 6 }
+            });
+            
+            expectEquals(fold_index.getLineHeight(2), row_height * 2.0);
+            expectEquals(fold_index.getLineHeight(1), row_height);
+            expectEquals(fold_index.getTotalHeight(), total_height + row_height);
+            
+            // The description moves along with its line
+            document.insertText(0, "<!-- comment -->\n");
+            expectEquals(fold_index.getLineHeight(3), row_height * 2.0);
+            
+            editor.setDiagnostics({});
+            expectEquals(fold_index.getTotalHeight(), total_height + row_height);
+            expectEquals(fold_index.getLineHeight(3), row_height);
+        }
+    }
+};
+
+static CodeEditorTests codeEditorTests;
+//======================================================================================================================
+// endregion CodeEditorTests
+//**********************************************************************************************************************
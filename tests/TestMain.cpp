@@ -0,0 +1,51 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TestMain.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+//**********************************************************************************************************************
+// region Main
+//======================================================================================================================
+int main()
+{
+    // The editor needs fonts and components, though nothing is ever shown on the screen
+    const juce::ScopedJuceInitialiser_GUI juce_initialiser;
+    
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("Jamal");
+    
+    int num_failures = 0;
+    
+    for (int i = 0; i < runner.getNumResults(); ++i)
+    {
+        num_failures += runner.getResult(i)->failures;
+    }
+    
+    return num_failures > 0 ? 1 : 0;
+}
+//======================================================================================================================
+// endregion Main
+//**********************************************************************************************************************
@@ -0,0 +1,170 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   CaretListTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/document/CaretList.h"
+
+//**********************************************************************************************************************
+// region CaretListTests
+//======================================================================================================================
+class CaretListTests : public juce::UnitTest
+{
+public:
+    CaretListTests()
+        : juce::UnitTest("CaretList", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Typing with several carets edits at all of them in one transaction");
+        {
+            juce::CodeDocument document;
+            document.replaceAllContent("ab\ncd\nef");
+            
+            CaretList carets;
+            carets.setCarets({ caretAt(1), caretAt(4), caretAt(7) });
+            carets.insertText(document, "XY");
+            
+            expectEquals(document.getAllContent(), juce::String("aXYb\ncXYd\neXYf"));
+            expectPositions(carets, { 3, 8, 13 });
+            
+            document.undo();
+            expectEquals(document.getAllContent(), juce::String("ab\ncd\nef"));
+        }
+        
+        beginTest("Selections are replaced and carets without one delete a single character");
+        {
+            juce::CodeDocument document;
+            document.replaceAllContent("0123456789");
+            
+            CaretList carets;
+            carets.setCarets({ CaretList::Caret{ 3, 1 }, caretAt(5), CaretList::Caret{ 7, 9 } });
+            carets.deleteBackwards(document);
+            
+            expectEquals(document.getAllContent(), juce::String("03569"));
+            expectPositions(carets, { 1, 2, 4 });
+            
+            carets.deleteForwards(document);
+            expectEquals(document.getAllContent(), juce::String("06"));
+            expectPositions(carets, { 1, 2 });
+        }
+        
+        beginTest("A \\r\\n is deleted as a whole");
+        {
+            juce::CodeDocument document;
+            document.replaceAllContent("a\r\nb\r\nc");
+            
+            CaretList carets;
+            carets.reset(3);
+            carets.deleteBackwards(document);
+            expectEquals(document.getAllContent(), juce::String("ab\r\nc"));
+            expectPositions(carets, { 1 });
+            
+            carets.reset(2);
+            carets.deleteForwards(document);
+            expectEquals(document.getAllContent(), juce::String("abc"));
+            expectPositions(carets, { 2 });
+            
+            document.replaceAllContent("a\n\rb");
+            carets.reset(3);
+            carets.deleteBackwards(document);
+            expectEquals(document.getAllContent(), juce::String("a\nb"));
+        }
+        
+        beginTest("Overlapping and adjacent carets are merged");
+        {
+            CaretList carets;
+            carets.setCarets({ caretAt(4), CaretList::Caret{ 1, 5 }, caretAt(8), caretAt(8) });
+            expectEquals(static_cast<int>(carets.getNumCarets()), 2);
+            expect(carets.getCarets()[0].getSelection() == juce::Range<int>(1, 5));
+            
+            // A caret where the selection before it ends becomes part of it, and keeps being the main one
+            carets.addCaret(caretAt(5));
+            expectEquals(static_cast<int>(carets.getNumCarets()), 2);
+            expect(carets.getMainCaret().getSelection() == juce::Range<int>(1, 5));
+            
+            carets.addCaret(CaretList::Caret{ 8, 10 });
+            expectEquals(static_cast<int>(carets.getNumCarets()), 2);
+            expect(carets.getMainCaret().getSelection() == juce::Range<int>(8, 10));
+        }
+        
+        beginTest("Carets that meet after an edit are merged");
+        {
+            juce::CodeDocument document;
+            document.replaceAllContent("abcdef");
+            
+            CaretList carets;
+            carets.setCarets({ caretAt(1), caretAt(2), caretAt(3) });
+            carets.deleteBackwards(document);
+            
+            expectEquals(document.getAllContent(), juce::String("def"));
+            expectPositions(carets, { 0 });
+        }
+        
+        beginTest("Carets follow edits made somewhere else");
+        {
+            CaretList carets;
+            carets.setCarets({ caretAt(2), CaretList::Caret{ 5, 8 }, caretAt(12) });
+            
+            // Insertions move the carets after them, but not one right where the text was inserted
+            carets.shiftForEdit(2, 0, 3);
+            expectPositions(carets, { 2, 11, 15 });
+            expect(carets.getCarets()[1].getSelection() == juce::Range<int>(8, 11));
+            
+            // Carets inside removed text end up where it was
+            carets.shiftForEdit(9, 4, 0);
+            expectPositions(carets, { 2, 9, 11 });
+            expect(carets.getCarets()[1].getSelection() == juce::Range<int>(8, 9));
+            
+            carets.shiftForEdit(20, 1, 1);
+            expectPositions(carets, { 2, 9, 11 });
+        }
+    }
+    
+private:
+    static CaretList::Caret caretAt(int position)
+    {
+        return CaretList::Caret{ position, position };
+    }
+    
+    void expectPositions(const CaretList &carets, std::initializer_list<int> positions)
+    {
+        juce::Array<int> actual;
+        juce::String     message = "carets are at";
+        
+        for (const CaretList::Caret &caret : carets.getCarets())
+        {
+            actual.add(caret.position);
+            message << ' ' << caret.position;
+        }
+        
+        expect(actual == juce::Array<int>(positions), message);
+    }
+};
+
+static CaretListTests caretListTests;
+//======================================================================================================================
+// endregion CaretListTests
+//**********************************************************************************************************************
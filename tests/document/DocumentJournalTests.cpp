@@ -0,0 +1,192 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   DocumentJournalTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/document/DocumentJournal.h"
+
+//**********************************************************************************************************************
+// region DocumentJournalTests
+//======================================================================================================================
+class DocumentJournalTests : public juce::UnitTest
+{
+public:
+    DocumentJournalTests()
+        : juce::UnitTest("DocumentJournal", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void initialise() override
+    {
+        root = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                   .getNonexistentChildFile("jamal-document-journal", {});
+        (void) root.createDirectory();
+    }
+    
+    void shutdown() override
+    {
+        (void) root.deleteRecursively();
+    }
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("The snapshot is recovered with all edits of the log replayed on top of it");
+        {
+            const juce::File folder = createJournal("recovery");
+            
+            TextRope text;
+            expect(DocumentJournal::recover(getJournalDirectory(folder), getDocument(folder), text));
+            expectEquals(text.toString(), getEditedText());
+        }
+        
+        beginTest("Recovery stops at a last record that was cut off");
+        {
+            const juce::File folder = createJournal("truncated");
+            
+            changeFile(findJournalFile(folder, "*.log"), [](juce::MemoryBlock &data)
+            {
+                data.setSize(data.getSize() - 2);
+            });
+            
+            TextRope text;
+            expect(DocumentJournal::recover(getJournalDirectory(folder), getDocument(folder), text));
+            expectEquals(text.toString(), juce::String("Hello world"));
+        }
+        
+        beginTest("Recovery stops at a last record that doesn't match its checksum");
+        {
+            const juce::File folder = createJournal("corrupt");
+            
+            changeFile(findJournalFile(folder, "*.log"), [](juce::MemoryBlock &data)
+            {
+                data[data.getSize() - 1] ^= 0x55;
+            });
+            
+            TextRope text;
+            expect(DocumentJournal::recover(getJournalDirectory(folder), getDocument(folder), text));
+            expectEquals(text.toString(), juce::String("Hello world"));
+        }
+        
+        beginTest("A log of another generation than the snapshot is ignored");
+        {
+            const juce::File folder = createJournal("generation");
+            
+            // The generation follows the magic number at the start of the file
+            changeFile(findJournalFile(folder, "*.log"), [](juce::MemoryBlock &data)
+            {
+                data[4] ^= 0x55;
+            });
+            
+            TextRope text;
+            expect(DocumentJournal::recover(getJournalDirectory(folder), getDocument(folder), text));
+            expectEquals(text.toString(), juce::String("hello"));
+        }
+        
+        beginTest("A damaged snapshot recovers nothing and leaves the text alone");
+        {
+            const juce::File folder = createJournal("snapshot");
+            
+            changeFile(findJournalFile(folder, "*.snapshot"), [](juce::MemoryBlock &data)
+            {
+                data[data.getSize() - 5] ^= 0x55;
+            });
+            
+            TextRope text("untouched");
+            expect(!DocumentJournal::recover(getJournalDirectory(folder), getDocument(folder), text));
+            expectEquals(text.toString(), juce::String("untouched"));
+        }
+        
+        beginTest("Saving writes the edited text to the document and discards the journal");
+        {
+            const juce::File folder = root.getChildFile("save");
+            
+            {
+                DocumentJournal journal(getJournalDirectory(folder), getDocument(folder), TextRope("hello"));
+                recordEdits(journal);
+                journal.save();
+            }
+            
+            expectEquals(getDocument(folder).loadFileAsString(), getEditedText());
+            expect(getJournalDirectory(folder).findChildFiles(juce::File::findFiles, false).isEmpty());
+            
+            TextRope text;
+            expect(!DocumentJournal::recover(getJournalDirectory(folder), getDocument(folder), text));
+        }
+    }
+    
+private:
+    juce::File root;
+    
+    //==================================================================================================================
+    static juce::File getDocument        (const juce::File &folder) { return folder.getChildFile("Document.xml"); }
+    static juce::File getJournalDirectory(const juce::File &folder) { return folder.getChildFile("journal"); }
+    
+    static juce::String getEditedText()
+    {
+        return juce::String(juce::CharPointer_UTF8("Hello world \xc3\xa4"));
+    }
+    
+    /** Makes three edits to "hello", the last one is a record of its own at the end of the log. */
+    static void recordEdits(DocumentJournal &journal)
+    {
+        journal.recordEdit(5, 0, " world");
+        journal.recordEdit(0, 1, "H");
+        journal.recordEdit(11, 0, juce::String(juce::CharPointer_UTF8(" \xc3\xa4")));
+    }
+    
+    /** Leaves a journal behind as if the editor crashed, the journal's thread writes all edits before it stops. */
+    juce::File createJournal(const juce::String &name)
+    {
+        const juce::File folder = root.getChildFile(name);
+        
+        {
+            DocumentJournal journal(getJournalDirectory(folder), getDocument(folder), TextRope("hello"));
+            recordEdits(journal);
+        }
+        
+        return folder;
+    }
+    
+    juce::File findJournalFile(const juce::File &folder, const juce::String &pattern)
+    {
+        const juce::Array<juce::File> files = getJournalDirectory(folder).findChildFiles(juce::File::findFiles, false,
+                                                                                         pattern);
+        expectEquals(files.size(), 1);
+        return files.isEmpty() ? juce::File() : files.getFirst();
+    }
+    
+    template<class Fn>
+    static void changeFile(const juce::File &file, Fn &&change)
+    {
+        juce::MemoryBlock data;
+        (void) file.loadFileAsData(data);
+        change(data);
+        (void) file.replaceWithData(data.getData(), data.getSize());
+    }
+};
+
+static DocumentJournalTests documentJournalTests;
+//======================================================================================================================
+// endregion DocumentJournalTests
+//**********************************************************************************************************************
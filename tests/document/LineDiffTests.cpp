@@ -0,0 +1,195 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   LineDiffTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/document/LineDiff.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    // Applies the hunks the way CodeEditor::mergeExternalText does, back to front on the old lines
+    juce::String applyHunks(const juce::StringArray &oldLines, const juce::StringArray &newLines,
+                            const std::vector<LineDiff::Hunk> &hunks)
+    {
+        juce::StringArray lines = oldLines;
+        
+        for (auto it = hunks.rbegin(); it != hunks.rend(); ++it)
+        {
+            lines.removeRange(it->oldStart, it->oldCount);
+            
+            for (int i = it->newCount - 1; i >= 0; --i)
+            {
+                lines.insert(it->oldStart, newLines[it->newStart + i]);
+            }
+        }
+        
+        return lines.joinIntoString({});
+    }
+    
+    bool areOrdered(const std::vector<LineDiff::Hunk> &hunks)
+    {
+        for (std::size_t i = 1; i < hunks.size(); ++i)
+        {
+            const LineDiff::Hunk &previous = hunks[i - 1];
+            
+            if (hunks[i].oldStart <= previous.oldStart + previous.oldCount
+                || hunks[i].newStart <= previous.newStart + previous.newCount)
+            {
+                return false;
+            }
+        }
+        
+        return true;
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region LineDiffTests
+//======================================================================================================================
+class LineDiffTests : public juce::UnitTest
+{
+public:
+    LineDiffTests()
+        : juce::UnitTest("LineDiff", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Lines keep their line breaks and a trailing break leaves an empty last line");
+        {
+            const juce::StringArray lines = LineDiff::splitLines("a\nb\r\nc\rd");
+            expectEquals(lines.size(), 4);
+            expectEquals(lines[1], juce::String("b\r\n"));
+            expectEquals(lines[3], juce::String("d"));
+            
+            expectEquals(LineDiff::splitLines("a\n").size(), 2);
+            expectEquals(LineDiff::splitLines({}).size(),    1);
+        }
+        
+        beginTest("Empty texts");
+        {
+            expect(diff({}, {}).empty());
+            
+            const std::vector<LineDiff::Hunk> hunks = diff({}, "a\nb");
+            expectEquals(static_cast<int>(hunks.size()), 1);
+            expectResult({}, "a\nb");
+            expectResult("a\nb", {});
+        }
+        
+        beginTest("Identical texts have no hunks");
+        {
+            const juce::String text = "<root>\n    <child/>\n</root>\n";
+            expect(diff(text, text).empty());
+        }
+        
+        beginTest("Replacing every line gives one hunk");
+        {
+            const std::vector<LineDiff::Hunk> hunks = diff("a\nb\nc", "x\ny");
+            expectEquals(static_cast<int>(hunks.size()), 1);
+            expectEquals(hunks[0].oldCount, 3);
+            expectEquals(hunks[0].newCount, 2);
+            expectResult("a\nb\nc", "x\ny");
+        }
+        
+        beginTest("Line breaks are part of the lines they end");
+        {
+            // Only the line whose break changed differs, a \r\n is never split into two lines
+            const std::vector<LineDiff::Hunk> hunks = diff("a\r\nb\r\nc\r\n", "a\r\nb\nc\r\n");
+            expectEquals(static_cast<int>(hunks.size()), 1);
+            expectEquals(hunks[0].oldStart, 1);
+            expectEquals(hunks[0].oldCount, 1);
+            expectEquals(hunks[0].newCount, 1);
+            expectResult("a\r\nb\r\nc\r\n", "a\r\nb\nc\r\n");
+            
+            expectResult("a\r\nb\r\n", "a\nb\n");
+            expectResult("a\rb\r",     "a\r\nb\r\n");
+        }
+        
+        beginTest("Random edits are undone by applying the hunks");
+        {
+            juce::Random &random = getRandom();
+            
+            for (int i = 0; i < 500; ++i)
+            {
+                juce::StringArray old_lines;
+                
+                for (int j = random.nextInt(40); j > 0; --j)
+                {
+                    old_lines.add(makeLine(random));
+                }
+                
+                juce::StringArray new_lines = old_lines;
+                
+                for (int j = random.nextInt(10); j > 0; --j)
+                {
+                    const int index = random.nextInt(new_lines.size() + 1);
+                    
+                    switch (random.nextInt(3))
+                    {
+                        case 0:  new_lines.remove(index);                   break;
+                        case 1:  new_lines.insert(index, makeLine(random)); break;
+                        default: new_lines.set(index, makeLine(random));    break;
+                    }
+                }
+                
+                // A small limit makes the diff give up early, which must still produce a correct result
+                const int                         max_distance = (i % 5 == 0 ? 2 : LineDiff::Max_Edit_Distance);
+                const std::vector<LineDiff::Hunk> hunks        = LineDiff::compute(old_lines, new_lines, max_distance);
+                
+                expectEquals(applyHunks(old_lines, new_lines, hunks), new_lines.joinIntoString({}));
+                expect(areOrdered(hunks), "hunks overlap or touch");
+            }
+        }
+    }
+    
+private:
+    std::vector<LineDiff::Hunk> diff(const juce::String &oldText, const juce::String &newText)
+    {
+        return LineDiff::compute(LineDiff::splitLines(oldText), LineDiff::splitLines(newText));
+    }
+    
+    void expectResult(const juce::String &oldText, const juce::String &newText)
+    {
+        const juce::StringArray old_lines = LineDiff::splitLines(oldText);
+        const juce::StringArray new_lines = LineDiff::splitLines(newText);
+        expectEquals(applyHunks(old_lines, new_lines, LineDiff::compute(old_lines, new_lines)), newText);
+    }
+    
+    // Few distinct lines, so that the diff has plenty of equal lines to choose between
+    static juce::String makeLine(juce::Random &random)
+    {
+        static const char *const breaks[] { "\n", "\r\n", "\r" };
+        return juce::String::charToString(static_cast<juce::juce_wchar>('a' + random.nextInt(5)))
+               + breaks[random.nextInt(3)];
+    }
+};
+
+static LineDiffTests lineDiffTests;
+//======================================================================================================================
+// endregion LineDiffTests
+//**********************************************************************************************************************
@@ -0,0 +1,88 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TokenArenaTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/document/TokenArena.h"
+
+//**********************************************************************************************************************
+// region TokenArenaTests
+//======================================================================================================================
+class TokenArenaTests : public juce::UnitTest
+{
+public:
+    TokenArenaTests()
+        : juce::UnitTest("TokenArena", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Tokens are looked up by their index, even past 65536 characters");
+        {
+            TokenArena          arena;
+            TokenArena::Builder builder;
+            builder.add(0,      1);
+            builder.add(7,      2);
+            builder.add(70000,  3);
+            builder.add(70010,  4);
+            builder.add(300000, 5);
+            
+            const TokenArena::Run run = arena.store(builder, {});
+            
+            expectEquals(arena.getNumTokens(run), 5);
+            expectEquals(arena.getToken(run, 1).start, 7);
+            expectEquals(arena.getToken(run, 2).start, 70000);
+            expectEquals(arena.getToken(run, 3).start, 70010);
+            expectEquals(arena.getToken(run, 4).start, 300000);
+            expectEquals(arena.getToken(run, 4).style, 5);
+            
+            std::vector<int> starts;
+            arena.forEachToken(run, [&starts](TokenArena::Token token) { starts.push_back(token.start); });
+            expect(starts == std::vector<int>{ 0, 7, 70000, 70010, 300000 });
+        }
+        
+        beginTest("A run that is stored again in its old space keeps no tokens of before");
+        {
+            TokenArena          arena;
+            TokenArena::Builder builder;
+            builder.add(0,     1);
+            builder.add(80000, 2);
+            
+            TokenArena::Run run = arena.store(builder, {});
+            
+            builder.clear();
+            builder.add(3, 7);
+            run = arena.store(builder, run);
+            
+            expectEquals(arena.getNumTokens(run), 1);
+            expectEquals(arena.getToken(run, 0).start, 3);
+            expectEquals(arena.getToken(run, 0).style, 7);
+        }
+    }
+};
+
+static TokenArenaTests tokenArenaTests;
+//======================================================================================================================
+// endregion TokenArenaTests
+//**********************************************************************************************************************
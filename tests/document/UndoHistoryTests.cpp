@@ -0,0 +1,241 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   UndoHistoryTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/document/UndoHistory.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    constexpr int Edit_Length = 1000;
+    
+    //==================================================================================================================
+    // Every edit gets its own text, so reading back the wrong part of the history can't go unnoticed
+    juce::String makeText(int index)
+    {
+        const juce::String prefix = "edit " + juce::String(index) + " ";
+        return prefix + juce::String::repeatedString("-", Edit_Length - prefix.length());
+    }
+    
+    void addEdits(UndoHistory &history, int first, int count)
+    {
+        for (int i = first; i < first + count; ++i)
+        {
+            history.addEdit(0, {}, makeText(i));
+        }
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region UndoHistoryTests
+//======================================================================================================================
+class UndoHistoryTests : public juce::UnitTest
+{
+public:
+    UndoHistoryTests()
+        : juce::UnitTest("UndoHistory", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Actions of the same kind in a row are coalesced, until the kind changes or the history is sealed");
+        {
+            UndoHistory history;
+            type(history, UndoHistory::EditKind::Typing,   0, {},  "a");
+            type(history, UndoHistory::EditKind::Typing,   1, {},  "b");
+            expectEquals(history.getNumTransactions(), 1);
+            
+            type(history, UndoHistory::EditKind::Deleting, 1, "b", {});
+            expectEquals(history.getNumTransactions(), 2);
+            
+            history.seal();
+            type(history, UndoHistory::EditKind::Deleting, 0, "a", {});
+            expectEquals(history.getNumTransactions(), 3);
+            
+            type(history, UndoHistory::EditKind::Other,    0, {},  "\n");
+            type(history, UndoHistory::EditKind::Other,    1, {},  "\n");
+            expectEquals(history.getNumTransactions(), 5);
+        }
+        
+        beginTest("Undo reverts the edits of a transaction in reverse order, redo applies them again");
+        {
+            UndoHistory history;
+            type(history, UndoHistory::EditKind::Typing, 0, {}, "a");
+            type(history, UndoHistory::EditKind::Typing, 1, {}, "b");
+            
+            const std::vector<UndoHistory::Edit> undone = history.undo();
+            expectEquals(static_cast<int>(undone.size()), 2);
+            expectEquals(undone[0].start, 1);
+            expectEquals(undone[0].removed, juce::String("b"));
+            expectEquals(undone[0].inserted, juce::String());
+            expectEquals(undone[1].start, 0);
+            expectEquals(undone[1].removed, juce::String("a"));
+            expect(!history.canUndo());
+            
+            const std::vector<UndoHistory::Edit> redone = history.redo();
+            expectEquals(static_cast<int>(redone.size()), 2);
+            expectEquals(redone[0].inserted, juce::String("a"));
+            expectEquals(redone[1].inserted, juce::String("b"));
+            expect(!history.canRedo());
+        }
+        
+        beginTest("An edit after undoing drops what could have been redone");
+        {
+            UndoHistory history;
+            addEdits(history, 0, 3);
+            (void) history.undo();
+            expect(history.canRedo());
+            
+            addEdits(history, 3, 1);
+            expect(!history.canRedo());
+            expectEquals(history.getNumTransactions(), 3);
+            expectUndone(history, 3);
+            expectUndone(history, 1);
+        }
+        
+        beginTest("History beyond the memory budget is forgotten if nothing may be spilled");
+        {
+            constexpr int num_edits = 400;
+            
+            UndoHistory history;
+            history.setSpillBudget(0);
+            history.setMemoryBudget(UndoHistory::Chunk_Size);
+            addEdits(history, 0, num_edits);
+            
+            const int num_kept = history.getNumTransactions();
+            expect(num_kept > 0 && num_kept < num_edits);
+            expect(history.getMemoryUsage() < 3 * UndoHistory::Chunk_Size);
+            expect(history.getSpilledSize() == 0);
+            
+            for (int i = num_edits - 1; i >= num_edits - num_kept; --i)
+            {
+                expectUndone(history, i);
+            }
+            
+            expect(!history.canUndo());
+        }
+        
+        beginTest("The oldest history is spilled to disk and read back to undo and redo it");
+        {
+            constexpr int num_edits = 400;
+            
+            UndoHistory history;
+            history.setMemoryBudget(UndoHistory::Chunk_Size);
+            addEdits(history, 0, num_edits);
+            
+            expectEquals(history.getNumTransactions(), num_edits);
+            expect(history.getSpilledSize() > 2 * UndoHistory::Chunk_Size);
+            expect(history.getMemoryUsage() < 3 * UndoHistory::Chunk_Size);
+            
+            for (int i = num_edits - 1; i >= 0; --i)
+            {
+                expectUndone(history, i);
+            }
+            
+            for (int i = 0; i < num_edits; ++i)
+            {
+                const std::vector<UndoHistory::Edit> edits = history.redo();
+                expect(edits.size() == 1 && edits[0].inserted == makeText(i), "redo " + juce::String(i));
+            }
+        }
+        
+        beginTest("An edit after undoing into spilled history brings it back into memory");
+        {
+            constexpr int num_edits  = 400;
+            constexpr int num_undone = 300;
+            
+            UndoHistory history;
+            history.setMemoryBudget(UndoHistory::Chunk_Size);
+            addEdits(history, 0, num_edits);
+            
+            for (int i = num_edits - 1; i >= num_edits - num_undone; --i)
+            {
+                expectUndone(history, i);
+            }
+            
+            addEdits(history, num_edits, 1);
+            expect(!history.canRedo());
+            expectEquals(history.getNumTransactions(), num_edits - num_undone + 1);
+            expectUndone(history, num_edits);
+            
+            for (int i = num_edits - num_undone - 1; i >= 0; --i)
+            {
+                expectUndone(history, i);
+            }
+            
+            expect(!history.canUndo());
+        }
+        
+        beginTest("Spilled history beyond the spill budget is forgotten and the spill file compacted");
+        {
+            constexpr int num_edits = 2000;
+            
+            UndoHistory history;
+            history.setMemoryBudget(UndoHistory::Chunk_Size);
+            history.setSpillBudget(2 * UndoHistory::Chunk_Size);
+            addEdits(history, 0, num_edits);
+            
+            const int num_kept = history.getNumTransactions();
+            expect(num_kept < num_edits);
+            expect(history.getSpilledSize() > 0);
+            expect(history.getSpilledSize() <= 2 * UndoHistory::Chunk_Size);
+            
+            // Without compaction, the file would hold all the history that was ever spilled
+            expect(history.getSpillFileSize() >= history.getSpilledSize());
+            expect(history.getSpillFileSize() <= 6 * UndoHistory::Chunk_Size);
+            
+            for (int i = num_edits - 1; i >= num_edits - num_kept; --i)
+            {
+                expectUndone(history, i);
+            }
+            
+            expect(!history.canUndo());
+        }
+    }
+    
+private:
+    void type(UndoHistory &history, UndoHistory::EditKind kind, int start, const juce::String &removed,
+              const juce::String &inserted)
+    {
+        history.beginAction(kind);
+        history.addEdit(start, removed, inserted);
+        history.endAction();
+    }
+    
+    void expectUndone(UndoHistory &history, int index)
+    {
+        const std::vector<UndoHistory::Edit> edits = history.undo();
+        expect(edits.size() == 1 && edits[0].removed == makeText(index) && edits[0].inserted.isEmpty(),
+               "undo " + juce::String(index));
+    }
+};
+
+static UndoHistoryTests undoHistoryTests;
+//======================================================================================================================
+// endregion UndoHistoryTests
+//**********************************************************************************************************************
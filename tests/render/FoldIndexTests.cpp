@@ -0,0 +1,109 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FoldIndexTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/render/FoldIndex.h"
+
+//**********************************************************************************************************************
+// region FoldIndexTests
+//======================================================================================================================
+class FoldIndexTests : public juce::UnitTest
+{
+public:
+    FoldIndexTests()
+        : juce::UnitTest("FoldIndex", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Nested folds hide their lines until the last of them is shown");
+        {
+            FoldIndex index;
+            index.reset(10);
+            index.hideLines({ 2, 8 });
+            index.hideLines({ 4, 6 });
+            
+            expectEquals(index.getNumRows(), 4);
+            expect(index.isLineVisible(1));
+            expect(!index.isLineVisible(5));
+            expectEquals(index.getLineForRow(2), 8);
+            expectEquals(index.getRowForLine(5), 1);
+            
+            index.showLines({ 2, 8 });
+            
+            expectEquals(index.getNumRows(), 8);
+            expect(index.isLineVisible(3));
+            expect(!index.isLineVisible(4));
+            
+            index.showLines({ 4, 6 });
+            expectEquals(index.getNumRows(), 10);
+        }
+        
+        beginTest("Inserted lines take the folds of the line before them");
+        {
+            FoldIndex index;
+            index.reset(6);
+            index.hideLines({ 1, 4 });
+            index.insertLines(2, 3);
+            
+            expectEquals(index.getNumLines(), 9);
+            expectEquals(index.getNumRows(), 3);
+            expect(!index.isLineVisible(4));
+            expect(index.isLineVisible(7));
+            
+            index.insertLines(0, 2);
+            expectEquals(index.getNumRows(), 5);
+            expect(index.isLineVisible(1));
+            
+            index.removeLines(3, 6);
+            expectEquals(index.getNumLines(), 5);
+            expectEquals(index.getNumRows(), 5);
+        }
+        
+        beginTest("Positions account for hidden lines and extra heights");
+        {
+            FoldIndex index;
+            index.reset(5);
+            index.setDefaultHeight(10.0);
+            index.setExtraHeight(0, 5.0);
+            index.setExtraHeight(2, 20.0);
+            index.hideLines({ 2, 4 });
+            
+            expectEquals(index.getTotalHeight(), 35.0);
+            expectEquals(index.getYForLine(1),   15.0);
+            expectEquals(index.getYForLine(3),   15.0);
+            expectEquals(index.getYForLine(4),   25.0);
+            expectEquals(index.getLineAtY(14.0), 0);
+            expectEquals(index.getLineAtY(24.0), 1);
+            expectEquals(index.getLineAtY(25.0), 4);
+            expectEquals(index.getLineAtY(35.0), 5);
+        }
+    }
+};
+
+static FoldIndexTests foldIndexTests;
+//======================================================================================================================
+// endregion FoldIndexTests
+//**********************************************************************************************************************
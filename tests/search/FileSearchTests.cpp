@@ -0,0 +1,217 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   FileSearchTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/search/FileSearch.h"
+
+//**********************************************************************************************************************
+// region FileSearchTests
+//======================================================================================================================
+class FileSearchTests : public juce::UnitTest
+{
+public:
+    FileSearchTests()
+        : juce::UnitTest("FileSearch", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void initialise() override
+    {
+        root = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                   .getNonexistentChildFile("jamal-file-search", {});
+        (void) root.createDirectory();
+    }
+    
+    void shutdown() override
+    {
+        (void) root.deleteRecursively();
+    }
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Ignored folders are skipped with everything inside them and file globs pick the files");
+        {
+            const juce::File folder = createFolder("globs");
+            writeFile(folder, "a.xml",         "<a/>");
+            writeFile(folder, "b.txt",         "b");
+            writeFile(folder, "bin/c.xml",     "<c/>");
+            writeFile(folder, "sub/d.xml",     "<d/>");
+            writeFile(folder, "sub/e.xaml",    "<e/>");
+            writeFile(folder, "sub/obj/f.xml", "<f/>");
+            
+            FileSearch::Options options;
+            options.fileGlobs = { "*.xml", "*.xaml" };
+            
+            expect(findFiles(folder, options) == juce::StringArray { "a.xml", "sub/d.xml", "sub/e.xaml" });
+            
+            // Globs with a slash are matched against the whole relative path
+            options.ignoreGlobs.add("sub/*.xaml");
+            expect(findFiles(folder, options) == juce::StringArray { "a.xml", "sub/d.xml" });
+            
+            expect( FileSearch::isSearchable("sub/d.xml",     options));
+            expect(!FileSearch::isSearchable("sub/obj/f.xml", options));
+            expect(!FileSearch::isSearchable("b.txt",         options));
+        }
+        
+        beginTest("Matches stream in over several calls and only the last one finishes the search");
+        {
+            const juce::File folder = createFolder("stream");
+            const int        count  = FileSearch::Max_Batch_Size * 3;
+            
+            juce::String text;
+            
+            for (int i = 0; i < count; ++i)
+            {
+                text << "line " << i << ": <item/>\n";
+            }
+            
+            writeFile(folder, "items.xml",       text);
+            writeFile(folder, "other.xml",       "<root>\n    <item/>\n</root>");
+            writeFile(folder, "bin/skipped.xml", "<item/>");
+            
+            FileSearch                     search(2);
+            std::vector<FileSearch::Match> matches;
+            int                            num_calls    = 0;
+            int                            num_finished = 0;
+            bool                           finished     = false;
+            
+            expect(search.start(folder, { "<item/>" }, {}, [&](std::vector<FileSearch::Match> batch, bool isFinished)
+            {
+                ++num_calls;
+                num_finished += (isFinished ? 1 : 0);
+                expect(!finished, "There was a call after the one that finished the search");
+                
+                matches.insert(matches.end(), batch.begin(), batch.end());
+                finished = isFinished;
+            }));
+            
+            expect(waitUntil([&finished] { return finished; }));
+            expect(!search.isSearching());
+            expectEquals(static_cast<int>(matches.size()), count + 1);
+            expectGreaterThan(num_calls, 2);
+            expectEquals(num_finished, 1);
+            
+            for (const auto &match : matches)
+            {
+                if (match.file.getFileName() == "other.xml")
+                {
+                    expectEquals(match.line, 1);
+                    expect(match.columns == juce::Range<int>(4, 11));
+                    expectEquals(match.lineText, juce::String("    <item/>"));
+                }
+            }
+        }
+        
+        beginTest("A cancelled search never calls back and the next one runs on the same threads");
+        {
+            const juce::File folder = createFolder("cancel");
+            
+            for (int i = 0; i < 64; ++i)
+            {
+                writeFile(folder, "file" + juce::String(i) + ".xml", juce::String::repeatedString("<a/>\n", 4096));
+            }
+            
+            FileSearch search(2);
+            bool       called = false;
+            
+            expect(search.start(folder, { "<a/>" }, {}, [&called](std::vector<FileSearch::Match>, bool)
+            {
+                called = true;
+            }));
+            
+            search.cancel();
+            expect(!search.isSearching());
+            
+            (void) waitUntil([] { return false; }, 100);
+            expect(!called);
+            
+            int  num_matches = 0;
+            bool finished    = false;
+            
+            expect(search.start(folder, { "<a/>" }, {}, [&](std::vector<FileSearch::Match> batch, bool isFinished)
+            {
+                num_matches += static_cast<int>(batch.size());
+                finished     = isFinished;
+            }));
+            
+            expect(waitUntil([&finished] { return finished; }));
+            expectEquals(num_matches, 64 * 4096);
+        }
+    }
+
+private:
+    static constexpr int Timeout_Ms = 10000;
+    
+    //==================================================================================================================
+    juce::File root;
+    
+    //==================================================================================================================
+    juce::File createFolder(const juce::String &name) const
+    {
+        const juce::File folder = root.getChildFile(name);
+        (void) folder.createDirectory();
+        return folder;
+    }
+    
+    void writeFile(const juce::File &folder, const juce::String &path, const juce::String &text)
+    {
+        const juce::File file = folder.getChildFile(path);
+        (void) file.getParentDirectory().createDirectory();
+        expect(file.replaceWithText(text));
+    }
+    
+    static juce::StringArray findFiles(const juce::File &folder, const FileSearch::Options &options)
+    {
+        juce::StringArray paths;
+        
+        FileSearch::forEachFile(folder, options, [&paths](const juce::File&, const juce::String &relativePath)
+        {
+            paths.add(relativePath);
+            return true;
+        });
+        
+        paths.sort(false);
+        return paths;
+    }
+    
+    /** Runs the message loop, which results are delivered on, until a condition is met or the time is up. */
+    template<class Fn>
+    static bool waitUntil(Fn &&condition, int timeoutMs = Timeout_Ms)
+    {
+        const juce::uint32 end = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+        
+        while (!condition() && juce::Time::getMillisecondCounter() < end)
+        {
+            (void) juce::MessageManager::getInstance()->runDispatchLoopUntil(10);
+        }
+        
+        return condition();
+    }
+};
+
+static FileSearchTests fileSearchTests;
+//======================================================================================================================
+// endregion FileSearchTests
+//**********************************************************************************************************************
@@ -0,0 +1,297 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   TrigramIndexTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/search/TrigramIndex.h"
+
+//**********************************************************************************************************************
+// region TrigramIndexTests
+//======================================================================================================================
+class TrigramIndexTests : public juce::UnitTest
+{
+public:
+    TrigramIndexTests()
+        : juce::UnitTest("TrigramIndex", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void initialise() override
+    {
+        root = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                   .getNonexistentChildFile("jamal-trigram-index", {});
+        (void) root.createDirectory();
+    }
+    
+    void shutdown() override
+    {
+        (void) root.deleteRecursively();
+    }
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Only files with all trigrams of a literal are candidates, regular expressions can't be narrowed");
+        {
+            const juce::File folder = createFolder("candidates");
+            writeFile(folder, "a.xml",     "<Window x:Name=\"main\"/>");
+            writeFile(folder, "b.xml",     "<window/>");
+            writeFile(folder, "c.xml",     "<Grid/>");
+            writeFile(folder, "bin/d.xml", "<Window/>");
+            
+            TrigramIndex index(folder, {});
+            expectEquals(index.update(), 3);
+            expectEquals(index.getNumFiles(), 3);
+            expectEquals(index.update(), 0);
+            
+            // Letters are folded, the exact scan decides whether the case matched
+            expect(findCandidates(index, "<Window") == juce::StringArray { "a.xml", "b.xml" });
+            expect(findCandidates(index, "x:Name") == juce::StringArray { "a.xml" });
+            expect(findCandidates(index, "<Button").isEmpty());
+            
+            expect(!index.findCandidates({ "<W" }).has_value());
+            expect(!index.findCandidates({ "<Window", true }).has_value());
+        }
+        
+        beginTest("A saved index loads with the same postings and only for the folder it was built for");
+        {
+            const juce::File folder = createFolder("round-trip");
+            
+            for (int i = 0; i < 300; ++i)
+            {
+                // Enough files for ids and deltas that take more than one byte
+                writeFile(folder, "file" + juce::String(i) + ".xml",
+                          "<item id=\"" + juce::String(i) + "\"/>" + (i % 7 == 0 ? "<seventh/>" : ""));
+            }
+            
+            TrigramIndex index(folder, {});
+            (void) index.update();
+            
+            const juce::File index_file = root.getChildFile("round-trip.jtri");
+            expect(index.save(index_file));
+            expect(!index_file.getSiblingFile("round-trip.jtri.tmp").exists());
+            
+            TrigramIndex loaded(folder, {});
+            expect(loaded.load(index_file));
+            expectEquals(loaded.getNumFiles(), 300);
+            expect(loaded.getPostingsSize() == index.getPostingsSize());
+            expect(findCandidates(loaded, "<seventh/>") == findCandidates(index, "<seventh/>"));
+            expectEquals(findCandidates(loaded, "<seventh/>").size(), 43);
+            expectEquals(loaded.update(), 0);
+            
+            TrigramIndex other_root(root, {});
+            expect(!other_root.load(index_file));
+            
+            // A truncated file must not be taken for an index with fewer files
+            juce::MemoryBlock data;
+            expect(index_file.loadFileAsData(data));
+            
+            const juce::File truncated_file = root.getChildFile("truncated.jtri");
+            expect(truncated_file.replaceWithData(data.getData(), data.getSize() - 3));
+            
+            TrigramIndex truncated(folder, {});
+            expect(!truncated.load(truncated_file));
+            expectEquals(truncated.getNumFiles(), 0);
+        }
+        
+        beginTest("Changed files leave tombstones behind until there are more of them than live files");
+        {
+            const juce::File folder = createFolder("tombstones");
+            
+            for (int i = 0; i < 4; ++i)
+            {
+                writeFile(folder, "file" + juce::String(i) + ".xml", "<old/>");
+            }
+            
+            TrigramIndex index(folder, {});
+            (void) index.update();
+            
+            writeFile(folder, "file0.xml", "<new/>");
+            index.updateFile(folder.getChildFile("file0.xml"));
+            
+            expectEquals(index.getNumFiles(), 4);
+            expectEquals(index.getNumTombstones(), 1);
+            expect(findCandidates(index, "<new/>") == juce::StringArray { "file0.xml" });
+            expect(findCandidates(index, "<old/>") == juce::StringArray { "file1.xml", "file2.xml", "file3.xml" });
+            
+            // Tombstones are saved with the index, the ids in the lists still point at them
+            const juce::File index_file = root.getChildFile("tombstones.jtri");
+            expect(index.save(index_file));
+            
+            TrigramIndex loaded(folder, {});
+            expect(loaded.load(index_file));
+            expectEquals(loaded.getNumTombstones(), 1);
+            expect(findCandidates(loaded, "<old/>") == findCandidates(index, "<old/>"));
+            
+            (void) folder.getChildFile("file3.xml").deleteFile();
+            index.updateFile(folder.getChildFile("file3.xml"));
+            expectEquals(index.getNumFiles(), 3);
+            expectEquals(index.getNumTombstones(), 2);
+            
+            const std::size_t postings_size = index.getPostingsSize();
+            
+            for (const auto &name : { "file1.xml", "file2.xml" })
+            {
+                writeFile(folder, name, "<new/>");
+                index.updateFile(folder.getChildFile(name));
+            }
+            
+            // The last change made four tombstones next to three live files, which rewrote all lists
+            expectEquals(index.getNumFiles(), 3);
+            expectEquals(index.getNumTombstones(), 0);
+            expectLessThan(index.getPostingsSize(), postings_size);
+            expect(findCandidates(index, "<new/>") == juce::StringArray { "file0.xml", "file1.xml", "file2.xml" });
+            expect(findCandidates(index, "<old/>").isEmpty());
+            
+            expect(index.save(index_file));
+            expect(loaded.load(index_file));
+            expectEquals(loaded.getNumTombstones(), 0);
+            expect(findCandidates(loaded, "<new/>") == findCandidates(index, "<new/>"));
+        }
+        
+        beginTest("Files a watcher reports as changed are reindexed");
+        {
+            const juce::File folder = createFolder("watched");
+            const juce::File file   = writeFile(folder, "watched.xml", "<before/>");
+            
+            FileWatcher  watcher;
+            TrigramIndex index(folder, {});
+            (void) index.update();
+            
+            watcher.addFile(file);
+            index.setFileWatcher(&watcher);
+            
+            writeFile(folder, "watched.xml", "<after changed=\"true\"/>");
+            
+            expect(waitUntil([&index] { return findCandidates(index, "<after").size() == 1; }));
+            expect(findCandidates(index, "<before/>").isEmpty());
+            
+            index.setFileWatcher(nullptr);
+        }
+        
+        beginTest("FileSearch only scans the files the index says can contain a match");
+        {
+            const juce::File folder = createFolder("search");
+            writeFile(folder, "a.xml", "<match/>");
+            writeFile(folder, "b.xml", "<other/>");
+            
+            TrigramIndex index(folder, {});
+            (void) index.update();
+            
+            // The index hasn't seen this yet, so the search has to skip it
+            writeFile(folder, "b.xml", "<match/>");
+            
+            FileSearch::Options options;
+            options.index = &index;
+            
+            expect(search(folder, { "<match/>" }, options) == juce::StringArray { "a.xml" });
+            
+            index.updateFile(folder.getChildFile("b.xml"));
+            expect(search(folder, { "<match/>" }, options) == juce::StringArray { "a.xml", "b.xml" });
+            
+            // The index can't narrow down expressions, every file is scanned for them
+            writeFile(folder, "c.xml", "<match/>");
+            expect(search(folder, { "<match/>", true }, options)
+                   == juce::StringArray { "a.xml", "b.xml", "c.xml" });
+        }
+    }
+
+private:
+    static constexpr int Timeout_Ms = 10000;
+    
+    //==================================================================================================================
+    juce::File root;
+    
+    //==================================================================================================================
+    juce::File createFolder(const juce::String &name) const
+    {
+        const juce::File folder = root.getChildFile(name);
+        (void) folder.createDirectory();
+        return folder;
+    }
+    
+    juce::File writeFile(const juce::File &folder, const juce::String &path, const juce::String &text)
+    {
+        const juce::File file = folder.getChildFile(path);
+        (void) file.getParentDirectory().createDirectory();
+        expect(file.replaceWithText(text));
+        return file;
+    }
+    
+    static juce::StringArray findCandidates(const TrigramIndex &index, const juce::String &pattern)
+    {
+        juce::StringArray names;
+        
+        if (const auto candidates = index.findCandidates({ pattern }))
+        {
+            for (const auto &file : *candidates)
+            {
+                names.add(file.getFileName());
+            }
+        }
+        
+        names.sort(false);
+        return names;
+    }
+    
+    juce::StringArray search(const juce::File &folder, const SearchQuery &query, const FileSearch::Options &options)
+    {
+        FileSearch        file_search(1);
+        juce::StringArray names;
+        bool              finished = false;
+        
+        expect(file_search.start(folder, query, options, [&](std::vector<FileSearch::Match> matches, bool isFinished)
+        {
+            for (const auto &match : matches)
+            {
+                names.addIfNotAlreadyThere(match.file.getFileName());
+            }
+            
+            finished = isFinished;
+        }));
+        
+        expect(waitUntil([&finished] { return finished; }));
+        
+        names.sort(false);
+        return names;
+    }
+    
+    /** Runs the message loop, which watchers and searches report on, until a condition is met or the time is up. */
+    template<class Fn>
+    static bool waitUntil(Fn &&condition, int timeoutMs = Timeout_Ms)
+    {
+        const juce::uint32 end = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+        
+        while (!condition() && juce::Time::getMillisecondCounter() < end)
+        {
+            (void) juce::MessageManager::getInstance()->runDispatchLoopUntil(10);
+        }
+        
+        return condition();
+    }
+};
+
+static TrigramIndexTests trigramIndexTests;
+//======================================================================================================================
+// endregion TrigramIndexTests
+//**********************************************************************************************************************
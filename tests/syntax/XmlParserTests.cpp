@@ -0,0 +1,197 @@
+/**
+    ===============================================================
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any internal version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+    Copyright (c) 2021 ElandaSunshine
+    ===============================================================
+
+    @author Elanda
+    @file   XmlParserTests.cpp
+    @date   19, October 2026
+
+    ===============================================================
+ */
+
+#include "editor/document/TextRope.h"
+#include "editor/syntax/XmlParser.h"
+
+//**********************************************************************************************************************
+// region Namespace
+//======================================================================================================================
+namespace
+{
+    // Pieces of well-formed and broken markup, random edits made of these keep running into every recovery path
+    const char* const Fragments[] {
+        "<a>", "</a>", "<b x=\"1\">", "</b>", "<c/>", "<!--", "-->", "text", "<", ">", "\"", "<?pi?>", "<![CDATA[",
+        "]]>", "<!DOCTYPE d [<!ENTITY e 'x'>]>", " ", "</c>", "y='2'", "\n", "<a><b>t</b><c/></a>", "<b>", "</b>",
+        "<!a>"
+    };
+    
+    //==================================================================================================================
+    juce::String randomFragments(juce::Random &random, int count)
+    {
+        juce::String text;
+        
+        for (int i = 0; i < count; ++i)
+        {
+            text << Fragments[random.nextInt(static_cast<int>(std::size(Fragments)))];
+        }
+        
+        return text;
+    }
+    
+    /** Writes out everything a parse produced for a node's children, with absolute offsets. */
+    juce::String describeChildren(const SyntaxTree &tree, SyntaxTree::NodeId id)
+    {
+        juce::String description;
+        
+        for (SyntaxTree::NodeId child = tree.getNode(id).firstChild; child != SyntaxTree::Invalid_Id;
+             child = tree.getNode(child).nextSibling)
+        {
+            const SyntaxTree::Node &node = tree.getNode(child);
+            
+            description << '(' << static_cast<int>(node.type) << ' ' << tree.getName(child)
+                        << " @" << tree.getStart(child) << '+' << node.length
+                        << ' ' << node.startTagLength << '/' << node.endTagStart
+                        << " f" << static_cast<int>(node.flags);
+            
+            for (int i = 0; i < static_cast<int>(node.numAttributes); ++i)
+            {
+                const SyntaxTree::Attribute &attribute = tree.getAttribute(child, i);
+                description << " [" << tree.getNameForId(attribute.name) << ' ' << attribute.start << ' '
+                            << attribute.valueStart << ' ' << attribute.valueLength << ']';
+            }
+            
+            description << describeChildren(tree, child) << ')';
+        }
+        
+        return description;
+    }
+    
+    juce::String describe(const SyntaxTree &tree)
+    {
+        const SyntaxTree::Node &root = tree.getNode(tree.getRoot());
+        return juce::String(root.length) + " f" + juce::String(static_cast<int>(root.flags))
+               + describeChildren(tree, tree.getRoot());
+    }
+}
+//======================================================================================================================
+// endregion Namespace
+//**********************************************************************************************************************
+// region XmlParserTests
+//======================================================================================================================
+class XmlParserTests : public juce::UnitTest
+{
+public:
+    XmlParserTests()
+        : juce::UnitTest("XmlParser", "Jamal")
+    {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Broken markup is closed where it stops and marked dirty");
+        {
+            TextRope   text("<r><c><a></c></r>");
+            SyntaxTree tree;
+            XmlParser::parse(tree, text);
+            
+            const SyntaxTree::NodeId r = tree.getNode(tree.getRoot()).firstChild;
+            const SyntaxTree::NodeId c = tree.getNode(r).firstChild;
+            const SyntaxTree::NodeId a = tree.getNode(c).firstChild;
+            
+            expect(tree.getRange(c) == juce::Range<int>(3, 13));
+            expect(tree.getRange(a) == juce::Range<int>(6, 9));
+            expect((tree.getNode(a).flags & SyntaxTree::NodeFlags::Unclosed) != 0);
+            expect((tree.getNode(c).flags & SyntaxTree::NodeFlags::Dirty)    != 0);
+            expect((tree.getNode(r).flags & SyntaxTree::NodeFlags::Dirty)    != 0);
+        }
+        
+        beginTest("An edit that repairs an element makes it and its ancestors clean again");
+        {
+            TextRope   text("<r><c><a></c></r>");
+            SyntaxTree tree;
+            XmlParser::parse(tree, text);
+            
+            text.insert(7, "!");
+            XmlParser::reparse(tree, text, 7, 0, 1);
+            
+            const SyntaxTree::NodeId r = tree.getNode(tree.getRoot()).firstChild;
+            const SyntaxTree::NodeId c = tree.getNode(r).firstChild;
+            
+            expect(tree.getNode(tree.getNode(c).firstChild).type == SyntaxTree::NodeType::Declaration);
+            expectEquals(static_cast<int>(tree.getNode(c).flags & SyntaxTree::NodeFlags::Dirty), 0);
+            expectEquals(static_cast<int>(tree.getNode(r).flags & SyntaxTree::NodeFlags::Dirty), 0);
+            expectEquals(static_cast<int>(tree.getNode(tree.getRoot()).flags & SyntaxTree::NodeFlags::Dirty), 0);
+        }
+        
+        beginTest("Stray markup outside of the edited children keeps an element dirty");
+        {
+            TextRope   text("<r>< <c><a></c></r>");
+            SyntaxTree tree;
+            XmlParser::parse(tree, text);
+            
+            text.insert(9, "!");
+            XmlParser::reparse(tree, text, 9, 0, 1);
+            
+            const SyntaxTree::NodeId r = tree.getNode(tree.getRoot()).firstChild;
+            const SyntaxTree::NodeId c = tree.getNode(r).firstChild;
+            
+            expectEquals(static_cast<int>(tree.getNode(c).flags & SyntaxTree::NodeFlags::Dirty), 0);
+            expect((tree.getNode(r).flags & SyntaxTree::NodeFlags::Dirty) != 0);
+        }
+        
+        beginTest("Reparsing after random edits gives the same tree as parsing from scratch");
+        {
+            juce::Random &random = getRandom();
+            int           failures = 0;
+            
+            for (int document = 0; document < 500 && failures == 0; ++document)
+            {
+                TextRope   text(randomFragments(random, random.nextInt(60)));
+                SyntaxTree incremental;
+                XmlParser::parse(incremental, text);
+                
+                for (int i = 0; i < 40; ++i)
+                {
+                    const int          offset   = random.nextInt(text.getLength() + 1);
+                    const int          removed  = juce::jmin(random.nextInt(6), text.getLength() - offset);
+                    const juce::String inserted = randomFragments(random, random.nextInt(3));
+                    
+                    text.replace(offset, removed, inserted);
+                    XmlParser::reparse(incremental, text, offset, removed, inserted.length());
+                    
+                    SyntaxTree fresh;
+                    XmlParser::parse(fresh, text);
+                    
+                    if (describe(incremental) != describe(fresh))
+                    {
+                        ++failures;
+                        expectEquals(describe(incremental), describe(fresh),
+                                     "after replacing " + juce::String(removed) + " characters at "
+                                     + juce::String(offset) + " in: " + text.toString());
+                        break;
+                    }
+                }
+            }
+            
+            expectEquals(failures, 0);
+        }
+    }
+};
+
+static XmlParserTests xmlParserTests;
+//======================================================================================================================
+// endregion XmlParserTests
+//**********************************************************************************************************************